@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "sim.h"
+#include "sim_sx1276.h"
+#include "rfm95.h"
+#include "rfm95_definitions.h"
+
+// ============================================================================
+// TEMPO NO AR E ORÇAMENTO DE DUTY CYCLE
+// ============================================================================
+// 1. rfm95_time_on_air_us() contra valores de referência do SX1276
+//    (calculadora LoRa da Semtech / AN1200.13), com LDRO automático
+// 2. Transmissões reais no simulador com o orçamento de 1%: tempo no ar
+//    efetivo e pior janela de uma hora
+
+typedef struct {
+    uint8_t config1;
+    uint8_t config2;
+    uint16_t preamble;
+    uint8_t size;
+    uint32_t expected_us;
+    bool ldro;
+} toa_case_t;
+
+#define C1(bw, cr) (BANDWIDTH_##bw + ERROR_CODING_##cr + EXPLICIT_MODE)
+
+static const toa_case_t toa_cases[] = {
+    { C1(125K, 4_5), SPREADING_7  + CRC_ON,  8,   0,   25856, false },
+    { C1(125K, 4_5), SPREADING_7  + CRC_ON,  8,  11,   41216, false },
+    { C1(125K, 4_5), SPREADING_7  + CRC_ON,  8,  20,   56576, false },
+    { C1(125K, 4_5), SPREADING_7  + CRC_ON,  8,  51,  102656, false },
+    { C1(125K, 4_5), SPREADING_7  + CRC_ON,  8, 255,  399616, false },
+    { C1(125K, 4_5), SPREADING_8  + CRC_ON,  8,  20,  102912, false },
+    { C1(125K, 4_5), SPREADING_9  + CRC_ON,  8,  20,  185344, false },
+    { C1(125K, 4_5), SPREADING_10 + CRC_ON,  8,   1,  206848, false },
+    { C1(125K, 4_5), SPREADING_10 + CRC_ON,  8,  20,  370688, false },
+    { C1(125K, 4_5), SPREADING_11 + CRC_ON,  8,  20,  741376, true  },
+    { C1(125K, 4_5), SPREADING_12 + CRC_ON,  8,  20, 1318912, true  },
+    { C1(125K, 4_5), SPREADING_12 + CRC_ON,  8,  51, 2465792, true  },
+    { C1(125K, 4_5), SPREADING_12 + CRC_ON,  8, 255, 9019392, true  },
+    { C1(250K, 4_5), SPREADING_7  + CRC_ON,  8,  20,   28288, false },
+    { C1(500K, 4_5), SPREADING_8  + CRC_ON,  8,  20,   25728, false },
+    { C1(500K, 4_5), SPREADING_12 + CRC_ON,  8,  20,  329728, false },
+    { C1(62K5, 4_5), SPREADING_9  + CRC_ON,  8,  20,  370688, false },
+    { C1(41K7, 4_5), SPREADING_10 + CRC_ON,  8,  20, 1234944, true  },
+    { C1(7K8,  4_5), SPREADING_7  + CRC_ON,  8,  10,  741376, true  },
+    { C1(125K, 4_8), SPREADING_7  + CRC_ON,  8,  20,   78080, false },
+    { C1(125K, 4_5), SPREADING_7  + CRC_ON, 12,  20,   60672, false },
+    { C1(125K, 4_5), SPREADING_7  + CRC_OFF, 8,  20,   51456, false },
+    { BANDWIDTH_125K + ERROR_CODING_4_5 + IMPLICIT_MODE, SPREADING_6 + CRC_ON, 8, 20, 28288, false },
+};
+
+#define NUM_TOA_CASES (int)(sizeof(toa_cases) / sizeof(toa_cases[0]))
+
+static int check_time_on_air(void) {
+    int failures = 0;
+
+    sim_reset();
+    rfm95_initialize();
+
+    printf("%-6s %-6s %-4s %5s %5s %12s %12s %12s %5s\n",
+           "cfg1", "cfg2", "pre", "PL", "LDRO", "esperado_us", "rfm95_us", "modelo_us", "ok");
+
+    for (int i = 0; i < NUM_TOA_CASES; i++) {
+        const toa_case_t* c = &toa_cases[i];
+        rfm95_set_modem_config(c->config1, c->config2);
+        rfm95_set_preamble_length(c->preamble);
+
+        // O registrador real (não a sombra) deve refletir o LDRO automático
+        bool ldro = (sim_radio()->regs[REG_MODEM_CONFIG_3] & LOW_DATA_RATE_OPTIMIZE) != 0;
+        uint32_t toa = rfm95_time_on_air_us(c->size);
+        double model = sim_sx1276_time_on_air_ns(sim_radio(), c->size) / 1000.0;
+        bool ok = toa == c->expected_us && ldro == c->ldro && (uint32_t)(model + 0.5) == c->expected_us;
+        if (!ok) failures++;
+
+        printf("0x%02X   0x%02X   %-4u %5u %5s %12u %12u %12.1f %5s\n",
+               c->config1, c->config2, c->preamble, c->size, ldro ? "sim" : "nao",
+               (unsigned)c->expected_us, (unsigned)toa, model, ok ? "ok" : "FALHA");
+    }
+
+    // Duração real de uma transmissão: TS_FS + tempo no ar
+    rfm95_set_modem_config(C1(125K, 4_5), SPREADING_7 + CRC_ON);
+    rfm95_set_preamble_length(8);
+    uint8_t payload[20] = { 0 };
+    sim_stats_t start = sim_stats();
+    rfm95_transmit(payload, sizeof(payload));
+    sim_stats_t d = sim_stats_since(&start);
+    printf("\nrfm95_transmit(20 B, SF7): %.1f us no simulador, ToA %u us\n",
+           d.time_ns / 1000.0, (unsigned)rfm95_time_on_air_us(sizeof(payload)));
+
+    printf("tempo no ar: %d casos, %d falhas\n", NUM_TOA_CASES, failures);
+    return failures;
+}
+
+// ---------------------------------------------------------------------------
+// Orçamento: transmissões tão rápidas quanto possível durante 3 horas
+// ---------------------------------------------------------------------------
+
+#define MAX_TX_LOG 32768
+
+static uint64_t tx_start[MAX_TX_LOG];
+static uint64_t tx_end[MAX_TX_LOG];
+static int tx_count;
+
+static void on_tx(void* ctx, const uint8_t* data, uint8_t len, uint64_t start_ns, uint64_t end_ns) {
+    if (tx_count < MAX_TX_LOG) {
+        // Emissão de RF: o início do TX inclui o TS_FS do sintetizador
+        tx_start[tx_count] = end_ns - sim_sx1276_time_on_air_ns(sim_radio(), len);
+        tx_end[tx_count] = end_ns;
+        tx_count++;
+    }
+}
+
+/**
+ * @brief Maior tempo no ar somado dentro de qualquer janela de window_ns
+ */
+static uint64_t worst_window_ns(uint64_t window_ns) {
+    uint64_t worst = 0, sum = 0;
+    int first = 0;
+    for (int i = 0; i < tx_count; i++) {
+        sum += tx_end[i] - tx_start[i];
+        while (tx_start[i] - tx_start[first] >= window_ns) {
+            sum -= tx_end[first] - tx_start[first];
+            first++;
+        }
+        if (sum > worst) worst = sum;
+    }
+    return worst;
+}
+
+static int check_budget(uint8_t size, uint32_t duty_ppm, uint32_t burst_us, bool use_async) {
+    const uint64_t duration_ns = 3ull * 3600 * 1000000000;
+    const uint64_t hour_ns = 3600ull * 1000000000;
+    uint8_t payload[255];
+    memset(payload, 0xA5, sizeof(payload));
+
+    sim_reset();
+    tx_count = 0;
+    sim_sx1276_on_tx(sim_radio(), on_tx, NULL);
+    rfm95_initialize();
+    rfm95_set_airtime_budget(duty_ppm, burst_us);
+
+    uint32_t rejected = 0;
+    while (sim_now_ns() < duration_ns) {
+        if (use_async) {
+            // Tentativa a cada 100 ms; recusas do orçamento são contadas
+            rfm95_transmit_wait();
+            if (!rfm95_transmit_async(payload, size, NULL)) rejected++;
+            sleep_ms(100);
+        } else {
+            rfm95_transmit(payload, size);
+        }
+    }
+    rfm95_transmit_wait();
+
+    uint64_t total = 0;
+    for (int i = 0; i < tx_count; i++) total += tx_end[i] - tx_start[i];
+    uint64_t worst = worst_window_ns(hour_ns);
+    uint64_t toa_ns = (uint64_t)rfm95_time_on_air_us(size) * 1000;
+    uint64_t burst_ns = (uint64_t)burst_us * 1000;
+    uint64_t limit = hour_ns / 1000000 * duty_ppm + (toa_ns > burst_ns ? toa_ns : burst_ns);
+
+    bool ok = worst <= limit && tx_count < MAX_TX_LOG;
+    printf("%-6s %4u B %7.2f %% %9.1f ms %6d %8u %9.3f %% %12.1f ms %12.1f ms %5s\n",
+           use_async ? "async" : "bloq", size, duty_ppm / 1e4, burst_us / 1000.0, tx_count, rejected,
+           100.0 * total / sim_now_ns(), worst / 1e6, limit / 1e6, ok ? "ok" : "FALHA");
+    return ok ? 0 : 1;
+}
+
+int main(void) {
+    int failures = check_time_on_air();
+
+    printf("\n%-6s %6s %9s %12s %6s %8s %11s %15s %15s %5s\n",
+           "modo", "PL", "duty", "rajada", "tx", "recusas", "uso_medio", "pior_hora", "limite", "ok");
+    failures += check_budget(11, 10000, 41216, false);
+    failures += check_budget(11, 10000, 41216, true);
+    failures += check_budget(51, 10000, 10 * 102656, false);
+    failures += check_budget(255, 10000, 100000, false);    // Pacote maior que a rajada
+    failures += check_budget(20, 100000, 56576, true);
+
+    return failures ? 1 : 0;
+}
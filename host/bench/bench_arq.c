@@ -0,0 +1,382 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sim.h"
+#include "sim_sx1276.h"
+#include "rfm95.h"
+#include "frame.h"
+#include "arq.h"
+
+// ============================================================================
+// ENTREGA CONFIRMADA: SEM CONFIRMAÇÃO x PARE E ESPERE x JANELA SELETIVA
+// ============================================================================
+// A estação (driver rfm95 sobre o SX1276 simulado) transmite uma leitura a
+// cada PERIOD_MS. O gateway é modelado no callback de fim de transmissão: o
+// canal decide se o quadro chega e, nos modos com confirmação, o gateway
+// responde ACK_DELAY_MS depois com o mapa de recepção, que também passa pelo
+// canal e é agendado na antena da estação.
+//
+// Canal de Gilbert-Elliott no tempo: estados bom e ruim com durações
+// exponenciais e probabilidade de perda própria; os desvanecimentos duram
+// vários ciclos, como uma estação atrás de um obstáculo móvel.
+//
+// Modos:
+//   sem-ack   : transmite e esquece; a estação não sabe o que se perdeu
+//   pare-esp  : janela 1, até 4 tentativas seguidas, cada uma com a sua
+//               janela de recepção
+//   seletivo  : janela de 16 quadros, retransmissão só do que falta no mapa,
+//               espera dobrando de 1 a 8 períodos, até 8 tentativas
+//
+// A sequência começa perto de 0xFFFF para passar pela volta do contador.
+
+#define NUM_READINGS        3000
+#define PERIOD_MS           2000
+#define RX_WINDOW_MS        100
+#define ACK_DELAY_MS        20
+#define FIRST_SEQUENCE      (0x10000 - NUM_READINGS / 2)
+#define STATION_ID          7
+
+typedef enum { MODE_NONE, MODE_SAW, MODE_SELECTIVE, NUM_MODES } link_mode_t;
+
+static const char* mode_names[NUM_MODES] = { "sem-ack", "pare-esp", "seletivo" };
+
+static const arq_config_t mode_config[NUM_MODES] = {
+    [MODE_SAW] = { .window = 1, .max_tries = 4, .timeout_ms = 0, .backoff_max_ms = 0 },
+    [MODE_SELECTIVE] = { .window = 16, .max_tries = 8, .timeout_ms = PERIOD_MS, .backoff_max_ms = 8 * PERIOD_MS },
+};
+static const int mode_per_cycle[NUM_MODES] = { 1, 4, 4 };
+
+typedef struct {
+    const char* name;
+    double loss_good;
+    double loss_bad;
+    double mean_good_s;         // 0 = sempre no estado bom
+    double mean_bad_s;
+} channel_t;
+
+static const channel_t channels[] = {
+    { "ideal", 0.0, 0.0, 0, 0 },
+    { "uniforme 10%", 0.10, 0.0, 0, 0 },
+    { "uniforme 30%", 0.30, 0.0, 0, 0 },
+    { "rajadas ~15%", 0.02, 0.90, 120, 20 },
+};
+#define NUM_CHANNELS (int)(sizeof(channels) / sizeof(channels[0]))
+
+// ----------------------------------------------------------------------------
+// Canal
+// ----------------------------------------------------------------------------
+
+static uint32_t rng_state;
+
+static double rng_uniform(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (rng_state >> 8) / 16777216.0;
+}
+
+static const channel_t* channel;
+static bool channel_bad;
+static uint64_t channel_until_ns;
+
+static void channel_reset(const channel_t* c, uint32_t seed) {
+    channel = c;
+    rng_state = seed;
+    channel_bad = false;
+    channel_until_ns = c->mean_good_s > 0 ? (uint64_t)(-log(1 - rng_uniform()) * c->mean_good_s * 1e9) : SIM_NEVER;
+}
+
+static bool channel_delivers(uint64_t t_ns) {
+    while (t_ns >= channel_until_ns) {
+        channel_bad = !channel_bad;
+        double mean = channel_bad ? channel->mean_bad_s : channel->mean_good_s;
+        channel_until_ns += (uint64_t)(-log(1 - rng_uniform()) * mean * 1e9);
+    }
+    return rng_uniform() >= (channel_bad ? channel->loss_bad : channel->loss_good);
+}
+
+// ----------------------------------------------------------------------------
+// Gateway
+// ----------------------------------------------------------------------------
+
+typedef struct {
+    link_mode_t mode;
+    arq_receiver_t receiver;
+    bool have[NUM_READINGS];
+    uint64_t made_ns[NUM_READINGS];
+    uint32_t unique;
+    uint32_t duplicates;
+    uint32_t mark_errors;       // Mapa do gateway diverge do que chegou
+    uint64_t ack_air_ns;
+    uint32_t acks_sent;
+    double latency_s;           // Soma; média = latency_s / unique
+} gateway_t;
+
+static gateway_t gw;
+
+static int reading_index(uint16_t sequence) {
+    return (uint16_t)(sequence - FIRST_SEQUENCE);
+}
+
+static void gateway_rx(void* ctx, const uint8_t* data, uint8_t len, uint64_t start_ns, uint64_t end_ns) {
+    (void)ctx;
+    (void)start_ns;
+    uint16_t first;
+    if (frame_sequence_span(data, len, &first) != 1 || !channel_delivers(end_ns)) {
+        return;
+    }
+
+    int i = reading_index(first);
+    bool fresh = arq_receiver_mark(&gw.receiver, first, 1) == 1;
+    if (fresh == gw.have[i]) gw.mark_errors++;
+    if (gw.have[i]) {
+        gw.duplicates++;
+    } else {
+        gw.have[i] = true;
+        gw.unique++;
+        gw.latency_s += (end_ns - gw.made_ns[i]) / 1e9;
+    }
+
+    if (gw.mode != MODE_NONE) {
+        frame_ack_t ack;
+        uint8_t buf[FRAME_ACK_SIZE];
+        arq_receiver_ack(&gw.receiver, STATION_ID, &ack);
+        int n = frame_encode_ack(&ack, buf, sizeof(buf));
+        uint64_t toa = sim_sx1276_time_on_air_ns(sim_radio(), (uint8_t)n);
+        uint64_t at = end_ns + ACK_DELAY_MS * 1000000ull + toa;
+        gw.ack_air_ns += toa;
+        gw.acks_sent++;
+        if (channel_delivers(at)) {
+            sim_sx1276_schedule_rx(sim_radio(), at, buf, (uint8_t)n, -110, 5.0f, true);
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Estação
+// ----------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t confirmed;
+    uint32_t false_acks;        // Confirmados que o gateway não tem
+    uint32_t dropped;
+    uint32_t dropped_but_arrived;
+} station_t;
+
+static station_t st;
+
+static void on_result(void* ctx, const arq_frame_t* frame, bool delivered) {
+    (void)ctx;
+    int i = reading_index(frame->sequence);
+    if (delivered) {
+        st.confirmed++;
+        if (!gw.have[i]) st.false_acks++;
+    } else {
+        st.dropped++;
+        if (gw.have[i]) st.dropped_but_arrived++;
+    }
+}
+
+static uint32_t now_ms(void) {
+    return (uint32_t)(sim_now_ns() / 1000000);
+}
+
+// Janela de recepção após uma transmissão; true se chegou confirmação
+static bool receive_ack(arq_sender_t* arq) {
+    for (int t = 0; t < RX_WINDOW_MS; t++) {
+        uint8_t data[16];
+        frame_ack_t ack;
+        int n = rfm95_receive(data, sizeof(data));
+        if (n > 0 && frame_decode_ack(data, n, &ack) && ack.station_id == STATION_ID) {
+            arq_sender_ack(arq, &ack, now_ms());
+            rfm95_set_idle_mode();
+            return true;
+        }
+        sleep_ms(1);
+    }
+    rfm95_set_idle_mode();
+    return false;
+}
+
+static void service_link(arq_sender_t* arq, int max_per_cycle) {
+    for (int i = 0; i < max_per_cycle; i++) {
+        const arq_frame_t* f = arq_sender_due(arq, now_ms());
+        if (f == NULL) break;
+        rfm95_transmit(f->data, f->length);
+        arq_sender_sent(arq, f, now_ms());
+        receive_ack(arq);
+    }
+}
+
+typedef struct {
+    double delivered;           // Fração das leituras no gateway
+    double known_lost;          // Fração que a estação sabe que perdeu
+    double tx_ms;               // Tempo no ar da estação por leitura entregue
+    double rx_ms;               // Rádio da estação em RX por leitura entregue
+    double ack_ms;              // Tempo no ar do gateway por leitura entregue
+    double goodput;             // Bytes de leitura entregues por segundo de canal ocupado
+    double latency_s;
+    uint32_t retransmissions;
+    uint32_t duplicates;
+    bool ok;
+} result_t;
+
+static result_t run(const channel_t* c, link_mode_t mode) {
+    static arq_sender_t arq;
+    memset(&gw, 0, sizeof(gw));
+    memset(&st, 0, sizeof(st));
+    gw.mode = mode;
+    arq_receiver_init(&gw.receiver);
+    channel_reset(c, 2024);
+
+    sim_reset();
+    sim_sx1276_on_tx(sim_radio(), gateway_rx, NULL);
+    rfm95_initialize();
+    arq_sender_init(&arq, &mode_config[mode], on_result, NULL);
+
+    uint32_t rejected = 0;
+    uint8_t frame[FRAME_READING_MAX_SIZE];
+    for (int k = 0; k < NUM_READINGS; k++) {
+        uint64_t cycle_ns = (uint64_t)k * PERIOD_MS * 1000000ull;
+        if (sim_now_ns() < cycle_ns) sim_advance_ns(cycle_ns - sim_now_ns());
+
+        frame_reading_t r = {
+            .station_id = STATION_ID, .sequence = (uint16_t)(FIRST_SEQUENCE + k),
+            .fields = FRAME_FIELDS_ALL, .temperature = 2350, .humidity = 5500, .pressure = 94300,
+        };
+        int len = frame_encode(&r, frame, sizeof(frame));
+        gw.made_ns[k] = sim_now_ns();
+
+        if (mode == MODE_NONE) {
+            rfm95_transmit(frame, (uint8_t)len);
+            continue;
+        }
+        if (!arq_sender_push(&arq, frame, (uint8_t)len, now_ms())) {
+            rejected++;
+        }
+        service_link(&arq, mode_per_cycle[mode]);
+    }
+    rfm95_transmit_wait();
+
+    rfm95_mode_times_t times;
+    rfm95_get_mode_times(&times);
+    arq_stats_t s;
+    arq_sender_get_stats(&arq, &s);
+
+    result_t res = { 0 };
+    double n = gw.unique ? gw.unique : 1;
+    res.delivered = (double)gw.unique / NUM_READINGS;
+    res.known_lost = (double)(st.dropped + rejected) / NUM_READINGS;
+    res.tx_ms = times.tx_us / 1000.0 / n;
+    res.rx_ms = times.rx_us / 1000.0 / n;
+    res.ack_ms = gw.ack_air_ns / 1e6 / n;
+    res.goodput = gw.unique * 6.0 / ((times.tx_us + gw.ack_air_ns / 1000.0) / 1e6);
+    res.latency_s = gw.latency_s / n;
+    res.retransmissions = s.retransmissions;
+    res.duplicates = gw.duplicates;
+
+    // Invariantes: o mapa do gateway acompanha o que chegou, nada é dado como
+    // entregue sem ter chegado e, com confirmação, toda leitura termina
+    // confirmada, descartada (ciente) ou ainda na janela
+    res.ok = gw.mark_errors == 0 && st.false_acks == 0;
+    if (mode != MODE_NONE) {
+        res.ok = res.ok && st.confirmed + st.dropped + rejected + (uint32_t)arq_sender_pending(&arq) == NUM_READINGS &&
+                 gw.unique >= st.confirmed;
+    }
+    if (c->loss_good == 0 && c->mean_good_s == 0) {
+        res.ok = res.ok && gw.unique == NUM_READINGS && s.retransmissions == 0;
+    }
+    return res;
+}
+
+/**
+ * @brief Mapa do gateway: fora de ordem, duplicatas, volta do contador e reinício
+ */
+static bool check_receiver(void) {
+    arq_receiver_t r;
+    arq_receiver_init(&r);
+    bool ok = arq_receiver_mark(&r, 0xFFFE, 1) == 1;
+    ok = ok && arq_receiver_mark(&r, 0x0001, 1) == 1;        // 0xFFFF e 0x0000 faltam
+    ok = ok && arq_receiver_mark(&r, 0xFFFF, 1) == 1 && arq_receiver_mark(&r, 0xFFFF, 1) == 0;
+    ok = ok && r.sequence == 0x0001 && r.bitmap == 0xD;       // 0001, FFFF e FFFE; falta 0000
+    ok = ok && arq_receiver_mark(&r, 0x0002, 4) == 4 && r.sequence == 0x0005;    // Lote de 4
+    ok = ok && arq_receiver_mark(&r, 0x0000, 1) == 1 && arq_receiver_mark(&r, 0x0003, 2) == 0;
+    ok = ok && arq_receiver_mark(&r, (uint16_t)(0x0005 - FRAME_ACK_SPAN), 1) == 1 &&    // Reinício
+         r.sequence == (uint16_t)(0x0005 - FRAME_ACK_SPAN) && r.bitmap == 1;
+
+    frame_ack_t a = { STATION_ID, 0x1234, 0x80000001u }, b;
+    uint8_t buf[FRAME_ACK_SIZE];
+    ok = ok && frame_encode_ack(&a, buf, sizeof(buf)) == FRAME_ACK_SIZE &&
+         frame_decode_ack(buf, sizeof(buf), &b) && b.sequence == a.sequence && b.bitmap == a.bitmap &&
+         !frame_decode_ack(buf, sizeof(buf) - 1, &b);
+    printf("Mapa de recepção e quadro de confirmação: %s\n", ok ? "OK" : "FALHA");
+    return ok;
+}
+
+/**
+ * @brief Espera sem limite (backoff_max_ms = 0) com muitas tentativas
+ *
+ * A espera dobra até saturar; nunca volta a encolher nem chega a 0.
+ */
+static bool check_backoff(void) {
+    static const arq_config_t config = { .window = 1, .max_tries = 255, .timeout_ms = 1000, .backoff_max_ms = 0 };
+    arq_sender_t arq;
+    arq_sender_init(&arq, &config, NULL, NULL);
+
+    frame_reading_t r = { .station_id = STATION_ID, .sequence = 1, .fields = FRAME_FIELDS_ALL };
+    uint8_t frame[FRAME_READING_MAX_SIZE];
+    int len = frame_encode(&r, frame, sizeof(frame));
+    uint32_t now = 0;
+    bool ok = arq_sender_push(&arq, frame, (uint8_t)len, now);
+
+    uint32_t last_wait = 0;
+    for (int i = 0; ok && i < 100; i++) {
+        const arq_frame_t* f = arq_sender_due(&arq, now);
+        ok = f != NULL;
+        if (!ok) break;
+        arq_sender_sent(&arq, f, now);
+        uint32_t wait = f->due_ms - now;
+        ok = wait >= last_wait && wait > 0 && wait <= (uint32_t)INT32_MAX;
+        last_wait = wait;
+        now = f->due_ms;
+    }
+    printf("Espera sem limite, 100 tentativas: satura em %u ms: %s\n\n", (unsigned)last_wait, ok ? "OK" : "FALHA");
+    return ok;
+}
+
+int main(void) {
+    bool ok = check_receiver();
+    ok &= check_backoff();
+
+    sim_reset();
+    rfm95_initialize();
+    printf("%d leituras a cada %d ms, quadro de %d B (%.1f ms no ar), confirmação de %d B (%.1f ms)\n",
+           NUM_READINGS, PERIOD_MS, FRAME_READING_MAX_SIZE, rfm95_time_on_air_us(FRAME_READING_MAX_SIZE) / 1000.0,
+           FRAME_ACK_SIZE, rfm95_time_on_air_us(FRAME_ACK_SIZE) / 1000.0);
+    printf("janela de recepção %d ms após cada transmissão\n\n", RX_WINDOW_MS);
+    printf("%-14s %-9s %9s %8s %9s %9s %9s %9s %9s %7s %6s\n",
+           "canal", "modo", "entregue%", "ciente%", "TX_ms/e", "RX_ms/e", "ACK_ms/e",
+           "goodput", "atraso_s", "retx", "dup");
+
+    for (int c = 0; c < NUM_CHANNELS; c++) {
+        result_t r[NUM_MODES];
+        for (int m = 0; m < NUM_MODES; m++) {
+            r[m] = run(&channels[c], (link_mode_t)m);
+            printf("%-14s %-9s %9.1f %8.1f %9.1f %9.1f %9.1f %9.1f %9.2f %7u %6u %s\n",
+                   m == 0 ? channels[c].name : "", mode_names[m], 100 * r[m].delivered, 100 * r[m].known_lost,
+                   r[m].tx_ms, r[m].rx_ms, r[m].ack_ms, r[m].goodput, r[m].latency_s,
+                   r[m].retransmissions, r[m].duplicates, r[m].ok ? "" : "FALHA");
+            ok = ok && r[m].ok;
+        }
+        // Com perdas, a janela seletiva entrega pelo menos o que o modo sem
+        // confirmação entrega
+        if (r[MODE_SELECTIVE].delivered < r[MODE_NONE].delivered) {
+            printf("  seletivo entregou menos que sem-ack: FALHA\n");
+            ok = false;
+        }
+    }
+    printf("\ngoodput: bytes de leitura entregues por segundo de canal ocupado (TX da estação + ACK)\n");
+    printf("ciente: leituras que a estação sabe que não foram entregues\n");
+    printf("%s\n", ok ? "OK" : "FALHA");
+    return ok ? 0 : 1;
+}
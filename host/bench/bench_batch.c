@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "sim_sx1276.h"
+#include "rfm95.h"
+#include "rfm95_definitions.h"
+#include "frame.h"
+
+// ============================================================================
+// LOTES DE LEITURAS: BYTES E TEMPO NO AR POR AMOSTRA
+// ============================================================================
+// 1. Tabela analítica: tamanho do quadro, tempo no ar e despertares do rádio
+//    por amostra em função do tamanho do lote (leituras a cada 2 s)
+// 2. Uma hora simulada com lotes reais: o gateway (callback de TX do modelo)
+//    decodifica cada pacote e confere valores, sequência e instante
+//    reconstruído de cada leitura
+
+#define SAMPLE_PERIOD_MS    2000
+
+static const int batch_sizes[] = { 1, 2, 4, 8, 12, 16, 20, 27 };
+#define NUM_BATCH_SIZES (int)(sizeof(batch_sizes) / sizeof(batch_sizes[0]))
+
+static int frame_size(int n) {
+    return n == 1 ? FRAME_READING_MAX_SIZE : FRAME_HEADER_SIZE + n * FRAME_BATCH_SAMPLE_MAX_SIZE;
+}
+
+static void set_sf(uint8_t spreading) {
+    rfm95_set_modem_config(BANDWIDTH_125K + ERROR_CODING_4_5 + EXPLICIT_MODE, spreading + CRC_ON);
+}
+
+static void bench_table(void) {
+    static const uint8_t sfs[] = { SPREADING_7, SPREADING_10, SPREADING_12 };
+
+    sim_reset();
+    rfm95_initialize();
+
+    printf("%-5s %7s %8s", "lote", "bytes", "B/amostra");
+    for (int s = 0; s < 3; s++) printf("   SF%-2d ms/amostra", sfs[s] >> 4);
+    printf(" %10s\n", "tx/hora");
+
+    for (int i = 0; i < NUM_BATCH_SIZES; i++) {
+        int n = batch_sizes[i];
+        int bytes = frame_size(n);
+        printf("%-5d %7d %8.2f", n, bytes, (double)bytes / n);
+        for (int s = 0; s < 3; s++) {
+            set_sf(sfs[s]);
+            printf(" %18.2f", rfm95_time_on_air_us((uint8_t)bytes) / 1000.0 / n);
+        }
+        printf(" %10.0f\n", 3600.0 * 1000 / SAMPLE_PERIOD_MS / n);
+    }
+    set_sf(SPREADING_7);
+}
+
+// ---------------------------------------------------------------------------
+// Uma hora simulada
+// ---------------------------------------------------------------------------
+
+#define MAX_SAMPLES 4096
+
+// Leituras geradas pela estação, indexadas pela sequência
+static frame_reading_t sent[MAX_SAMPLES];
+static uint64_t sent_ns[MAX_SAMPLES];
+static int num_sent;
+
+static int received;
+static int errors;
+static uint16_t next_sequence;
+static int64_t worst_time_error_ns;
+
+static void gateway_rx(void* ctx, const uint8_t* data, uint8_t len, uint64_t start_ns, uint64_t end_ns) {
+    frame_reading_t r[FRAME_BATCH_MAX_SAMPLES];
+    uint32_t age_ms[FRAME_BATCH_MAX_SAMPLES];
+    int n;
+
+    if (len > 0 && (data[0] & 0x0F) == FRAME_TYPE_READING) {
+        n = frame_decode(data, len, &r[0]) ? 1 : -1;
+        age_ms[0] = 0;
+    } else {
+        n = frame_decode_batch(data, len, r, age_ms, FRAME_BATCH_MAX_SAMPLES);
+    }
+    if (n < 0) {
+        errors++;
+        return;
+    }
+
+    // Instante do fechamento do quadro: fim da recepção menos o tempo no ar
+    uint64_t sent_at = end_ns - sim_sx1276_time_on_air_ns(sim_radio(), len);
+    for (int i = 0; i < n; i++) {
+        const frame_reading_t* e = &sent[r[i].sequence % MAX_SAMPLES];
+        bool ok = r[i].sequence == next_sequence && r[i].fields == e->fields;
+        if (e->fields & FRAME_FIELD_TEMPERATURE) ok = ok && r[i].temperature == e->temperature;
+        if (e->fields & FRAME_FIELD_HUMIDITY) ok = ok && r[i].humidity == e->humidity;
+        ok = ok && labs((long)r[i].pressure - (long)e->pressure) <= 5;
+        if (!ok) errors++;
+        next_sequence = (uint16_t)(r[i].sequence + 1);
+
+        int64_t err = (int64_t)(sent_at - (uint64_t)age_ms[i] * 1000000) - (int64_t)sent_ns[r[i].sequence % MAX_SAMPLES];
+        if (llabs(err) > worst_time_error_ns) worst_time_error_ns = llabs(err);
+        received++;
+    }
+}
+
+static void bench_hour(int batch_samples, uint32_t max_age_ms) {
+    static frame_batch_t batch;
+    uint8_t buffer[FRAME_READING_MAX_SIZE];
+
+    sim_reset();
+    sim_sx1276_on_tx(sim_radio(), gateway_rx, NULL);
+    rfm95_initialize();
+    num_sent = received = errors = 0;
+    next_sequence = 0;
+    worst_time_error_ns = 0;
+    batch.count = 0;
+
+    srand(1);
+    int16_t temperature = 2350;
+    uint16_t humidity = 5500;
+    uint32_t pressure = 94300;
+
+    sim_stats_t start = sim_stats();
+    uint64_t tx_ns_before = sim_radio()->mode_ns[MODE_TX];
+    uint32_t packets_before = sim_radio()->tx_packets;
+
+    while (sim_now_ns() < 3600ull * 1000000000) {
+        // Passeio aleatório lento, como nas leituras reais
+        temperature += rand() % 5 - 2;
+        humidity += rand() % 7 - 3;
+        pressure += rand() % 11 - 5;
+
+        frame_reading_t r = {
+            .station_id = 1, .sequence = (uint16_t)num_sent,
+            .fields = (num_sent % 97 == 50) ? FRAME_FIELD_PRESSURE : FRAME_FIELDS_ALL,
+            .temperature = temperature, .humidity = humidity, .pressure = pressure,
+        };
+        sent[num_sent % MAX_SAMPLES] = r;
+        sent_ns[num_sent % MAX_SAMPLES] = sim_now_ns();
+        num_sent++;
+
+        const uint8_t* payload = buffer;
+        int length;
+        uint32_t now = to_ms_since_boot(get_absolute_time());
+        if (batch_samples > 1) {
+            if (batch.count == 0) frame_batch_init(&batch, 1);
+            frame_batch_add(&batch, &r, now);
+            if (batch.count < batch_samples && now - batch.time_ms[0] < max_age_ms && !frame_batch_full(&batch)) {
+                sleep_ms(SAMPLE_PERIOD_MS);
+                continue;
+            }
+            length = frame_batch_finish(&batch, now);
+            batch.count = 0;
+            payload = batch.data;
+        } else {
+            length = frame_encode(&r, buffer, sizeof(buffer));
+        }
+
+        rfm95_transmit_wait();
+        rfm95_transmit_async(payload, (uint8_t)length, NULL);
+        sleep_ms(SAMPLE_PERIOD_MS);
+    }
+    rfm95_transmit_wait();
+    rfm95_set_idle_mode();
+
+    sim_stats_t d = sim_stats_since(&start);
+    uint32_t packets = sim_radio()->tx_packets - packets_before;
+    double tx_ms = (sim_radio()->mode_ns[MODE_TX] - tx_ns_before) / 1e6;
+    printf("%-5d %7u %8u %8d %10.1f %12.3f %10u %8.1f %6d\n",
+           batch_samples, packets, d.spi_bytes, received, tx_ms, tx_ms / received,
+           d.spi_transactions, worst_time_error_ns / 1e6, errors + (num_sent - received > batch_samples ? 1 : 0));
+}
+
+int main(void) {
+    bench_table();
+
+    printf("\n1 hora simulada, leitura a cada %d ms, SF7/125 kHz, idade maxima 60 s\n", SAMPLE_PERIOD_MS);
+    printf("%-5s %7s %8s %8s %10s %12s %10s %8s %6s\n",
+           "lote", "pacotes", "spi_B", "leituras", "tx_ms", "tx_ms/leit", "spi_tx", "erro_ms", "erros");
+    for (int i = 0; i < NUM_BATCH_SIZES; i++) {
+        bench_hour(batch_sizes[i], 60000);
+    }
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "bmp280.h"
+
+// ============================================================================
+// COMPENSAÇÃO DO BMP280: PAR DE CHAMADAS x UMA PASSADA x LOTE
+// ============================================================================
+// Tempo de CPU do host (relógio real) por leitura para:
+//   par       bmp280_convert_temp + bmp280_convert_pressure (t_fine 2x)
+//   32 bits   bmp280_compensate
+//   64 bits   bmp280_compensate64 (resolução de 1/256 Pa)
+//   lote      bmp280_compensate_batch sobre vetores
+//
+// Calibração e leitura de exemplo do datasheet (seção 3.12); as leituras do
+// teste varrem a faixa bruta de 20 bits em torno do exemplo. O erro de cada
+// variante é medido contra a fórmula em double do datasheet.
+
+#define NUM_SAMPLES     (1 << 20)
+#define REPEATS         5
+
+static struct bmp280_calib_param params = {
+    .dig_t1 = 27504, .dig_t2 = 26435, .dig_t3 = -1000,
+    .dig_p1 = 36477, .dig_p2 = -10685, .dig_p3 = 3024, .dig_p4 = 2855,
+    .dig_p5 = 140, .dig_p6 = -7, .dig_p7 = 15500, .dig_p8 = -14600, .dig_p9 = 6000,
+};
+
+static int32_t raw_t[NUM_SAMPLES], raw_p[NUM_SAMPLES];
+static int32_t temp_pair[NUM_SAMPLES], temp_batch[NUM_SAMPLES];
+static uint32_t press_pair[NUM_SAMPLES], press_batch[NUM_SAMPLES];
+static bmp280_reading_t out32[NUM_SAMPLES], out64[NUM_SAMPLES];
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+ * @brief Fórmula em ponto flutuante do datasheet (referência)
+ */
+static double reference_pressure(int32_t adc_t, int32_t adc_p) {
+    const struct bmp280_calib_param* c = &params;
+    double var1 = (adc_t / 16384.0 - c->dig_t1 / 1024.0) * c->dig_t2;
+    double var2 = (adc_t / 131072.0 - c->dig_t1 / 8192.0) * (adc_t / 131072.0 - c->dig_t1 / 8192.0) * c->dig_t3;
+    double t_fine = var1 + var2;
+
+    var1 = t_fine / 2.0 - 64000.0;
+    var2 = var1 * var1 * c->dig_p6 / 32768.0;
+    var2 = var2 + var1 * c->dig_p5 * 2.0;
+    var2 = var2 / 4.0 + c->dig_p4 * 65536.0;
+    var1 = (c->dig_p3 * var1 * var1 / 524288.0 + c->dig_p2 * var1) / 524288.0;
+    var1 = (1.0 + var1 / 32768.0) * c->dig_p1;
+    double p = 1048576.0 - adc_p;
+    p = (p - var2 / 4096.0) * 6250.0 / var1;
+    var1 = c->dig_p9 * p * p / 2147483648.0;
+    var2 = p * c->dig_p8 / 32768.0;
+    return p + (var1 + var2 + c->dig_p7) / 16.0;
+}
+
+static bool check_datasheet_example(void) {
+    bmp280_reading_t r32, r64;
+    bmp280_compensate(519888, 415148, &params, &r32);
+    bmp280_compensate64(519888, 415148, &params, &r64);
+    int32_t t_pair = bmp280_convert_temp(519888, &params);
+    int32_t p_pair = bmp280_convert_pressure(415148, 519888, &params);
+
+    // O datasheet dá 25.08 C e 100653.27 Pa (fórmula em double); a versão de
+    // 32 bits tem erro de alguns Pa e só precisa coincidir com o par
+    printf("Exemplo do datasheet (raw_t 519888, raw_p 415148): 25.08 C, 100653.27 Pa\n");
+    printf("  par      %d.%02d C  %d Pa\n", (int)t_pair / 100, (int)t_pair % 100, (int)p_pair);
+    printf("  32 bits  %d.%02d C  %u Pa\n", (int)r32.temperature / 100, (int)r32.temperature % 100, r32.pressure);
+    printf("  64 bits  %d.%02d C  %.2f Pa (q8 %u)\n\n", (int)r64.temperature / 100, (int)r64.temperature % 100,
+           r64.pressure_q8 / 256.0, r64.pressure_q8);
+    return t_pair == 2508 && r32.temperature == 2508 && r64.temperature == 2508 &&
+           r32.pressure == (uint32_t)p_pair && fabs(r64.pressure_q8 / 256.0 - 100653.27) < 0.1;
+}
+
+static void generate_samples(void) {
+    uint32_t state = 12345;
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        state = state * 1664525u + 1013904223u;
+        raw_t[i] = 420000 + (int32_t)((state >> 8) % 200000);      // ~ -20 a 60 C
+        state = state * 1664525u + 1013904223u;
+        raw_p[i] = 250000 + (int32_t)((state >> 8) % 250000);      // ~ 68 a 118 kPa
+    }
+}
+
+#define TIME_BEST(best, body)                                       \
+    do {                                                            \
+        best = 1e30;                                                \
+        for (int rep_ = 0; rep_ < REPEATS; rep_++) {                \
+            uint64_t t0_ = now_ns();                                \
+            body;                                                   \
+            double ns_ = (double)(now_ns() - t0_) / NUM_SAMPLES;    \
+            if (ns_ < best) best = ns_;                             \
+        }                                                           \
+    } while (0)
+
+int main(void) {
+    bool ok = check_datasheet_example();
+    generate_samples();
+
+    double t_pair, t_32, t_64, t_batch;
+    TIME_BEST(t_pair, for (int i = 0; i < NUM_SAMPLES; i++) {
+        temp_pair[i] = bmp280_convert_temp(raw_t[i], &params);
+        press_pair[i] = bmp280_convert_pressure(raw_p[i], raw_t[i], &params);
+    });
+    TIME_BEST(t_32, for (int i = 0; i < NUM_SAMPLES; i++) {
+        bmp280_compensate(raw_t[i], raw_p[i], &params, &out32[i]);
+    });
+    TIME_BEST(t_64, for (int i = 0; i < NUM_SAMPLES; i++) {
+        bmp280_compensate64(raw_t[i], raw_p[i], &params, &out64[i]);
+    });
+    TIME_BEST(t_batch, bmp280_compensate_batch(raw_t, raw_p, temp_batch, press_batch, NUM_SAMPLES, &params));
+
+    // Igualdade com o par de chamadas e erro contra a referência em double
+    int mismatch_32 = 0, mismatch_batch = 0;
+    double err_32 = 0, err_64 = 0, err_64_q8 = 0;
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        if (out32[i].temperature != temp_pair[i] || out32[i].pressure != press_pair[i]) mismatch_32++;
+        if (temp_batch[i] != temp_pair[i] || press_batch[i] != press_pair[i]) mismatch_batch++;
+
+        double ref = reference_pressure(raw_t[i], raw_p[i]);
+        err_32 = fmax(err_32, fabs(out32[i].pressure - ref));
+        err_64 = fmax(err_64, fabs(out64[i].pressure - ref));
+        err_64_q8 = fmax(err_64_q8, fabs(out64[i].pressure_q8 / 256.0 - ref));
+    }
+    ok = ok && mismatch_32 == 0 && mismatch_batch == 0;
+
+    printf("Compensação de %d leituras (melhor de %d)\n", NUM_SAMPLES, REPEATS);
+    printf("  %-10s %10s %12s %22s\n", "variante", "ns/leitura", "x par", "erro máx vs double (Pa)");
+    printf("  %-10s %10.2f %12.2f %22.3f\n", "par", t_pair, 1.0, err_32);
+    printf("  %-10s %10.2f %12.2f %22.3f\n", "32 bits", t_32, t_pair / t_32, err_32);
+    printf("  %-10s %10.2f %12.2f %22.3f  (q8: %.3f)\n", "64 bits", t_64, t_pair / t_64, err_64, err_64_q8);
+    printf("  %-10s %10.2f %12.2f %22.3f\n", "lote", t_batch, t_pair / t_batch, err_32);
+    printf("  divergências do par: 32 bits %d, lote %d  -> %s\n",
+           mismatch_32, mismatch_batch, ok ? "OK" : "FALHA");
+    return ok ? 0 : 1;
+}
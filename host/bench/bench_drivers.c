@@ -0,0 +1,212 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "sim.h"
+#include "sim_sx1276.h"
+#include "rfm95.h"
+#include "aht20.h"
+#include "bmp280.h"
+
+// ============================================================================
+// CUSTO DAS CHAMADAS DE DRIVER NO SIMULADOR
+// ============================================================================
+// Cada linha mostra a diferença dos contadores do simulador antes e depois da
+// chamada: tempo virtual total, tempo em sleep, tempo de barramento e número
+// de transações/bytes em SPI e I2C.
+
+#define I2C_PORT_SENSORS i2c0
+
+bool setup();
+void loop();
+
+extern int16_t temperatura;
+extern int32_t pressao;
+extern uint16_t umidade;
+
+#define MEASURE(label, call)                            \
+    do {                                                \
+        sim_stats_t start_ = sim_stats();               \
+        call;                                           \
+        sim_stats_t delta_ = sim_stats_since(&start_);  \
+        sim_print_stats(label, &delta_);                \
+    } while (0)
+
+static void bench_drivers(void) {
+    uint8_t payload[40];
+    memset(payload, 'x', sizeof(payload));
+
+    sim_reset();
+    sim_print_stats_header();
+
+    MEASURE("rfm95_initialize", rfm95_initialize());
+    MEASURE("rfm95_set_tx_power", rfm95_set_tx_power(17));
+    MEASURE("rfm95_set_frequency", rfm95_set_frequency(868100000));
+    rfm95_set_frequency(FREQUENCY_HZ);
+    MEASURE("rfm95_transmit(40 B)", rfm95_transmit(payload, sizeof(payload)));
+
+    // Recepção: primeiro sem pacote (polling), depois com um pacote na FIFO
+    uint8_t rx[64];
+    int n;
+    MEASURE("rfm95_receive(vazio)", n = rfm95_receive(rx, sizeof(rx)));
+    sim_sx1276_schedule_rx(sim_radio(), sim_now_ns() + 1000, payload, sizeof(payload), -80, 7.5f, true);
+    sleep_us(2);
+    MEASURE("rfm95_receive(40 B)", n = rfm95_receive(rx, sizeof(rx)));
+    if (n != (int)sizeof(payload) || memcmp(rx, payload, sizeof(payload)) != 0) {
+        printf("rfm95_receive: payload incorreto (%d bytes)\n", n);
+    }
+    rfm95_set_idle_mode();
+
+    setup_I2C_aht20(I2C_PORT_SENSORS, 0, 1, 400 * 1000);
+    MEASURE("aht20_init", aht20_init(I2C_PORT_SENSORS));
+
+    AHT20_Data aht;
+    MEASURE("aht20_read", aht20_read(I2C_PORT_SENSORS, &aht));
+    MEASURE("aht20_start_measurement", aht20_start_measurement(I2C_PORT_SENSORS));
+    MEASURE("aht20_poll(convertendo)", aht20_poll(I2C_PORT_SENSORS, &aht));
+    MEASURE("aht20_collect", aht20_collect(I2C_PORT_SENSORS, &aht));
+
+    bmp280_init(I2C_PORT_SENSORS);
+    struct bmp280_calib_param params;
+    MEASURE("bmp280_get_calib_params", bmp280_get_calib_params(I2C_PORT_SENSORS, &params));
+
+    int32_t raw_t, raw_p;
+    MEASURE("bmp280_read_raw", bmp280_read_raw(I2C_PORT_SENSORS, &raw_t, &raw_p));
+    MEASURE("bmp280_set_profile", bmp280_set_profile(I2C_PORT_SENSORS, &bmp280_profile_standard));
+    MEASURE("bmp280_measure(padrao)", bmp280_measure(I2C_PORT_SENSORS, &raw_t, &raw_p));
+
+    printf("\nToA(40 B) no modelo: %.3f ms\n", sim_sx1276_time_on_air_ns(sim_radio(), 40) / 1e6);
+}
+
+static void bench_main_loop(void) {
+    sim_reset();
+    sim_env_t env = { .temperature_c = 23.5, .humidity_rh = 55.0, .pressure_pa = 94300.0 };
+    sim_env_set(&env);
+
+    printf("\n");
+    sim_print_stats_header();
+    bool ok;
+    MEASURE("setup()", ok = setup());
+    if (!ok) {
+        printf("setup() falhou\n");
+        return;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        char label[32];
+        snprintf(label, sizeof(label), "loop() #%d", i + 1);
+        MEASURE(label, loop());
+        sleep_ms(2000);
+    }
+
+    printf("\nambiente: %.2f C %.2f %% %.0f Pa -> temperatura=%.2f pressao=%d kPa umidade=%.2f\n",
+           env.temperature_c, env.humidity_rh, env.pressure_pa, temperatura / 100.0, (int)pressao, umidade / 100.0);
+    printf("pacotes transmitidos: %u\n", sim_radio()->tx_packets);
+}
+
+/**
+ * @brief Um ciclo de amostragem com o AHT20 bloqueante ou em duas fases
+ *
+ * O ciclo lê os dois sensores e, se payload_size > 0, transmite um pacote
+ * com rfm95_transmit() (carga da FIFO + tempo no ar). Em duas fases, a
+ * leitura do BMP280 e a transmissão acontecem durante a conversão do AHT20.
+ */
+static sim_stats_t sample_cycle(bool split, int payload_size) {
+    static const uint8_t payload[255];
+    AHT20_Data aht;
+    int32_t raw_t, raw_p;
+
+    sim_stats_t start = sim_stats();
+    if (split) {
+        aht20_start_measurement(I2C_PORT_SENSORS);
+        bmp280_read_raw(I2C_PORT_SENSORS, &raw_t, &raw_p);
+        if (payload_size) rfm95_transmit(payload, payload_size);
+        aht20_collect(I2C_PORT_SENSORS, &aht);
+    } else {
+        aht20_read(I2C_PORT_SENSORS, &aht);
+        bmp280_read_raw(I2C_PORT_SENSORS, &raw_t, &raw_p);
+        if (payload_size) rfm95_transmit(payload, payload_size);
+    }
+    return sim_stats_since(&start);
+}
+
+static void bench_overlap(void) {
+    static const int sizes[] = { 0, 11, 40, 80, 120 };
+
+    sim_reset();
+    rfm95_initialize();
+    setup_I2C_aht20(I2C_PORT_SENSORS, 0, 1, 400 * 1000);
+    aht20_init(I2C_PORT_SENSORS);
+    bmp280_init(I2C_PORT_SENSORS);
+
+    printf("\nCiclo de amostragem: AHT20 bloqueante x duas fases (SF7, 125 kHz)\n");
+    printf("%-10s %9s %15s %15s %12s %12s\n",
+           "payload", "ToA_ms", "bloqueante_ms", "duas_fases_ms", "i2c_tx_bloq", "i2c_tx_2f");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        int n = sizes[i];
+        double toa = n ? sim_sx1276_time_on_air_ns(sim_radio(), n) / 1e6 : 0.0;
+        sim_stats_t b = sample_cycle(false, n);
+        sim_stats_t d = sample_cycle(true, n);
+
+        char label[16];
+        snprintf(label, sizeof(label), n ? "%d B" : "sem radio", n);
+        printf("%-10s %9.2f %15.2f %15.2f %12u %12u\n", label, toa,
+               b.time_ns / 1e6, d.time_ns / 1e6, b.i2c_transactions, d.i2c_transactions);
+    }
+}
+
+/**
+ * @brief Latência de bmp280_measure() e conversões por amostra em cada perfil
+ *
+ * No modo normal o sensor converte sem parar e a leitura devolve o último
+ * resultado, com idade de até standby + conversão; no modo forçado há uma
+ * conversão por leitura, feita na hora.
+ */
+static void bench_bmp280_profiles(void) {
+    static const uint32_t standby_us[] = { 500, 62500, 125000, 250000, 500000, 1000000, 2000000, 4000000 };
+    static const struct {
+        const char* name;
+        const bmp280_profile_t* profile;
+    } profiles[] = {
+        { "ultra_low_power", &bmp280_profile_ultra_low_power },
+        { "standard",        &bmp280_profile_standard },
+        { "high_resolution", &bmp280_profile_high_resolution },
+        { "normal (antigo)", &bmp280_profile_normal },
+    };
+
+    sim_reset();
+    setup_I2C_bmp280(I2C_PORT_SENSORS, 0, 1, 400 * 1000);
+    bmp280_init(I2C_PORT_SENSORS);
+
+    printf("\nPerfis do BMP280 (amostra a cada 2 s)\n");
+    printf("%-16s %8s %8s %10s %12s %8s %14s %12s\n",
+           "perfil", "osrs_t", "osrs_p", "t_max_us", "measure_us", "i2c_tx", "conv/amostra", "idade_max_ms");
+    for (size_t i = 0; i < sizeof(profiles) / sizeof(profiles[0]); i++) {
+        const bmp280_profile_t* p = profiles[i].profile;
+        uint32_t t_max = bmp280_conversion_time_us(p);
+        bmp280_set_profile(I2C_PORT_SENSORS, p);
+        sleep_ms(100);
+
+        int32_t raw_t, raw_p;
+        sim_stats_t start = sim_stats();
+        bool ok = bmp280_measure(I2C_PORT_SENSORS, &raw_t, &raw_p);
+        sim_stats_t d = sim_stats_since(&start);
+
+        double conversions = 1.0, age_ms = 0.0;
+        if (p->mode == BMP280_MODE_NORMAL) {
+            double cycle_us = t_max + standby_us[p->standby & 0x07];
+            conversions = 2e6 / cycle_us;
+            age_ms = cycle_us / 1000.0;
+        }
+        printf("%-16s %8d %8d %10u %12.1f %8u %14.1f %12.1f%s\n", profiles[i].name,
+               1 << (p->osrs_t - 1), 1 << (p->osrs_p - 1), t_max, d.time_ns / 1e3,
+               d.i2c_transactions, conversions, age_ms, ok ? "" : "  FALHA");
+    }
+}
+
+int main(void) {
+    bench_drivers();
+    bench_overlap();
+    bench_bmp280_profiles();
+    bench_main_loop();
+    return 0;
+}
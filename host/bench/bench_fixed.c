@@ -0,0 +1,197 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "aht20.h"
+#include "bmp280.h"
+
+// ============================================================================
+// PONTO FIXO x PONTO FLUTUANTE
+// ============================================================================
+// Caminho de conversão do laço principal com float/double (o de antes) contra
+// o caminho só com inteiros (o de agora):
+//   AHT20      aht20_convert         x aht20_convert_fixed
+//   fusão      média em float        x média em centésimos
+//   altitude   calculate_altitude    x bmp280_altitude_cm
+//
+// O Cortex-M0+ não tem FPU: lá cada operação em float/double vira chamada de
+// biblioteca, enquanto o caminho fixo usa só soma, multiplicação e
+// deslocamento. Sem toolchain ARM aqui, os ciclos medidos são do host (TSC,
+// ou ns quando não há TSC) e servem apenas como comparação relativa.
+//
+// A precisão é verificada sobre todas as 2^20 leituras brutas do AHT20 e
+// sobre cada Pa da faixa da tabela de altitude.
+
+#define NUM_SAMPLES     (1 << 20)
+#define REPEATS         5
+
+static uint32_t raw_h[NUM_SAMPLES], raw_t[NUM_SAMPLES], pressure[NUM_SAMPLES];
+static int32_t temp_bmp[NUM_SAMPLES];
+
+static uint64_t ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+#endif
+}
+
+#define TIME_BEST(best, body)                                       \
+    do {                                                            \
+        best = 1e30;                                                \
+        for (int rep_ = 0; rep_ < REPEATS; rep_++) {                \
+            uint64_t t0_ = ticks();                                 \
+            body;                                                   \
+            double c_ = (double)(ticks() - t0_) / NUM_SAMPLES;      \
+            if (c_ < best) best = c_;                               \
+        }                                                           \
+    } while (0)
+
+static void generate_samples(void) {
+    uint32_t state = 12345;
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        state = state * 1664525u + 1013904223u;
+        raw_h[i] = state >> 12;
+        state = state * 1664525u + 1013904223u;
+        raw_t[i] = state >> 12;
+        state = state * 1664525u + 1013904223u;
+        temp_bmp[i] = -2000 + (int32_t)((state >> 8) % 8000);     // -20 a 60 C
+        state = state * 1664525u + 1013904223u;
+        pressure[i] = 70000 + (state >> 8) % 40000;                // 70 a 110 kPa
+    }
+}
+
+// Fusão como era feita antes: AHT20 em float e BMP280 em centésimos
+static float fuse_float(const AHT20_Data* aht, int32_t temperature_bmp) {
+    return (aht->temperature + temperature_bmp / 100.0f) / 2.0f;
+}
+
+static int16_t fuse_fixed(const AHT20_Fixed* aht, int32_t temperature_bmp) {
+    return (int16_t)((aht->temperature + temperature_bmp) / 2);
+}
+
+// Centésimos que o caminho em float enviaria no quadro binário
+static int32_t centi(float v) {
+    return (int32_t)lroundf(v * 100.0f);
+}
+
+int main(void) {
+    generate_samples();
+
+    // === TEMPO ===
+    volatile double sink_d;
+    volatile int32_t sink_i;
+    double c_aht_f, c_aht_x, c_fuse_f, c_fuse_x, c_alt_f, c_alt_x;
+
+    TIME_BEST(c_aht_f, {
+        float acc = 0;
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            AHT20_Data d;
+            aht20_convert(raw_h[i], raw_t[i], &d);
+            acc += d.temperature + d.humidity;
+        }
+        sink_d = acc;
+    });
+    TIME_BEST(c_aht_x, {
+        int32_t acc = 0;
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            AHT20_Fixed d;
+            aht20_convert_fixed(raw_h[i], raw_t[i], &d);
+            acc += d.temperature + d.humidity;
+        }
+        sink_i = acc;
+    });
+    TIME_BEST(c_fuse_f, {
+        float acc = 0;
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            AHT20_Data d;
+            aht20_convert(raw_h[i], raw_t[i], &d);
+            acc += fuse_float(&d, temp_bmp[i]);
+        }
+        sink_d = acc;
+    });
+    TIME_BEST(c_fuse_x, {
+        int32_t acc = 0;
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            AHT20_Fixed d;
+            aht20_convert_fixed(raw_h[i], raw_t[i], &d);
+            acc += fuse_fixed(&d, temp_bmp[i]);
+        }
+        sink_i = acc;
+    });
+    TIME_BEST(c_alt_f, {
+        double acc = 0;
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            acc += calculate_altitude(pressure[i]);
+        }
+        sink_d = acc;
+    });
+    TIME_BEST(c_alt_x, {
+        int32_t acc = 0;
+        for (int i = 0; i < NUM_SAMPLES; i++) {
+            acc += bmp280_altitude_cm(pressure[i]);
+        }
+        sink_i = acc;
+    });
+    (void)sink_d;
+    (void)sink_i;
+
+    // === PRECISÃO DO AHT20: todas as leituras brutas ===
+    // Diferença em centésimos entre o caminho fixo e o float arredondado, e
+    // entre o caminho fixo e a fórmula exata em double
+    int32_t diff_t = 0, diff_h = 0, fuse_diff = 0;
+    double exact_t = 0, exact_h = 0;
+    for (uint32_t raw = 0; raw < (1u << 20); raw++) {
+        AHT20_Data f;
+        AHT20_Fixed x;
+        aht20_convert(raw, raw, &f);
+        aht20_convert_fixed(raw, raw, &x);
+
+        diff_t = abs(x.temperature - centi(f.temperature)) > diff_t ? abs(x.temperature - centi(f.temperature)) : diff_t;
+        diff_h = abs(x.humidity - centi(f.humidity)) > diff_h ? abs(x.humidity - centi(f.humidity)) : diff_h;
+        exact_t = fmax(exact_t, fabs(x.temperature - (raw * 20000.0 / 1048576.0 - 5000.0)));
+        exact_h = fmax(exact_h, fabs(x.humidity - raw * 10000.0 / 1048576.0));
+
+        // Fusão com uma temperatura do BMP280 que varia junto com a leitura
+        int32_t bmp = -4000 + (int32_t)(raw % 12500);
+        int32_t d = abs(fuse_fixed(&x, bmp) - centi(fuse_float(&f, bmp)));
+        if (d > fuse_diff) fuse_diff = d;
+    }
+
+    // === PRECISÃO DA ALTITUDE: cada Pa da tabela ===
+    double alt_err = 0, alt_err_70k = 0;
+    for (uint32_t p = 30720; p <= 110592; p++) {
+        double err = fabs(bmp280_altitude_cm(p) / 100.0 - calculate_altitude(p));
+        alt_err = fmax(alt_err, err);
+        if (p >= 70000) alt_err_70k = fmax(alt_err_70k, err);
+    }
+
+    bool ok = diff_t <= 1 && diff_h <= 1 && exact_t <= 0.5 && exact_h <= 0.5 && fuse_diff <= 1 &&
+              alt_err < 0.75 && alt_err_70k < 0.2;
+
+#if defined(__x86_64__) || defined(__i386__)
+    const char* unit = "ciclos";
+#else
+    const char* unit = "ns";
+#endif
+    printf("Conversão por leitura, %d leituras (melhor de %d, %s do host)\n", NUM_SAMPLES, REPEATS, unit);
+    printf("  %-10s %12s %12s %8s\n", "etapa", "float", "fixo", "x");
+    printf("  %-10s %12.2f %12.2f %8.2f\n", "AHT20", c_aht_f, c_aht_x, c_aht_f / c_aht_x);
+    printf("  %-10s %12.2f %12.2f %8.2f\n", "+ fusão", c_fuse_f, c_fuse_x, c_fuse_f / c_fuse_x);
+    printf("  %-10s %12.2f %12.2f %8.2f\n", "altitude", c_alt_f, c_alt_x, c_alt_f / c_alt_x);
+
+    printf("\nPrecisão sobre as 2^20 leituras brutas do AHT20 (centésimos)\n");
+    printf("  temperatura: fixo x float %d, fixo x exato %.3f\n", (int)diff_t, exact_t);
+    printf("  umidade:     fixo x float %d, fixo x exato %.3f\n", (int)diff_h, exact_h);
+    printf("  fusão:       fixo x float %d\n", (int)fuse_diff);
+    printf("Altitude em tabela x pow(): erro máx %.3f m (30.7-110.6 kPa), %.3f m acima de 70 kPa\n",
+           alt_err, alt_err_70k);
+    printf("%s\n", ok ? "OK" : "FALHA");
+    return ok ? 0 : 1;
+}
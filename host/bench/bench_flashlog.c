@@ -0,0 +1,308 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sim.h"
+#include "sim_flash.h"
+#include "flashlog.h"
+
+// ============================================================================
+// LOG CIRCULAR NA FLASH: VAZÃO, AMPLIFICAÇÃO DE ESCRITA E CORTES DE ENERGIA
+// ============================================================================
+// A flash simulada é mapeada em um arquivo temporário.
+// 1. Regime de store-and-forward na região padrão (64 setores): lotes de
+//    leituras gravados durante quedas do enlace e esvaziados em lotes de 16,
+//    por várias voltas do anel. Tempo de flash e de CPU por leitura, páginas
+//    gravadas e bytes apagados por byte de leitura, desgaste por setor.
+// 2. Enlace fora por mais leituras do que cabem: o anel descarta as mais
+//    antigas e devolve as restantes em ordem, sem buracos.
+// 3. Cortes de energia em pontos aleatórios de gravações e apagamentos, em
+//    uma região pequena que dá a volta com frequência: após cada corte o log
+//    é remontado e as leituras pendentes têm de estar íntegras, contíguas e
+//    completas (nenhuma gravação concluída antes do corte se perde).
+// 4. O arquivo é fechado e reaberto: o log remontado tem o mesmo conteúdo.
+
+#define STEADY_READINGS     60000
+#define OUTAGE_MAX          600         // Leituras por queda do enlace
+#define DRAIN_BATCH         16
+#define CUT_TRIALS          3000
+#define CUT_SECTORS         4
+#define CUT_OFFSET          (FLASHLOG_OFFSET - 16 * FLASH_SECTOR_SIZE)
+
+static uint32_t rng_state = 12345;
+
+static uint32_t rng(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return rng_state >> 8;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Conteúdo determinístico de cada leitura, conferido pela sequência
+static flashlog_record_t make_record(uint32_t seq) {
+    flashlog_record_t r = {
+        .time_ms = seq * 2000u,
+        .fields = (uint8_t)(seq % 8),
+        .temperature = (int16_t)(2000 + (int)(seq * 37 % 2000) - 1000),
+        .humidity = (uint16_t)(seq * 13 % 10001),
+        .pressure = 90000 + seq * 7 % 20000,
+    };
+    return r;
+}
+
+static bool record_matches(const flashlog_record_t* r) {
+    flashlog_record_t e = make_record(r->seq);
+    return r->time_ms == e.time_ms && r->fields == e.fields && r->temperature == e.temperature &&
+           r->humidity == e.humidity && r->pressure == e.pressure;
+}
+
+static bool append_seq(flashlog_t* log) {
+    flashlog_record_t r = make_record(log->next_seq);
+    return flashlog_append(log, &r);
+}
+
+/**
+ * @brief Confere as pendentes: conteúdo íntegro e sequências contíguas
+ *
+ * @return Quantidade de pendentes, ou -1 se houver divergência
+ */
+static int check_pending(const flashlog_t* log, uint32_t* first, uint32_t* last) {
+    static flashlog_record_t buf[CUT_SECTORS * FLASHLOG_RECORDS_PER_SECTOR + 1];
+    int n = flashlog_peek(log, buf, (int)(sizeof(buf) / sizeof(buf[0])));
+    for (int i = 0; i < n; i++) {
+        if (!record_matches(&buf[i]) || (i > 0 && buf[i].seq != buf[i - 1].seq + 1)) {
+            return -1;
+        }
+    }
+    if (n != (int)flashlog_pending(log)) {
+        return -1;
+    }
+    if (n > 0) {
+        *first = buf[0].seq;
+        *last = buf[n - 1].seq;
+    }
+    return n;
+}
+
+/**
+ * @brief Esvazia até count leituras em lotes, conferindo a ordem
+ */
+static bool drain(flashlog_t* log, uint32_t* expected_seq, uint32_t count) {
+    flashlog_record_t batch[DRAIN_BATCH];
+    while (count > 0) {
+        int n = flashlog_peek(log, batch, count < DRAIN_BATCH ? (int)count : DRAIN_BATCH);
+        if (n == 0) {
+            return true;
+        }
+        for (int i = 0; i < n; i++) {
+            if (batch[i].seq != *expected_seq || !record_matches(&batch[i])) {
+                return false;
+            }
+            (*expected_seq)++;
+        }
+        if (!flashlog_consume(log, n)) {
+            return false;
+        }
+        count -= (uint32_t)n;
+    }
+    return true;
+}
+
+static bool run_steady(void) {
+    flashlog_t log;
+    flashlog_init(&log, FLASHLOG_OFFSET, FLASHLOG_SECTORS);
+    sim_flash_stats_t f0 = sim_flash_stats();
+    uint64_t v0 = sim_now_ns();
+    uint32_t expected = log.tail_seq;
+    bool ok = true;
+
+    uint64_t t0 = now_ns();
+    uint32_t written = 0;
+    while (written < STEADY_READINGS && ok) {
+        uint32_t outage = 1 + rng() % OUTAGE_MAX;
+        for (uint32_t i = 0; i < outage && written < STEADY_READINGS; i++, written++) {
+            ok = ok && append_seq(&log);
+        }
+        ok = ok && drain(&log, &expected, UINT32_MAX);
+    }
+    double cpu_ns = (double)(now_ns() - t0) / STEADY_READINGS;
+
+    flashlog_stats_t st;
+    flashlog_get_stats(&log, &st);
+    sim_flash_stats_t f = sim_flash_stats();
+    uint32_t programs = f.page_programs - f0.page_programs;
+    uint32_t erases = f.sector_erases - f0.sector_erases;
+    double payload = (double)STEADY_READINGS * FLASHLOG_RECORD_SIZE;
+    uint32_t sim_min = UINT32_MAX, sim_max = 0;
+    for (int s = 0; s < FLASHLOG_SECTORS; s++) {
+        uint32_t e = sim_flash_sector_erases(FLASHLOG_OFFSET + s * FLASH_SECTOR_SIZE);
+        if (e < sim_min) sim_min = e;
+        if (e > sim_max) sim_max = e;
+    }
+
+    printf("Regime: %d leituras em quedas de até %d, esvaziadas em lotes de %d (%d setores, %d leituras)\n",
+           STEADY_READINGS, OUTAGE_MAX, DRAIN_BATCH, FLASHLOG_SECTORS,
+           FLASHLOG_SECTORS * FLASHLOG_RECORDS_PER_SECTOR);
+    printf("  voltas do anel        %.2f\n", (double)erases / FLASHLOG_SECTORS);
+    printf("  flash por leitura     %.3f ms (gravação + confirmação + apagamento)\n",
+           (double)(f.busy_ns - f0.busy_ns) / STEADY_READINGS / 1e6);
+    printf("  CPU host por leitura  %.0f ns (fora o tempo da flash)\n", cpu_ns);
+    printf("  páginas por leitura   %.3f; bytes gravados/byte útil %.1f (página parcial)\n",
+           (double)programs / STEADY_READINGS, programs * (double)FLASH_PAGE_SIZE / payload);
+    printf("  bytes apagados/byte útil %.3f\n", erases * (double)FLASH_SECTOR_SIZE / payload);
+    printf("  apagamentos por setor %u a %u (cabeçalhos), %u a %u (simulador)\n",
+           st.min_erase_count, st.max_erase_count, sim_min, sim_max);
+    printf("  tempo virtual         %.1f s\n", (sim_now_ns() - v0) / 1e9);
+
+    ok = ok && expected == log.next_seq && flashlog_pending(&log) == 0 && st.dropped == 0 &&
+         st.max_erase_count - st.min_erase_count <= 1 && sim_max - sim_min <= 1;
+    printf("  entrega em ordem, sem perdas, desgaste uniforme: %s\n\n", ok ? "OK" : "FALHA");
+    return ok;
+}
+
+static bool run_overflow(void) {
+    flashlog_t log;
+    flashlog_init(&log, FLASHLOG_OFFSET, FLASHLOG_SECTORS);
+    uint32_t capacity = FLASHLOG_SECTORS * FLASHLOG_RECORDS_PER_SECTOR;
+    uint32_t total = capacity * 3 / 2;
+    uint32_t first_seq = log.next_seq;
+    bool ok = true;
+    for (uint32_t i = 0; i < total && ok; i++) {
+        ok = append_seq(&log);
+    }
+    flashlog_stats_t st;
+    flashlog_get_stats(&log, &st);
+    uint32_t pending = flashlog_pending(&log);
+    uint32_t expected = log.tail_seq;
+    bool tail_ok = log.tail_seq - first_seq == st.dropped;
+    ok = ok && tail_ok && drain(&log, &expected, UINT32_MAX) && expected == log.next_seq;
+
+    printf("Enlace fora por %u leituras (capacidade %u): %u pendentes, %u descartadas (as mais antigas)\n",
+           total, capacity, pending, st.dropped);
+    ok = ok && pending + st.dropped == total && pending >= capacity - FLASHLOG_RECORDS_PER_SECTOR;
+    printf("  restantes em ordem e sem buracos: %s\n\n", ok ? "OK" : "FALHA");
+    return ok;
+}
+
+/**
+ * @brief Cortes de energia em pontos aleatórios
+ *
+ * Antes de cada operação guarda o estado em RAM; após o corte, o log
+ * remontado deve conter todas as pendentes desse estado (menos as de um
+ * setor que a própria operação estivesse descartando), mais no máximo a
+ * leitura que estava sendo gravada, e nenhuma confirmada antes dele.
+ */
+static bool run_power_cuts(void) {
+    flashlog_t log;
+    flashlog_init(&log, CUT_OFFSET, CUT_SECTORS);
+    uint32_t failures = 0, torn = 0, redelivered = 0, lost_in_flight = 0;
+    uint32_t cuts_before = sim_flash_stats().cuts;
+
+    for (int trial = 0; trial < CUT_TRIALS; trial++) {
+        sim_flash_cut_after(1 + rng() % (3 * FLASH_SECTOR_SIZE));
+
+        flashlog_t before = log;
+        bool consuming = false;
+        int consumed = 0;
+        while (sim_flash_powered()) {
+            before = log;
+            consuming = flashlog_pending(&log) > 0 && rng() % 4 == 0;
+            if (consuming) {
+                flashlog_record_t batch[DRAIN_BATCH];
+                consumed = flashlog_peek(&log, batch, 1 + rng() % DRAIN_BATCH);
+                flashlog_consume(&log, consumed);
+            } else {
+                append_seq(&log);
+            }
+        }
+        sim_flash_power_on();
+        sim_reset();                                // Reboot: a flash é mantida
+
+        flashlog_init(&log, CUT_OFFSET, CUT_SECTORS);
+        torn += log.stats.torn;
+        uint32_t first = 0, last = 0;
+        int n = check_pending(&log, &first, &last);
+
+        // Limites a partir do estado antes da operação interrompida: a
+        // confirmação pode ou não ter sido gravada, e a volta do anel pode
+        // ter descartado o setor mais antigo
+        uint32_t lo = before.tail_seq;
+        uint32_t hi = before.next_seq - 1;                  // Última gravação concluída
+        uint32_t slack = before.head_slot >= FLASHLOG_RECORDS_PER_SECTOR ? FLASHLOG_RECORDS_PER_SECTOR : 0;
+        if (consuming) slack += (uint32_t)consumed;
+        bool ok = n >= 0;
+        if (ok && n == 0) {
+            ok = before.pending <= slack;
+        } else if (ok) {
+            ok = first >= before.acked_seq && first <= lo + slack &&
+                 (consuming ? last == hi : (last == hi || last == hi + 1));
+        }
+        if (ok && n > 0 && first < (consuming ? lo + (uint32_t)consumed : lo)) redelivered++;
+        if (ok && !consuming && (n == 0 || last == hi)) lost_in_flight++;
+        if (!ok) {
+            failures++;
+        }
+
+        // O log segue utilizável depois da recuperação
+        uint32_t next = log.next_seq;
+        if (!append_seq(&log) || log.next_seq != next + 1) {
+            failures++;
+        }
+    }
+
+    printf("Cortes de energia: %d em pontos aleatórios (%d setores, gravações e apagamentos)\n",
+           CUT_TRIALS, CUT_SECTORS);
+    printf("  cortes efetivos %u; registros rasgados ignorados na montagem %u\n",
+           sim_flash_stats().cuts - cuts_before, torn);
+    printf("  gravação interrompida perdida %u vezes; lote reentregue (confirmação interrompida) %u vezes\n",
+           lost_in_flight, redelivered);
+    printf("  leituras concluídas perdidas ou corrompidas: %u -> %s\n\n", failures, failures ? "FALHA" : "OK");
+    return failures == 0;
+}
+
+static bool run_reopen(const char* path) {
+    flashlog_t log;
+    flashlog_init(&log, FLASHLOG_OFFSET, FLASHLOG_SECTORS);
+    for (int i = 0; i < 500; i++) {
+        append_seq(&log);
+    }
+    uint32_t expected = log.tail_seq;
+    drain(&log, &expected, 200);
+    uint32_t pending = flashlog_pending(&log), tail = log.tail_seq, next = log.next_seq;
+
+    sim_flash_close();
+    bool ok = sim_flash_open(path);
+    flashlog_t again;
+    ok = ok && flashlog_init(&again, FLASHLOG_OFFSET, FLASHLOG_SECTORS);
+    ok = ok && flashlog_pending(&again) == pending && again.tail_seq == tail && again.next_seq == next &&
+         drain(&again, &expected, UINT32_MAX) && expected == next;
+    printf("Arquivo fechado e reaberto com %u pendentes: %s\n", pending, ok ? "OK" : "FALHA");
+    return ok;
+}
+
+int main(void) {
+    char path[] = "/tmp/bench_flashlog_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0 || !sim_flash_open(path)) {
+        printf("não foi possível criar a flash em %s\n", path);
+        return 1;
+    }
+    close(fd);
+    sim_reset();
+
+    bool ok = run_steady();
+    ok = run_overflow() && ok;
+    ok = run_power_cuts() && ok;
+    ok = run_reopen(path) && ok;
+
+    sim_flash_close();
+    unlink(path);
+    printf("%s\n", ok ? "OK" : "FALHA");
+    return ok ? 0 : 1;
+}
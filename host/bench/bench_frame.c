@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "sim_sx1276.h"
+#include "rfm95.h"
+#include "rfm95_definitions.h"
+#include "frame.h"
+
+// ============================================================================
+// QUADRO BINÁRIO x JSON
+// ============================================================================
+// 1. Ida e volta encode/decode sobre toda a faixa dos sensores
+// 2. Tamanho e tempo no ar do quadro binário contra o JSON de main.c
+
+static int roundtrip_failures;
+
+static void check_roundtrip(const frame_reading_t* in) {
+    uint8_t buf[FRAME_READING_MAX_SIZE];
+    frame_reading_t out;
+    int len = frame_encode(in, buf, sizeof(buf));
+
+    bool ok = len > 0 && frame_decode(buf, len, &out)
+           && out.station_id == in->station_id
+           && out.sequence == in->sequence
+           && out.fields == in->fields;
+    if (ok && (in->fields & FRAME_FIELD_TEMPERATURE)) ok = out.temperature == in->temperature;
+    if (ok && (in->fields & FRAME_FIELD_HUMIDITY)) ok = out.humidity == in->humidity;
+    if (ok && (in->fields & FRAME_FIELD_PRESSURE)) ok = labs((long)out.pressure - (long)in->pressure) <= 5;
+
+    // Quadros truncados devem ser rejeitados
+    for (int n = 0; ok && n < len; n++) {
+        ok = !frame_decode(buf, n, &out);
+    }
+
+    if (!ok) {
+        roundtrip_failures++;
+        if (roundtrip_failures <= 5) {
+            printf("falha: id=%u seq=%u campos=%02x T=%d H=%u P=%u\n", in->station_id, in->sequence,
+                   in->fields, in->temperature, in->humidity, (unsigned)in->pressure);
+        }
+    }
+}
+
+static void bench_roundtrip(void) {
+    int total = 0;
+    frame_reading_t r = { .station_id = 7 };
+
+    for (int t = -4000; t <= 8500; t += 37) {
+        for (int h = 0; h <= 10000; h += 911) {
+            for (uint32_t p = 30000; p <= 110000; p += 7919) {
+                for (uint8_t fields = 0; fields <= FRAME_FIELDS_ALL; fields++) {
+                    r.sequence = (uint16_t)(total * 40503u);
+                    r.fields = fields;
+                    r.temperature = (int16_t)t;
+                    r.humidity = (uint16_t)h;
+                    r.pressure = p;
+                    check_roundtrip(&r);
+                    total++;
+                }
+            }
+        }
+    }
+    printf("ida e volta: %d quadros, %d falhas\n", total, roundtrip_failures);
+}
+
+static void bench_airtime(void) {
+    char json[64];
+    snprintf(json, sizeof(json), "{\"temperatura\":%.2f,\"pressao\":%d,\"umidade\":%.2f}\r\n",
+             23.47f, 94, 55.12f);
+    int json_len = (int)strlen(json);
+
+    frame_reading_t r = {
+        .station_id = 1, .sequence = 42, .fields = FRAME_FIELDS_ALL,
+        .temperature = 2347, .humidity = 5512, .pressure = 94321,
+    };
+    uint8_t frame[FRAME_READING_MAX_SIZE];
+    int frame_len = frame_encode(&r, frame, sizeof(frame));
+
+    sim_reset();
+    rfm95_initialize();
+
+    printf("\npayload: JSON %d bytes, binario %d bytes\n", json_len, frame_len);
+
+    sim_stats_t start = sim_stats();
+    rfm95_transmit((const uint8_t*)json, (uint8_t)json_len);
+    sim_stats_t d_json = sim_stats_since(&start);
+    start = sim_stats();
+    rfm95_transmit(frame, (uint8_t)frame_len);
+    sim_stats_t d_frame = sim_stats_since(&start);
+
+    printf("rfm95_transmit no simulador (SF7/125 kHz): JSON %.2f ms, binario %.2f ms\n",
+           d_json.time_ns / 1e6, d_frame.time_ns / 1e6);
+
+    // Tempo no ar por fator de espalhamento (LDRO ativo em SF11/SF12 a 125 kHz)
+    printf("\n%-5s %12s %12s %8s\n", "SF", "JSON_ms", "binario_ms", "razao");
+    sim_sx1276_t radio = *sim_radio();
+    for (int sf = 7; sf <= 12; sf++) {
+        radio.regs[REG_MODEM_CONFIG_2] = (uint8_t)((sf << 4) | CRC_ON);
+        radio.regs[REG_MODEM_CONFIG_3] = sf >= 11 ? 0x08 : 0x00;
+        double t_json = sim_sx1276_time_on_air_ns(&radio, (uint8_t)json_len) / 1e6;
+        double t_frame = sim_sx1276_time_on_air_ns(&radio, (uint8_t)frame_len) / 1e6;
+        printf("SF%-3d %12.2f %12.2f %8.2f\n", sf, t_json, t_frame, t_json / t_frame);
+    }
+}
+
+int main(void) {
+    bench_roundtrip();
+    bench_airtime();
+    return roundtrip_failures ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "json.h"
+
+// ============================================================================
+// JSON SEM PRINTF x SNPRINTF
+// ============================================================================
+// 1. Igualdade byte a byte com o formato antigo de main.c, que imprimia
+//    temperatura e umidade em float com %.2f: toda a faixa do AHT20 em
+//    temperatura (-50.00 a 150.00 °C), toda a umidade (0.00 a 100.00 %) e
+//    pressões de 0 a 200 kPa, além dos extremos dos tipos. As entradas já
+//    estão em centésimos, como no main.c antigo; não é uma garantia contra
+//    %.2f para um float arbitrário.
+// 2. Tempo de CPU do host por payload: snprintf com %.2f, snprintf com
+//    inteiros (%d.%02d) e json_encode().
+//
+// O ganho de flash do firmware sem o printf de float não é medido aqui: só
+// com o toolchain ARM (opção PRINTF_FLOAT do CMakeLists.txt do firmware e
+// arm-none-eabi-size nas duas imagens).
+
+#define NUM_PAYLOADS    (1 << 18)
+#define REPEATS         5
+
+static const char* LEGACY_FORMAT = "{\"temperatura\":%.2f,\"pressao\":%d,\"umidade\":%.2f}\r\n";
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+ * @brief Compara json_encode() com o snprintf antigo sobre os mesmos valores
+ */
+static bool check_one(int16_t temperatura, int32_t pressao, uint16_t umidade) {
+    char expected[96];
+    uint8_t got[JSON_READING_MAX_SIZE];
+
+    // As variáveis globais antigas eram float
+    float t = temperatura / 100.0f;
+    float h = umidade / 100.0f;
+    int expected_len = snprintf(expected, sizeof(expected), LEGACY_FORMAT, t, (int)pressao, h);
+    int len = json_encode(temperatura, pressao, umidade, got, sizeof(got));
+
+    if (len != expected_len || memcmp(got, expected, len) != 0) {
+        printf("  divergência: esperado %s  obtido %.*s\n", expected, len, (const char*)got);
+        return false;
+    }
+    return true;
+}
+
+static int check_equivalence(void) {
+    int checked = 0, failures = 0;
+
+    for (int t = -5000; t <= 15000; t++) {
+        failures += !check_one((int16_t)t, 94, 5500);
+        checked++;
+    }
+    for (int h = 0; h <= 10000; h++) {
+        failures += !check_one(2350, 94, (uint16_t)h);
+        checked++;
+    }
+    for (int p = 0; p <= 200; p++) {
+        failures += !check_one(-1, p, 1);
+        checked++;
+    }
+
+    // Extremos dos tipos (fora da faixa dos sensores)
+    failures += !check_one(INT16_MIN, INT32_MIN, UINT16_MAX);
+    failures += !check_one(INT16_MAX, INT32_MAX, 0);
+    checked += 2;
+
+    // Tamanho máximo declarado
+    uint8_t buffer[JSON_READING_MAX_SIZE];
+    int max_len = json_encode(INT16_MIN, INT32_MIN, UINT16_MAX, buffer, sizeof(buffer));
+    bool short_rejected = json_encode(0, 0, 0, buffer, JSON_READING_MAX_SIZE - 1) == 0;
+
+    printf("Igualdade com snprintf(%%.2f): %d payloads, %d divergências\n", checked, failures);
+    printf("  maior payload %d bytes (JSON_READING_MAX_SIZE %d), buffer curto %s\n\n",
+           max_len, JSON_READING_MAX_SIZE, short_rejected ? "recusado" : "ACEITO");
+    return failures + (max_len > JSON_READING_MAX_SIZE) + !short_rejected;
+}
+
+static int16_t temps[NUM_PAYLOADS];
+static uint16_t hums[NUM_PAYLOADS];
+static int32_t press[NUM_PAYLOADS];
+
+#define TIME_BEST(best, body)                                       \
+    do {                                                            \
+        best = 1e30;                                                \
+        for (int rep_ = 0; rep_ < REPEATS; rep_++) {                \
+            uint64_t t0_ = now_ns();                                \
+            body;                                                   \
+            double ns_ = (double)(now_ns() - t0_) / NUM_PAYLOADS;   \
+            if (ns_ < best) best = ns_;                             \
+        }                                                           \
+    } while (0)
+
+int main(void) {
+    int failures = check_equivalence();
+
+    uint32_t state = 12345;
+    for (int i = 0; i < NUM_PAYLOADS; i++) {
+        state = state * 1664525u + 1013904223u;
+        temps[i] = (int16_t)(-2000 + (int)((state >> 8) % 8000));
+        state = state * 1664525u + 1013904223u;
+        hums[i] = (uint16_t)((state >> 8) % 10001);
+        press[i] = 70 + (int32_t)((state >> 20) % 40);
+    }
+
+    char text[96];
+    uint8_t buffer[JSON_READING_MAX_SIZE];
+    volatile int sink = 0;
+    double t_float, t_int, t_json;
+
+    TIME_BEST(t_float, for (int i = 0; i < NUM_PAYLOADS; i++) {
+        sink += snprintf(text, sizeof(text), LEGACY_FORMAT, temps[i] / 100.0f, (int)press[i], hums[i] / 100.0f);
+    });
+    TIME_BEST(t_int, for (int i = 0; i < NUM_PAYLOADS; i++) {
+        int t = temps[i];
+        sink += snprintf(text, sizeof(text), "{\"temperatura\":%s%d.%02d,\"pressao\":%d,\"umidade\":%d.%02d}\r\n",
+                         t < 0 ? "-" : "", (t < 0 ? -t : t) / 100, (t < 0 ? -t : t) % 100,
+                         (int)press[i], hums[i] / 100, hums[i] % 100);
+    });
+    TIME_BEST(t_json, for (int i = 0; i < NUM_PAYLOADS; i++) {
+        sink += json_encode(temps[i], press[i], hums[i], buffer, sizeof(buffer));
+    });
+    (void)sink;
+
+    printf("Payload JSON, %d leituras (melhor de %d)\n", NUM_PAYLOADS, REPEATS);
+    printf("  %-22s %10s %8s\n", "variante", "ns/payload", "x");
+    printf("  %-22s %10.1f %8.2f\n", "snprintf %.2f", t_float, 1.0);
+    printf("  %-22s %10.1f %8.2f\n", "snprintf %d.%02d", t_int, t_float / t_int);
+    printf("  %-22s %10.1f %8.2f\n", "json_encode", t_json, t_float / t_json);
+    printf("%s\n", failures == 0 ? "OK" : "FALHA");
+    return failures == 0 ? 0 : 1;
+}
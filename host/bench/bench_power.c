@@ -0,0 +1,158 @@
+#include <stdio.h>
+
+#include "sim.h"
+#include "sim_sx1276.h"
+#include "rfm95.h"
+#include "power.h"
+
+// ============================================================================
+// CONSUMO ESTIMADO POR CICLO: STANDBY x ESCALONADOR DE BAIXO CONSUMO
+// ============================================================================
+// Roda o laço de main.c no relógio virtual por NUM_CYCLES ciclos de
+// PERIOD_MS em dois cenários:
+//   antes   loop() + sleep_ms(): rádio parado em Standby, CPU sem sono profundo
+//   agora   loop() + power_sleep_until(): rádio em Sleep e sono profundo
+//
+// Mostra tempo e carga por fase (power_get_stats), corrente média e a
+// autonomia com uma bateria de BATTERY_MAH. Os tempos do rádio contados pelo
+// driver são conferidos com os do modelo do SX1276, o sono profundo da CPU
+// com o SLEEPDEEP visto pelo simulador, e as transações SPI por ciclo mostram
+// que a volta do Sleep não repete rfm95_initialize(). Por fim, com dois
+// núcleos declarados e só um dormindo, nada pode contar como sono da CPU.
+
+#define NUM_CYCLES      30
+#define PERIOD_MS       2000
+#define BATTERY_MAH     2000
+
+// Modos do SX1276 (bits 2-0 de REG_OPMODE)
+#define SX_SLEEP        0
+#define SX_STDBY        1
+#define SX_TX           3
+
+bool setup();
+void loop();
+
+typedef struct {
+    power_stats_t power;
+    uint64_t sim_mode_us[8];        // Tempo em cada modo segundo o modelo do rádio
+    uint64_t deep_sleep_us;
+    uint32_t spi_per_cycle;
+    uint32_t packets;
+    uint8_t final_mode;
+} scenario_t;
+
+static void radio_mode_us(uint64_t out[8]) {
+    const sim_sx1276_t* radio = sim_radio();
+    for (int m = 0; m < 8; m++) {
+        out[m] = radio->mode_ns[m] / 1000;
+    }
+    out[sim_sx1276_mode(radio)] += (sim_now_ns() - radio->mode_since_ns) / 1000;
+}
+
+static bool run_scenario(bool low_power, scenario_t* r) {
+    sim_reset();
+    if (!setup()) {
+        return false;
+    }
+
+    uint64_t mode_start[8];
+    radio_mode_us(mode_start);
+    sim_stats_t start = sim_stats();
+    uint32_t packets_start = sim_radio()->tx_packets;
+
+    absolute_time_t proxima = get_absolute_time();
+    for (int i = 0; i < NUM_CYCLES; i++) {
+        loop();
+        if (low_power) {
+            proxima = delayed_by_ms(proxima, PERIOD_MS);
+            power_sleep_until(proxima);
+        } else {
+            sleep_ms(PERIOD_MS);
+        }
+    }
+    rfm95_transmit_wait();
+
+    power_get_stats(&r->power);
+    sim_stats_t d = sim_stats_since(&start);
+    radio_mode_us(r->sim_mode_us);
+    for (int m = 0; m < 8; m++) {
+        r->sim_mode_us[m] -= mode_start[m];
+    }
+    r->deep_sleep_us = d.deep_sleep_ns / 1000;
+    r->spi_per_cycle = d.spi_transactions / NUM_CYCLES;
+    r->packets = sim_radio()->tx_packets - packets_start;
+    r->final_mode = sim_sx1276_mode(sim_radio());
+    return true;
+}
+
+static uint64_t diff_us(uint64_t a, uint64_t b) {
+    return a > b ? a - b : b - a;
+}
+
+int main(void) {
+    scenario_t before, after;
+    if (!run_scenario(false, &before) || !run_scenario(true, &after)) {
+        printf("setup() falhou\n");
+        return 1;
+    }
+
+    printf("%d ciclos de %d ms (carga em mC)\n", NUM_CYCLES, PERIOD_MS);
+    printf("  %-16s %12s %10s %12s %10s\n", "fase", "antes_ms", "antes_mC", "agora_ms", "agora_mC");
+    for (int i = 0; i < POWER_NUM_PHASES; i++) {
+        printf("  %-16s %12.1f %10.3f %12.1f %10.3f\n", power_phase_name(i),
+               before.power.time_us[i] / 1000.0, before.power.charge_nc[i] / 1e6,
+               after.power.time_us[i] / 1000.0, after.power.charge_nc[i] / 1e6);
+    }
+    printf("  %-16s %12.1f %10.3f %12.1f %10.3f\n", "total",
+           before.power.elapsed_us / 1000.0, before.power.total_charge_nc / 1e6,
+           after.power.elapsed_us / 1000.0, after.power.total_charge_nc / 1e6);
+
+    printf("\ncorrente média: antes %u uA, agora %u uA (%.1fx)\n",
+           before.power.average_ua, after.power.average_ua,
+           (double)before.power.average_ua / after.power.average_ua);
+    printf("autonomia com %d mAh: antes %.1f dias, agora %.1f dias\n", BATTERY_MAH,
+           BATTERY_MAH * 1000.0 / before.power.average_ua / 24,
+           BATTERY_MAH * 1000.0 / after.power.average_ua / 24);
+
+    // Conferência com o simulador (tolerância de 1 ms por ciclo)
+    uint64_t tol = NUM_CYCLES * 1000;
+    bool radio_ok = true;
+    const scenario_t* s[2] = { &before, &after };
+    for (int k = 0; k < 2; k++) {
+        radio_ok = radio_ok &&
+            diff_us(s[k]->power.time_us[POWER_RADIO_TX], s[k]->sim_mode_us[SX_TX]) <= tol &&
+            diff_us(s[k]->power.time_us[POWER_RADIO_SLEEP], s[k]->sim_mode_us[SX_SLEEP]) <= tol;
+    }
+    bool sleep_ok = diff_us(after.power.time_us[POWER_CPU_SLEEP], after.deep_sleep_us) <= tol &&
+                    before.deep_sleep_us == 0;
+    bool packets_ok = before.packets == NUM_CYCLES && after.packets == NUM_CYCLES;
+
+    printf("\nrádio (driver x modelo): TX %.1f x %.1f ms, Sleep %.1f x %.1f ms -> %s\n",
+           after.power.time_us[POWER_RADIO_TX] / 1000.0, after.sim_mode_us[SX_TX] / 1000.0,
+           after.power.time_us[POWER_RADIO_SLEEP] / 1000.0, after.sim_mode_us[SX_SLEEP] / 1000.0,
+           radio_ok ? "OK" : "FALHA");
+    printf("sono profundo (escalonador x SLEEPDEEP no simulador): %.1f x %.1f ms -> %s\n",
+           after.power.time_us[POWER_CPU_SLEEP] / 1000.0, after.deep_sleep_us / 1000.0,
+           sleep_ok ? "OK" : "FALHA");
+    printf("pacotes: antes %u, agora %u; rádio ao fim: %s; SPI por ciclo: antes %u, agora %u\n",
+           before.packets, after.packets, after.final_mode == SX_SLEEP ? "Sleep" : "acordado",
+           before.spi_per_cycle, after.spi_per_cycle);
+
+    // Com DUAL_CORE o core0 segue acordado enquanto o core1 dorme: o chip
+    // não corta os clocks, então o sono do core1 sozinho não conta
+    power_stats_t dual;
+    sim_reset();
+    bool dual_ok = setup();
+    power_set_num_cores(2);
+    loop();
+    power_sleep_until(make_timeout_time_ms(PERIOD_MS));
+    power_get_stats(&dual);
+    dual_ok = dual_ok && dual.time_us[POWER_CPU_SLEEP] == 0;
+    printf("dois núcleos, só um em sono profundo: sono da CPU %.1f ms -> %s\n",
+           dual.time_us[POWER_CPU_SLEEP] / 1000.0, dual_ok ? "OK" : "FALHA");
+
+    bool ok = radio_ok && sleep_ok && packets_ok && dual_ok && after.final_mode == SX_SLEEP &&
+              after.power.average_ua < before.power.average_ua;
+    printf("%s\n", ok ? "OK" : "FALHA");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "sim.h"
+#include "sim_trace.h"
+#include "aht20.h"
+#include "bmp280.h"
+#include "frame.h"
+#include "series.h"
+
+// ============================================================================
+// COMPRESSÃO DE SÉRIES: RAZÃO E CUSTO DE CODIFICAÇÃO
+// ============================================================================
+// Os traços são gravados pelos drivers reais (aht20_read, bmp280_read_raw e
+// bmp280_convert_*) lendo os sensores simulados alimentados por sim_trace:
+// 6 horas a cada 2 s, com a quantização e o arredondamento do firmware.
+// Cada janela é comprimida, descomprimida e comparada com a original.
+
+#define I2C_PORT_SENSORS    i2c0
+#define TRACE_SAMPLES       10800
+#define SAMPLE_PERIOD_MS    2000
+#define CHANNELS            3
+#define TIMING_ROUNDS       20
+
+static int32_t fixed[TRACE_SAMPLES][CHANNELS];     // centi-°C, centi-%RH, Pa
+static float floats[TRACE_SAMPLES][CHANNELS];      // °C, %RH, Pa como em main.c
+
+static void record_trace(sim_trace_profile_t profile) {
+    sim_trace_t trace;
+    struct bmp280_calib_param params;
+    AHT20_Data aht;
+
+    sim_reset();
+    sim_trace_init(&trace, profile, 12345);
+    setup_I2C_aht20(I2C_PORT_SENSORS, 0, 1, 400 * 1000);
+    aht20_init(I2C_PORT_SENSORS);
+    bmp280_init(I2C_PORT_SENSORS);
+    bmp280_get_calib_params(I2C_PORT_SENSORS, &params);
+
+    for (int i = 0; i < TRACE_SAMPLES; i++) {
+        uint64_t start = sim_now_ns();
+        sim_env_t env = sim_trace_env(&trace, start);
+        sim_env_set(&env);
+
+        int32_t raw_t, raw_p;
+        bmp280_read_raw(I2C_PORT_SENSORS, &raw_t, &raw_p);
+        int32_t t_bmp = bmp280_convert_temp(raw_t, &params);
+        int32_t p = bmp280_convert_pressure(raw_p, raw_t, &params);
+        aht20_read(I2C_PORT_SENSORS, &aht);
+
+        float temperatura = (aht.temperature + (t_bmp / 100.0)) / 2.0;
+        float umidade = aht.humidity > 100 ? 100 : aht.humidity;
+        fixed[i][0] = lroundf(temperatura * 100.0f);
+        fixed[i][1] = lroundf(umidade * 100.0f);
+        fixed[i][2] = p;
+        floats[i][0] = temperatura;
+        floats[i][1] = umidade;
+        floats[i][2] = (float)p;
+
+        sim_advance_ns(start + SAMPLE_PERIOD_MS * 1000000ull - sim_now_ns());
+    }
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint8_t buffer[TRACE_SAMPLES * CHANNELS * SERIES_VARINT_MAX_SIZE];
+
+/**
+ * @brief Comprime o traço em janelas de window amostras
+ *
+ * @return Total de bytes, ou -1 se a descompressão divergir
+ */
+static long run_delta(int window) {
+    long total = 0;
+    for (int start = 0; start < TRACE_SAMPLES; start += window) {
+        int n = TRACE_SAMPLES - start < window ? TRACE_SAMPLES - start : window;
+        series_encoder_t enc;
+        series_encoder_init(&enc, buffer, sizeof(buffer), CHANNELS);
+        for (int i = 0; i < n; i++) series_encode(&enc, fixed[start + i]);
+
+        series_decoder_t dec;
+        int32_t v[CHANNELS];
+        series_decoder_init(&dec, buffer, enc.length, CHANNELS);
+        for (int i = 0; i < n; i++) {
+            if (!series_decode(&dec, v) || memcmp(v, fixed[start + i], sizeof(v)) != 0) return -1;
+        }
+        if (series_decode(&dec, v)) return -1;
+        total += enc.length;
+    }
+    return total;
+}
+
+static long run_xor(int window) {
+    long total = 0;
+    for (int start = 0; start < TRACE_SAMPLES; start += window) {
+        int n = TRACE_SAMPLES - start < window ? TRACE_SAMPLES - start : window;
+        series_xor_encoder_t enc;
+        series_xor_encoder_init(&enc, buffer, sizeof(buffer), CHANNELS);
+        for (int i = 0; i < n; i++) series_xor_encode(&enc, floats[start + i]);
+        int length = series_xor_length(&enc);
+
+        series_xor_decoder_t dec;
+        float v[CHANNELS];
+        series_xor_decoder_init(&dec, buffer, length, CHANNELS, (uint16_t)n);
+        for (int i = 0; i < n; i++) {
+            if (!series_xor_decode(&dec, v) || memcmp(v, floats[start + i], sizeof(v)) != 0) return -1;
+        }
+        total += length;
+    }
+    return total;
+}
+
+static double time_encode(int window, bool xor) {
+    double best = 1e30;
+    for (int r = 0; r < TIMING_ROUNDS; r++) {
+        double t0 = now_ns();
+        for (int start = 0; start < TRACE_SAMPLES; start += window) {
+            int n = TRACE_SAMPLES - start < window ? TRACE_SAMPLES - start : window;
+            if (xor) {
+                series_xor_encoder_t enc;
+                series_xor_encoder_init(&enc, buffer, sizeof(buffer), CHANNELS);
+                for (int i = 0; i < n; i++) series_xor_encode(&enc, floats[start + i]);
+            } else {
+                series_encoder_t enc;
+                series_encoder_init(&enc, buffer, sizeof(buffer), CHANNELS);
+                for (int i = 0; i < n; i++) series_encode(&enc, fixed[start + i]);
+            }
+        }
+        double dt = now_ns() - t0;
+        if (dt < best) best = dt;
+    }
+    return best / TRACE_SAMPLES;
+}
+
+/**
+ * @brief Quantas leituras consecutivas cabem em um payload de 255 bytes
+ */
+static int samples_per_packet(void) {
+    uint8_t packet[FRAME_MAX_SIZE - FRAME_HEADER_SIZE];
+    series_encoder_t enc;
+    series_encoder_init(&enc, packet, sizeof(packet), CHANNELS);
+    int i = 0;
+    while (i < TRACE_SAMPLES && series_encode(&enc, fixed[i])) i++;
+    return i;
+}
+
+static int bench_profile(sim_trace_profile_t profile) {
+    static const int windows[] = { 8, 27, 64, 256 };
+    int failures = 0;
+
+    record_trace(profile);
+    printf("\ntraco %s: %d leituras\n", sim_trace_name(profile), TRACE_SAMPLES);
+    printf("%-7s %-12s %10s %10s %10s %10s\n",
+           "janela", "codec", "B/leitura", "razao_6B", "razao_12B", "ns/leitura");
+
+    for (int w = 0; w < 4; w++) {
+        long delta = run_delta(windows[w]);
+        long xor = run_xor(windows[w]);
+        if (delta < 0 || xor < 0) failures++;
+
+        double bd = (double)delta / TRACE_SAMPLES;
+        double bx = (double)xor / TRACE_SAMPLES;
+        printf("%-7d %-12s %10.2f %10.2f %10.2f %10.1f\n", windows[w], "delta", bd, 6.0 / bd, 12.0 / bd,
+               time_encode(windows[w], false));
+        printf("%-7d %-12s %10.2f %10.2f %10.2f %10.1f\n", windows[w], "xor float", bx, 6.0 / bx, 12.0 / bx,
+               time_encode(windows[w], true));
+    }
+    printf("leituras por payload de %d bytes: delta %d, quadro de lote %d\n",
+           FRAME_MAX_SIZE - FRAME_HEADER_SIZE, samples_per_packet(),
+           (FRAME_MAX_SIZE - FRAME_HEADER_SIZE) / FRAME_BATCH_SAMPLE_MAX_SIZE);
+    return failures;
+}
+
+int main(void) {
+    int failures = 0;
+    printf("razao_6B: contra os campos do quadro binario; razao_12B: contra 3 x int32/float\n");
+    failures += bench_profile(SIM_TRACE_INDOOR);
+    failures += bench_profile(SIM_TRACE_OUTDOOR);
+    failures += bench_profile(SIM_TRACE_STORM);
+    printf("\nida e volta: %s\n", failures ? "FALHA" : "ok");
+    return failures ? 1 : 0;
+}
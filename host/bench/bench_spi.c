@@ -0,0 +1,239 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "sim.h"
+#include "sim_sx1276.h"
+#include "hardware/irq.h"
+#include "rfm95.h"
+#include "rfm95_definitions.h"
+
+#if !RFM95_USE_DMA
+#error "bench_spi mede o caminho por DMA: compile o rfm95.c com RFM95_USE_DMA=1"
+#endif
+
+// ============================================================================
+// FIFO DO RÁDIO: CLOCK SPI E RAJADAS POR DMA
+// ============================================================================
+// Tempo de CPU ocupada (tempo virtual menos o tempo em WFI/sleep) gasto em
+// rfm95_transmit_async() para vários tamanhos de pacote, em três modos:
+//
+// 1 MHz:        clock anterior, escrita bloqueante do FIFO
+// 10 MHz:       clock validado, escrita bloqueante
+// 10 MHz + DMA: clock validado, FIFO por DMA com o núcleo em WFI
+//
+// Em todos os modos o conteúdo transmitido é conferido byte a byte. Também
+// verifica a escrita em trechos (cabeçalho + carga sem cópia), a leitura
+// do FIFO por DMA em rfm95_receive(), o clock máximo ao fim de
+// rfm95_initialize(), o Standby e o ponteiro do FIFO preservado por uma
+// nova verificação do clock, a volta a 1 MHz quando o módulo não responde
+// corretamente no clock pedido e a DMA_IRQ_0 dividida com outro tratador.
+// Falha se, a partir de RFM95_DMA_MIN_BYTES, o DMA não ocupar menos a CPU
+// que a escrita bloqueante a 10 MHz: só com este resultado vale ligar
+// RFM95_USE_DMA (desligado por padrão) no firmware.
+
+#define HEADER_SIZE     5
+#define DMA_OFF         256             // Acima do maior pacote: DMA nunca usado
+#define SEGMENT_SETUP_US 2.0            // Par de canais a mais por trecho (configuração e disparo)
+
+typedef struct {
+    const char* name;
+    uint32_t spi_hz;
+    uint16_t dma_min_bytes;
+} bench_mode_t;
+
+static const bench_mode_t modes[] = {
+    { "1 MHz",        1000000,  DMA_OFF },
+    { "10 MHz",       10000000, DMA_OFF },
+    { "10 MHz + DMA", 10000000, 1 },
+};
+
+static const uint8_t sizes[] = { 4, 11, 16, 64, 128, 255 };
+
+#define NUM_MODES   (sizeof(modes) / sizeof(modes[0]))
+#define NUM_SIZES   (sizeof(sizes) / sizeof(sizes[0]))
+
+static uint8_t sent[256];
+static uint8_t sent_len;
+
+static void on_tx(void* ctx, const uint8_t* data, uint8_t len, uint64_t start_ns, uint64_t end_ns) {
+    memcpy(sent, data, len);
+    sent_len = len;
+}
+
+static int other_dma_irqs;
+
+static void other_dma_irq(void) {
+    other_dma_irqs++;
+}
+
+static void fill(uint8_t* buf, int len, uint8_t seed) {
+    for (int i = 0; i < len; i++) {
+        buf[i] = (uint8_t)(seed + i * 37);
+    }
+}
+
+static bool sent_equals(const uint8_t* data, uint8_t len) {
+    return sent_len == len && memcmp(sent, data, len) == 0;
+}
+
+static void station_reset(void) {
+    sim_reset();
+    sim_sx1276_on_tx(sim_radio(), on_tx, NULL);
+    rfm95_initialize();
+}
+
+/**
+ * @brief Transmite e devolve a CPU ocupada dentro de rfm95_transmit_async (µs)
+ */
+static double transmit_busy_us(const uint8_t* data, uint8_t len, bool* ok) {
+    sim_stats_t start = sim_stats();
+    *ok &= rfm95_transmit_async(data, len, NULL);
+    sim_stats_t delta = sim_stats_since(&start);
+    rfm95_transmit_wait();
+    *ok &= sent_equals(data, len);
+    return (delta.time_ns - delta.sleep_ns) / 1000.0;
+}
+
+int main(void) {
+    bool ok = true;
+    uint8_t data[255];
+    double busy[NUM_MODES][NUM_SIZES];
+
+    for (size_t m = 0; m < NUM_MODES; m++) {
+        station_reset();
+        bool mode_ok = rfm95_set_spi_clock(modes[m].spi_hz) == modes[m].spi_hz;
+        rfm95_set_dma_min_bytes(modes[m].dma_min_bytes);
+        for (size_t s = 0; s < NUM_SIZES; s++) {
+            fill(data, sizes[s], (uint8_t)(m * 16 + s));
+            busy[m][s] = transmit_busy_us(data, sizes[s], &mode_ok);
+        }
+        if (!mode_ok) printf("%s: clock recusado ou conteúdo transmitido incorreto\n", modes[m].name);
+        ok &= mode_ok;
+    }
+
+    printf("CPU ocupada em rfm95_transmit_async (µs):\n%-8s", "bytes");
+    for (size_t m = 0; m < NUM_MODES; m++) printf(" %14s", modes[m].name);
+    printf(" %9s\n", "ganho");
+    for (size_t s = 0; s < NUM_SIZES; s++) {
+        printf("%-8u", sizes[s]);
+        for (size_t m = 0; m < NUM_MODES; m++) printf(" %14.1f", busy[m][s]);
+        printf(" %8.1fx\n", busy[0][s] / busy[NUM_MODES - 1][s]);
+    }
+
+    // A partir do limiar padrão o DMA tem de ser o mais barato dos três
+    bool faster = true;
+    for (size_t s = 0; s < NUM_SIZES; s++) {
+        faster &= busy[1][s] < busy[0][s];
+        if (sizes[s] >= RFM95_DMA_MIN_BYTES) faster &= busy[2][s] < busy[1][s];
+    }
+    printf("\n10 MHz mais rápido que 1 MHz; DMA mais rápido a partir de %u bytes: %s\n",
+           RFM95_DMA_MIN_BYTES, faster ? "OK" : "FALHA");
+    ok &= faster;
+
+    // Cabeçalho e carga em buffers separados chegam iguais ao buffer contíguo,
+    // tanto pelo SPI bloqueante quanto por DMA. Com DMA, a segunda rajada da
+    // mesma transação também tem de esperar dormindo: a CPU ocupada fica
+    // abaixo da escrita bloqueante dos mesmos trechos e só a configuração
+    // extra de um par de canais pode somar à da escrita contígua
+    bool segments_ok = true;
+    double segments_busy[NUM_MODES];
+    for (size_t m = 0; m < NUM_MODES; m++) {
+        station_reset();
+        rfm95_set_spi_clock(modes[m].spi_hz);
+        rfm95_set_dma_min_bytes(modes[m].dma_min_bytes);
+        uint8_t len = 64;
+        fill(data, len, 0xA5);
+        rfm95_segment_t segments[] = {
+            { data, HEADER_SIZE },
+            { data + HEADER_SIZE, 0 },
+            { data + HEADER_SIZE, (uint8_t)(len - HEADER_SIZE) },
+        };
+        sim_stats_t start = sim_stats();
+        segments_ok &= rfm95_transmit_async_segments(segments, 3, NULL);
+        sim_stats_t delta = sim_stats_since(&start);
+        segments_busy[m] = (delta.time_ns - delta.sleep_ns) / 1000.0;
+        rfm95_transmit_wait();
+        segments_ok &= sent_equals(data, len);
+    }
+    rfm95_segment_t too_long[] = { { data, 200 }, { data, 100 } };
+    segments_ok &= !rfm95_transmit_async_segments(too_long, 2, NULL);
+    printf("Escrita em trechos igual à contígua e recusa acima de 255 bytes: %s\n",
+           segments_ok ? "OK" : "FALHA");
+    ok &= segments_ok;
+
+    double dma_busy = segments_busy[NUM_MODES - 1];
+    double blocking_busy = segments_busy[1];
+    double contiguous_busy = busy[NUM_MODES - 1][3];
+    bool segments_faster = sizes[3] == 64 && dma_busy < blocking_busy
+                           && dma_busy <= contiguous_busy + SEGMENT_SETUP_US;
+    printf("Trechos de 64 bytes: CPU ocupada com DMA %.1f µs, bloqueante %.1f µs "
+           "(DMA contígua %.1f µs): %s\n",
+           dma_busy, blocking_busy, contiguous_busy, segments_faster ? "OK" : "FALHA");
+    ok &= segments_faster;
+
+    // Leitura do FIFO por DMA
+    station_reset();
+    uint8_t rx[255];
+    fill(data, 200, 0x3C);
+    rfm95_receive(rx, sizeof(rx));                      // Entra em RX contínuo
+    sim_sx1276_schedule_rx(sim_radio(), sim_now_ns() + 1000, data, 200, -80, 7.5f, true);
+    sleep_ms(1);
+    int n = rfm95_receive(rx, sizeof(rx));
+    bool rx_ok = n == 200 && memcmp(rx, data, 200) == 0;
+    rfm95_set_idle_mode();
+    printf("Recepção de 200 bytes pelo DMA: %s\n", rx_ok ? "OK" : "FALHA");
+    ok &= rx_ok;
+
+    // Módulo comum: a verificação em rfm95_initialize, já com o rádio em
+    // LoRa Standby, confirma o clock máximo
+    station_reset();
+    uint full = spi_get_baudrate(spi0);
+    bool full_ok = full == RFM95_SPI_HZ;
+    printf("Clock após rfm95_initialize: %u Hz: %s\n", full, full_ok ? "OK" : "FALHA");
+    ok &= full_ok;
+
+    // Nova verificação com o motor de recepção ligado: o rádio vai a Standby
+    // e REG_FIFO_ADDR_PTR volta ao valor anterior aos padrões
+    rfm95_rx_start();
+    sim_radio()->regs[REG_FIFO_ADDR_PTR] = 0x42;
+    uint32_t again = rfm95_set_spi_clock(RFM95_SPI_HZ);
+    uint8_t ptr = sim_radio()->regs[REG_FIFO_ADDR_PTR];
+    bool restore_ok = again == RFM95_SPI_HZ && ptr == 0x42
+                      && (sim_sx1276_mode(sim_radio()) & 0x07) == MODE_STDBY;
+    printf("Clock refeito com RX ligado: Standby, ponteiro do FIFO 0x%02X preservado: %s\n",
+           ptr, restore_ok ? "OK" : "FALHA");
+    ok &= restore_ok;
+
+    // Módulo que só funciona até 4 MHz (fiação longa): a verificação em
+    // rfm95_initialize detecta os bits trocados e volta ao clock seguro
+    sim_reset();
+    sim_sx1276_on_tx(sim_radio(), on_tx, NULL);
+    sim_sx1276_set_max_spi_hz(sim_radio(), 4000000);
+    bool init = rfm95_initialize();
+    uint baud = spi_get_baudrate(spi0);
+    uint32_t retry = rfm95_set_spi_clock(8000000);
+    fill(data, 64, 0x5A);
+    bool fallback_ok = init && baud == RFM95_SPI_SAFE_HZ && retry == RFM95_SPI_SAFE_HZ;
+    transmit_busy_us(data, 64, &fallback_ok);
+    printf("Módulo limitado a 4 MHz: clock %u Hz, pedido de 8 MHz -> %u Hz, transmissão íntegra: %s\n",
+           baud, (unsigned)retry, fallback_ok ? "OK" : "FALHA");
+    ok &= fallback_ok;
+
+    // DMA_IRQ_0 compartilhada com outro usuário: reinicializar o driver não
+    // toma a linha nem some com o outro tratador
+    sim_reset();
+    sim_sx1276_on_tx(sim_radio(), on_tx, NULL);
+    other_dma_irqs = 0;
+    irq_add_shared_handler(DMA_IRQ_0, other_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    bool shared_ok = rfm95_initialize() && rfm95_initialize();
+    fill(data, 64, 0x77);
+    transmit_busy_us(data, 64, &shared_ok);
+    int during_tx = other_dma_irqs;
+    sim_irq_raise(DMA_IRQ_0);
+    shared_ok &= other_dma_irqs == during_tx + 1;
+    printf("DMA_IRQ_0 compartilhada, driver inicializado duas vezes: %s\n", shared_ok ? "OK" : "FALHA");
+    ok &= shared_ok;
+
+    printf("%s\n", ok ? "OK" : "FALHA");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,319 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "spsc.h"
+
+// ============================================================================
+// FILA SPSC ENTRE DUAS THREADS
+// ============================================================================
+// A mesma lib/spsc/spsc.c do firmware, com uma thread POSIX no papel de cada
+// núcleo do RP2040 (relógio real, não o virtual do simulador).
+//
+// estresse:  milhões de elementos por uma fila pequena (enche e esvazia o
+//            tempo todo); o consumidor confere ordem, perdas, duplicatas e
+//            se o conteúdo chegou inteiro
+// latência:  produtor em período fixo; tempo entre o push e o pop
+// jitter:    o laço da estação em escala de tempo reduzida. Em um núcleo,
+//            leitura + transmissão + sleep, como no main.c com DUAL_CORE=0;
+//            em dois, o produtor lê em instantes absolutos e o consumidor
+//            espera o rádio. A transmissão é uma espera (o rádio no ar), não
+//            uso de CPU, como rfm95_transmit_wait() dormindo em __wfi().
+
+#define STRESS_ITEMS        5000000
+#define STRESS_CAPACITY     16
+
+#define LATENCY_ITEMS       20000
+#define LATENCY_PERIOD_NS   100000          // 100 us entre elementos
+
+#define JITTER_SAMPLES      400
+#define JITTER_PERIOD_NS    20000000        // 20 ms (2 s no firmware, escala 1:100)
+#define JITTER_CAPACITY     16
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void sleep_ns(uint64_t ns) {
+    struct timespec ts = { .tv_sec = ns / 1000000000ull, .tv_nsec = ns % 1000000000ull };
+    clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+}
+
+static void sleep_until_ns(uint64_t t) {
+    struct timespec ts = { .tv_sec = t / 1000000000ull, .tv_nsec = t % 1000000000ull };
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
+static int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// ============================================================================
+// ESTRESSE
+// ============================================================================
+
+typedef struct {
+    uint64_t seq;
+    uint64_t pad[2];            // Elemento maior que uma palavra: detecta leitura parcial
+    uint64_t check;
+} item_t;
+
+static uint64_t item_check(uint64_t seq) {
+    return seq * 0x9E3779B97F4A7C15ull ^ 0xA5A5A5A5A5A5A5A5ull;
+}
+
+typedef struct {
+    spsc_queue_t q;
+    uint64_t full_spins;
+    uint64_t empty_spins;
+    uint64_t errors;
+} stress_t;
+
+static void* stress_producer(void* arg) {
+    stress_t* s = arg;
+    for (uint64_t i = 0; i < STRESS_ITEMS; i++) {
+        item_t it = { .seq = i, .pad = { ~i, i }, .check = item_check(i) };
+        while (!spsc_push(&s->q, &it)) {
+            s->full_spins++;
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void* stress_consumer(void* arg) {
+    stress_t* s = arg;
+    for (uint64_t expected = 0; expected < STRESS_ITEMS; ) {
+        item_t it;
+        if (!spsc_pop(&s->q, &it)) {
+            s->empty_spins++;
+            sched_yield();
+            continue;
+        }
+        if (it.seq != expected || it.check != item_check(expected) ||
+            it.pad[0] != ~expected || it.pad[1] != expected) {
+            s->errors++;
+            expected = it.seq;                      // Ressincroniza para contar erros seguintes
+        }
+        expected++;
+    }
+    return NULL;
+}
+
+static bool run_stress(void) {
+    static item_t storage[STRESS_CAPACITY];
+    stress_t s = { 0 };
+    spsc_init(&s.q, storage, STRESS_CAPACITY, sizeof(item_t));
+
+    pthread_t prod, cons;
+    uint64_t t0 = now_ns();
+    pthread_create(&cons, NULL, stress_consumer, &s);
+    pthread_create(&prod, NULL, stress_producer, &s);
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+    double secs = (now_ns() - t0) / 1e9;
+
+    bool ok = s.errors == 0 && spsc_count(&s.q) == 0;
+    printf("Estresse: %d elementos de %zu B, capacidade %d\n",
+           STRESS_ITEMS, sizeof(item_t), STRESS_CAPACITY);
+    printf("  %.2f s, %.1f M elementos/s, fila cheia %llu vezes, vazia %llu vezes\n",
+           secs, STRESS_ITEMS / secs / 1e6,
+           (unsigned long long)s.full_spins, (unsigned long long)s.empty_spins);
+    printf("  erros de ordem/conteúdo: %llu  -> %s\n\n",
+           (unsigned long long)s.errors, ok ? "OK" : "FALHA");
+    return ok;
+}
+
+// ============================================================================
+// LATÊNCIA PUSH -> POP
+// ============================================================================
+
+typedef struct {
+    uint64_t seq;
+    uint64_t t_ns;              // Instante do push
+} stamp_t;
+
+typedef struct {
+    spsc_queue_t q;
+    uint64_t latency[LATENCY_ITEMS];
+    int received;
+} latency_t;
+
+static void* latency_producer(void* arg) {
+    latency_t* l = arg;
+    uint64_t next = now_ns();
+    for (int i = 0; i < LATENCY_ITEMS; i++) {
+        next += LATENCY_PERIOD_NS;
+        sleep_until_ns(next);
+        stamp_t st = { .seq = i, .t_ns = now_ns() };
+        while (!spsc_push(&l->q, &st)) sched_yield();
+    }
+    return NULL;
+}
+
+static void* latency_consumer(void* arg) {
+    latency_t* l = arg;
+    while (l->received < LATENCY_ITEMS) {
+        stamp_t st;
+        if (!spsc_pop(&l->q, &st)) {
+            sched_yield();
+            continue;
+        }
+        l->latency[l->received++] = now_ns() - st.t_ns;
+    }
+    return NULL;
+}
+
+static void run_latency(void) {
+    static stamp_t storage[64];
+    static latency_t l;
+    spsc_init(&l.q, storage, 64, sizeof(stamp_t));
+
+    pthread_t prod, cons;
+    pthread_create(&cons, NULL, latency_consumer, &l);
+    pthread_create(&prod, NULL, latency_producer, &l);
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+
+    qsort(l.latency, LATENCY_ITEMS, sizeof(uint64_t), cmp_u64);
+    printf("Latência push -> pop (%d elementos, um a cada %d us)\n",
+           LATENCY_ITEMS, LATENCY_PERIOD_NS / 1000);
+    printf("  p50 %.1f us  p99 %.1f us  p99.9 %.1f us  máx %.1f us\n\n",
+           l.latency[LATENCY_ITEMS / 2] / 1e3,
+           l.latency[LATENCY_ITEMS * 99 / 100] / 1e3,
+           l.latency[LATENCY_ITEMS * 999 / 1000] / 1e3,
+           l.latency[LATENCY_ITEMS - 1] / 1e3);
+}
+
+// ============================================================================
+// JITTER DE AMOSTRAGEM: UM NÚCLEO x DOIS NÚCLEOS
+// ============================================================================
+
+/**
+ * @brief Duração da "transmissão" da amostra i, em escala 1:100
+ *
+ * A maioria dos pacotes fica 0.4-1.0 ms no ar (41-100 ms em SF7); um em
+ * cada 20 espera 30 ms, como um lote grande em SF12 ou o orçamento de duty
+ * cycle esgotado, e passa do período.
+ */
+static uint64_t tx_time_ns(int i) {
+    uint32_t h = (uint32_t)i * 2654435761u;
+    if ((h >> 4) % 20 == 0) return 30000000;
+    return 400000 + (h >> 8) % 600000;
+}
+
+typedef struct {
+    double mean_ms;
+    double p50_us;              // |intervalo - período|
+    double p99_us;
+    double max_us;
+} jitter_t;
+
+static jitter_t jitter_stats(const uint64_t* t, int n) {
+    static uint64_t err[JITTER_SAMPLES];
+    jitter_t j = { 0 };
+    for (int i = 1; i < n; i++) {
+        int64_t d = (int64_t)(t[i] - t[i - 1]);
+        err[i - 1] = (uint64_t)llabs(d - JITTER_PERIOD_NS);
+    }
+    qsort(err, n - 1, sizeof(uint64_t), cmp_u64);
+    j.mean_ms = (t[n - 1] - t[0]) / 1e6 / (n - 1);
+    j.p50_us = err[(n - 1) / 2] / 1e3;
+    j.p99_us = err[(n - 1) * 99 / 100] / 1e3;
+    j.max_us = err[n - 2] / 1e3;
+    return j;
+}
+
+static uint64_t sample_time[JITTER_SAMPLES];
+
+/**
+ * @brief Laço de um núcleo: ler, transmitir, dormir o período
+ */
+static jitter_t run_single_core(void) {
+    for (int i = 0; i < JITTER_SAMPLES; i++) {
+        sample_time[i] = now_ns();                  // read_sensors()
+        sleep_ns(tx_time_ns(i));                    // send_reading()
+        sleep_ns(JITTER_PERIOD_NS);                 // sleep_ms(SAMPLE_PERIOD_MS)
+    }
+    return jitter_stats(sample_time, JITTER_SAMPLES);
+}
+
+typedef struct {
+    spsc_queue_t q;
+    int dropped;
+    int sent;
+    uint64_t max_latency_ns;    // Da leitura ao início da transmissão
+} pipeline_t;
+
+static void* pipeline_producer(void* arg) {
+    pipeline_t* p = arg;
+    uint64_t next = now_ns();
+    for (int i = 0; i < JITTER_SAMPLES; i++) {
+        stamp_t st = { .seq = i, .t_ns = now_ns() };
+        sample_time[i] = st.t_ns;
+        if (!spsc_push(&p->q, &st)) p->dropped++;
+
+        next += JITTER_PERIOD_NS;                   // sleep_until(delayed_by_ms())
+        sleep_until_ns(next);
+    }
+    return NULL;
+}
+
+static void* pipeline_consumer(void* arg) {
+    pipeline_t* p = arg;
+    while (p->sent + p->dropped < JITTER_SAMPLES) {
+        stamp_t st;
+        if (!spsc_pop(&p->q, &st)) {
+            sleep_ns(20000);                        // __wfe()
+            continue;
+        }
+        uint64_t latency = now_ns() - st.t_ns;
+        if (latency > p->max_latency_ns) p->max_latency_ns = latency;
+        sleep_ns(tx_time_ns((int)st.seq));
+        p->sent++;
+    }
+    return NULL;
+}
+
+static jitter_t run_dual_core(pipeline_t* p) {
+    static stamp_t storage[JITTER_CAPACITY];
+    memset(p, 0, sizeof(*p));
+    spsc_init(&p->q, storage, JITTER_CAPACITY, sizeof(stamp_t));
+
+    pthread_t prod, cons;
+    pthread_create(&cons, NULL, pipeline_consumer, p);
+    pthread_create(&prod, NULL, pipeline_producer, p);
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+    return jitter_stats(sample_time, JITTER_SAMPLES);
+}
+
+static void run_jitter(void) {
+    printf("Jitter de amostragem (%d leituras, período %.0f ms, escala 1:100)\n",
+           JITTER_SAMPLES, JITTER_PERIOD_NS / 1e6);
+    printf("  |intervalo - período| entre leituras consecutivas\n");
+    printf("  %-12s %14s %10s %10s %10s\n", "Laço", "Intervalo (ms)", "p50 (us)", "p99 (us)", "máx (us)");
+
+    jitter_t s = run_single_core();
+    printf("  %-12s %14.3f %10.1f %10.1f %10.1f\n", "1 núcleo", s.mean_ms, s.p50_us, s.p99_us, s.max_us);
+
+    pipeline_t p;
+    jitter_t d = run_dual_core(&p);
+    printf("  %-12s %14.3f %10.1f %10.1f %10.1f\n", "2 núcleos", d.mean_ms, d.p50_us, d.p99_us, d.max_us);
+    printf("  2 núcleos: %d transmitidas, %d descartadas, maior espera na fila %.2f ms\n",
+           p.sent, p.dropped, p.max_latency_ns / 1e6);
+}
+
+int main(void) {
+    bool ok = run_stress();
+    run_latency();
+    run_jitter();
+    return ok ? 0 : 1;
+}
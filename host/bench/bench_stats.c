@@ -0,0 +1,232 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "sim.h"
+#include "rfm95.h"
+#include "frame.h"
+#include "stats.h"
+
+// ============================================================================
+// ESTATÍSTICAS DE JANELA: WELFORD EM INTEIROS
+// ============================================================================
+// 1. Janelas aleatórias de 1 a 2000 leituras (temperatura, umidade e pressão
+//    sintéticas): contagem, mínimo, máximo e última exatos; média e desvio
+//    padrão contra a referência em double de duas passadas.
+// 2. Estabilidade numérica em séries longas (10^7 leituras) com média grande
+//    e variação pequena, o caso em que Σx² - (Σx)²/n cancela: Welford em
+//    inteiros contra a mesma soma ingênua em float e em double.
+// 3. Quadro de resumo: ida e volta e tempo no ar de um resumo contra uma
+//    leitura por quadro para a mesma janela.
+
+#define NUM_WINDOWS         2000
+#define MAX_WINDOW          2000
+#define LONG_SERIES         10000000
+#define SUMMARY_WINDOW      30
+
+static uint32_t rng_state = 12345;
+
+static uint32_t rng(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return rng_state >> 8;
+}
+
+// Ruído aproximadamente gaussiano (soma de 4 uniformes), amplitude ±amp
+static int32_t noise(int32_t amp) {
+    int32_t s = 0;
+    for (int i = 0; i < 4; i++) {
+        s += (int32_t)(rng() % (2 * amp + 1)) - amp;
+    }
+    return s / 2;
+}
+
+typedef struct {
+    double mean;
+    double stddev;
+} reference_t;
+
+static reference_t two_pass(const int32_t* x, int n) {
+    double sum = 0;
+    for (int i = 0; i < n; i++) sum += x[i];
+    double mean = sum / n;
+    double m2 = 0;
+    for (int i = 0; i < n; i++) m2 += (x[i] - mean) * (x[i] - mean);
+    reference_t r = { mean, n > 1 ? sqrt(m2 / (n - 1)) : 0 };
+    return r;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+ * @brief Janelas aleatórias contra a referência de duas passadas
+ *
+ * A média e o desvio inteiros são arredondados para a unidade do canal, então
+ * o erro esperado é de até 0.5 unidade mais o erro de arredondamento interno.
+ */
+static bool check_windows(void) {
+    static int32_t x[MAX_WINDOW];
+    const int32_t base[3] = { 2350, 5500, 94300 };     // Centésimos de °C, centésimos de %RH, Pa
+    const int32_t amp[3] = { 300, 800, 150 };
+    const char* names[3] = { "temperatura", "umidade", "pressao" };
+    bool ok = true;
+
+    printf("Janelas aleatórias (%d por canal, até %d leituras)\n", NUM_WINDOWS, MAX_WINDOW);
+    for (int ch = 0; ch < 3; ch++) {
+        double err_mean = 0, err_sd = 0;
+        int exact_fail = 0;
+        for (int w = 0; w < NUM_WINDOWS; w++) {
+            int n = 1 + (int)(rng() % MAX_WINDOW);
+            stats_channel_t c;
+            stats_reset(&c);
+            int32_t lo = INT32_MAX, hi = INT32_MIN;
+            for (int i = 0; i < n; i++) {
+                x[i] = base[ch] + noise(amp[ch]) + (int32_t)(i * amp[ch] / n);    // Com tendência
+                stats_add(&c, x[i]);
+                if (x[i] < lo) lo = x[i];
+                if (x[i] > hi) hi = x[i];
+            }
+            reference_t ref = two_pass(x, n);
+            err_mean = fmax(err_mean, fabs(stats_mean(&c) - ref.mean));
+            err_sd = fmax(err_sd, fabs(stats_stddev(&c) - ref.stddev));
+            if (c.count != (uint32_t)n || c.min != lo || c.max != hi || c.last != x[n - 1]) {
+                exact_fail++;
+            }
+        }
+        bool ch_ok = exact_fail == 0 && err_mean <= 0.501 && err_sd <= 0.51;
+        printf("  %-12s erro máx: média %.3f, desvio %.3f unidades; min/max/última/contagem %s\n",
+               names[ch], err_mean, err_sd, exact_fail ? "DIVERGEM" : "exatos");
+        ok = ok && ch_ok;
+    }
+    return ok;
+}
+
+/**
+ * @brief Série longa: pressão em Pa em torno de 101325 com variação de poucos Pa
+ */
+static bool check_long_series(void) {
+    stats_channel_t c;
+    stats_reset(&c);
+    float f_sum = 0, f_sum2 = 0;
+    double d_sum = 0, d_sum2 = 0;
+
+    // Referência de duas passadas sem guardar a série: a mesma sequência é
+    // gerada duas vezes
+    double ref_sum = 0;
+    uint32_t seed = rng_state;
+    for (int i = 0; i < LONG_SERIES; i++) {
+        int32_t v = 101325 + noise(8) + (int32_t)(20 * sin(i * 1e-5));
+        ref_sum += v;
+    }
+    double ref_mean = ref_sum / LONG_SERIES;
+
+    rng_state = seed;
+    double ref_m2 = 0;
+    for (int i = 0; i < LONG_SERIES; i++) {
+        int32_t v = 101325 + noise(8) + (int32_t)(20 * sin(i * 1e-5));
+        stats_add(&c, v);
+        f_sum += v;
+        f_sum2 += (float)v * v;
+        d_sum += v;
+        d_sum2 += (double)v * v;
+        ref_m2 += (v - ref_mean) * (v - ref_mean);
+    }
+    double ref_sd = sqrt(ref_m2 / (LONG_SERIES - 1));
+
+    double n = LONG_SERIES;
+    double f_var = ((double)f_sum2 - (double)f_sum * f_sum / n) / (n - 1);
+    double d_var = (d_sum2 - d_sum * d_sum / n) / (n - 1);
+    double w_mean = (double)c.mean_q / (1 << STATS_FRAC_BITS);
+    double w_sd = sqrt((double)stats_variance_q(&c) / (1 << STATS_FRAC_BITS));
+
+    // Custo de stats_add sem o gerador: a mesma janela de leituras repetida
+    static int32_t window[4096];
+    for (int i = 0; i < 4096; i++) window[i] = 101325 + noise(8);
+    stats_channel_t t;
+    stats_reset(&t);
+    uint64_t t0 = now_ns();
+    for (int k = 0; k < 1000; k++) {
+        for (int i = 0; i < 4096; i++) stats_add(&t, window[i]);
+    }
+    double add_ns = (double)(now_ns() - t0) / (1000 * 4096);
+    volatile int32_t sink = stats_mean(&t);
+    (void)sink;
+
+    printf("\nSérie longa: %d leituras de pressão (média %.4f Pa, desvio %.4f Pa)\n",
+           LONG_SERIES, ref_mean, ref_sd);
+    printf("  %-22s %12s %12s\n", "método", "erro média", "desvio");
+    printf("  %-22s %12.6f %12.6f\n", "Welford inteiro", fabs(w_mean - ref_mean), w_sd);
+    printf("  %-22s %12.6f %12.6f\n", "soma ingênua float", fabs(f_sum / n - ref_mean), sqrt(fabs(f_var)));
+    printf("  %-22s %12.6f %12.6f\n", "soma ingênua double", fabs(d_sum / n - ref_mean), sqrt(fabs(d_var)));
+    printf("  stats_add: %.1f ns por leitura no host\n", add_ns);
+
+    return fabs(w_mean - ref_mean) < 0.001 && fabs(w_sd - ref_sd) < 0.001;
+}
+
+/**
+ * @brief Resumo de uma janela no quadro: ida e volta e tempo no ar
+ */
+static bool check_summary_frame(void) {
+    stats_channel_t ch[3];
+    for (int i = 0; i < 3; i++) stats_reset(&ch[i]);
+    for (int i = 0; i < SUMMARY_WINDOW; i++) {
+        stats_add(&ch[0], 2350 + noise(30));
+        stats_add(&ch[1], 5500 + noise(100));
+        stats_add(&ch[2], 94300 + noise(20));
+    }
+
+    frame_summary_t s = {
+        .station_id = 1, .sequence = 42, .fields = FRAME_FIELDS_ALL,
+        .count = SUMMARY_WINDOW, .span_ms = (SUMMARY_WINDOW - 1) * 2000,
+    };
+    frame_stat_t* dst[3] = { &s.temperature, &s.humidity, &s.pressure };
+    for (int i = 0; i < 3; i++) {
+        dst[i]->last = ch[i].last;
+        dst[i]->mean = stats_mean(&ch[i]);
+        dst[i]->min = ch[i].min;
+        dst[i]->max = ch[i].max;
+        dst[i]->stddev = stats_stddev(&ch[i]);
+    }
+
+    uint8_t buf[FRAME_SUMMARY_MAX_SIZE];
+    int len = frame_encode_summary(&s, buf, sizeof(buf));
+    frame_summary_t d;
+    bool ok = len == FRAME_SUMMARY_MAX_SIZE && frame_decode_summary(buf, len, &d) &&
+              d.count == s.count && d.span_ms == s.span_ms && d.fields == s.fields &&
+              d.temperature.mean == s.temperature.mean && d.temperature.stddev == s.temperature.stddev &&
+              d.humidity.min == s.humidity.min && d.humidity.max == s.humidity.max &&
+              abs(d.pressure.mean - s.pressure.mean) <= 5 && abs(d.pressure.last - s.pressure.last) <= 5;
+
+    // Quadro sem pressão e quadro truncado
+    s.fields = FRAME_FIELD_TEMPERATURE | FRAME_FIELD_HUMIDITY;
+    int len2 = frame_encode_summary(&s, buf, sizeof(buf));
+    ok = ok && len2 == FRAME_SUMMARY_MAX_SIZE - FRAME_SUMMARY_STAT_SIZE &&
+         frame_decode_summary(buf, len2, &d) && d.pressure.mean == 0 &&
+         !frame_decode_summary(buf, len2 - 1, &d);
+
+    sim_reset();
+    rfm95_initialize();
+    uint32_t t_summary = rfm95_time_on_air_us((uint8_t)len);
+    uint32_t t_reading = rfm95_time_on_air_us(FRAME_READING_MAX_SIZE);
+
+    printf("\nJanela de %d leituras: resumo %d bytes (%.1f ms no ar) contra %d quadros de %d bytes (%.1f ms)\n",
+           SUMMARY_WINDOW, len, t_summary / 1000.0, SUMMARY_WINDOW, FRAME_READING_MAX_SIZE,
+           SUMMARY_WINDOW * t_reading / 1000.0);
+    printf("  tempo no ar por janela %.1fx menor; o resumo custa %.2fx uma leitura\n",
+           (double)SUMMARY_WINDOW * t_reading / t_summary, (double)t_summary / t_reading);
+    printf("  ida e volta do quadro de resumo: %s\n", ok ? "OK" : "FALHA");
+    return ok;
+}
+
+int main(void) {
+    bool ok = check_windows();
+    ok = check_long_series() && ok;
+    ok = check_summary_frame() && ok;
+    printf("%s\n", ok ? "OK" : "FALHA");
+    return ok ? 0 : 1;
+}
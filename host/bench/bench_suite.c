@@ -0,0 +1,535 @@
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "sim.h"
+#include "rfm95.h"
+#include "aht20.h"
+#include "bmp280.h"
+#include "frame.h"
+#include "json.h"
+
+// ============================================================================
+// SUÍTE DE MICRO-BENCHMARKS
+// ============================================================================
+// Conversões dos sensores, codificação do payload e envio pelo driver do
+// rádio sobre o SX1276 simulado. Cada caso:
+//   1. Aquecimento: dobra o número de operações por repetição até a
+//      repetição passar de REP_MIN_NS (caches e preditores já aquecidos)
+//   2. Repetições: REPEATS medidas de ns por operação (relógio real)
+//   3. Resumo: mínimo, mediana, média, desvio padrão e máximo
+//
+// O host não é um Cortex-M0+, então cada caso também é informado em:
+//   relativo     mediana da razão entre cada repetição e uma repetição da
+//                "referencia" (laço de multiplicação e soma de 32 bits) feita
+//                logo antes; menos sensível à máquina e à frequência do momento
+//   instrucoes   instruções por operação (perf_event_open), quando o kernel
+//                permite; é a métrica menos ruidosa para comparar commits
+//   sim_*        para o rádio, tempo virtual ocupado e bytes SPI por envio,
+//                exatos para o RP2040 no clock SPI configurado
+//
+// Uma linha JSON por caso (-o) e comparação com um arquivo anterior (-c):
+// só as métricas determinísticas decidem, piora acima da tolerância em
+// instrucoes ou qualquer aumento em sim_* => FALHA. O relativo varia até
+// ±50% entre execuções em máquina compartilhada e só gera AVISO.
+//
+//   bench_suite -o base.jsonl
+//   bench_suite -c base.jsonl -t 5
+
+#define REPEATS         15
+#define REP_MIN_NS      2000000         // 2 ms por repetição
+#define NUM_INPUTS      1024
+#define TOLERANCE_PCT   5.0             // instrucoes
+#define RELATIVE_WARN_PCT 50.0          // relativo: acima do ruído medido entre execuções
+#define MAX_CASES       16
+
+typedef struct {
+    const char* name;
+    void (*run)(uint32_t ops);
+    bool radio;                         // Usa o simulador: coleta sim_*
+} bench_case_t;
+
+typedef struct {
+    const char* name;
+    uint32_t ops;
+    double ns_min, ns_median, ns_mean, ns_stddev, ns_max;
+    double relative;
+    double instructions;                // < 0: indisponível
+    double busy_us, spi_bytes;          // < 0: não se aplica
+} bench_result_t;
+
+static struct bmp280_calib_param params = {
+    .dig_t1 = 27504, .dig_t2 = 26435, .dig_t3 = -1000,
+    .dig_p1 = 36477, .dig_p2 = -10685, .dig_p3 = 3024, .dig_p4 = 2855,
+    .dig_p5 = 140, .dig_p6 = -7, .dig_p7 = 15500, .dig_p8 = -14600, .dig_p9 = 6000,
+};
+
+static int32_t raw_t[NUM_INPUTS], raw_p[NUM_INPUTS];
+static uint32_t raw_h[NUM_INPUTS], raw_at[NUM_INPUTS], pressure[NUM_INPUTS];
+static int16_t temperatura[NUM_INPUTS];
+static uint16_t umidade[NUM_INPUTS];
+static volatile uint32_t sink;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// ============================================================================
+// CONTADOR DE INSTRUÇÕES
+// ============================================================================
+
+static int perf_fd = -1;
+
+static void perf_open(void) {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    perf_fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (perf_fd < 0) {
+        fprintf(stderr, "contador de instruções indisponível (perf_event_open: %s)\n", strerror(errno));
+    }
+#endif
+}
+
+static void perf_start(void) {
+#ifdef __linux__
+    if (perf_fd >= 0) {
+        ioctl(perf_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+static int64_t perf_stop(void) {
+#ifdef __linux__
+    long long count;
+    if (perf_fd >= 0) {
+        ioctl(perf_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(perf_fd, &count, sizeof(count)) == sizeof(count)) {
+            return count;
+        }
+    }
+#endif
+    return -1;
+}
+
+// ============================================================================
+// CASOS
+// ============================================================================
+
+static void run_reference(uint32_t ops) {
+    uint32_t acc = sink;
+    for (uint32_t i = 0; i < ops; i++) {
+        acc = acc * 1664525u + raw_h[i % NUM_INPUTS];
+    }
+    sink = acc;
+}
+
+static void run_convert_temp(uint32_t ops) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < ops; i++) {
+        acc += (uint32_t)bmp280_convert_temp(raw_t[i % NUM_INPUTS], &params);
+    }
+    sink = acc;
+}
+
+static void run_convert_pressure(uint32_t ops) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < ops; i++) {
+        acc += (uint32_t)bmp280_convert_pressure(raw_p[i % NUM_INPUTS], raw_t[i % NUM_INPUTS], &params);
+    }
+    sink = acc;
+}
+
+static void run_compensate(uint32_t ops) {
+    uint32_t acc = 0;
+    bmp280_reading_t out;
+    for (uint32_t i = 0; i < ops; i++) {
+        bmp280_compensate(raw_t[i % NUM_INPUTS], raw_p[i % NUM_INPUTS], &params, &out);
+        acc += (uint32_t)out.temperature + out.pressure;
+    }
+    sink = acc;
+}
+
+static void run_altitude(uint32_t ops) {
+    double acc = 0;
+    for (uint32_t i = 0; i < ops; i++) {
+        acc += calculate_altitude(pressure[i % NUM_INPUTS]);
+    }
+    sink = (uint32_t)acc;
+}
+
+static void run_altitude_cm(uint32_t ops) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < ops; i++) {
+        acc += (uint32_t)bmp280_altitude_cm(pressure[i % NUM_INPUTS]);
+    }
+    sink = acc;
+}
+
+static void run_aht20_convert(uint32_t ops) {
+    float acc = 0;
+    AHT20_Data data;
+    for (uint32_t i = 0; i < ops; i++) {
+        aht20_convert(raw_h[i % NUM_INPUTS], raw_at[i % NUM_INPUTS], &data);
+        acc += data.temperature + data.humidity;
+    }
+    sink = (uint32_t)acc;
+}
+
+static void run_aht20_convert_fixed(uint32_t ops) {
+    uint32_t acc = 0;
+    AHT20_Fixed data;
+    for (uint32_t i = 0; i < ops; i++) {
+        aht20_convert_fixed(raw_h[i % NUM_INPUTS], raw_at[i % NUM_INPUTS], &data);
+        acc += (uint32_t)data.temperature + data.humidity;
+    }
+    sink = acc;
+}
+
+// Formato de main.c antes do json_encode(), com as globais em float
+static void run_json_snprintf(uint32_t ops) {
+    uint32_t acc = 0;
+    char buffer[JSON_READING_MAX_SIZE];
+    for (uint32_t i = 0; i < ops; i++) {
+        uint32_t k = i % NUM_INPUTS;
+        acc += (uint32_t)snprintf(buffer, sizeof(buffer),
+                                  "{\"temperatura\":%.2f,\"pressao\":%d,\"umidade\":%.2f}\r\n",
+                                  temperatura[k] / 100.0f, (int)(pressure[k] / 1000), umidade[k] / 100.0f);
+    }
+    sink = acc;
+}
+
+static void run_json_encode(uint32_t ops) {
+    uint32_t acc = 0;
+    uint8_t buffer[JSON_READING_MAX_SIZE];
+    for (uint32_t i = 0; i < ops; i++) {
+        uint32_t k = i % NUM_INPUTS;
+        acc += (uint32_t)json_encode(temperatura[k], (int32_t)(pressure[k] / 1000), umidade[k],
+                                     buffer, sizeof(buffer));
+    }
+    sink = acc;
+}
+
+static void run_frame_encode(uint32_t ops) {
+    uint32_t acc = 0;
+    uint8_t buffer[FRAME_READING_MAX_SIZE];
+    frame_reading_t reading = { .station_id = 1, .fields = FRAME_FIELDS_ALL };
+    for (uint32_t i = 0; i < ops; i++) {
+        uint32_t k = i % NUM_INPUTS;
+        reading.sequence = (uint16_t)i;
+        reading.temperature = temperatura[k];
+        reading.humidity = umidade[k];
+        reading.pressure = pressure[k];
+        acc += (uint32_t)frame_encode(&reading, buffer, sizeof(buffer));
+    }
+    sink = acc;
+}
+
+static void run_transmit(uint32_t ops) {
+    uint8_t payload[FRAME_READING_MAX_SIZE];
+    memset(payload, 0x5A, sizeof(payload));
+    for (uint32_t i = 0; i < ops; i++) {
+        payload[0] = (uint8_t)i;
+        rfm95_transmit(payload, sizeof(payload));
+    }
+}
+
+static const bench_case_t cases[] = {
+    { "referencia",               run_reference,           false },
+    { "bmp280_convert_temp",      run_convert_temp,        false },
+    { "bmp280_convert_pressure",  run_convert_pressure,    false },
+    { "bmp280_compensate",        run_compensate,          false },
+    { "calculate_altitude",       run_altitude,            false },
+    { "bmp280_altitude_cm",       run_altitude_cm,         false },
+    { "aht20_convert",            run_aht20_convert,       false },
+    { "aht20_convert_fixed",      run_aht20_convert_fixed, false },
+    { "json_snprintf",            run_json_snprintf,       false },
+    { "json_encode",              run_json_encode,         false },
+    { "frame_encode",             run_frame_encode,        false },
+    { "rfm95_transmit",           run_transmit,            true  },
+};
+
+#define NUM_CASES (sizeof(cases) / sizeof(cases[0]))
+
+static void make_inputs(void) {
+    uint32_t rng = 12345;
+    for (int i = 0; i < NUM_INPUTS; i++) {
+        rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+        // Em torno da leitura de exemplo do datasheet (25 °C, 1006 hPa)
+        raw_t[i] = 519888 + (int32_t)(rng % 65536) - 32768;
+        raw_p[i] = 415148 + (int32_t)((rng >> 8) % 65536) - 32768;
+        raw_h[i] = rng & 0xFFFFF;
+        raw_at[i] = (rng >> 12) & 0xFFFFF;
+        pressure[i] = 80000 + (rng >> 4) % 30000;
+        temperatura[i] = (int16_t)((int32_t)(rng % 9000) - 2000);
+        umidade[i] = (uint16_t)((rng >> 16) % 10001);
+    }
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * @brief Aquece: operações por repetição para passar de REP_MIN_NS
+ */
+static uint32_t warm_up(void (*run)(uint32_t ops)) {
+    uint32_t ops = 1;
+    for (;;) {
+        uint64_t t0 = now_ns();
+        run(ops);
+        if (now_ns() - t0 >= REP_MIN_NS || ops >= (1u << 30)) return ops;
+        ops *= 2;
+    }
+}
+
+static double time_ns(void (*run)(uint32_t ops), uint32_t ops) {
+    uint64_t t0 = now_ns();
+    run(ops);
+    return (double)(now_ns() - t0) / ops;
+}
+
+/**
+ * @brief Aquece, repete e resume um caso
+ *
+ * Cada repetição é precedida por uma da referência, para que "relativo"
+ * compare as duas no mesmo estado de clock da CPU do host.
+ */
+static bench_result_t measure(const bench_case_t* c, uint32_t reference_ops) {
+    bench_result_t r = { .name = c->name, .instructions = -1, .busy_us = -1, .spi_bytes = -1 };
+
+    if (c->radio) {
+        sim_reset();
+        rfm95_initialize();
+    }
+
+    uint32_t ops = warm_up(c->run);
+    r.ops = ops;
+
+    double ns[REPEATS], ratio[REPEATS];
+    int64_t best_instructions = -1;
+    sim_stats_t sim_start = sim_stats();
+    for (int rep = 0; rep < REPEATS; rep++) {
+        double reference = time_ns(run_reference, reference_ops);
+        perf_start();
+        ns[rep] = time_ns(c->run, ops);
+        int64_t count = perf_stop();
+        ratio[rep] = ns[rep] / reference;
+        if (count >= 0 && (best_instructions < 0 || count < best_instructions)) {
+            best_instructions = count;
+        }
+    }
+    if (c->radio) {
+        sim_stats_t d = sim_stats_since(&sim_start);
+        double sent = (double)ops * REPEATS;
+        r.busy_us = (d.time_ns - d.sleep_ns) / 1e3 / sent;
+        r.spi_bytes = d.spi_bytes / sent;
+    }
+    if (best_instructions >= 0) {
+        r.instructions = (double)best_instructions / ops;
+    }
+
+    double sum = 0, sq = 0;
+    for (int i = 0; i < REPEATS; i++) sum += ns[i];
+    r.ns_mean = sum / REPEATS;
+    for (int i = 0; i < REPEATS; i++) sq += (ns[i] - r.ns_mean) * (ns[i] - r.ns_mean);
+    r.ns_stddev = sqrt(sq / (REPEATS - 1));
+    qsort(ns, REPEATS, sizeof(double), compare_double);
+    r.ns_min = ns[0];
+    r.ns_median = ns[REPEATS / 2];
+    r.ns_max = ns[REPEATS - 1];
+    qsort(ratio, REPEATS, sizeof(double), compare_double);
+    r.relative = ratio[REPEATS / 2];
+    return r;
+}
+
+// ============================================================================
+// JSON LINES
+// ============================================================================
+
+static void print_optional(FILE* f, const char* key, double value, const char* format) {
+    fprintf(f, ",\"%s\":", key);
+    if (value < 0) {
+        fprintf(f, "null");
+    } else {
+        fprintf(f, format, value);
+    }
+}
+
+static void write_json(FILE* f, const bench_result_t* r) {
+    fprintf(f, "{\"nome\":\"%s\",\"ops\":%u,\"repeticoes\":%d,\"ns_min\":%.3f,\"ns_mediana\":%.3f,"
+               "\"ns_media\":%.3f,\"ns_desvio\":%.3f,\"ns_max\":%.3f,\"relativo\":%.4f",
+            r->name, r->ops, REPEATS, r->ns_min, r->ns_median, r->ns_mean, r->ns_stddev, r->ns_max,
+            r->relative);
+    print_optional(f, "instrucoes", r->instructions, "%.1f");
+    print_optional(f, "sim_ocupado_us", r->busy_us, "%.3f");
+    print_optional(f, "spi_bytes", r->spi_bytes, "%.1f");
+    fprintf(f, "}\n");
+}
+
+/**
+ * @brief Número do campo "key" de uma linha JSON; false se ausente ou null
+ */
+static bool json_number(const char* line, const char* key, double* value) {
+    char pattern[48];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char* p = strstr(line, pattern);
+    if (p == NULL) {
+        return false;
+    }
+    char* end;
+    *value = strtod(p + strlen(pattern), &end);
+    return end != p + strlen(pattern);
+}
+
+/**
+ * @brief Compara uma métrica; true se piorou além da tolerância
+ * 
+ * @param gate false: a piora só é informada como AVISO
+ */
+static bool compare_metric(const char* name, const char* key, const char* line, double now,
+                           double tolerance, bool gate) {
+    double before;
+    if (now < 0 || !json_number(line, key, &before) || before <= 0) {
+        return false;
+    }
+    double change = 100.0 * (now - before) / before;
+    bool worse = change > tolerance;
+    printf("%-24s %-15s %12.3f %12.3f %+8.1f%%  %s\n", name, key, before, now, change,
+           !worse ? "OK" : gate ? "FALHA" : "AVISO");
+    return worse;
+}
+
+/**
+ * @brief Compara os resultados com um arquivo anterior
+ *
+ * Só métricas determinísticas contam como regressão: instruções quando as
+ * duas execuções as têm e os contadores do simulador (qualquer aumento). O
+ * tempo relativo à referência é ruidoso demais para decidir e só avisa.
+ *
+ * @param warnings Pioras do relativo acima de RELATIVE_WARN_PCT
+ * @return Número de regressões, ou -1 se o arquivo não pôde ser lido
+ */
+static int compare(const char* path, const bench_result_t* results, int count, double tolerance,
+                   int* warnings) {
+    FILE* f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    printf("\n%-24s %-15s %12s %12s %9s\n", "caso", "metrica", "antes", "agora", "variacao");
+    int regressions = 0;
+    char line[1024];
+    while (fgets(line, sizeof(line), f)) {
+        for (int i = 0; i < count; i++) {
+            const bench_result_t* r = &results[i];
+            char key[64];
+            snprintf(key, sizeof(key), "\"nome\":\"%s\"", r->name);
+            if (strstr(line, key) == NULL || strcmp(r->name, "referencia") == 0) {
+                continue;
+            }
+            regressions += compare_metric(r->name, "instrucoes", line, r->instructions, tolerance, true);
+            *warnings += compare_metric(r->name, "relativo", line, r->relative, RELATIVE_WARN_PCT, false);
+            regressions += compare_metric(r->name, "sim_ocupado_us", line, r->busy_us, 0, true);
+            regressions += compare_metric(r->name, "spi_bytes", line, r->spi_bytes, 0, true);
+        }
+    }
+    fclose(f);
+    return regressions;
+}
+
+static void usage(void) {
+    fprintf(stderr,
+            "uso: bench_suite [-o resultados.jsonl] [-c anterior.jsonl] [-t tolerancia_%%] [-f filtro]\n");
+}
+
+int main(int argc, char** argv) {
+    const char* output = NULL;
+    const char* baseline = NULL;
+    const char* filter = NULL;
+    double tolerance = TOLERANCE_PCT;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "-o") == 0) {
+            output = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "-c") == 0) {
+            baseline = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "-t") == 0) {
+            tolerance = atof(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "-f") == 0) {
+            filter = argv[++i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    make_inputs();
+    perf_open();
+    uint32_t reference_ops = warm_up(run_reference);
+
+    bench_result_t results[MAX_CASES];
+    int count = 0;
+    printf("%-24s %10s %10s %10s %10s %10s %9s %10s %10s %9s\n", "caso", "ops/rep", "ns_min",
+           "ns_mediana", "ns_desvio", "ns_max", "relativo", "instrucoes", "ocupado_us", "spi_bytes");
+    for (size_t i = 0; i < NUM_CASES; i++) {
+        if (filter && strstr(cases[i].name, filter) == NULL) {
+            continue;
+        }
+        bench_result_t* r = &results[count++];
+        *r = measure(&cases[i], reference_ops);
+        printf("%-24s %10u %10.2f %10.2f %10.2f %10.2f %9.2f", r->name, r->ops, r->ns_min,
+               r->ns_median, r->ns_stddev, r->ns_max, r->relative);
+        r->instructions < 0 ? printf(" %10s", "-") : printf(" %10.1f", r->instructions);
+        r->busy_us < 0 ? printf(" %10s %9s\n", "-", "-") : printf(" %10.1f %9.1f\n", r->busy_us, r->spi_bytes);
+    }
+
+    if (output) {
+        FILE* f = fopen(output, "w");
+        if (f == NULL) {
+            fprintf(stderr, "%s: %s\n", output, strerror(errno));
+            return 1;
+        }
+        for (int i = 0; i < count; i++) {
+            write_json(f, &results[i]);
+        }
+        fclose(f);
+        printf("\nResultados em %s\n", output);
+    }
+
+    if (baseline) {
+        int warnings = 0;
+        int regressions = compare(baseline, results, count, tolerance, &warnings);
+        if (regressions < 0) {
+            return 1;
+        }
+        if (warnings) {
+            printf("%d avisos: relativo piorou mais de %.0f%% (ruído do host, não falha)\n",
+                   warnings, RELATIVE_WARN_PCT);
+        }
+        printf("%d regressões (instrucoes acima de %.1f%%, sim_* acima de 0%%): %s\n", regressions, tolerance,
+               regressions ? "FALHA" : "OK");
+        return regressions ? 1 : 0;
+    }
+    return 0;
+}
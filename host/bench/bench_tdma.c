@@ -0,0 +1,279 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "rfm95.h"
+#include "frame.h"
+#include "tdma.h"
+
+// ============================================================================
+// CANAL COMPARTILHADO: TRANSMISSÃO LIVRE x TDMA COM BEACON
+// ============================================================================
+// Centenas de estações virtuais transmitem um quadro de leitura (11 bytes,
+// SF7) por período. Cada estação liga em um instante aleatório e tem o seu
+// cristal: deriva fixa de até ±30 ppm mais uma variação térmica lenta de
+// ±2 ppm. O período é o do quadro TDMA para o mesmo número de estações, ou
+// seja, a mesma carga oferecida nos dois casos.
+//
+// livre      : o laço atual, um envio a cada período do relógio local desde
+//              o boot; as fases se espalham e derivam umas sobre as outras
+// tdma K=1   : escuta todo beacon (slot 0 inteiro) e transmite no seu slot
+// tdma K=8   : escuta um beacon a cada 8 quadros e prevê os demais pelo
+//              relógio local com a deriva estimada
+// sem deriva : como K=8, mas sem corrigir a deriva
+//
+// O beacon chega com latência de IRQ de até 50 µs e se perde com 5% de
+// probabilidade. Uma transmissão colide se qualquer outra (inclusive o
+// beacon) se sobrepõe a ela no tempo; não há efeito de captura.
+
+#define DURATION_S          3600
+#define GUARD_US            2000
+#define BEACON_EVERY        8
+#define MAX_MISSED          3
+#define BEACON_LOSS         0.05
+#define IRQ_JITTER_US       50
+#define DRIFT_PPM           30.0
+#define WANDER_PPM          2.0
+#define MAX_STATIONS        400
+
+typedef enum { MODE_FREE, MODE_TDMA_1, MODE_TDMA_K, MODE_TDMA_NO_DRIFT, NUM_MODES } link_mode_t;
+
+static const char* mode_names[NUM_MODES] = { "livre", "tdma K=1", "tdma K=8", "sem deriva" };
+
+static double rng_uniform(void) {
+    return rand() / ((double)RAND_MAX + 1);
+}
+
+// ----------------------------------------------------------------------------
+// Relógio de uma estação
+// ----------------------------------------------------------------------------
+
+typedef struct {
+    double boot_s;              // Instante real do boot
+    double drift;               // Deriva fixa (fração)
+    double wander;              // Amplitude da variação térmica (fração)
+    double wander_period_s;
+    double phase;
+} station_clock_t;
+
+// Relógio local em µs desde o boot no instante real t
+static double clock_local_us(const station_clock_t* c, double t) {
+    double x = t - c->boot_s;
+    double w = 2 * M_PI / c->wander_period_s;
+    return 1e6 * (x * (1 + c->drift) + c->wander / w * (cos(c->phase) - cos(w * x + c->phase)));
+}
+
+// Instante real em que o relógio local marca local_us
+static double clock_true_s(const station_clock_t* c, double local_us) {
+    double t = c->boot_s + local_us / 1e6;
+    double w = 2 * M_PI / c->wander_period_s;
+    for (int i = 0; i < 4; i++) {
+        double rate = 1 + c->drift + c->wander * sin(w * (t - c->boot_s) + c->phase);
+        t -= (clock_local_us(c, t) - local_us) / 1e6 / rate;
+    }
+    return t;
+}
+
+// ----------------------------------------------------------------------------
+// Canal
+// ----------------------------------------------------------------------------
+
+typedef struct {
+    double start;
+    double end;
+    bool station;               // false = beacon do gateway
+} tx_t;
+
+static tx_t txs[MAX_STATIONS * 1200 + 4000];
+static int num_tx;
+
+static int compare_tx(const void* a, const void* b) {
+    double d = ((const tx_t*)a)->start - ((const tx_t*)b)->start;
+    return d < 0 ? -1 : d > 0;
+}
+
+// Transmissões de estação que se sobrepõem a alguma outra
+static int count_collisions(void) {
+    qsort(txs, num_tx, sizeof(tx_t), compare_tx);
+    int collided = 0;
+    double prev_end = -1;
+    for (int i = 0; i < num_tx; i++) {
+        bool hit = txs[i].start < prev_end || (i + 1 < num_tx && txs[i + 1].start < txs[i].end);
+        if (hit && txs[i].station) collided++;
+        if (txs[i].end > prev_end) prev_end = txs[i].end;
+    }
+    return collided;
+}
+
+static void add_tx(double start, double toa_s, bool station) {
+    txs[num_tx].start = start;
+    txs[num_tx].end = start + toa_s;
+    txs[num_tx].station = station;
+    num_tx++;
+}
+
+// ----------------------------------------------------------------------------
+// Simulação
+// ----------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t transmissions;
+    uint32_t collided;
+    uint32_t unlocks;           // Perdas de sincronismo
+    uint32_t beacons_missed;
+    double rx_s;                // Tempo total em RX escutando beacons
+    double worst_offset_us;     // Maior desvio do pacote em relação ao centro do slot
+} result_t;
+
+// Início do quadro previsto pela estação mais próximo de local_us
+static uint64_t predicted_frame(const tdma_sync_t* sync, double local_us) {
+    return tdma_next_frame_us(sync, (uint64_t)local_us - sync->schedule.slot_us / 2);
+}
+
+static result_t run(link_mode_t mode, int stations, const tdma_schedule_t* schedule,
+                    uint32_t toa_us, uint32_t beacon_toa_us) {
+    result_t r = { 0 };
+    double frame_s = tdma_frame_us(schedule) / 1e6;
+    double toa_s = toa_us / 1e6;
+    double btoa_s = beacon_toa_us / 1e6;
+    int frames = (int)(DURATION_S / frame_s);
+    num_tx = 0;
+    srand(99);
+
+    if (mode != MODE_FREE) {
+        for (int n = 0; n < frames; n++) {
+            add_tx(n * frame_s, btoa_s, false);
+        }
+    }
+
+    for (int s = 0; s < stations; s++) {
+        station_clock_t c = {
+            .boot_s = rng_uniform() * 60,
+            .drift = (2 * rng_uniform() - 1) * DRIFT_PPM * 1e-6,
+            .wander = WANDER_PPM * 1e-6,
+            .wander_period_s = 1800 + rng_uniform() * 3600,
+            .phase = rng_uniform() * 2 * M_PI,
+        };
+        uint16_t slot = (uint16_t)(1 + s);              // Identificadores únicos de 1 a stations
+
+        if (mode == MODE_FREE) {
+            // Primeiro envio ~150 ms após o boot (setup e leitura dos sensores)
+            for (double local = 150000; ; local += frame_s * 1e6) {
+                double t = clock_true_s(&c, local);
+                if (t + toa_s > frames * frame_s) break;
+                add_tx(t, toa_s, true);
+                r.transmissions++;
+            }
+            continue;
+        }
+
+        tdma_sync_t sync;
+        tdma_sync_init(&sync, mode != MODE_TDMA_NO_DRIFT, MAX_MISSED);
+        int every = mode == MODE_TDMA_1 ? 1 : BEACON_EVERY;
+        double listen_from = c.boot_s;                 // Escuta contínua até o primeiro beacon
+
+        for (int n = (int)ceil(c.boot_s / frame_s); n < frames; n++) {
+            double beacon_s = n * frame_s;
+            double local_start = clock_local_us(&c, beacon_s);
+            bool heard = false;
+
+            if (!sync.locked) {
+                r.rx_s += beacon_s + btoa_s - listen_from;
+                listen_from = beacon_s + btoa_s;
+                heard = rng_uniform() >= BEACON_LOSS;
+                if (!heard) continue;
+            } else if (tdma_sync_listen(&sync, predicted_frame(&sync, local_start), every)) {
+                // Janela do slot 0 aberta uma guarda antes do início previsto
+                double open = (double)predicted_frame(&sync, local_start) - GUARD_US;
+                double close = open + GUARD_US + schedule->slot_us;
+                r.rx_s += (close - open) / 1e6;
+                bool inside = local_start >= open && clock_local_us(&c, beacon_s + btoa_s) <= close;
+                heard = inside && rng_uniform() >= BEACON_LOSS;
+                if (!heard) {
+                    r.beacons_missed++;
+                    if (!tdma_sync_missed(&sync)) {
+                        r.unlocks++;
+                        listen_from = clock_true_s(&c, close);
+                        continue;
+                    }
+                }
+            }
+
+            if (heard) {
+                frame_beacon_t b;
+                tdma_beacon(schedule, 0, (uint16_t)n, &b);
+                double rx_end = clock_local_us(&c, beacon_s + btoa_s) + rng_uniform() * IRQ_JITTER_US;
+                tdma_sync_beacon(&sync, &b, (uint64_t)rx_end, beacon_toa_us);
+            }
+
+            uint64_t tx_local = tdma_next_slot_us(&sync, slot, toa_us, (uint64_t)local_start);
+            double t = clock_true_s(&c, (double)tx_local);
+            double ideal = beacon_s + (slot * (double)schedule->slot_us + (schedule->slot_us - toa_us) / 2) / 1e6;
+            double off = fabs(t - ideal) * 1e6;
+            if (off > r.worst_offset_us) r.worst_offset_us = off;
+            add_tx(t, toa_s, true);
+            r.transmissions++;
+        }
+        if (!sync.locked && frames > 0) {
+            r.rx_s += frames * frame_s - listen_from;
+        }
+    }
+    r.collided = count_collisions();
+    return r;
+}
+
+int main(void) {
+    static const int fleet[] = { 50, 100, 200, 400 };
+    bool ok = true;
+
+    sim_reset();
+    rfm95_initialize();
+    uint32_t toa_us = rfm95_time_on_air_us(FRAME_READING_MAX_SIZE);
+    uint32_t beacon_toa_us = rfm95_time_on_air_us(FRAME_BEACON_SIZE);
+
+    // Ida e volta do beacon
+    frame_beacon_t b = { 3, 0xFFFE, 101, 45300 }, d;
+    uint8_t buf[FRAME_BEACON_SIZE];
+    ok = frame_encode_beacon(&b, buf, sizeof(buf)) == FRAME_BEACON_SIZE &&
+         frame_decode_beacon(buf, sizeof(buf), &d) && d.frame_number == b.frame_number &&
+         d.slots == b.slots && d.slot_us == b.slot_us && !frame_decode_beacon(buf, 7, &d);
+    printf("Beacon: ida e volta %s\n", ok ? "OK" : "FALHA");
+    printf("Quadro de leitura %u µs no ar, beacon %u µs, guarda %d µs de cada lado, %d s simulados\n\n",
+           toa_us, beacon_toa_us, GUARD_US, DURATION_S);
+
+    printf("%-9s %-9s %6s %-11s %8s %9s %9s %8s %9s %9s\n",
+           "estacoes", "quadro_s", "carga", "modo", "envios", "colisao%", "util%", "perdidos",
+           "RX_s/h", "desvio_us");
+    for (int f = 0; f < 4; f++) {
+        int n = fleet[f];
+        tdma_schedule_t schedule;
+        tdma_schedule_init(&schedule, (uint16_t)n, toa_us, GUARD_US);
+        double frame_s = tdma_frame_us(&schedule) / 1e6;
+        double load = n * toa_us / 1e6 / frame_s;
+
+        for (int m = 0; m < NUM_MODES; m++) {
+            result_t r = run((link_mode_t)m, n, &schedule, toa_us, beacon_toa_us);
+            double collision = r.transmissions ? 100.0 * r.collided / r.transmissions : 0;
+            double util = 100.0 * (r.transmissions - r.collided) * (toa_us / 1e6) / ((int)(DURATION_S / frame_s) * frame_s);
+            if (m == MODE_FREE) {
+                printf("%-9d %-9.2f %6.2f %-11s %8u %9.1f %9.1f %8s %9s %9s\n", n, frame_s, load,
+                       mode_names[m], r.transmissions, collision, util, "-", "-", "-");
+            } else {
+                printf("%-9s %-9s %6s %-11s %8u %9.1f %9.1f %8u %9.1f %9.0f\n", "", "", "",
+                       mode_names[m], r.transmissions, collision, util, r.beacons_missed,
+                       r.rx_s / n, r.worst_offset_us);
+            }
+            // O TDMA com beacon (com ou sem escuta esparsa) não pode colidir
+            if ((m == MODE_TDMA_1 || m == MODE_TDMA_K) && r.collided != 0) ok = false;
+            if (m == MODE_FREE && r.collided == 0) ok = false;
+        }
+        printf("          ALOHA puro com carga %.2f: %.1f%% de colisão esperada\n", load, 100 * (1 - exp(-2 * load)));
+    }
+    printf("\ncarga: tempo no ar oferecido / tempo; util: tempo no ar sem colisão / tempo\n");
+    printf("perdidos: beacons esperados e não recebidos; desvio: pior distância ao centro do slot\n");
+    printf("%s\n", ok ? "OK" : "FALHA");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "sim.h"
+#include "power.h"
+#include "trace.h"
+
+// ============================================================================
+// PONTOS DE MEDIÇÃO E HISTOGRAMAS LOG-LINEARES
+// ============================================================================
+// 1. Faixas: cada valor cai na faixa cujos limites o contêm, faixas
+//    contíguas, exatas até 15 µs e com largura relativa de até 1/8 acima
+// 2. Percentis: 200000 durações com cauda longa contra os percentis exatos
+//    (erro de no máximo meia faixa, 1/16)
+// 3. Custo: registro com relógio real do host, para valores pequenos e
+//    grandes (custo constante)
+// 4. Laço de main.c compilado com TRACE_ENABLED no relógio virtual: as
+//    linhas @trace impressas podem ser passadas ao trace_report
+//
+//   bench_trace | trace_report
+
+#define NUM_SAMPLES     200000
+#define NUM_RECORDS     10000000
+#define NUM_CYCLES      60
+#define PERIOD_MS       2000
+#define MAX_RECORD_NS   100.0           // Limite no host (ordem de grandeza acima do medido)
+
+bool setup();
+void loop();
+
+static uint32_t rng = 12345;
+
+static uint32_t rng_next(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static bool check_buckets(void) {
+    for (uint32_t b = 0; b < TRACE_BUCKETS; b++) {
+        uint32_t low = trace_bucket_low(b), high = trace_bucket_high(b);
+        if (trace_bucket(low) != b || trace_bucket(high) != b || high < low) return false;
+        if (b + 1 < TRACE_BUCKETS && trace_bucket_low(b + 1) != high + 1) return false;
+        if (b >= 2 * TRACE_SUB_BUCKETS && (double)(high - low + 1) / low > 1.0 / TRACE_SUB_BUCKETS) return false;
+    }
+    if (trace_bucket_high(TRACE_BUCKETS - 1) != UINT32_MAX) return false;
+    for (int i = 0; i < 1000000; i++) {
+        uint32_t v = rng_next() >> (rng_next() % 32);
+        uint32_t b = trace_bucket(v);
+        if (b >= TRACE_BUCKETS || v < trace_bucket_low(b) || v > trace_bucket_high(b)) return false;
+    }
+    return true;
+}
+
+static int compare_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+static double check_percentiles(void) {
+    static uint32_t values[NUM_SAMPLES];
+    static const uint32_t per_mille[] = { 10, 100, 500, 900, 990, 999 };
+    trace_hist_t h;
+    trace_hist_clear(&h);
+
+    // ~13 ms com ruído e uma cauda rara de dezenas de ms (retentativas)
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        uint32_t v = 12000 + rng_next() % 2000;
+        if (rng_next() % 100 == 0) v += rng_next() % 60000;
+        values[i] = v;
+        trace_hist_add(&h, v);
+    }
+    qsort(values, NUM_SAMPLES, sizeof(uint32_t), compare_u32);
+
+    double worst = 0;
+    printf("Percentis (µs):   exato  histograma\n");
+    for (size_t i = 0; i < sizeof(per_mille) / sizeof(per_mille[0]); i++) {
+        uint32_t rank = (uint32_t)(((uint64_t)NUM_SAMPLES * per_mille[i] + 999) / 1000);
+        uint32_t exact = values[rank - 1];
+        uint32_t approx = trace_percentile(&h, per_mille[i]);
+        double err = (double)(approx > exact ? approx - exact : exact - approx) / exact;
+        if (err > worst) worst = err;
+        printf("  p%-5.1f %14u %11u  (%.2f%%)\n", per_mille[i] / 10.0, exact, approx, 100 * err);
+    }
+    return worst;
+}
+
+static double record_ns(uint32_t mask) {
+    static trace_hist_t h;
+    static uint32_t values[1024];
+    for (int i = 0; i < 1024; i++) values[i] = rng_next() & mask;
+    trace_hist_clear(&h);
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < NUM_RECORDS; i++) {
+        trace_hist_add(&h, values[i & 1023]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (h.count != NUM_RECORDS) return -1;
+    return ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / NUM_RECORDS;
+}
+
+int main(void) {
+    bool ok = true;
+
+    bool buckets = check_buckets();
+    printf("Faixas: %u por fase (%u bytes), contíguas e com até 1/%u de largura relativa: %s\n",
+           TRACE_BUCKETS, (unsigned)sizeof(trace_hist_t), TRACE_SUB_BUCKETS, buckets ? "OK" : "FALHA");
+    ok &= buckets;
+
+    double worst = check_percentiles();
+    bool percentiles = worst <= 1.0 / (2 * TRACE_SUB_BUCKETS);
+    printf("Pior erro de percentil: %.2f%% (limite %.2f%%): %s\n\n", 100 * worst,
+           100.0 / (2 * TRACE_SUB_BUCKETS), percentiles ? "OK" : "FALHA");
+    ok &= percentiles;
+
+    double small = record_ns(0xF), large = record_ns(0xFFFFFFFF);
+    bool cost = small > 0 && large > 0 && small < MAX_RECORD_NS && large < MAX_RECORD_NS;
+    printf("Registro no host: %.1f ns (valores < 16 µs), %.1f ns (qualquer valor), limite %.0f ns: %s\n",
+           small, large, MAX_RECORD_NS, cost ? "OK" : "FALHA");
+    ok &= cost;
+
+    // Laço completo no simulador; o relógio virtual não avança durante o
+    // registro, então o custo calibrado aqui é 0 (no RP2040 é medido de fato)
+    sim_reset();
+    if (!setup()) {
+        printf("Falha no setup\n");
+        return 1;
+    }
+    trace_reset();
+    absolute_time_t proxima = get_absolute_time();
+    for (int i = 0; i < NUM_CYCLES; i++) {
+        loop();
+        proxima = delayed_by_ms(proxima, PERIOD_MS);
+        power_sleep_until(proxima);
+    }
+    printf("\n%d ciclos do laço no simulador:\n", NUM_CYCLES);
+    trace_dump();
+
+    static const trace_phase_t per_cycle[] = {
+        TRACE_LOOP, TRACE_SENSORS, TRACE_AHT20_START, TRACE_BMP280, TRACE_AHT20_WAIT,
+        TRACE_ENCODE, TRACE_SEND, TRACE_RFM95_FIFO,
+    };
+    bool counts = true;
+    for (size_t i = 0; i < sizeof(per_cycle) / sizeof(per_cycle[0]); i++) {
+        counts &= trace_get(per_cycle[i])->count == NUM_CYCLES;
+    }
+    counts &= trace_get(TRACE_AHT20_READ)->count >= NUM_CYCLES;
+    counts &= trace_get(TRACE_LOOP)->min_us >= trace_get(TRACE_SENSORS)->max_us;
+    printf("\nUma amostra por ciclo em cada fase e laço mais longo que a leitura: %s\n", counts ? "OK" : "FALHA");
+    ok &= counts;
+
+    printf("%s\n", ok ? "OK" : "FALHA");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,27 @@
+#ifndef _HARDWARE_CLOCKS_H
+#define _HARDWARE_CLOCKS_H
+
+// ============================================================================
+// SHIM HOST DO PICO SDK - CLOCKS
+// ============================================================================
+// Apenas os registradores SLEEP_EN0/1, que escolhem os clocks mantidos no
+// sono profundo. O simulador guarda os valores sem efeito sobre o tempo.
+
+#include "pico/types.h"
+
+typedef struct {
+    volatile uint32_t sleep_en0;
+    volatile uint32_t sleep_en1;
+} clocks_hw_t;
+
+extern clocks_hw_t sim_clocks_hw;
+#define clocks_hw (&sim_clocks_hw)
+
+#define CLOCKS_SLEEP_EN0_RESET                  _u(0xffffffff)
+#define CLOCKS_SLEEP_EN1_RESET                  _u(0x00007fff)
+#define CLOCKS_SLEEP_EN1_CLK_SYS_TIMER_BITS     _u(0x00000020)
+#define CLOCKS_SLEEP_EN1_CLK_SYS_USBCTRL_BITS   _u(0x00000400)
+#define CLOCKS_SLEEP_EN1_CLK_USB_USBCTRL_BITS   _u(0x00000800)
+#define CLOCKS_SLEEP_EN1_CLK_SYS_WATCHDOG_BITS  _u(0x00001000)
+
+#endif // _HARDWARE_CLOCKS_H
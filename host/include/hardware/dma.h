@@ -0,0 +1,62 @@
+#ifndef _HARDWARE_DMA_H
+#define _HARDWARE_DMA_H
+
+// ============================================================================
+// SHIM HOST DO PICO SDK - DMA
+// ============================================================================
+// Canais com DREQ do SPI: um canal que escreve no registrador de dados do
+// SPI anda no ritmo do baudrate configurado e, ao terminar, troca os bytes
+// com o dispositivo selecionado; o canal de leitura do mesmo SPI iniciado
+// junto recebe as respostas e termina no mesmo instante. O tempo de
+// barramento não ocupa a CPU: só a configuração dos canais é contabilizada
+// (SIM_DMA_CALL_OVERHEAD_NS). O fim levanta DMA_IRQ_0 nos canais com
+// dma_channel_set_irq0_enabled().
+
+#include "pico/types.h"
+
+#define NUM_DMA_CHANNELS 12
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2,
+};
+
+typedef struct {
+    bool read_increment;
+    bool write_increment;
+    uint dreq;
+    enum dma_channel_transfer_size size;
+} dma_channel_config;
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(uint channel);
+
+dma_channel_config dma_channel_get_default_config(uint channel);
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {
+    c->size = size;
+}
+
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool incr) {
+    c->read_increment = incr;
+}
+
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool incr) {
+    c->write_increment = incr;
+}
+
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq) {
+    c->dreq = dreq;
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger);
+void dma_start_channel_mask(uint32_t chan_mask);
+bool dma_channel_is_busy(uint channel);
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled);
+bool dma_channel_get_irq0_status(uint channel);
+void dma_channel_acknowledge_irq0(uint channel);
+
+#endif // _HARDWARE_DMA_H
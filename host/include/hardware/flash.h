@@ -0,0 +1,25 @@
+#ifndef _HARDWARE_FLASH_H
+#define _HARDWARE_FLASH_H
+
+// ============================================================================
+// SHIM HOST DO PICO SDK - FLASH QSPI
+// ============================================================================
+// Apagamento e gravação sobre a flash simulada (sim_flash.c), com a mesma
+// semântica de NOR: o apagamento leva o setor inteiro a 0xFF e a gravação só
+// limpa bits. Offsets e tamanhos fora do alinhamento exigido pelo SDK
+// encerram o programa.
+
+#include "pico/types.h"
+
+#define FLASH_PAGE_SIZE         (1u << 8)
+#define FLASH_SECTOR_SIZE       (1u << 12)
+#define FLASH_BLOCK_SIZE        (1u << 16)
+
+#ifndef PICO_FLASH_SIZE_BYTES
+#define PICO_FLASH_SIZE_BYTES   (2 * 1024 * 1024)   // W25Q16JV do Pico W
+#endif
+
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t* data, size_t count);
+
+#endif // _HARDWARE_FLASH_H
@@ -0,0 +1,29 @@
+#ifndef _HARDWARE_I2C_H
+#define _HARDWARE_I2C_H
+
+// ============================================================================
+// SHIM HOST DO PICO SDK - I2C
+// ============================================================================
+// As transações são roteadas pelo endereço de 7 bits para os modelos de
+// sensores do simulador. Endereços sem dispositivo retornam NACK
+// (PICO_ERROR_GENERIC), como no hardware real.
+
+#include "pico/types.h"
+
+// Estado do periférico simulado (no SDK real é o bloco de registradores)
+typedef struct i2c_inst {
+    uint baudrate;
+} i2c_inst_t;
+
+extern i2c_inst_t sim_i2c_inst[2];
+#define i2c0 (&sim_i2c_inst[0])
+#define i2c1 (&sim_i2c_inst[1])
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+void i2c_deinit(i2c_inst_t *i2c);
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate);
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+
+#endif // _HARDWARE_I2C_H
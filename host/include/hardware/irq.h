@@ -0,0 +1,28 @@
+#ifndef _HARDWARE_IRQ_H
+#define _HARDWARE_IRQ_H
+
+// ============================================================================
+// SHIM HOST DO PICO SDK - INTERRUPÇÕES DE PERIFÉRICOS
+// ============================================================================
+// Tabela de tratadores do NVIC. Uma interrupção levantada pelo simulador
+// (ex: fim de uma transferência DMA) fica pendente enquanto as interrupções
+// estiverem desabilitadas e é entregue em restore_interrupts(); enquanto
+// isso, __wfi() retorna na hora. Uma linha pode ter um tratador exclusivo
+// ou vários compartilhados, chamados em ordem decrescente de prioridade.
+
+#include "pico/types.h"
+
+#define DMA_IRQ_0   11
+#define DMA_IRQ_1   12
+#define NUM_IRQS    32
+
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY  0x80
+
+typedef void (*irq_handler_t)(void);
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority);
+void irq_set_enabled(uint num, bool enabled);
+void irq_clear(uint int_num);
+
+#endif // _HARDWARE_IRQ_H
@@ -0,0 +1,15 @@
+#ifndef _HARDWARE_REGS_ADDRESSMAP_H
+#define _HARDWARE_REGS_ADDRESSMAP_H
+
+// ============================================================================
+// SHIM HOST DO PICO SDK - MAPA DE ENDEREÇOS
+// ============================================================================
+// Apenas a janela XIP, que no host aponta para a memória da flash simulada.
+
+#include <stdint.h>
+
+const uint8_t* sim_flash_xip(void);
+
+#define XIP_BASE    ((uintptr_t)sim_flash_xip())
+
+#endif // _HARDWARE_REGS_ADDRESSMAP_H
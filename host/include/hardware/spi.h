@@ -0,0 +1,62 @@
+#ifndef _HARDWARE_SPI_H
+#define _HARDWARE_SPI_H
+
+// ============================================================================
+// SHIM HOST DO PICO SDK - SPI
+// ============================================================================
+// Cada byte trocado é entregue ao dispositivo simulado cujo pino CS estiver
+// em nível baixo. O tempo de barramento é contabilizado no relógio virtual
+// de acordo com o baudrate configurado em spi_init(). Transferências por DMA
+// usam o registrador de dados de spi_get_hw() e o DREQ de spi_get_dreq().
+
+#include "pico/types.h"
+
+// Estado do periférico simulado (no SDK real é o bloco de registradores)
+typedef struct spi_inst {
+    uint baudrate;
+} spi_inst_t;
+
+extern spi_inst_t sim_spi_inst[2];
+#define spi0 (&sim_spi_inst[0])
+#define spi1 (&sim_spi_inst[1])
+
+// Registrador de dados, usado como endereço de origem/destino do DMA
+typedef struct {
+    volatile uint32_t dr;
+} spi_hw_t;
+
+extern spi_hw_t sim_spi_hw[2];
+
+// Mesmos números de DREQ do RP2040
+#define DREQ_SPI0_TX 16
+#define DREQ_SPI0_RX 17
+#define DREQ_SPI1_TX 18
+#define DREQ_SPI1_RX 19
+
+static inline uint spi_get_index(const spi_inst_t *spi) {
+    return spi == spi1 ? 1 : 0;
+}
+
+static inline spi_hw_t *spi_get_hw(spi_inst_t *spi) {
+    return &sim_spi_hw[spi_get_index(spi)];
+}
+
+static inline uint spi_get_dreq(spi_inst_t *spi, bool is_tx) {
+    return DREQ_SPI0_TX + 2 * spi_get_index(spi) + (is_tx ? 0 : 1);
+}
+
+typedef enum { SPI_CPHA_0 = 0, SPI_CPHA_1 = 1 } spi_cpha_t;
+typedef enum { SPI_CPOL_0 = 0, SPI_CPOL_1 = 1 } spi_cpol_t;
+typedef enum { SPI_LSB_FIRST = 0, SPI_MSB_FIRST = 1 } spi_order_t;
+
+uint spi_init(spi_inst_t *spi, uint baudrate);
+void spi_deinit(spi_inst_t *spi);
+uint spi_set_baudrate(spi_inst_t *spi, uint baudrate);
+uint spi_get_baudrate(const spi_inst_t *spi);
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order);
+
+int spi_write_read_blocking(spi_inst_t *spi, const uint8_t *src, uint8_t *dst, size_t len);
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len);
+int spi_read_blocking(spi_inst_t *spi, uint8_t repeated_tx_data, uint8_t *dst, size_t len);
+
+#endif // _HARDWARE_SPI_H
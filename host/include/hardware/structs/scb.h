@@ -0,0 +1,21 @@
+#ifndef _HARDWARE_STRUCTS_SCB_H
+#define _HARDWARE_STRUCTS_SCB_H
+
+// ============================================================================
+// SHIM HOST DO PICO SDK - SYSTEM CONTROL BLOCK
+// ============================================================================
+// Apenas o SCR: com SLEEPDEEP ligado, o tempo dormido em __wfi()/__wfe() e
+// sleep_*() é contabilizado como sono profundo (sim_stats_t.deep_sleep_ns).
+
+#include "pico/types.h"
+
+typedef struct {
+    volatile uint32_t scr;
+} armv6m_scb_hw_t;
+
+extern armv6m_scb_hw_t sim_scb_hw;
+#define scb_hw (&sim_scb_hw)
+
+#define M0PLUS_SCR_SLEEPDEEP_BITS   _u(0x00000004)
+
+#endif // _HARDWARE_STRUCTS_SCB_H
@@ -0,0 +1,42 @@
+#ifndef _HARDWARE_SYNC_H
+#define _HARDWARE_SYNC_H
+
+// ============================================================================
+// SHIM HOST DO PICO SDK - SINCRONIZAÇÃO
+// ============================================================================
+// Interrupções desabilitadas adiam os callbacks de GPIO simulados até
+// restore_interrupts(). __wfi() avança o relógio virtual até o próximo evento
+// de dispositivo, como o núcleo dormindo até a próxima interrupção; com uma
+// interrupção habilitada já pendente, retorna na hora (como no Cortex-M0+).
+// Com um só núcleo simulado, as travas de hardware só desabilitam as
+// interrupções.
+
+#include "pico/types.h"
+
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+void __wfi(void);
+void __wfe(void);
+void __sev(void);
+
+typedef volatile uint32_t spin_lock_t;
+
+int spin_lock_claim_unused(bool required);
+spin_lock_t* spin_lock_init(uint lock_num);
+
+static inline uint32_t spin_lock_blocking(spin_lock_t* lock) {
+    (void)lock;
+    return save_and_disable_interrupts();
+}
+
+static inline void spin_unlock(spin_lock_t* lock, uint32_t saved_irq) {
+    (void)lock;
+    restore_interrupts(saved_irq);
+}
+
+static inline void __dmb(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+#endif // _HARDWARE_SYNC_H
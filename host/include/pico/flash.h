@@ -0,0 +1,16 @@
+#ifndef _PICO_FLASH_H
+#define _PICO_FLASH_H
+
+// ============================================================================
+// SHIM HOST DO PICO SDK - EXECUÇÃO SEGURA EM FLASH
+// ============================================================================
+// No firmware, flash_safe_execute() para o outro núcleo e desabilita as
+// interrupções enquanto a flash sai do modo XIP. O simulador tem uma única
+// thread: basta desabilitar as interrupções simuladas.
+
+#include "pico/types.h"
+
+int flash_safe_execute(void (*func)(void*), void* param, uint32_t enter_exit_timeout_ms);
+bool flash_safe_execute_core_init(void);
+
+#endif // _PICO_FLASH_H
@@ -0,0 +1,16 @@
+#ifndef _PICO_STDLIB_H
+#define _PICO_STDLIB_H
+
+// ============================================================================
+// SHIM HOST DO PICO SDK - pico/stdlib.h
+// ============================================================================
+// Permite compilar os drivers de lib/ sem alterações no Linux. As funções são
+// implementadas em host/sim sobre barramentos e relógio simulados.
+
+#include "pico/types.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+bool stdio_init_all(void);
+
+#endif // _PICO_STDLIB_H
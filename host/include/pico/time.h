@@ -0,0 +1,34 @@
+#ifndef _PICO_TIME_H
+#define _PICO_TIME_H
+
+// ============================================================================
+// SHIM HOST DO PICO SDK - TEMPO
+// ============================================================================
+// Todas as funções operam sobre o relógio virtual do simulador: sleep_ms()
+// não bloqueia o processo, apenas avança o tempo e processa os eventos dos
+// dispositivos simulados (fim de transmissão, conversões dos sensores...).
+
+#include "pico/types.h"
+
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+void busy_wait_us(uint64_t us);
+
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+
+absolute_time_t get_absolute_time(void);
+absolute_time_t make_timeout_time_ms(uint32_t ms);
+absolute_time_t make_timeout_time_us(uint64_t us);
+uint32_t to_ms_since_boot(absolute_time_t t);
+uint64_t to_us_since_boot(absolute_time_t t);
+absolute_time_t from_us_since_boot(uint64_t us);
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to);
+absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us);
+absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms);
+bool time_reached(absolute_time_t t);
+void sleep_until(absolute_time_t t);
+
+static inline void tight_loop_contents(void) {}
+
+#endif // _PICO_TIME_H
@@ -0,0 +1,28 @@
+#ifndef _PICO_TYPES_H
+#define _PICO_TYPES_H
+
+// ============================================================================
+// SHIM HOST DO PICO SDK - TIPOS BÁSICOS
+// ============================================================================
+// Apenas o subconjunto de tipos e macros usado pelos drivers em lib/.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+#define _u(x) x ## u
+
+// Tempo absoluto em microssegundos desde o boot (relógio virtual do simulador)
+typedef uint64_t absolute_time_t;
+
+// Códigos de erro retornados pelas funções bloqueantes do SDK
+enum pico_error_codes {
+    PICO_OK = 0,
+    PICO_ERROR_NONE = 0,
+    PICO_ERROR_TIMEOUT = -1,
+    PICO_ERROR_GENERIC = -2,
+};
+
+#endif // _PICO_TYPES_H
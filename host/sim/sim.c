@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "sim.h"
+#include "hardware/i2c.h"
+#include "hardware/structs/scb.h"
+#include "sim_sx1276.h"
+#include "sim_sensors.h"
+#include "rfm95.h"
+
+// ============================================================================
+// ESTADO GLOBAL DO SIMULADOR
+// ============================================================================
+
+static uint64_t now_ns;
+static sim_stats_t stats;
+static sim_device_t devices[SIM_MAX_DEVICES];
+static int num_devices;
+
+static sim_env_t env = {
+    .temperature_c = 25.0,
+    .humidity_rh   = 60.0,
+    .pressure_pa   = 101325.0,
+};
+
+// Modelos da estação padrão
+static sim_sx1276_t radio;
+static sim_aht20_t aht20;
+static sim_bmp280_t bmp280;
+
+// ============================================================================
+// RELÓGIO VIRTUAL E EVENTOS
+// ============================================================================
+
+void sim_register_device(const sim_device_t* dev) {
+    if (num_devices < SIM_MAX_DEVICES) {
+        devices[num_devices++] = *dev;
+    }
+}
+
+uint64_t sim_now_ns(void) {
+    return now_ns;
+}
+
+/**
+ * @brief Retorna o instante do próximo evento pendente entre os dispositivos
+ */
+static uint64_t sim_next_event_ns(void) {
+    uint64_t next = SIM_NEVER;
+    for (int i = 0; i < num_devices; i++) {
+        uint64_t t = devices[i].next_event_ns(devices[i].ctx);
+        if (t < next) next = t;
+    }
+    return next;
+}
+
+static void sim_run_devices(void) {
+    for (int i = 0; i < num_devices; i++) {
+        devices[i].run_until(devices[i].ctx, now_ns);
+    }
+}
+
+/**
+ * @brief Avança o relógio virtual processando eventos em ordem cronológica
+ *
+ * O relógio para em cada evento pendente para que callbacks disparados por
+ * ele (ex: IRQ do DIO0) observem o instante correto.
+ */
+void sim_advance_ns(uint64_t ns) {
+    uint64_t target = now_ns + ns;
+
+    for (;;) {
+        uint64_t next = sim_next_event_ns();
+        if (next > target) break;
+        if (next > now_ns) {
+            stats.time_ns += next - now_ns;
+            now_ns = next;
+        }
+        sim_run_devices();
+    }
+
+    if (target > now_ns) {
+        stats.time_ns += target - now_ns;
+        now_ns = target;
+    }
+    sim_run_devices();
+}
+
+void sim_wait_for_event(void) {
+    uint64_t next = sim_next_event_ns();
+    uint64_t ns = SIM_IDLE_TICK_NS;
+    if (next != SIM_NEVER) {
+        ns = next > now_ns ? next - now_ns : 0;
+    }
+    sim_account_sleep(ns);
+    sim_advance_ns(ns);
+}
+
+// ============================================================================
+// CONTABILIZAÇÃO
+// ============================================================================
+
+void sim_account_sleep(uint64_t ns) {
+    stats.sleep_ns += ns;
+    stats.sleep_calls++;
+    if (scb_hw->scr & M0PLUS_SCR_SLEEPDEEP_BITS) {
+        stats.deep_sleep_ns += ns;
+    }
+}
+
+void sim_account_spi(uint32_t bytes, uint64_t ns) {
+    stats.spi_bytes += bytes;
+    stats.spi_ns += ns;
+}
+
+void sim_account_spi_transaction(void) {
+    stats.spi_transactions++;
+}
+
+void sim_account_i2c(uint32_t bytes, uint64_t ns) {
+    stats.i2c_transactions++;
+    stats.i2c_bytes += bytes;
+    stats.i2c_ns += ns;
+}
+
+sim_stats_t sim_stats(void) {
+    return stats;
+}
+
+sim_stats_t sim_stats_since(const sim_stats_t* start) {
+    sim_stats_t d;
+    d.time_ns          = stats.time_ns - start->time_ns;
+    d.sleep_ns         = stats.sleep_ns - start->sleep_ns;
+    d.deep_sleep_ns    = stats.deep_sleep_ns - start->deep_sleep_ns;
+    d.spi_ns           = stats.spi_ns - start->spi_ns;
+    d.i2c_ns           = stats.i2c_ns - start->i2c_ns;
+    d.spi_transactions = stats.spi_transactions - start->spi_transactions;
+    d.spi_bytes        = stats.spi_bytes - start->spi_bytes;
+    d.i2c_transactions = stats.i2c_transactions - start->i2c_transactions;
+    d.i2c_bytes        = stats.i2c_bytes - start->i2c_bytes;
+    d.sleep_calls      = stats.sleep_calls - start->sleep_calls;
+    return d;
+}
+
+void sim_print_stats_header(void) {
+    printf("%-28s %12s %12s %10s %8s %8s %8s %8s %7s\n",
+           "operacao", "tempo_us", "sleep_us", "barram_us",
+           "spi_tx", "spi_B", "i2c_tx", "i2c_B", "sleeps");
+}
+
+void sim_print_stats(const char* label, const sim_stats_t* s) {
+    printf("%-28s %12.1f %12.1f %10.1f %8u %8u %8u %8u %7u\n",
+           label,
+           s->time_ns / 1000.0,
+           s->sleep_ns / 1000.0,
+           (s->spi_ns + s->i2c_ns) / 1000.0,
+           s->spi_transactions, s->spi_bytes,
+           s->i2c_transactions, s->i2c_bytes,
+           s->sleep_calls);
+}
+
+// ============================================================================
+// AMBIENTE E ESTAÇÃO PADRÃO
+// ============================================================================
+
+void sim_env_set(const sim_env_t* e) {
+    env = *e;
+}
+
+sim_env_t sim_env_get(void) {
+    return env;
+}
+
+void sim_reset(void) {
+    now_ns = 0;
+    memset(&stats, 0, sizeof(stats));
+    num_devices = 0;
+    sim_hal_reset();
+    sim_dma_reset();
+
+    sim_sx1276_init(&radio, SPI_PORT, PIN_CS, PIN_RST);
+    sim_sx1276_set_dio0_pin(&radio, PIN_DIO0);
+    sim_aht20_init(&aht20, i2c0);
+    sim_bmp280_init(&bmp280, i2c0);
+}
+
+sim_sx1276_t* sim_radio(void) {
+    return &radio;
+}
@@ -0,0 +1,152 @@
+#ifndef SIM_H
+#define SIM_H
+
+// ============================================================================
+// SIMULADOR HOST - NÚCLEO
+// ============================================================================
+// Relógio virtual, contadores de barramento e registro de dispositivos
+// simulados. O HAL em sim_hal.c implementa a API do Pico SDK sobre este
+// núcleo; os modelos (SX1276, AHT20, BMP280) se registram aqui para receber
+// bytes de SPI/I2C e eventos temporizados.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "pico/types.h"
+
+// Custo fixo modelado por chamada spi_*_blocking / i2c_*_blocking (ns)
+#define SIM_SPI_CALL_OVERHEAD_NS    1000
+#define SIM_I2C_CALL_OVERHEAD_NS    2000
+
+// Custo de CPU de cada configuração ou disparo de canal DMA (ns)
+#define SIM_DMA_CALL_OVERHEAD_NS    500
+
+// CPU gasta por __wfi() que retorna na hora, com uma IRQ habilitada já
+// pendente (mascarada por save_and_disable_interrupts)
+#define SIM_WFI_PENDING_NS          100
+
+#define SIM_MAX_DEVICES             8
+#define SIM_NEVER                   UINT64_MAX
+
+// Intervalo coberto por __wfi() quando não há eventos pendentes
+#define SIM_IDLE_TICK_NS            1000000ull
+
+// ----------------------------------------------------------------------------
+// Estatísticas
+// ----------------------------------------------------------------------------
+
+// Contadores acumulados desde sim_reset(). Diferenças entre dois instantâneos
+// (sim_stats_since) dão o custo de uma chamada de driver.
+typedef struct {
+    uint64_t time_ns;           // Tempo virtual decorrido
+    uint64_t sleep_ns;          // Tempo dentro de sleep_ms/sleep_us
+    uint64_t deep_sleep_ns;     // Parte de sleep_ns com SLEEPDEEP ligado no SCR
+    uint64_t spi_ns;            // Tempo de barramento SPI (bytes + overhead)
+    uint64_t i2c_ns;            // Tempo de barramento I2C (bits + overhead)
+    uint32_t spi_transactions;  // Quadros CS baixo -> CS alto
+    uint32_t spi_bytes;         // Bytes trocados no SPI (incluindo endereço)
+    uint32_t i2c_transactions;  // Transações START ... STOP/RESTART
+    uint32_t i2c_bytes;         // Bytes de dados no I2C (sem endereço)
+    uint32_t sleep_calls;       // Chamadas a sleep_ms/sleep_us
+} sim_stats_t;
+
+sim_stats_t sim_stats(void);
+sim_stats_t sim_stats_since(const sim_stats_t* start);
+void sim_print_stats_header(void);
+void sim_print_stats(const char* label, const sim_stats_t* s);
+
+// ----------------------------------------------------------------------------
+// Relógio virtual e dispositivos
+// ----------------------------------------------------------------------------
+
+// Dispositivo com eventos temporizados (ex: fim de TX do SX1276)
+typedef struct sim_device {
+    void* ctx;
+    uint64_t (*next_event_ns)(void* ctx);            // SIM_NEVER se nenhum
+    void (*run_until)(void* ctx, uint64_t now_ns);   // Processa eventos <= now
+} sim_device_t;
+
+void sim_register_device(const sim_device_t* dev);
+
+uint64_t sim_now_ns(void);
+
+// Avança o relógio processando, em ordem, todos os eventos dos dispositivos
+void sim_advance_ns(uint64_t ns);
+
+// Dorme até o próximo evento de dispositivo (SIM_IDLE_TICK_NS se não houver
+// nenhum), contabilizado como tempo ocioso. Usado por __wfi()/__wfe().
+void sim_wait_for_event(void);
+
+// Contabilização usada pelo HAL
+void sim_account_sleep(uint64_t ns);
+void sim_account_spi(uint32_t bytes, uint64_t ns);
+void sim_account_spi_transaction(void);
+void sim_account_i2c(uint32_t bytes, uint64_t ns);
+
+// ----------------------------------------------------------------------------
+// Barramentos simulados (registrados pelos modelos)
+// ----------------------------------------------------------------------------
+
+typedef struct spi_inst spi_inst_t;
+typedef struct i2c_inst i2c_inst_t;
+
+typedef struct {
+    spi_inst_t* spi;
+    uint cs_pin;
+    void* ctx;
+    void (*select)(void* ctx);                  // CS desceu
+    uint8_t (*exchange)(void* ctx, uint8_t tx); // Um byte full-duplex
+    void (*deselect)(void* ctx);                // CS subiu
+} sim_spi_device_t;
+
+typedef struct {
+    i2c_inst_t* i2c;
+    uint8_t addr;
+    void* ctx;
+    bool (*write)(void* ctx, const uint8_t* src, size_t len);
+    bool (*read)(void* ctx, uint8_t* dst, size_t len);
+} sim_i2c_device_t;
+
+void sim_spi_attach(const sim_spi_device_t* dev);
+void sim_i2c_attach(const sim_i2c_device_t* dev);
+
+// Troca um byte com o dispositivo selecionado sem avançar o relógio (DMA)
+uint8_t sim_spi_exchange(spi_inst_t* spi, uint8_t tx);
+
+// Levanta uma interrupção de periférico (número do NVIC); entregue aos
+// tratadores da linha (exclusivo ou compartilhados) quando as interrupções
+// permitirem
+void sim_irq_raise(uint num);
+
+// Libera os canais DMA e registra o motor de DMA (usado por sim_reset)
+void sim_dma_reset(void);
+
+// Observador de pino de saída (ex: RST do SX1276)
+typedef void (*sim_gpio_listener_t)(void* ctx, uint pin, bool level);
+void sim_gpio_listen(uint pin, sim_gpio_listener_t fn, void* ctx);
+
+// Força o nível de um pino de entrada (saída de um dispositivo, ex: DIO0)
+void sim_gpio_drive(uint pin, bool level);
+
+// Desconecta todos os dispositivos e observadores (usado por sim_reset)
+void sim_hal_reset(void);
+
+// ----------------------------------------------------------------------------
+// Ambiente e estação padrão
+// ----------------------------------------------------------------------------
+
+// Grandezas físicas vistas pelos sensores simulados
+typedef struct {
+    double temperature_c;
+    double humidity_rh;
+    double pressure_pa;
+} sim_env_t;
+
+void sim_env_set(const sim_env_t* env);
+sim_env_t sim_env_get(void);
+
+// Zera relógio e contadores e monta a estação padrão: SX1276 em spi0
+// (pinos de rfm95.h), AHT20 e BMP280 em i2c0.
+void sim_reset(void);
+
+#endif // SIM_H
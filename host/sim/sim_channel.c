@@ -0,0 +1,58 @@
+#include <math.h>
+
+#include "sim_channel.h"
+
+// Sensibilidade com BW = 125 kHz, SF7 a SF12
+static const double sensitivity_dbm[SIM_CHANNEL_NUM_SF] = { -123.0, -126.0, -129.0, -132.0, -134.5, -137.0 };
+
+// SIR mínima entre SFs diferentes: linha = SF desejado, coluna = SF
+// interferente (a diagonal é substituída por capture_db)
+static const double sir_db[SIM_CHANNEL_NUM_SF][SIM_CHANNEL_NUM_SF] = {
+    {   0,  -8,  -9,  -9,  -9,  -9 },
+    { -11,   0, -11, -12, -13, -13 },
+    { -15, -13,   0, -13, -14, -15 },
+    { -19, -18, -17,   0, -17, -18 },
+    { -22, -22, -21, -20,   0, -20 },
+    { -25, -25, -25, -24, -23,   0 },
+};
+
+void sim_channel_default(sim_channel_t* channel) {
+    channel->d0_m = 1.0;
+    channel->pl_d0_db = 31.7;
+    channel->exponent = 2.7;
+    channel->shadowing_db = 6.0;
+    channel->fading_db = 2.0;
+    channel->capture_db = 6.0;
+}
+
+double sim_channel_path_loss_db(const sim_channel_t* channel, double distance_m) {
+    if (distance_m < channel->d0_m) distance_m = channel->d0_m;
+    return channel->pl_d0_db + 10.0 * channel->exponent * log10(distance_m / channel->d0_m);
+}
+
+static int sf_index(int sf) {
+    if (sf < SIM_CHANNEL_SF_MIN) return 0;
+    if (sf > SIM_CHANNEL_SF_MAX) return SIM_CHANNEL_NUM_SF - 1;
+    return sf - SIM_CHANNEL_SF_MIN;
+}
+
+double sim_channel_sensitivity_dbm(int sf) {
+    return sensitivity_dbm[sf_index(sf)];
+}
+
+double sim_channel_sir_db(const sim_channel_t* channel, int sf_wanted, int sf_interferer) {
+    if (sf_wanted == sf_interferer) return channel->capture_db;
+    return sir_db[sf_index(sf_wanted)][sf_index(sf_interferer)];
+}
+
+uint64_t sim_channel_symbol_ns(int sf) {
+    return ((uint64_t)1000000000 << sf) / SIM_CHANNEL_BW_HZ;
+}
+
+bool sim_channel_interferes(const sim_channel_t* channel, const sim_channel_packet_t* wanted,
+                            const sim_channel_packet_t* interferer) {
+    if (interferer->start_ns >= wanted->end_ns || interferer->end_ns <= wanted->lock_ns) {
+        return false;
+    }
+    return wanted->rssi_dbm - interferer->rssi_dbm < sim_channel_sir_db(channel, wanted->sf, interferer->sf);
+}
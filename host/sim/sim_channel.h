@@ -0,0 +1,63 @@
+#ifndef SIM_CHANNEL_H
+#define SIM_CHANNEL_H
+
+// ============================================================================
+// CANAL LORA COMPARTILHADO
+// ============================================================================
+// Modelo de propagação e interferência para vários nós em um mesmo canal de
+// 125 kHz: perda de percurso log-distância com sombreamento lognormal por nó
+// e variação por pacote, sensibilidade do SX1276 por SF, efeito de captura
+// entre pacotes do mesmo SF e ortogonalidade imperfeita entre SFs (SIR
+// mínima medida por Croce et al., "Impact of LoRa Imperfect Orthogonality").
+//
+// Uma sobreposição só destrói o pacote se atingir a parte útil: os primeiros
+// símbolos do preâmbulo podem se perder sem impedir a sincronização.
+
+#include "sim.h"
+
+#define SIM_CHANNEL_SF_MIN      7
+#define SIM_CHANNEL_SF_MAX      12
+#define SIM_CHANNEL_NUM_SF      (SIM_CHANNEL_SF_MAX - SIM_CHANNEL_SF_MIN + 1)
+#define SIM_CHANNEL_BW_HZ       125000
+#define SIM_CHANNEL_LOCK_SYMBOLS 5      // Símbolos do fim do preâmbulo necessários à sincronização
+
+typedef struct {
+    double d0_m;                // Distância de referência
+    double pl_d0_db;            // Perda em d0 (espaço livre em 915 MHz a 1 m)
+    double exponent;            // Expoente de perda
+    double shadowing_db;        // Desvio do sombreamento (fixo por nó)
+    double fading_db;           // Desvio da variação por pacote
+    double capture_db;          // SIR para capturar um pacote do mesmo SF
+} sim_channel_t;
+
+// Pacote no ar, do ponto de vista do gateway
+typedef struct {
+    uint64_t start_ns;
+    uint64_t end_ns;
+    uint64_t lock_ns;           // Início da parte que não pode sofrer sobreposição
+    uint8_t sf;
+    float rssi_dbm;
+} sim_channel_packet_t;
+
+// Ambiente suburbano (expoente 2.7, sombreamento de 6 dB)
+void sim_channel_default(sim_channel_t* channel);
+
+// Perda de percurso média até distance_m, sem sombreamento
+double sim_channel_path_loss_db(const sim_channel_t* channel, double distance_m);
+
+// Sensibilidade do SX1276 com 125 kHz (datasheet, tabela 13)
+double sim_channel_sensitivity_dbm(int sf);
+
+// SIR mínima (dB) para receber um pacote de sf_wanted com um interferente
+// de sf_interferer sobreposto
+double sim_channel_sir_db(const sim_channel_t* channel, int sf_wanted, int sf_interferer);
+
+// Duração de um símbolo em ns
+uint64_t sim_channel_symbol_ns(int sf);
+
+// true se interferer se sobrepõe à parte útil de wanted com potência
+// suficiente para destruí-lo
+bool sim_channel_interferes(const sim_channel_t* channel, const sim_channel_packet_t* wanted,
+                            const sim_channel_packet_t* interferer);
+
+#endif // SIM_CHANNEL_H
@@ -0,0 +1,181 @@
+#include <string.h>
+
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/spi.h"
+#include "sim.h"
+
+// ============================================================================
+// MOTOR DE DMA
+// ============================================================================
+// Só o caso usado pelos drivers: bytes entre a memória e o registrador de
+// dados de um SPI, no ritmo do DREQ. O canal de TX define a duração (bytes
+// a 8 bits no baudrate atual); os bytes são trocados com o dispositivo no
+// fim, enquanto o CS continua baixo, e as respostas vão para o canal de RX
+// iniciado junto.
+
+typedef struct {
+    bool claimed;
+    bool busy;
+    bool irq0_enabled;
+    bool irq0_status;
+    dma_channel_config config;
+    volatile void* write_addr;
+    const volatile void* read_addr;
+    uint count;
+    uint64_t done_ns;           // Fim da transferência (canal de TX)
+} sim_dma_channel_t;
+
+static sim_dma_channel_t channels[NUM_DMA_CHANNELS];
+
+/**
+ * @brief SPI cujo DREQ pacia o canal, ou NULL
+ */
+static spi_inst_t* sim_dma_spi(const sim_dma_channel_t* c, bool* is_tx) {
+    for (uint i = 0; i < 2; i++) {
+        spi_inst_t* spi = i ? spi1 : spi0;
+        if (c->config.dreq == spi_get_dreq(spi, true) || c->config.dreq == spi_get_dreq(spi, false)) {
+            *is_tx = c->config.dreq == spi_get_dreq(spi, true);
+            return spi;
+        }
+    }
+    return NULL;
+}
+
+static void sim_dma_finish(sim_dma_channel_t* c) {
+    c->busy = false;
+    if (c->irq0_enabled) {
+        c->irq0_status = true;
+        sim_irq_raise(DMA_IRQ_0);
+    }
+}
+
+/**
+ * @brief Troca os bytes do canal de TX e entrega as respostas ao canal de RX pareado
+ */
+static void sim_dma_complete(sim_dma_channel_t* tx, spi_inst_t* spi) {
+    sim_dma_channel_t* rx = NULL;
+    for (uint i = 0; i < NUM_DMA_CHANNELS; i++) {
+        bool is_tx;
+        if (channels[i].busy && sim_dma_spi(&channels[i], &is_tx) == spi && !is_tx) {
+            rx = &channels[i];
+        }
+    }
+
+    const volatile uint8_t* src = tx->read_addr;
+    volatile uint8_t* dst = rx ? rx->write_addr : NULL;
+    for (uint n = 0; n < tx->count; n++) {
+        uint8_t byte = sim_spi_exchange(spi, src[tx->config.read_increment ? n : 0]);
+        if (dst && n < rx->count) {
+            dst[rx->config.write_increment ? n : 0] = byte;
+        }
+    }
+
+    uint baud = spi->baudrate ? spi->baudrate : 1000000;
+    sim_account_spi(tx->count, (uint64_t)tx->count * 8 * 1000000000ull / baud);
+    sim_dma_finish(tx);
+    if (rx) sim_dma_finish(rx);
+}
+
+static uint64_t sim_dma_next_event(void* ctx) {
+    (void)ctx;
+    uint64_t next = SIM_NEVER;
+    for (uint i = 0; i < NUM_DMA_CHANNELS; i++) {
+        if (channels[i].busy && channels[i].done_ns < next) next = channels[i].done_ns;
+    }
+    return next;
+}
+
+static void sim_dma_run_until(void* ctx, uint64_t now_ns) {
+    (void)ctx;
+    for (uint i = 0; i < NUM_DMA_CHANNELS; i++) {
+        sim_dma_channel_t* c = &channels[i];
+        bool is_tx;
+        spi_inst_t* spi;
+        if (c->busy && c->done_ns <= now_ns && (spi = sim_dma_spi(c, &is_tx)) != NULL && is_tx) {
+            sim_dma_complete(c, spi);
+        }
+    }
+}
+
+void sim_dma_reset(void) {
+    memset(channels, 0, sizeof(channels));
+    sim_device_t dev = { .ctx = NULL, .next_event_ns = sim_dma_next_event, .run_until = sim_dma_run_until };
+    sim_register_device(&dev);
+}
+
+// ============================================================================
+// API DO SDK
+// ============================================================================
+
+int dma_claim_unused_channel(bool required) {
+    for (uint i = 0; i < NUM_DMA_CHANNELS; i++) {
+        if (!channels[i].claimed) {
+            channels[i].claimed = true;
+            return (int)i;
+        }
+    }
+    return required ? 0 : -1;
+}
+
+void dma_channel_unclaim(uint channel) {
+    if (channel < NUM_DMA_CHANNELS) channels[channel].claimed = false;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    (void)channel;
+    dma_channel_config c = {
+        .read_increment = true, .write_increment = false, .dreq = 0x3F, .size = DMA_SIZE_32,
+    };
+    return c;
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+    if (channel >= NUM_DMA_CHANNELS) return;
+    sim_dma_channel_t* c = &channels[channel];
+    c->config = *config;
+    c->write_addr = write_addr;
+    c->read_addr = read_addr;
+    c->count = transfer_count;
+    sim_advance_ns(SIM_DMA_CALL_OVERHEAD_NS);
+    if (trigger) dma_start_channel_mask(1u << channel);
+}
+
+/**
+ * @brief Dispara os canais; os de TX do SPI terminam após os bytes no baudrate atual
+ *
+ * Um canal de RX sem canal de TX no mesmo SPI nunca termina, como no RP2040
+ * (sem escrita no SPI não há clock).
+ */
+void dma_start_channel_mask(uint32_t chan_mask) {
+    sim_advance_ns(SIM_DMA_CALL_OVERHEAD_NS);
+    for (uint i = 0; i < NUM_DMA_CHANNELS; i++) {
+        if (!(chan_mask & (1u << i))) continue;
+        sim_dma_channel_t* c = &channels[i];
+        bool is_tx;
+        spi_inst_t* spi = sim_dma_spi(c, &is_tx);
+        c->busy = c->count > 0 && c->config.size == DMA_SIZE_8 && spi != NULL;
+        c->done_ns = SIM_NEVER;
+        if (c->busy && is_tx) {
+            uint baud = spi->baudrate ? spi->baudrate : 1000000;
+            c->done_ns = sim_now_ns() + (uint64_t)c->count * 8 * 1000000000ull / baud;
+        }
+    }
+}
+
+bool dma_channel_is_busy(uint channel) {
+    return channel < NUM_DMA_CHANNELS && channels[channel].busy;
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled) {
+    if (channel < NUM_DMA_CHANNELS) channels[channel].irq0_enabled = enabled;
+}
+
+bool dma_channel_get_irq0_status(uint channel) {
+    return channel < NUM_DMA_CHANNELS && channels[channel].irq0_status;
+}
+
+void dma_channel_acknowledge_irq0(uint channel) {
+    if (channel < NUM_DMA_CHANNELS) channels[channel].irq0_status = false;
+}
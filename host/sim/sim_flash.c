@@ -0,0 +1,211 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "hardware/regs/addressmap.h"
+#include "pico/flash.h"
+#include "sim_flash.h"
+
+// ============================================================================
+// FLASH QSPI SOBRE MEMÓRIA ANÔNIMA OU ARQUIVO MAPEADO
+// ============================================================================
+
+#define SIM_FLASH_SECTORS   (PICO_FLASH_SIZE_BYTES / FLASH_SECTOR_SIZE)
+
+static uint8_t* flash;
+static int flash_fd = -1;
+static sim_flash_stats_t stats;
+static uint32_t erase_counts[SIM_FLASH_SECTORS];
+static uint64_t cut_remaining;          // 0 = sem corte armado
+static bool powered = true;
+static uint32_t rng_state = 0x9E3779B9u;
+
+static void sim_flash_map_anonymous(void) {
+    flash = mmap(NULL, PICO_FLASH_SIZE_BYTES, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (flash == MAP_FAILED) {
+        perror("sim_flash");
+        abort();
+    }
+    memset(flash, 0xFF, PICO_FLASH_SIZE_BYTES);
+}
+
+uint8_t* sim_flash_data(void) {
+    if (!flash) {
+        sim_flash_map_anonymous();
+    }
+    return flash;
+}
+
+const uint8_t* sim_flash_xip(void) {
+    return sim_flash_data();
+}
+
+static void sim_flash_unmap(void) {
+    if (flash) {
+        munmap(flash, PICO_FLASH_SIZE_BYTES);
+        flash = NULL;
+    }
+    if (flash_fd >= 0) {
+        close(flash_fd);
+        flash_fd = -1;
+    }
+    memset(&stats, 0, sizeof(stats));
+    memset(erase_counts, 0, sizeof(erase_counts));
+    cut_remaining = 0;
+    powered = true;
+}
+
+bool sim_flash_open(const char* path) {
+    sim_flash_unmap();
+
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    // Completa com 0xFF (flash apagada) até o tamanho total
+    if (st.st_size < PICO_FLASH_SIZE_BYTES) {
+        static const uint8_t erased[FLASH_SECTOR_SIZE] = { [0 ... FLASH_SECTOR_SIZE - 1] = 0xFF };
+        off_t pos = st.st_size;
+        lseek(fd, pos, SEEK_SET);
+        while (pos < PICO_FLASH_SIZE_BYTES) {
+            size_t n = PICO_FLASH_SIZE_BYTES - pos < FLASH_SECTOR_SIZE
+                ? (size_t)(PICO_FLASH_SIZE_BYTES - pos) : FLASH_SECTOR_SIZE;
+            if (write(fd, erased, n) != (ssize_t)n) {
+                close(fd);
+                return false;
+            }
+            pos += n;
+        }
+    }
+    flash = mmap(NULL, PICO_FLASH_SIZE_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (flash == MAP_FAILED) {
+        flash = NULL;
+        close(fd);
+        return false;
+    }
+    flash_fd = fd;
+    return true;
+}
+
+void sim_flash_close(void) {
+    if (flash && flash_fd >= 0) {
+        msync(flash, PICO_FLASH_SIZE_BYTES, MS_SYNC);
+    }
+    sim_flash_unmap();
+}
+
+void sim_flash_cut_after(uint64_t bytes) {
+    cut_remaining = bytes;
+}
+
+bool sim_flash_powered(void) {
+    return powered;
+}
+
+void sim_flash_power_on(void) {
+    powered = true;
+    cut_remaining = 0;
+}
+
+sim_flash_stats_t sim_flash_stats(void) {
+    return stats;
+}
+
+uint32_t sim_flash_sector_erases(uint32_t flash_offs) {
+    return flash_offs < PICO_FLASH_SIZE_BYTES ? erase_counts[flash_offs / FLASH_SECTOR_SIZE] : 0;
+}
+
+/**
+ * @brief Quantos bytes da próxima operação são processados antes do corte
+ */
+static size_t sim_flash_budget(size_t count) {
+    if (cut_remaining == 0 || cut_remaining > count) {
+        if (cut_remaining) cut_remaining -= count;
+        return count;
+    }
+    size_t done = (size_t)(cut_remaining - 1);
+    cut_remaining = 0;
+    powered = false;
+    stats.cuts++;
+    return done;
+}
+
+static uint8_t sim_flash_random_bits(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (uint8_t)(rng_state >> 24);
+}
+
+static void sim_flash_check(uint32_t flash_offs, size_t count, uint32_t align, const char* op) {
+    if (flash_offs % align || count % align || flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        fprintf(stderr, "%s: offset 0x%x e tamanho %zu fora do alinhamento de %u bytes\n",
+                op, flash_offs, count, align);
+        abort();
+    }
+}
+
+// ============================================================================
+// API DO PICO SDK
+// ============================================================================
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    sim_flash_check(flash_offs, count, FLASH_SECTOR_SIZE, "flash_range_erase");
+    uint8_t* mem = sim_flash_data();
+    if (!powered) {
+        return;
+    }
+    size_t done = sim_flash_budget(count);
+    memset(mem + flash_offs, 0xFF, done);
+    if (done < count) {
+        mem[flash_offs + done] |= sim_flash_random_bits();     // Apagamento parcial
+    }
+
+    uint32_t sectors = (uint32_t)((done + FLASH_SECTOR_SIZE - 1) / FLASH_SECTOR_SIZE);
+    for (uint32_t s = 0; s < sectors; s++) {
+        erase_counts[flash_offs / FLASH_SECTOR_SIZE + s]++;
+    }
+    stats.sector_erases += sectors;
+    uint64_t ns = (uint64_t)sectors * SIM_FLASH_SECTOR_ERASE_NS;
+    stats.busy_ns += ns;
+    sim_advance_ns(ns);
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t* data, size_t count) {
+    sim_flash_check(flash_offs, count, FLASH_PAGE_SIZE, "flash_range_program");
+    uint8_t* mem = sim_flash_data();
+    if (!powered) {
+        return;
+    }
+    size_t done = sim_flash_budget(count);
+    for (size_t i = 0; i < done; i++) {
+        mem[flash_offs + i] &= data[i];                         // NOR só limpa bits
+    }
+    if (done < count) {
+        mem[flash_offs + done] &= data[done] | sim_flash_random_bits();
+    }
+
+    uint32_t pages = (uint32_t)((done + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE);
+    stats.page_programs += pages;
+    uint64_t ns = (uint64_t)pages * SIM_FLASH_PAGE_PROGRAM_NS;
+    stats.busy_ns += ns;
+    sim_advance_ns(ns);
+}
+
+int flash_safe_execute(void (*func)(void*), void* param, uint32_t enter_exit_timeout_ms) {
+    uint32_t irq = save_and_disable_interrupts();
+    func(param);
+    restore_interrupts(irq);
+    return PICO_OK;
+}
+
+bool flash_safe_execute_core_init(void) {
+    return true;
+}
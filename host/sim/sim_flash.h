@@ -0,0 +1,50 @@
+#ifndef SIM_FLASH_H
+#define SIM_FLASH_H
+
+// ============================================================================
+// FLASH QSPI SIMULADA
+// ============================================================================
+// Memória de PICO_FLASH_SIZE_BYTES com semântica de NOR (apagamento por setor
+// para 0xFF, gravação por página que só limpa bits) e tempos típicos do
+// W25Q16JV cobrados no relógio virtual. Por padrão a memória é anônima e
+// começa apagada; sim_flash_open() a mapeia em um arquivo, que preserva o
+// conteúdo entre execuções. sim_reset() não altera a flash, como um reboot.
+//
+// Cortes de energia: sim_flash_cut_after(n) interrompe a operação em que o
+// n-ésimo byte seria processado. Na gravação, os bytes anteriores ficam
+// gravados e o byte do corte fica com parte dos bits; no apagamento, os bytes
+// anteriores ficam em 0xFF e os seguintes intactos. Depois do corte a flash
+// ignora gravações e apagamentos até sim_flash_power_on().
+
+#include "sim.h"
+
+#define SIM_FLASH_PAGE_PROGRAM_NS   400000ull       // tPP típico
+#define SIM_FLASH_SECTOR_ERASE_NS   45000000ull     // tSE típico
+
+typedef struct {
+    uint32_t page_programs;     // Páginas gravadas (flash_range_program / 256)
+    uint32_t sector_erases;
+    uint64_t busy_ns;           // Tempo virtual com a flash ocupada
+    uint32_t cuts;              // Cortes de energia ocorridos
+} sim_flash_stats_t;
+
+// Mapeia a flash em um arquivo, criado (ou completado) com 0xFF
+bool sim_flash_open(const char* path);
+
+// Desfaz o mapeamento; a flash volta a ser anônima e apagada
+void sim_flash_close(void);
+
+// Memória da flash (janela XIP no host)
+uint8_t* sim_flash_data(void);
+
+// Corte de energia após mais n bytes processados (0 = sem corte)
+void sim_flash_cut_after(uint64_t bytes);
+bool sim_flash_powered(void);
+void sim_flash_power_on(void);
+
+sim_flash_stats_t sim_flash_stats(void);
+
+// Apagamentos do setor que contém flash_offs desde a abertura da flash
+uint32_t sim_flash_sector_erases(uint32_t flash_offs);
+
+#endif // SIM_FLASH_H
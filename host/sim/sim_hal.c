@@ -0,0 +1,526 @@
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/spi.h"
+#include "hardware/i2c.h"
+#include "hardware/sync.h"
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "hardware/structs/scb.h"
+#include "sim.h"
+
+// ============================================================================
+// SHIM DO PICO SDK SOBRE O SIMULADOR
+// ============================================================================
+
+spi_inst_t sim_spi_inst[2];
+spi_hw_t sim_spi_hw[2];
+i2c_inst_t sim_i2c_inst[2];
+clocks_hw_t sim_clocks_hw;
+armv6m_scb_hw_t sim_scb_hw;
+
+#define SIM_MAX_BUS_DEVICES 4
+#define SIM_MAX_SHARED_IRQ  4           // Tratadores por linha compartilhada
+
+typedef struct {
+    bool out;
+    bool level;
+    uint32_t irq_mask;          // Eventos GPIO_IRQ_EDGE_* habilitados
+    uint32_t irq_pending;       // Eventos adiados com interrupções desabilitadas
+    sim_gpio_listener_t listener;
+    void* listener_ctx;
+} sim_pin_t;
+
+static sim_pin_t pins[NUM_BANK0_GPIOS];
+static gpio_irq_callback_t gpio_callback;
+static bool irq_disabled;
+
+static spin_lock_t spin_locks[32];
+static uint32_t spin_locks_claimed;
+
+typedef struct {
+    irq_handler_t handler;
+    uint8_t order_priority;
+} sim_irq_slot_t;
+
+static sim_irq_slot_t irq_handlers[NUM_IRQS][SIM_MAX_SHARED_IRQ];
+static uint8_t irq_num_handlers[NUM_IRQS];
+static uint32_t irq_enabled_mask;
+static uint32_t irq_pending_mask;
+
+static sim_spi_device_t spi_devices[SIM_MAX_BUS_DEVICES];
+static bool spi_selected[SIM_MAX_BUS_DEVICES];
+static int num_spi_devices;
+
+static sim_i2c_device_t i2c_devices[SIM_MAX_BUS_DEVICES];
+static int num_i2c_devices;
+
+void sim_hal_reset(void) {
+    memset(pins, 0, sizeof(pins));
+    sim_clocks_hw.sleep_en0 = CLOCKS_SLEEP_EN0_RESET;
+    sim_clocks_hw.sleep_en1 = CLOCKS_SLEEP_EN1_RESET;
+    sim_scb_hw.scr = 0;
+    gpio_callback = NULL;
+    irq_disabled = false;
+    memset(irq_handlers, 0, sizeof(irq_handlers));
+    memset(irq_num_handlers, 0, sizeof(irq_num_handlers));
+    irq_enabled_mask = irq_pending_mask = 0;
+    spin_locks_claimed = 0;
+    memset(spi_selected, 0, sizeof(spi_selected));
+    num_spi_devices = 0;
+    num_i2c_devices = 0;
+    sim_spi_inst[0].baudrate = sim_spi_inst[1].baudrate = 0;
+    sim_i2c_inst[0].baudrate = sim_i2c_inst[1].baudrate = 0;
+}
+
+void sim_spi_attach(const sim_spi_device_t* dev) {
+    if (num_spi_devices < SIM_MAX_BUS_DEVICES) {
+        spi_selected[num_spi_devices] = false;
+        spi_devices[num_spi_devices++] = *dev;
+    }
+}
+
+void sim_i2c_attach(const sim_i2c_device_t* dev) {
+    if (num_i2c_devices < SIM_MAX_BUS_DEVICES) {
+        i2c_devices[num_i2c_devices++] = *dev;
+    }
+}
+
+void sim_gpio_listen(uint pin, sim_gpio_listener_t fn, void* ctx) {
+    if (pin < NUM_BANK0_GPIOS) {
+        pins[pin].listener = fn;
+        pins[pin].listener_ctx = ctx;
+    }
+}
+
+// ============================================================================
+// STDIO E TEMPO
+// ============================================================================
+
+bool stdio_init_all(void) {
+    return true;
+}
+
+void sleep_us(uint64_t us) {
+    sim_account_sleep(us * 1000);
+    sim_advance_ns(us * 1000);
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_us((uint64_t)ms * 1000);
+}
+
+void busy_wait_us(uint64_t us) {
+    sim_advance_ns(us * 1000);
+}
+
+uint64_t time_us_64(void) {
+    return sim_now_ns() / 1000;
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)time_us_64();
+}
+
+absolute_time_t get_absolute_time(void) {
+    return time_us_64();
+}
+
+absolute_time_t make_timeout_time_ms(uint32_t ms) {
+    return time_us_64() + (uint64_t)ms * 1000;
+}
+
+absolute_time_t make_timeout_time_us(uint64_t us) {
+    return time_us_64() + us;
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)(t / 1000);
+}
+
+uint64_t to_us_since_boot(absolute_time_t t) {
+    return t;
+}
+
+absolute_time_t from_us_since_boot(uint64_t us) {
+    return us;
+}
+
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) {
+    return (int64_t)(to - from);
+}
+
+absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) {
+    return t + us;
+}
+
+absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) {
+    return t + (uint64_t)ms * 1000;
+}
+
+bool time_reached(absolute_time_t t) {
+    return time_us_64() >= t;
+}
+
+void sleep_until(absolute_time_t t) {
+    uint64_t now = time_us_64();
+    if (t > now) {
+        sleep_us(t - now);
+    }
+}
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+void gpio_init(uint gpio) {
+    if (gpio < NUM_BANK0_GPIOS) {
+        pins[gpio].out = false;
+        pins[gpio].level = false;
+    }
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    if (gpio < NUM_BANK0_GPIOS) pins[gpio].out = out;
+}
+
+void gpio_pull_up(uint gpio) {
+    if (gpio < NUM_BANK0_GPIOS && !pins[gpio].out) pins[gpio].level = true;
+}
+
+void gpio_pull_down(uint gpio) {
+    if (gpio < NUM_BANK0_GPIOS && !pins[gpio].out) pins[gpio].level = false;
+}
+
+/**
+ * @brief Escreve um pino de saída e notifica CS de dispositivos SPI e observadores
+ */
+void gpio_put(uint gpio, bool value) {
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    bool old = pins[gpio].level;
+    pins[gpio].level = value;
+    if (old == value) return;
+
+    for (int i = 0; i < num_spi_devices; i++) {
+        if (spi_devices[i].cs_pin != gpio) continue;
+        if (!value) {
+            spi_selected[i] = true;
+            if (spi_devices[i].select) spi_devices[i].select(spi_devices[i].ctx);
+        } else if (spi_selected[i]) {
+            spi_selected[i] = false;
+            sim_account_spi_transaction();
+            if (spi_devices[i].deselect) spi_devices[i].deselect(spi_devices[i].ctx);
+        }
+    }
+
+    if (pins[gpio].listener) {
+        pins[gpio].listener(pins[gpio].listener_ctx, gpio, value);
+    }
+}
+
+bool gpio_get(uint gpio) {
+    return gpio < NUM_BANK0_GPIOS ? pins[gpio].level : false;
+}
+
+static void sim_irq_dispatch(void);
+
+/**
+ * @brief Entrega os eventos de GPIO pendentes se as interrupções estiverem habilitadas
+ *
+ * Como no NVIC, o tratador não é reentrante: bordas que chegam durante o
+ * callback (ex: um pacote recebido enquanto o anterior é lido do FIFO)
+ * ficam pendentes e são entregues ao fim dele.
+ */
+static void sim_gpio_dispatch(void) {
+    if (irq_disabled || !gpio_callback) return;
+
+    irq_disabled = true;
+    bool again = true;
+    while (again) {
+        again = false;
+        for (uint pin = 0; pin < NUM_BANK0_GPIOS; pin++) {
+            uint32_t events = pins[pin].irq_pending;
+            if (events) {
+                pins[pin].irq_pending = 0;
+                gpio_callback(pin, events);
+                again = true;
+            }
+        }
+    }
+    irq_disabled = false;
+    sim_irq_dispatch();                            // Levantadas durante o callback
+}
+
+void sim_gpio_drive(uint pin, bool level) {
+    if (pin >= NUM_BANK0_GPIOS) return;
+    bool old = pins[pin].level;
+    pins[pin].level = level;
+    if (old == level) return;
+
+    uint32_t event = level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+    if (pins[pin].irq_mask & event) {
+        pins[pin].irq_pending |= event;
+        sim_gpio_dispatch();
+    }
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled) {
+    if (gpio >= NUM_BANK0_GPIOS) return;
+    if (enabled) pins[gpio].irq_mask |= event_mask;
+    else pins[gpio].irq_mask &= ~event_mask;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback) {
+    gpio_set_irq_enabled(gpio, event_mask, enabled);
+    gpio_callback = callback;
+}
+
+// ============================================================================
+// INTERRUPÇÕES E ESPERA
+// ============================================================================
+
+/**
+ * @brief Entrega as interrupções de periféricos pendentes e habilitadas
+ *
+ * Mesma regra do GPIO: sem reentrância e nada com as interrupções desabilitadas.
+ */
+static void sim_irq_dispatch(void) {
+    if (irq_disabled) return;
+
+    irq_disabled = true;
+    uint32_t ready;
+    while ((ready = irq_pending_mask & irq_enabled_mask) != 0) {
+        uint num = (uint)__builtin_ctz(ready);
+        irq_pending_mask &= ~(1u << num);
+        for (int i = 0; i < irq_num_handlers[num]; i++) {
+            irq_handlers[num][i].handler();
+        }
+    }
+    irq_disabled = false;
+}
+
+void sim_irq_raise(uint num) {
+    if (num >= NUM_IRQS) return;
+    irq_pending_mask |= 1u << num;
+    sim_irq_dispatch();
+}
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    if (num >= NUM_IRQS) return;
+    irq_handlers[num][0].handler = handler;
+    irq_num_handlers[num] = handler ? 1 : 0;
+}
+
+/**
+ * @brief Acrescenta um tratador à linha, como no SDK: maior order_priority
+ *        roda antes; com a lista cheia o pedido é ignorado
+ */
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority) {
+    if (num >= NUM_IRQS || !handler || irq_num_handlers[num] >= SIM_MAX_SHARED_IRQ) return;
+
+    sim_irq_slot_t* slots = irq_handlers[num];
+    int i = irq_num_handlers[num]++;
+    while (i > 0 && slots[i - 1].order_priority < order_priority) {
+        slots[i] = slots[i - 1];
+        i--;
+    }
+    slots[i] = (sim_irq_slot_t){ handler, order_priority };
+}
+
+void irq_clear(uint int_num) {
+    if (int_num < NUM_IRQS) irq_pending_mask &= ~(1u << int_num);
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    if (num >= NUM_IRQS) return;
+    if (enabled) irq_enabled_mask |= 1u << num;
+    else irq_enabled_mask &= ~(1u << num);
+    sim_irq_dispatch();
+}
+
+uint32_t save_and_disable_interrupts(void) {
+    uint32_t status = irq_disabled;
+    irq_disabled = true;
+    return status;
+}
+
+void restore_interrupts(uint32_t status) {
+    irq_disabled = status != 0;
+    sim_gpio_dispatch();
+    sim_irq_dispatch();
+}
+
+/**
+ * @brief Há interrupção habilitada pendente (só possível com PRIMASK ativo)?
+ */
+static bool sim_irq_pending(void) {
+    if (irq_pending_mask & irq_enabled_mask) return true;
+    for (uint pin = 0; gpio_callback && pin < NUM_BANK0_GPIOS; pin++) {
+        if (pins[pin].irq_pending) return true;
+    }
+    return false;
+}
+
+void __wfi(void) {
+    if (sim_irq_pending()) {
+        sim_advance_ns(SIM_WFI_PENDING_NS);      // Não dorme: o núcleo segue acordado
+        return;
+    }
+    sim_wait_for_event();
+}
+
+void __wfe(void) {
+    sim_wait_for_event();
+}
+
+void __sev(void) {
+}
+
+int spin_lock_claim_unused(bool required) {
+    for (uint i = 0; i < 32; i++) {
+        if (!(spin_locks_claimed & (1u << i))) {
+            spin_locks_claimed |= 1u << i;
+            return (int)i;
+        }
+    }
+    return required ? 0 : -1;
+}
+
+spin_lock_t* spin_lock_init(uint lock_num) {
+    spin_lock_t* lock = &spin_locks[lock_num & 31];
+    *lock = 0;
+    return lock;
+}
+
+// ============================================================================
+// SPI
+// ============================================================================
+
+uint spi_init(spi_inst_t *spi, uint baudrate) {
+    return spi_set_baudrate(spi, baudrate);
+}
+
+void spi_deinit(spi_inst_t *spi) {
+    spi->baudrate = 0;
+}
+
+uint spi_set_baudrate(spi_inst_t *spi, uint baudrate) {
+    spi->baudrate = baudrate;
+    return baudrate;
+}
+
+uint spi_get_baudrate(const spi_inst_t *spi) {
+    return spi->baudrate;
+}
+
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order) {
+    (void)spi;
+    (void)data_bits;
+    (void)cpol;
+    (void)cpha;
+    (void)order;
+}
+
+uint8_t sim_spi_exchange(spi_inst_t *spi, uint8_t tx) {
+    uint8_t rx = 0xFF;   // Linha MISO em pull-up sem dispositivo selecionado
+    for (int i = 0; i < num_spi_devices; i++) {
+        if (spi_devices[i].spi == spi && spi_selected[i]) {
+            rx = spi_devices[i].exchange(spi_devices[i].ctx, tx);
+        }
+    }
+    return rx;
+}
+
+/**
+ * @brief Troca bytes com o dispositivo selecionado e contabiliza o barramento
+ */
+static int sim_spi_transfer(spi_inst_t *spi, const uint8_t *src, uint8_t repeated_tx, uint8_t *dst, size_t len) {
+    for (size_t n = 0; n < len; n++) {
+        uint8_t rx = sim_spi_exchange(spi, src ? src[n] : repeated_tx);
+        if (dst) dst[n] = rx;
+    }
+
+    uint baud = spi->baudrate ? spi->baudrate : 1000000;
+    uint64_t ns = SIM_SPI_CALL_OVERHEAD_NS + (uint64_t)len * 8 * 1000000000ull / baud;
+    sim_account_spi((uint32_t)len, ns);
+    sim_advance_ns(ns);
+    return (int)len;
+}
+
+int spi_write_read_blocking(spi_inst_t *spi, const uint8_t *src, uint8_t *dst, size_t len) {
+    return sim_spi_transfer(spi, src, 0, dst, len);
+}
+
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len) {
+    return sim_spi_transfer(spi, src, 0, NULL, len);
+}
+
+int spi_read_blocking(spi_inst_t *spi, uint8_t repeated_tx_data, uint8_t *dst, size_t len) {
+    return sim_spi_transfer(spi, NULL, repeated_tx_data, dst, len);
+}
+
+// ============================================================================
+// I2C
+// ============================================================================
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    return i2c_set_baudrate(i2c, baudrate);
+}
+
+void i2c_deinit(i2c_inst_t *i2c) {
+    i2c->baudrate = 0;
+}
+
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+static sim_i2c_device_t* sim_i2c_find(i2c_inst_t *i2c, uint8_t addr) {
+    for (int i = 0; i < num_i2c_devices; i++) {
+        if (i2c_devices[i].i2c == i2c && i2c_devices[i].addr == addr) {
+            return &i2c_devices[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Contabiliza uma transação I2C: START + endereço + dados (9 clocks/byte) + STOP
+ */
+static void sim_i2c_account(i2c_inst_t *i2c, size_t len) {
+    uint baud = i2c->baudrate ? i2c->baudrate : 100000;
+    uint64_t bits = 2 + (uint64_t)(len + 1) * 9;
+    uint64_t ns = SIM_I2C_CALL_OVERHEAD_NS + bits * 1000000000ull / baud;
+    sim_account_i2c((uint32_t)len, ns);
+    sim_advance_ns(ns);
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)nostop;
+    sim_i2c_device_t* dev = sim_i2c_find(i2c, addr);
+    if (!dev) {
+        sim_i2c_account(i2c, 0);
+        return PICO_ERROR_GENERIC;
+    }
+    bool ack = dev->write(dev->ctx, src, len);
+    sim_i2c_account(i2c, len);
+    return ack ? (int)len : PICO_ERROR_GENERIC;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    (void)nostop;
+    sim_i2c_device_t* dev = sim_i2c_find(i2c, addr);
+    if (!dev) {
+        sim_i2c_account(i2c, 0);
+        return PICO_ERROR_GENERIC;
+    }
+    bool ack = dev->read(dev->ctx, dst, len);
+    sim_i2c_account(i2c, len);
+    return ack ? (int)len : PICO_ERROR_GENERIC;
+}
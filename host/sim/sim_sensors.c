@@ -0,0 +1,288 @@
+#include <math.h>
+#include <string.h>
+
+#include "sim_sensors.h"
+
+// ============================================================================
+// AHT20
+// ============================================================================
+
+#define AHT20_CMD_INIT              0xBE
+#define AHT20_CMD_TRIGGER           0xAC
+#define AHT20_CMD_RESET             0xBA
+#define AHT20_STATUS_BUSY           0x80
+#define AHT20_STATUS_IDLE           0x10
+#define AHT20_STATUS_CALIBRATED     0x08
+#define AHT20_INIT_NS               10000000ull
+
+static uint8_t aht20_crc8(const uint8_t* data, int len) {
+    uint8_t crc = 0xFF;
+    for (int i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief Codifica a medição atual do ambiente no formato de 20 bits do AHT20
+ *
+ * S_RH = RH / 100 * 2^20 e S_T = (T + 50) / 200 * 2^20
+ */
+static void aht20_latch(sim_aht20_t* s) {
+    sim_env_t env = sim_env_get();
+    double rh = fmin(fmax(env.humidity_rh, 0.0), 100.0);
+    double t = fmin(fmax(env.temperature_c, -50.0), 150.0);
+    uint32_t srh = (uint32_t)fmin(rh / 100.0 * 1048576.0, 1048575.0);
+    uint32_t st = (uint32_t)fmin((t + 50.0) / 200.0 * 1048576.0, 1048575.0);
+
+    s->data[1] = (uint8_t)(srh >> 12);
+    s->data[2] = (uint8_t)(srh >> 4);
+    s->data[3] = (uint8_t)(((srh & 0x0F) << 4) | (st >> 16));
+    s->data[4] = (uint8_t)(st >> 8);
+    s->data[5] = (uint8_t)st;
+    s->measurements++;
+}
+
+static bool aht20_write(void* ctx, const uint8_t* src, size_t len) {
+    sim_aht20_t* s = ctx;
+    uint64_t now = sim_now_ns();
+    if (len == 0) return true;
+
+    switch (src[0]) {
+        case AHT20_CMD_INIT:
+            s->calibrated = true;
+            s->busy_until_ns = now + AHT20_INIT_NS;
+            break;
+        case AHT20_CMD_TRIGGER:
+            if (now < s->busy_until_ns) break;  // Comando ignorado enquanto ocupado
+            s->busy_until_ns = now + SIM_AHT20_MEASURE_NS;
+            s->pending = true;
+            break;
+        case AHT20_CMD_RESET:
+            s->calibrated = false;
+            s->busy_until_ns = now + SIM_AHT20_RESET_NS;
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+static bool aht20_read(void* ctx, uint8_t* dst, size_t len) {
+    sim_aht20_t* s = ctx;
+    bool busy = sim_now_ns() < s->busy_until_ns;
+
+    if (!busy && s->pending) {
+        aht20_latch(s);
+        s->pending = false;
+    }
+    s->data[0] = (busy ? AHT20_STATUS_BUSY : 0) | AHT20_STATUS_IDLE
+               | (s->calibrated ? AHT20_STATUS_CALIBRATED : 0);
+    s->data[6] = aht20_crc8(s->data, 6);
+
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = i < sizeof(s->data) ? s->data[i] : 0xFF;
+    }
+    return true;
+}
+
+void sim_aht20_init(sim_aht20_t* s, i2c_inst_t* i2c) {
+    memset(s, 0, sizeof(*s));
+    sim_i2c_device_t dev = {
+        .i2c = i2c, .addr = SIM_AHT20_ADDR, .ctx = s,
+        .write = aht20_write, .read = aht20_read,
+    };
+    sim_i2c_attach(&dev);
+}
+
+// ============================================================================
+// BMP280
+// ============================================================================
+
+#define BMP280_REG_CALIB            0x88
+#define BMP280_REG_ID               0xD0
+#define BMP280_REG_RESET            0xE0
+#define BMP280_REG_STATUS           0xF3
+#define BMP280_REG_CTRL_MEAS        0xF4
+#define BMP280_REG_CONFIG           0xF5
+#define BMP280_REG_PRESS_MSB        0xF7
+#define BMP280_REG_TEMP_MSB         0xFA
+#define BMP280_CHIP_ID              0x58
+#define BMP280_STATUS_MEASURING     0x08
+
+// Parâmetros de calibração do exemplo do datasheet (seção 3.12)
+static const uint16_t calib_t1 = 27504;
+static const int16_t calib_t[] = { 26435, -1000 };
+static const uint16_t calib_p1 = 36477;
+static const int16_t calib_p[] = { -10685, 3024, 2855, 140, -7, 15500, -14600, 6000 };
+
+static double bmp280_compensate_t(int32_t adc_t, double* t_fine) {
+    double var1 = (adc_t / 16384.0 - calib_t1 / 1024.0) * calib_t[0];
+    double var2 = (adc_t / 131072.0 - calib_t1 / 8192.0);
+    var2 = var2 * var2 * calib_t[1];
+    *t_fine = var1 + var2;
+    return (var1 + var2) / 5120.0;
+}
+
+static double bmp280_compensate_p(int32_t adc_p, double t_fine) {
+    double var1 = t_fine / 2.0 - 64000.0;
+    double var2 = var1 * var1 * calib_p[4] / 32768.0;
+    var2 = var2 + var1 * calib_p[3] * 2.0;
+    var2 = var2 / 4.0 + calib_p[2] * 65536.0;
+    var1 = (calib_p[1] * var1 * var1 / 524288.0 + calib_p[0] * var1) / 524288.0;
+    var1 = (1.0 + var1 / 32768.0) * calib_p1;
+    if (var1 == 0.0) return 0.0;
+    double p = 1048576.0 - adc_p;
+    p = (p - var2 / 4096.0) * 6250.0 / var1;
+    var1 = calib_p[7] * p * p / 2147483648.0;
+    var2 = p * calib_p[6] / 32768.0;
+    return p + (var1 + var2 + calib_p[5]) / 16.0;
+}
+
+static void bmp280_store_adc(uint8_t* regs, int32_t adc) {
+    regs[0] = (uint8_t)(adc >> 12);
+    regs[1] = (uint8_t)(adc >> 4);
+    regs[2] = (uint8_t)((adc & 0x0F) << 4);
+}
+
+/**
+ * @brief Converte o ambiente atual em leituras brutas do ADC
+ *
+ * Inverte a compensação em ponto flutuante do datasheet por busca binária:
+ * a temperatura cresce e a pressão decresce monotonicamente com o ADC.
+ */
+static void bmp280_latch(sim_bmp280_t* s) {
+    sim_env_t env = sim_env_get();
+    double t_fine = 0.0;
+
+    int32_t lo = 0, hi = 0xFFFFF;
+    while (lo < hi) {
+        int32_t mid = (lo + hi) / 2;
+        if (bmp280_compensate_t(mid, &t_fine) < env.temperature_c) lo = mid + 1;
+        else hi = mid;
+    }
+    int32_t adc_t = lo;
+    bmp280_compensate_t(adc_t, &t_fine);
+
+    lo = 0;
+    hi = 0xFFFFF;
+    while (lo < hi) {
+        int32_t mid = (lo + hi) / 2;
+        if (bmp280_compensate_p(mid, t_fine) > env.pressure_pa) lo = mid + 1;
+        else hi = mid;
+    }
+
+    bmp280_store_adc(&s->regs[BMP280_REG_PRESS_MSB], lo);
+    bmp280_store_adc(&s->regs[BMP280_REG_TEMP_MSB], adc_t);
+    s->conversions++;
+}
+
+static void bmp280_reset_registers(sim_bmp280_t* s) {
+    memset(&s->regs[BMP280_REG_STATUS], 0, 0x100 - BMP280_REG_STATUS);
+    s->regs[BMP280_REG_ID] = BMP280_CHIP_ID;
+    bmp280_store_adc(&s->regs[BMP280_REG_PRESS_MSB], 0x80000);
+    bmp280_store_adc(&s->regs[BMP280_REG_TEMP_MSB], 0x80000);
+    s->measuring_until_ns = 0;
+    s->pending_forced = false;
+}
+
+/**
+ * @brief Tempo típico de conversão (datasheet, apêndice B)
+ *
+ * t = 1 + 2 * T_os + 2 * P_os + 0.5 ms (P_os > 0), com T_os/P_os = 2^(osrs - 1)
+ */
+uint64_t sim_bmp280_conversion_ns(const sim_bmp280_t* s) {
+    uint8_t ctrl = s->regs[BMP280_REG_CTRL_MEAS];
+    int osrs_t = (ctrl >> 5) & 0x07;
+    int osrs_p = (ctrl >> 2) & 0x07;
+    int t_os = osrs_t ? 1 << ((osrs_t > 5 ? 5 : osrs_t) - 1) : 0;
+    int p_os = osrs_p ? 1 << ((osrs_p > 5 ? 5 : osrs_p) - 1) : 0;
+    uint64_t us = 1000 + 2000 * t_os + (p_os ? 2000 * p_os + 500 : 0);
+    return us * 1000;
+}
+
+/**
+ * @brief Conclui conversões pendentes antes de qualquer acesso ao sensor
+ */
+static void bmp280_update(sim_bmp280_t* s) {
+    uint64_t now = sim_now_ns();
+    uint8_t mode = s->regs[BMP280_REG_CTRL_MEAS] & 0x03;
+
+    if (s->pending_forced && now >= s->measuring_until_ns) {
+        bmp280_latch(s);
+        s->pending_forced = false;
+        s->regs[BMP280_REG_CTRL_MEAS] &= 0xFC;  // Volta ao modo Sleep
+    } else if (mode == 0x03 && now >= s->measuring_until_ns) {
+        bmp280_latch(s);                        // Modo normal: dado sempre recente
+    }
+
+    s->regs[BMP280_REG_STATUS] = now < s->measuring_until_ns ? BMP280_STATUS_MEASURING : 0;
+}
+
+static bool bmp280_write(void* ctx, const uint8_t* src, size_t len) {
+    sim_bmp280_t* s = ctx;
+    if (len == 0) return true;
+    bmp280_update(s);
+
+    // Escrita em pares (registrador, valor); um único byte só move o ponteiro
+    s->pointer = src[0];
+    for (size_t i = 0; i + 1 < len; i += 2) {
+        uint8_t reg = src[i];
+        uint8_t value = src[i + 1];
+
+        if (reg == BMP280_REG_RESET) {
+            if (value == 0xB6) bmp280_reset_registers(s);
+            continue;
+        }
+        if (reg != BMP280_REG_CTRL_MEAS && reg != BMP280_REG_CONFIG) continue;
+
+        s->regs[reg] = value;
+        if (reg == BMP280_REG_CTRL_MEAS) {
+            uint8_t mode = value & 0x03;
+            if (mode == 0x01 || mode == 0x02) {
+                s->pending_forced = true;
+                s->measuring_until_ns = sim_now_ns() + sim_bmp280_conversion_ns(s);
+            } else if (mode == 0x03) {
+                s->measuring_until_ns = sim_now_ns() + sim_bmp280_conversion_ns(s);
+            }
+        }
+    }
+    return true;
+}
+
+static bool bmp280_read(void* ctx, uint8_t* dst, size_t len) {
+    sim_bmp280_t* s = ctx;
+    bmp280_update(s);
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = s->regs[s->pointer++];
+    }
+    return true;
+}
+
+void sim_bmp280_init(sim_bmp280_t* s, i2c_inst_t* i2c) {
+    memset(s, 0, sizeof(*s));
+
+    uint8_t* c = &s->regs[BMP280_REG_CALIB];
+    c[0] = (uint8_t)calib_t1;
+    c[1] = (uint8_t)(calib_t1 >> 8);
+    for (int i = 0; i < 2; i++) {
+        c[2 + 2 * i] = (uint8_t)calib_t[i];
+        c[3 + 2 * i] = (uint8_t)((uint16_t)calib_t[i] >> 8);
+    }
+    c[6] = (uint8_t)calib_p1;
+    c[7] = (uint8_t)(calib_p1 >> 8);
+    for (int i = 0; i < 8; i++) {
+        c[8 + 2 * i] = (uint8_t)calib_p[i];
+        c[9 + 2 * i] = (uint8_t)((uint16_t)calib_p[i] >> 8);
+    }
+    bmp280_reset_registers(s);
+
+    sim_i2c_device_t dev = {
+        .i2c = i2c, .addr = SIM_BMP280_ADDR, .ctx = s,
+        .write = bmp280_write, .read = bmp280_read,
+    };
+    sim_i2c_attach(&dev);
+}
@@ -0,0 +1,42 @@
+#ifndef SIM_SENSORS_H
+#define SIM_SENSORS_H
+
+// ============================================================================
+// MODELOS I2C DO AHT20 E DO BMP280
+// ============================================================================
+// Os dois sensores leem as grandezas físicas de sim_env_get() no instante em
+// que a conversão termina, codificadas como o hardware real (20 bits do
+// AHT20; ADC do BMP280 obtido invertendo a compensação do datasheet).
+
+#include "sim.h"
+
+#define SIM_AHT20_ADDR              0x38
+#define SIM_BMP280_ADDR             0x76
+
+// Tempo de medição do AHT20 após o comando 0xAC (datasheet: 80 ms)
+#define SIM_AHT20_MEASURE_NS        80000000ull
+#define SIM_AHT20_RESET_NS          20000000ull
+
+typedef struct {
+    bool calibrated;
+    bool pending;               // Medição disparada ainda não registrada
+    uint64_t busy_until_ns;
+    uint8_t data[7];            // Status + 5 bytes de medição + CRC
+    uint32_t measurements;
+} sim_aht20_t;
+
+typedef struct {
+    uint8_t regs[256];
+    uint8_t pointer;
+    uint64_t measuring_until_ns;// Fim da conversão em andamento
+    bool pending_forced;        // Conversão forçada aguardando conclusão
+    uint32_t conversions;
+} sim_bmp280_t;
+
+void sim_aht20_init(sim_aht20_t* s, i2c_inst_t* i2c);
+void sim_bmp280_init(sim_bmp280_t* s, i2c_inst_t* i2c);
+
+// Tempo de conversão típico do BMP280 para a configuração de REG_CTRL_MEAS
+uint64_t sim_bmp280_conversion_ns(const sim_bmp280_t* s);
+
+#endif // SIM_SENSORS_H
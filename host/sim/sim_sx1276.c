@@ -0,0 +1,390 @@
+#include <math.h>
+#include <string.h>
+
+#include "hardware/spi.h"
+#include "sim_sx1276.h"
+#include "rfm95_definitions.h"
+
+#define REG_SYMB_TIMEOUT_LSB        0x1F
+#define REG_MAX_PAYLOAD_LENGTH      0x23
+#define REG_SYNC_WORD               0x39
+
+#define OPMODE_MODE_MASK            0x07
+#define REG_RX_CONFIG_FSK           0x0D
+#define RX_CONFIG_RESTART_MASK      0x60    // RestartRxWithoutPllLock/WithPllLock: lidos como 0
+#define DIO0_MAPPING_SHIFT          6
+
+// Tempo de sintetizador (TS_FS) entre Standby e início do preâmbulo
+#define SX1276_TS_TX_NS             60000
+
+// Largura de banda em Hz indexada por REG_MODEM_CONFIG_1[7:4]
+static const double bandwidth_hz[] = {
+    7812.5, 10416.667, 15625.0, 20833.333, 31250.0,
+    41666.667, 62500.0, 125000.0, 250000.0, 500000.0,
+};
+
+// ============================================================================
+// REGISTRADORES E SINAIS
+// ============================================================================
+
+static void sx1276_reset_registers(sim_sx1276_t* d) {
+    memset(d->regs, 0, sizeof(d->regs));
+    memset(d->fsk_regs, 0, sizeof(d->fsk_regs));
+    memset(d->fifo, 0, sizeof(d->fifo));
+
+    d->fsk_regs[REG_RX_CONFIG_FSK]  = 0x0E;     // RegRxConfig (FSK)
+
+    d->regs[REG_OPMODE]             = 0x09;     // FSK, Standby
+    d->regs[REG_FRF_MSB]            = 0x6C;     // 434 MHz
+    d->regs[REG_FRF_MID]            = 0x80;
+    d->regs[REG_FRF_LSB]            = 0x00;
+    d->regs[REG_PA_CONFIG]          = 0x4F;
+    d->regs[REG_LNA]                = 0x20;
+    d->regs[REG_FIFO_TX_BASE_AD]    = 0x80;
+    d->regs[REG_MODEM_CONFIG_1]     = 0x72;
+    d->regs[REG_MODEM_CONFIG_2]     = 0x70;
+    d->regs[REG_SYMB_TIMEOUT_LSB]   = 0x64;
+    d->regs[REG_PREAMBLE_LSB]       = 0x08;
+    d->regs[REG_PAYLOAD_LENGTH]     = 0x01;
+    d->regs[REG_MAX_PAYLOAD_LENGTH] = 0xFF;
+    d->regs[REG_DETECT_OPT]         = 0xC3;
+    d->regs[REG_DETECTION_THRESHOLD] = 0x0A;
+    d->regs[REG_SYNC_WORD]          = 0x12;
+    d->regs[REG_VERSION]            = 0x12;
+    d->regs[REG_PA_DAC]             = 0x84;
+
+    d->tx_end_ns = SIM_NEVER;
+    d->rx_wptr = 0;
+}
+
+uint8_t sim_sx1276_mode(const sim_sx1276_t* d) {
+    return d->regs[REG_OPMODE] & OPMODE_MODE_MASK;
+}
+
+/**
+ * @brief Atualiza o nível de DIO0 a partir das flags e de REG_DIO_MAPPING_1
+ *
+ * Mapeamento LoRa de DIO0: 00 = RxDone, 01 = TxDone, 10 = CadDone.
+ */
+static void sx1276_update_dio0(sim_sx1276_t* d) {
+    static const uint8_t dio0_source[4] = { IRQ_RX_DONE_MASK, IRQ_TX_DONE_MASK, 0x04, 0x00 };
+    uint8_t mapping = (d->regs[REG_DIO_MAPPING_1] >> DIO0_MAPPING_SHIFT) & 0x03;
+    bool level = (d->regs[REG_IRQ_FLAGS] & dio0_source[mapping]) != 0;
+
+    if (level != d->dio0) {
+        d->dio0 = level;
+        if (d->dio0_pin != SIM_SX1276_NO_PIN) sim_gpio_drive(d->dio0_pin, level);
+    }
+}
+
+static void sx1276_set_mode(sim_sx1276_t* d, uint8_t value) {
+    uint64_t now = sim_now_ns();
+    uint8_t old_mode = sim_sx1276_mode(d);
+    uint8_t new_mode = value & OPMODE_MODE_MASK;
+
+    d->mode_ns[old_mode] += now - d->mode_since_ns;
+    d->mode_since_ns = now;
+    d->regs[REG_OPMODE] = value;
+
+    if (old_mode == MODE_TX && new_mode != MODE_TX) {
+        d->tx_end_ns = SIM_NEVER;               // Transmissão abortada
+    }
+
+    if (new_mode == MODE_SLEEP && (value & MODE_LORA)) {
+        memset(d->fifo, 0, sizeof(d->fifo));    // FIFO é apagado no Sleep
+    }
+
+    if (new_mode == MODE_TX && old_mode != MODE_TX && (value & MODE_LORA)) {
+        d->tx_start_ns = now;
+        d->tx_end_ns = now + SX1276_TS_TX_NS
+                     + sim_sx1276_time_on_air_ns(d, d->regs[REG_PAYLOAD_LENGTH]);
+    }
+
+    if ((new_mode == MODE_RX_CONTINUOUS || new_mode == MODE_RX_SINGLE) && old_mode != new_mode) {
+        d->rx_wptr = d->regs[REG_FIFO_RX_BASE_AD];
+    }
+}
+
+/**
+ * @brief Registrador FSK no lugar do LoRa, ou NULL fora da faixa ou em modo LoRa
+ */
+static uint8_t* sx1276_fsk_register(sim_sx1276_t* d, uint8_t reg) {
+    if ((d->regs[REG_OPMODE] & MODE_LORA) || reg < SIM_SX1276_FSK_PAGE_START || reg >= SIM_SX1276_FSK_PAGE_END) {
+        return NULL;
+    }
+    return &d->fsk_regs[reg];
+}
+
+static void sx1276_write_register(sim_sx1276_t* d, uint8_t reg, uint8_t value) {
+    uint8_t* fsk = sx1276_fsk_register(d, reg);
+    if (fsk) {
+        *fsk = reg == REG_RX_CONFIG_FSK ? (uint8_t)(value & ~RX_CONFIG_RESTART_MASK) : value;
+        return;
+    }
+    switch (reg) {
+        case REG_FIFO:
+            if (sim_sx1276_mode(d) == MODE_SLEEP) {
+                d->fifo_dropped++;
+                return;
+            }
+            d->fifo[d->regs[REG_FIFO_ADDR_PTR]++] = value;
+            return;
+        case REG_OPMODE:
+            sx1276_set_mode(d, value);
+            return;
+        case REG_IRQ_FLAGS:
+            d->regs[REG_IRQ_FLAGS] &= (uint8_t)~value;
+            sx1276_update_dio0(d);
+            return;
+        case REG_FIFO_RX_CURRENT_ADDR:
+        case REG_RX_NB_BYTES:
+        case REG_PKT_SNR_VALUE:
+        case REG_PKT_RSSI_VALUE:
+        case REG_VERSION:
+            return;                             // Somente leitura
+        case REG_DIO_MAPPING_1:
+            d->regs[reg] = value;
+            sx1276_update_dio0(d);
+            return;
+        default:
+            d->regs[reg] = value;
+            return;
+    }
+}
+
+static uint8_t sx1276_read_register(sim_sx1276_t* d, uint8_t reg) {
+    if (reg == REG_FIFO) {
+        if (sim_sx1276_mode(d) == MODE_SLEEP) {
+            d->fifo_dropped++;
+            return 0;
+        }
+        return d->fifo[d->regs[REG_FIFO_ADDR_PTR]++];
+    }
+    uint8_t* fsk = sx1276_fsk_register(d, reg);
+    return fsk ? *fsk : d->regs[reg];
+}
+
+// ============================================================================
+// BARRAMENTO SPI
+// ============================================================================
+
+static void sx1276_select(void* ctx) {
+    sim_sx1276_t* d = ctx;
+    d->frame_first = true;
+}
+
+/**
+ * @brief Processa um byte do quadro SPI
+ *
+ * O primeiro byte é o endereço (bit 7 = escrita). Os seguintes acessam
+ * registradores consecutivos, exceto REG_FIFO, que não incrementa o endereço.
+ */
+static uint8_t sx1276_exchange(void* ctx, uint8_t tx) {
+    sim_sx1276_t* d = ctx;
+
+    if (d->frame_first) {
+        d->frame_first = false;
+        d->frame_write = (tx & 0x80) != 0;
+        d->frame_addr = tx & 0x7F;
+        return 0x00;
+    }
+
+    bool garbled = spi_get_baudrate(d->spi) > d->max_spi_hz;
+    if (garbled) {
+        tx = (uint8_t)((tx << 1) | 1);
+    }
+
+    uint8_t rx = 0x00;
+    if (d->frame_write) {
+        sx1276_write_register(d, d->frame_addr, tx);
+    } else {
+        rx = sx1276_read_register(d, d->frame_addr);
+    }
+    if (d->frame_addr != REG_FIFO) {
+        d->frame_addr = (d->frame_addr + 1) & 0x7F;
+    }
+    return garbled ? (uint8_t)((rx << 1) | 1) : rx;
+}
+
+static void sx1276_reset_pin(void* ctx, uint pin, bool level) {
+    (void)pin;
+    sim_sx1276_t* d = ctx;
+    if (!level) {
+        uint64_t now = sim_now_ns();
+        d->mode_ns[sim_sx1276_mode(d)] += now - d->mode_since_ns;
+        d->mode_since_ns = now;
+        sx1276_reset_registers(d);
+        sx1276_update_dio0(d);
+    }
+}
+
+// ============================================================================
+// EVENTOS TEMPORIZADOS
+// ============================================================================
+
+static uint64_t sx1276_next_event(void* ctx) {
+    sim_sx1276_t* d = ctx;
+    uint64_t next = d->tx_end_ns;
+    if (d->rx_count > 0 && d->rx_queue[0].end_ns < next) {
+        next = d->rx_queue[0].end_ns;
+    }
+    return next;
+}
+
+static void sx1276_finish_tx(sim_sx1276_t* d) {
+    uint8_t len = d->regs[REG_PAYLOAD_LENGTH];
+    uint8_t data[256];
+    uint8_t base = d->regs[REG_FIFO_TX_BASE_AD];
+    for (int i = 0; i < len; i++) {
+        data[i] = d->fifo[(uint8_t)(base + i)];
+    }
+
+    uint64_t start = d->tx_start_ns, end = d->tx_end_ns;
+    d->tx_end_ns = SIM_NEVER;
+    d->tx_packets++;
+    d->regs[REG_IRQ_FLAGS] |= IRQ_TX_DONE_MASK;
+    sx1276_set_mode(d, (d->regs[REG_OPMODE] & ~OPMODE_MODE_MASK) | MODE_STDBY);
+
+    if (d->on_tx) d->on_tx(d->on_tx_ctx, data, len, start, end);
+    sx1276_update_dio0(d);
+}
+
+static void sx1276_deliver_rx(sim_sx1276_t* d, const sim_sx1276_rx_t* p) {
+    uint8_t mode = sim_sx1276_mode(d);
+    if (!(d->regs[REG_OPMODE] & MODE_LORA) ||
+        (mode != MODE_RX_CONTINUOUS && mode != MODE_RX_SINGLE)) {
+        d->rx_missed++;
+        return;
+    }
+
+    if (d->regs[REG_IRQ_FLAGS] & IRQ_RX_DONE_MASK) {
+        d->rx_overwritten++;                    // Pacote anterior não foi tratado
+    }
+
+    uint8_t start = d->rx_wptr;
+    for (int i = 0; i < p->len; i++) {
+        d->fifo[d->rx_wptr++] = p->data[i];
+    }
+    d->regs[REG_FIFO_RX_CURRENT_ADDR] = start;
+    d->regs[REG_RX_NB_BYTES] = p->len;
+    d->regs[REG_PKT_RSSI_VALUE] = (uint8_t)(p->rssi_dbm + 157);
+    d->regs[REG_PKT_SNR_VALUE] = (uint8_t)p->snr_quarter_db;
+    d->regs[REG_IRQ_FLAGS] |= IRQ_RX_DONE_MASK;
+    if (!p->crc_ok) d->regs[REG_IRQ_FLAGS] |= IRQ_PAYLOAD_CRC_ERROR_MASK;
+    d->rx_packets++;
+
+    if (mode == MODE_RX_SINGLE) {
+        sx1276_set_mode(d, (d->regs[REG_OPMODE] & ~OPMODE_MODE_MASK) | MODE_STDBY);
+    }
+    sx1276_update_dio0(d);
+}
+
+static void sx1276_run_until(void* ctx, uint64_t now) {
+    sim_sx1276_t* d = ctx;
+
+    for (;;) {
+        bool tx_due = d->tx_end_ns <= now;
+        bool rx_due = d->rx_count > 0 && d->rx_queue[0].end_ns <= now;
+        if (!tx_due && !rx_due) break;
+
+        if (tx_due && (!rx_due || d->tx_end_ns <= d->rx_queue[0].end_ns)) {
+            sx1276_finish_tx(d);
+        } else {
+            sim_sx1276_rx_t p = d->rx_queue[0];
+            d->rx_count--;
+            memmove(&d->rx_queue[0], &d->rx_queue[1], d->rx_count * sizeof(d->rx_queue[0]));
+            sx1276_deliver_rx(d, &p);
+        }
+    }
+}
+
+// ============================================================================
+// API PÚBLICA
+// ============================================================================
+
+void sim_sx1276_init(sim_sx1276_t* d, spi_inst_t* spi, uint cs_pin, uint rst_pin) {
+    memset(d, 0, sizeof(*d));
+    d->cs_pin = cs_pin;
+    d->rst_pin = rst_pin;
+    d->dio0_pin = SIM_SX1276_NO_PIN;
+    d->spi = spi;
+    d->max_spi_hz = SIM_SX1276_MAX_SPI_HZ;
+    d->mode_since_ns = sim_now_ns();
+    sx1276_reset_registers(d);
+
+    sim_spi_device_t bus = {
+        .spi = spi, .cs_pin = cs_pin, .ctx = d,
+        .select = sx1276_select, .exchange = sx1276_exchange, .deselect = NULL,
+    };
+    sim_spi_attach(&bus);
+    sim_gpio_listen(rst_pin, sx1276_reset_pin, d);
+
+    sim_device_t dev = { .ctx = d, .next_event_ns = sx1276_next_event, .run_until = sx1276_run_until };
+    sim_register_device(&dev);
+}
+
+void sim_sx1276_set_max_spi_hz(sim_sx1276_t* d, uint32_t hz) {
+    d->max_spi_hz = hz;
+}
+
+void sim_sx1276_set_dio0_pin(sim_sx1276_t* d, uint pin) {
+    d->dio0_pin = pin;
+    if (pin != SIM_SX1276_NO_PIN) sim_gpio_drive(pin, d->dio0);
+}
+
+void sim_sx1276_on_tx(sim_sx1276_t* d, sim_sx1276_tx_cb_t fn, void* ctx) {
+    d->on_tx = fn;
+    d->on_tx_ctx = ctx;
+}
+
+/**
+ * @brief Tempo no ar LoRa conforme a seção 4.1.1.7 do datasheet do SX1276
+ *
+ * T_sym = 2^SF / BW
+ * T_preamble = (n_preamble + 4.25) * T_sym
+ * n_payload = 8 + max(ceil((8PL - 4SF + 28 + 16CRC - 20IH) / (4(SF - 2DE))) * (CR + 4), 0)
+ */
+uint64_t sim_sx1276_time_on_air_ns(const sim_sx1276_t* d, uint8_t len) {
+    uint8_t cfg1 = d->regs[REG_MODEM_CONFIG_1];
+    uint8_t cfg2 = d->regs[REG_MODEM_CONFIG_2];
+    uint8_t cfg3 = d->regs[REG_MODEM_CONFIG_3];
+
+    unsigned bw_idx = cfg1 >> 4;
+    if (bw_idx > 9) bw_idx = 9;
+    int sf = cfg2 >> 4;
+    if (sf < 6) sf = 6;
+    int cr = (cfg1 >> 1) & 0x07;
+    int ih = cfg1 & 0x01;
+    int crc = (cfg2 >> 2) & 0x01;
+    int de = (cfg3 >> 3) & 0x01;
+    int preamble = (d->regs[REG_PREAMBLE_MSB] << 8) | d->regs[REG_PREAMBLE_LSB];
+
+    double t_sym = (double)(1 << sf) / bandwidth_hz[bw_idx];
+    double t_preamble = (preamble + 4.25) * t_sym;
+    double num = 8.0 * len - 4.0 * sf + 28 + 16 * crc - 20 * ih;
+    double den = 4.0 * (sf - 2 * de);
+    double n_payload = 8 + fmax(ceil(num / den) * (cr + 4), 0.0);
+
+    return (uint64_t)llround((t_preamble + n_payload * t_sym) * 1e9);
+}
+
+bool sim_sx1276_schedule_rx(sim_sx1276_t* d, uint64_t end_ns, const uint8_t* data, uint8_t len,
+                            int rssi_dbm, float snr_db, bool crc_ok) {
+    if (d->rx_count >= SIM_SX1276_RX_QUEUE) return false;
+
+    // Inserção ordenada pelo instante de chegada
+    int i = d->rx_count;
+    while (i > 0 && d->rx_queue[i - 1].end_ns > end_ns) {
+        d->rx_queue[i] = d->rx_queue[i - 1];
+        i--;
+    }
+    sim_sx1276_rx_t* p = &d->rx_queue[i];
+    p->end_ns = end_ns;
+    memcpy(p->data, data, len);
+    p->len = len;
+    p->rssi_dbm = (int16_t)rssi_dbm;
+    p->snr_quarter_db = (int8_t)lroundf(snr_db * 4.0f);
+    p->crc_ok = crc_ok;
+    d->rx_count++;
+    return true;
+}
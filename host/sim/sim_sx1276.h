@@ -0,0 +1,97 @@
+#ifndef SIM_SX1276_H
+#define SIM_SX1276_H
+
+// ============================================================================
+// MODELO DE REGISTRADORES DO SX1276 (RFM95)
+// ============================================================================
+// Modela o acesso SPI (bit 7 = escrita, auto-incremento de endereço, FIFO
+// no endereço 0x00 via REG_FIFO_ADDR_PTR), as transições de REG_OPMODE, as
+// flags de REG_IRQ_FLAGS (limpas escrevendo 1) e o sinal DIO0 conforme
+// REG_DIO_MAPPING_1. Ao entrar em TX o fim da transmissão é agendado para
+// o tempo no ar calculado a partir de REG_MODEM_CONFIG_1/2/3, preâmbulo e
+// REG_PAYLOAD_LENGTH. Com LongRangeMode = 0 (FSK, estado após o reset) os
+// endereços 0x0D..0x3F são os registradores FSK, guardados à parte.
+
+#include "sim.h"
+
+#define SIM_SX1276_RX_QUEUE     32
+#define SIM_SX1276_NO_PIN       0xFFFFFFFFu
+#define SIM_SX1276_MAX_SPI_HZ   10000000u   // FSCK máximo do datasheet
+#define SIM_SX1276_FSK_PAGE_START   0x0D        // Primeiro endereço com mapas FSK e LoRa distintos
+#define SIM_SX1276_FSK_PAGE_END     0x40
+
+// Pacote agendado para chegar à antena
+typedef struct {
+    uint64_t end_ns;            // Instante em que o RxDone ocorre
+    uint8_t data[256];
+    uint8_t len;
+    int16_t rssi_dbm;
+    int8_t snr_quarter_db;      // SNR em passos de 0.25 dB
+    bool crc_ok;
+} sim_sx1276_rx_t;
+
+// Chamado ao final de cada transmissão com o conteúdo efetivamente enviado
+typedef void (*sim_sx1276_tx_cb_t)(void* ctx, const uint8_t* data, uint8_t len,
+                                   uint64_t start_ns, uint64_t end_ns);
+
+typedef struct {
+    uint8_t regs[128];
+    uint8_t fsk_regs[SIM_SX1276_FSK_PAGE_END];   // 0x0D..0x3F com LongRangeMode = 0
+    uint8_t fifo[256];
+
+    // Quadro SPI em andamento; acima de max_spi_hz os bytes de dados chegam
+    // e saem deslocados de um bit (amostrados na borda errada)
+    spi_inst_t* spi;
+    uint32_t max_spi_hz;
+    bool frame_first;
+    bool frame_write;
+    uint8_t frame_addr;
+
+    // Transmissão em andamento
+    uint64_t tx_start_ns;
+    uint64_t tx_end_ns;         // SIM_NEVER fora de TX
+
+    // Recepção
+    sim_sx1276_rx_t rx_queue[SIM_SX1276_RX_QUEUE];
+    int rx_count;
+    uint8_t rx_wptr;
+
+    // Pinos
+    uint cs_pin;
+    uint rst_pin;
+    uint dio0_pin;              // SIM_SX1276_NO_PIN se não conectado
+    bool dio0;
+
+    // Estatísticas
+    uint64_t mode_ns[8];        // Tempo acumulado em cada modo (bits 2-0 de OPMODE)
+    uint64_t mode_since_ns;
+    uint32_t tx_packets;
+    uint32_t rx_packets;
+    uint32_t rx_missed;         // Pacotes que chegaram fora de RX
+    uint32_t rx_overwritten;    // Pacotes sobrescritos antes de RxDone ser limpo
+    uint32_t fifo_dropped;      // Acessos ao FIFO em modo Sleep (ignorados)
+
+    sim_sx1276_tx_cb_t on_tx;
+    void* on_tx_ctx;
+} sim_sx1276_t;
+
+void sim_sx1276_init(sim_sx1276_t* d, spi_inst_t* spi, uint cs_pin, uint rst_pin);
+void sim_sx1276_set_dio0_pin(sim_sx1276_t* d, uint pin);
+void sim_sx1276_on_tx(sim_sx1276_t* d, sim_sx1276_tx_cb_t fn, void* ctx);
+
+// Clock SPI máximo que o módulo aceita (ex: fiação longa abaixo dos 10 MHz)
+void sim_sx1276_set_max_spi_hz(sim_sx1276_t* d, uint32_t hz);
+
+// Tempo no ar para o payload com a configuração atualmente programada
+uint64_t sim_sx1276_time_on_air_ns(const sim_sx1276_t* d, uint8_t len);
+
+// Agenda a chegada de um pacote (RxDone em end_ns). Retorna false se a fila estiver cheia.
+bool sim_sx1276_schedule_rx(sim_sx1276_t* d, uint64_t end_ns, const uint8_t* data, uint8_t len,
+                            int rssi_dbm, float snr_db, bool crc_ok);
+
+uint8_t sim_sx1276_mode(const sim_sx1276_t* d);
+
+// Rádio da estação padrão montada por sim_reset()
+sim_sx1276_t* sim_radio(void);
+
+#endif // SIM_SX1276_H
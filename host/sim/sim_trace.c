@@ -0,0 +1,80 @@
+#include <math.h>
+
+#include "sim_trace.h"
+
+#define DAY_S       86400.0
+
+static const char* const profile_names[] = { "interno", "externo", "tempestade" };
+
+/**
+ * @brief Amostra de uma normal padrão (xorshift32 + Box-Muller)
+ */
+static double sim_trace_gauss(sim_trace_t* trace) {
+    double u[2];
+    for (int i = 0; i < 2; i++) {
+        trace->rng ^= trace->rng << 13;
+        trace->rng ^= trace->rng >> 17;
+        trace->rng ^= trace->rng << 5;
+        u[i] = (trace->rng + 1.0) / 4294967297.0;
+    }
+    return sqrt(-2.0 * log(u[0])) * cos(2.0 * M_PI * u[1]);
+}
+
+void sim_trace_init(sim_trace_t* trace, sim_trace_profile_t profile, uint32_t seed) {
+    trace->profile = profile;
+    trace->rng = seed ? seed : 1;
+    trace->noise_t = 0.0;
+    trace->noise_h = 0.0;
+    trace->noise_p = 0.0;
+}
+
+/**
+ * @brief Ambiente no instante t_ns
+ *
+ * O ruído é um processo AR(1) (correlacionado entre amostras próximas), como
+ * as flutuações reais de temperatura e pressão, e não ruído branco.
+ */
+sim_env_t sim_trace_env(sim_trace_t* trace, uint64_t t_ns) {
+    double t = t_ns / 1e9;
+    double day = sin(2.0 * M_PI * (t / DAY_S - 0.25));  // Mínimo às 6h, máximo às 18h
+    double sigma_t, sigma_h, sigma_p;
+    sim_env_t env;
+
+    switch (trace->profile) {
+        case SIM_TRACE_INDOOR:
+            env.temperature_c = 23.0 + 0.8 * day;
+            env.humidity_rh = 55.0 - 3.0 * day;
+            env.pressure_pa = 94300.0 + 80.0 * sin(2.0 * M_PI * t / (DAY_S / 2));  // Maré barométrica
+            sigma_t = 0.02; sigma_h = 0.05; sigma_p = 1.5;
+            break;
+        case SIM_TRACE_OUTDOOR:
+            env.temperature_c = 21.0 + 6.0 * day;
+            env.humidity_rh = 65.0 - 20.0 * day;
+            env.pressure_pa = 94300.0 + 100.0 * sin(2.0 * M_PI * t / (DAY_S / 2));
+            sigma_t = 0.08; sigma_h = 0.3; sigma_p = 3.0;
+            break;
+        case SIM_TRACE_STORM:
+        default: {
+            // Frente fria passando 3 h após o início, em cerca de 1 h
+            double front = 0.5 * (1.0 + tanh((t - 3 * 3600.0) / 1800.0));
+            env.temperature_c = 26.0 + 5.0 * day - 8.0 * front;
+            env.humidity_rh = 60.0 - 15.0 * day + 30.0 * front;
+            env.pressure_pa = 94300.0 - 600.0 * front + 300.0 * front * front;
+            sigma_t = 0.2; sigma_h = 0.8; sigma_p = 8.0;
+            break;
+        }
+    }
+
+    trace->noise_t = 0.95 * trace->noise_t + sigma_t * sim_trace_gauss(trace);
+    trace->noise_h = 0.95 * trace->noise_h + sigma_h * sim_trace_gauss(trace);
+    trace->noise_p = 0.95 * trace->noise_p + sigma_p * sim_trace_gauss(trace);
+
+    env.temperature_c += trace->noise_t;
+    env.humidity_rh = fmin(fmax(env.humidity_rh + trace->noise_h, 0.0), 100.0);
+    env.pressure_pa += trace->noise_p;
+    return env;
+}
+
+const char* sim_trace_name(sim_trace_profile_t profile) {
+    return profile_names[profile];
+}
@@ -0,0 +1,35 @@
+#ifndef SIM_TRACE_H
+#define SIM_TRACE_H
+
+// ============================================================================
+// TRAÇOS DE AMBIENTE REALISTAS
+// ============================================================================
+// Gera a evolução de temperatura, umidade e pressão ao longo do tempo para
+// alimentar os sensores simulados: ciclo diário, passagem de frente fria
+// (queda de pressão e temperatura, subida da umidade) e ruído gaussiano de
+// curto prazo. O gerador é determinístico para uma dada semente.
+
+#include "sim.h"
+
+typedef enum {
+    SIM_TRACE_INDOOR,           // Ambiente interno estável, ruído de ventilação
+    SIM_TRACE_OUTDOOR,          // Ciclo diário ao ar livre
+    SIM_TRACE_STORM,            // Ciclo diário com frente fria e rajadas
+} sim_trace_profile_t;
+
+typedef struct {
+    sim_trace_profile_t profile;
+    uint32_t rng;
+    double noise_t;             // Componentes de ruído correlacionado
+    double noise_h;
+    double noise_p;
+} sim_trace_t;
+
+void sim_trace_init(sim_trace_t* trace, sim_trace_profile_t profile, uint32_t seed);
+
+// Ambiente no instante t_ns; chamadas devem ter t_ns crescente
+sim_env_t sim_trace_env(sim_trace_t* trace, uint64_t t_ns);
+
+const char* sim_trace_name(sim_trace_profile_t profile);
+
+#endif // SIM_TRACE_H
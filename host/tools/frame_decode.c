@@ -0,0 +1,97 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "frame.h"
+
+// ============================================================================
+// DECODIFICADOR DE QUADROS PARA O GATEWAY
+// ============================================================================
+// Lê da entrada padrão um quadro por linha em hexadecimal (como impresso por
+// um receptor LoRa) e escreve uma linha JSON por leitura na saída padrão;
+// quadros de lote geram uma linha para cada leitura e quadros de resumo uma
+// linha com as estatísticas da janela.
+//
+//   echo 1001 2a00 07 2b09 8815 d824 | frame_decode
+
+static int hex_value(int c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c = tolower(c);
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+static int parse_hex_line(const char* line, uint8_t* out, int size) {
+    int len = 0, high = -1;
+    for (; *line; line++) {
+        int v = hex_value((unsigned char)*line);
+        if (v < 0) continue;                        // Ignora espaços e separadores
+        if (high < 0) {
+            high = v;
+        } else {
+            if (len >= size) return -1;
+            out[len++] = (uint8_t)((high << 4) | v);
+            high = -1;
+        }
+    }
+    return high < 0 ? len : -1;
+}
+
+static void print_reading(const frame_reading_t* r, uint32_t age_ms) {
+    printf("{\"estacao\":%u,\"sequencia\":%u,\"idade_ms\":%u", r->station_id, r->sequence, (unsigned)age_ms);
+    if (r->fields & FRAME_FIELD_TEMPERATURE) printf(",\"temperatura\":%.2f", r->temperature / 100.0);
+    if (r->fields & FRAME_FIELD_HUMIDITY) printf(",\"umidade\":%.2f", r->humidity / 100.0);
+    if (r->fields & FRAME_FIELD_PRESSURE) printf(",\"pressao\":%u", (unsigned)r->pressure);
+    printf("}\n");
+}
+
+static void print_stat(const char* name, const frame_stat_t* s, double scale) {
+    printf(",\"%s\":{\"ultima\":%.2f,\"media\":%.2f,\"min\":%.2f,\"max\":%.2f,\"desvio\":%.2f}",
+           name, s->last / scale, s->mean / scale, s->min / scale, s->max / scale, s->stddev / scale);
+}
+
+static void print_summary(const frame_summary_t* s) {
+    printf("{\"estacao\":%u,\"sequencia\":%u,\"leituras\":%u,\"janela_ms\":%u",
+           s->station_id, s->sequence, s->count, (unsigned)s->span_ms);
+    if (s->fields & FRAME_FIELD_TEMPERATURE) print_stat("temperatura", &s->temperature, 100.0);
+    if (s->fields & FRAME_FIELD_HUMIDITY) print_stat("umidade", &s->humidity, 100.0);
+    if (s->fields & FRAME_FIELD_PRESSURE) print_stat("pressao", &s->pressure, 1.0);
+    printf("}\n");
+}
+
+int main(void) {
+    char line[1024];
+    uint8_t buf[256];
+    int errors = 0;
+
+    while (fgets(line, sizeof(line), stdin)) {
+        int len = parse_hex_line(line, buf, sizeof(buf));
+        if (len == 0) continue;
+
+        frame_reading_t r[FRAME_BATCH_MAX_SAMPLES];
+        uint32_t age_ms[FRAME_BATCH_MAX_SAMPLES] = { 0 };
+        frame_summary_t summary;
+        int n = -1;
+        if (len > 0 && (buf[0] & 0x0F) == FRAME_TYPE_SUMMARY) {
+            if (frame_decode_summary(buf, len, &summary)) {
+                print_summary(&summary);
+                continue;
+            }
+        } else if (len > 0 && (buf[0] & 0x0F) == FRAME_TYPE_BATCH) {
+            n = frame_decode_batch(buf, len, r, age_ms, FRAME_BATCH_MAX_SAMPLES);
+        } else if (len > 0 && frame_decode(buf, len, &r[0])) {
+            n = 1;
+        }
+        if (n < 0) {
+            printf("{\"erro\":\"quadro invalido\"}\n");
+            errors++;
+            continue;
+        }
+
+        // Uma linha por leitura; idade_ms é relativa à recepção do quadro
+        for (int i = 0; i < n; i++) {
+            print_reading(&r[i], age_ms[i]);
+        }
+    }
+    return errors ? 1 : 0;
+}
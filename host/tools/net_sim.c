@@ -0,0 +1,531 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sim.h"
+#include "sim_sx1276.h"
+#include "sim_channel.h"
+#include "rfm95.h"
+#include "rfm95_definitions.h"
+#include "frame.h"
+
+// ============================================================================
+// SIMULADOR DE REDE LORA POR EVENTOS DISCRETOS
+// ============================================================================
+// Muitas estações com a lógica de envio do main.c compartilham um canal de
+// 915 MHz e um gateway. Cada estação lê em período fixo do seu relógio
+// (boot aleatório, deriva de até ±30 ppm), codifica a leitura ou o lote com
+// lib/frame e transmite pelo driver rfm95 real sobre o SX1276 simulado: o
+// instante em que o pacote vai ao ar e o seu tempo no ar saem do driver e
+// do modelo de registradores, não de uma fórmula à parte.
+//
+// O relógio virtual do simulador só serve ao driver. O tempo da rede é o da
+// fila de eventos: cada transmissão começa no instante do evento mais a
+// latência medida no driver (configuração, FIFO, SPI). Assim uma única
+// instância do driver atende todas as estações, uma de cada vez.
+//
+// O gateway tem um número limitado de demoduladores (8 em um concentrador
+// SX1301, 1 em um gateway de SX1276) e o canal segue sim_channel.h. Cada
+// execução escreve uma linha JSON com entrega, perdas por causa, latência
+// da leitura ao fim da recepção e tempo no ar:
+//
+//   net_sim -n 1000 -H 24                     1000 estações por 24 h
+//   net_sim --sweep 100,500,1000,2000 -p 60   capacidade em função de N
+//   net_sim -s 7 -g 1 -b 8                    SF fixo, gateway de um rádio, lotes
+
+#define MAX_STATIONS        50000
+#define TX_POWER_DBM        17              // Como em main.c
+#define ADR_MARGIN_DB       10.0            // Folga sobre a sensibilidade na escolha do SF
+#define CLOCK_DRIFT_PPM     30.0
+#define PREAMBLE_SYMBOLS    8               // Como em rfm95_initialize()
+#define DUTY_BURST_NS       1e9             // AIRTIME_BURST_US de main.c
+
+typedef struct {
+    uint32_t stations;
+    double hours;
+    double period_s;
+    int batch;                  // Leituras por quadro (1 = quadro de leitura avulsa)
+    int sf;                     // 0 = menor SF com ADR_MARGIN_DB de folga
+    double radius_m;
+    int demodulators;
+    uint32_t duty_ppm;          // Duty cycle por estação (0 = sem limite)
+    uint32_t seed;
+    sim_channel_t channel;
+} config_t;
+
+typedef struct {
+    double distance_m;
+    float mean_rssi_dbm;        // Com sombreamento, sem variação por pacote
+    uint8_t sf;
+    uint8_t id;
+    uint16_t sequence;
+    double period_ns;           // Período nominal corrigido pela deriva do cristal
+    uint64_t next_ns;           // Próxima leitura, no tempo da rede
+    uint64_t busy_until_ns;     // Fim da transmissão em andamento
+    double budget_credit;       // ns de tempo no ar disponíveis
+    uint64_t budget_updated_ns;
+    uint64_t airtime_ns;
+    frame_batch_t batch;
+} station_t;
+
+// Pacote no ar, aguardando o fim para ser contabilizado
+typedef struct {
+    sim_channel_packet_t air;
+    uint32_t station;
+    bool audible;               // Acima da sensibilidade
+    bool demodulated;           // Um demodulador do gateway o acompanhou
+    bool collided;
+    uint8_t count;
+    uint32_t time_ms[FRAME_BATCH_MAX_SAMPLES];   // Instante de cada leitura
+} air_packet_t;
+
+typedef struct {
+    uint64_t packets;
+    uint64_t delivered;
+    uint64_t lost_sensitivity;
+    uint64_t lost_demodulator;
+    uint64_t lost_collision;
+    uint64_t readings;
+    uint64_t readings_delivered;
+    uint64_t readings_duty;     // Leituras não transmitidas por falta de orçamento
+    uint64_t sf_stations[SIM_CHANNEL_NUM_SF];
+    uint64_t sf_packets[SIM_CHANNEL_NUM_SF];
+    uint64_t sf_delivered[SIM_CHANNEL_NUM_SF];
+    uint64_t airtime_ns;
+    uint64_t delivered_airtime_ns;
+    uint64_t driver_tx;
+    uint64_t max_lead_ns;
+} stats_t;
+
+static station_t* stations;
+static uint32_t* heap;          // Índices das estações, ordenados por next_ns
+static uint32_t heap_size;
+static air_packet_t* active;
+static int active_count, active_capacity;
+static uint32_t* latencies;     // ms, uma por leitura entregue
+static uint64_t latency_count, latency_capacity;
+static stats_t stats;
+static uint32_t rng;
+static uint64_t tx_start_ns, tx_end_ns;     // Última transmissão vista no SX1276 simulado
+static int radio_sf;
+
+// ----------------------------------------------------------------------------
+// Números aleatórios
+// ----------------------------------------------------------------------------
+
+static double rng_uniform(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return (rng + 1.0) / 4294967297.0;
+}
+
+static double rng_gauss(void) {
+    return sqrt(-2.0 * log(rng_uniform())) * cos(2.0 * M_PI * rng_uniform());
+}
+
+// ----------------------------------------------------------------------------
+// Fila de eventos (heap mínimo de estações por próxima leitura)
+// ----------------------------------------------------------------------------
+
+static bool heap_less(uint32_t a, uint32_t b) {
+    return stations[heap[a]].next_ns < stations[heap[b]].next_ns;
+}
+
+static void heap_swap(uint32_t a, uint32_t b) {
+    uint32_t t = heap[a];
+    heap[a] = heap[b];
+    heap[b] = t;
+}
+
+static void heap_push(uint32_t station) {
+    uint32_t i = heap_size++;
+    heap[i] = station;
+    while (i > 0 && heap_less(i, (i - 1) / 2)) {
+        heap_swap(i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+// A raiz teve next_ns aumentado: desce até a posição certa
+static void heap_sift_root(void) {
+    uint32_t i = 0;
+    while (true) {
+        uint32_t l = 2 * i + 1, r = l + 1, m = i;
+        if (l < heap_size && heap_less(l, m)) m = l;
+        if (r < heap_size && heap_less(r, m)) m = r;
+        if (m == i) break;
+        heap_swap(i, m);
+        i = m;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Gateway
+// ----------------------------------------------------------------------------
+
+static void record_latency(uint32_t ms) {
+    if (latency_count == latency_capacity) {
+        latency_capacity = latency_capacity ? 2 * latency_capacity : 65536;
+        latencies = realloc(latencies, latency_capacity * sizeof(uint32_t));
+    }
+    latencies[latency_count++] = ms;
+}
+
+static void finish_packet(const air_packet_t* p) {
+    int sf = p->air.sf - SIM_CHANNEL_SF_MIN;
+    stats.packets++;
+    stats.sf_packets[sf]++;
+    if (!p->audible) {
+        stats.lost_sensitivity++;
+    } else if (!p->demodulated) {
+        stats.lost_demodulator++;
+    } else if (p->collided) {
+        stats.lost_collision++;
+    } else {
+        stats.delivered++;
+        stats.sf_delivered[sf]++;
+        stats.delivered_airtime_ns += p->air.end_ns - p->air.start_ns;
+        stats.readings_delivered += p->count;
+        uint32_t end_ms = (uint32_t)(p->air.end_ns / 1000000);
+        for (int i = 0; i < p->count; i++) {
+            record_latency(end_ms - p->time_ms[i]);
+        }
+    }
+}
+
+// Contabiliza os pacotes que terminaram até now_ns; os que ainda vão ao ar
+// começam em now_ns ou depois, então não os alcançam mais
+static void retire_packets(uint64_t now_ns) {
+    for (int i = 0; i < active_count; ) {
+        if (active[i].air.end_ns <= now_ns) {
+            finish_packet(&active[i]);
+            active[i] = active[--active_count];
+        } else {
+            i++;
+        }
+    }
+}
+
+static void add_packet(const config_t* config, const air_packet_t* packet) {
+    if (active_count == active_capacity) {
+        active_capacity = active_capacity ? 2 * active_capacity : 256;
+        active = realloc(active, active_capacity * sizeof(air_packet_t));
+    }
+    air_packet_t* p = &active[active_count];
+    *p = *packet;
+
+    int busy = 0;
+    for (int i = 0; i < active_count; i++) {
+        air_packet_t* q = &active[i];
+        if (sim_channel_interferes(&config->channel, &p->air, &q->air)) p->collided = true;
+        if (sim_channel_interferes(&config->channel, &q->air, &p->air)) q->collided = true;
+        if (q->demodulated && q->air.end_ns > p->air.start_ns) busy++;
+    }
+    p->demodulated = p->audible && busy < config->demodulators;
+    active_count++;
+}
+
+// ----------------------------------------------------------------------------
+// Estações
+// ----------------------------------------------------------------------------
+
+static void on_radio_tx(void* ctx, const uint8_t* data, uint8_t len, uint64_t start_ns, uint64_t end_ns) {
+    tx_start_ns = start_ns;
+    tx_end_ns = end_ns;
+}
+
+static void radio_set_sf(int sf) {
+    if (sf != radio_sf) {
+        rfm95_set_modem_config(BANDWIDTH_125K + ERROR_CODING_4_5 + EXPLICIT_MODE, (uint8_t)(sf << 4) + CRC_ON);
+        radio_sf = sf;
+    }
+}
+
+/**
+ * @brief Leva o quadro ao ar pelo driver e o entrega ao canal
+ */
+static void transmit(const config_t* config, uint32_t index, const uint8_t* data, int length,
+                     const uint32_t* time_ms, int count, uint64_t now_ns) {
+    station_t* s = &stations[index];
+    uint64_t t = now_ns > s->busy_until_ns ? now_ns : s->busy_until_ns;   // rfm95_transmit_wait()
+
+    radio_set_sf(s->sf);
+    if (config->duty_ppm > 0) {
+        // Mesmo balde do driver (rfm95_set_airtime_budget), um por estação
+        s->budget_credit += (double)(t - s->budget_updated_ns) * config->duty_ppm / 1e6;
+        if (s->budget_credit > DUTY_BURST_NS) s->budget_credit = DUTY_BURST_NS;
+        s->budget_updated_ns = t;
+        double cost = rfm95_time_on_air_us((uint8_t)length) * 1e3;
+        if (cost > DUTY_BURST_NS) cost = DUTY_BURST_NS;
+        if (s->budget_credit < cost) {
+            stats.readings_duty += count;
+            return;
+        }
+        s->budget_credit -= cost;
+    }
+
+    uint64_t before = sim_now_ns();
+    if (!rfm95_transmit_async(data, (uint8_t)length, NULL)) {
+        stats.readings_duty += count;
+        return;
+    }
+    rfm95_transmit_wait();
+    stats.driver_tx++;
+    uint64_t lead = tx_start_ns - before;
+    if (lead > stats.max_lead_ns) stats.max_lead_ns = lead;
+
+    air_packet_t p = { .station = index, .count = (uint8_t)count };
+    p.air.sf = s->sf;
+    p.air.start_ns = t + lead;
+    p.air.end_ns = p.air.start_ns + (tx_end_ns - tx_start_ns);
+    p.air.lock_ns = p.air.start_ns + (PREAMBLE_SYMBOLS - SIM_CHANNEL_LOCK_SYMBOLS) * sim_channel_symbol_ns(s->sf);
+    p.air.rssi_dbm = (float)(s->mean_rssi_dbm + config->channel.fading_db * rng_gauss());
+    p.audible = p.air.rssi_dbm >= sim_channel_sensitivity_dbm(s->sf);
+    memcpy(p.time_ms, time_ms, count * sizeof(uint32_t));
+
+    s->busy_until_ns = p.air.end_ns;
+    s->airtime_ns += p.air.end_ns - p.air.start_ns;
+    stats.airtime_ns += p.air.end_ns - p.air.start_ns;
+    add_packet(config, &p);
+}
+
+/**
+ * @brief Uma iteração do laço da estação: leitura, lote e envio
+ */
+static void station_cycle(const config_t* config, uint32_t index, uint64_t now_ns) {
+    station_t* s = &stations[index];
+    uint32_t now_ms = (uint32_t)(now_ns / 1000000);
+    frame_reading_t reading = {
+        .station_id = s->id,
+        .sequence = s->sequence++,
+        .fields = FRAME_FIELDS_ALL,
+        .temperature = 2350,
+        .humidity = 6120,
+        .pressure = 101325,
+    };
+    stats.readings++;
+
+    if (config->batch <= 1) {
+        uint8_t buffer[FRAME_MAX_SIZE];
+        int length = frame_encode(&reading, buffer, sizeof(buffer));
+        transmit(config, index, buffer, length, &now_ms, 1, now_ns);
+        return;
+    }
+
+    if (s->batch.count == 0) {
+        frame_batch_init(&s->batch, s->id);
+    }
+    frame_batch_add(&s->batch, &reading, now_ms);
+    if (s->batch.count < config->batch && !frame_batch_full(&s->batch)) {
+        return;
+    }
+    int length = frame_batch_finish(&s->batch, now_ms);
+    int count = s->batch.count;
+    s->batch.count = 0;
+    transmit(config, index, s->batch.data, length, s->batch.time_ms, count, now_ns);
+}
+
+static void place_stations(const config_t* config) {
+    for (uint32_t i = 0; i < config->stations; i++) {
+        station_t* s = &stations[i];
+        memset(s, 0, sizeof(*s));
+        s->id = (uint8_t)(1 + i % 255);
+        s->distance_m = config->radius_m * sqrt(rng_uniform());     // Uniforme no disco
+        s->mean_rssi_dbm = (float)(TX_POWER_DBM - sim_channel_path_loss_db(&config->channel, s->distance_m)
+                                   + config->channel.shadowing_db * rng_gauss());
+        if (config->sf) {
+            s->sf = (uint8_t)config->sf;
+        } else {
+            s->sf = SIM_CHANNEL_SF_MAX;
+            for (int sf = SIM_CHANNEL_SF_MIN; sf <= SIM_CHANNEL_SF_MAX; sf++) {
+                if (s->mean_rssi_dbm >= sim_channel_sensitivity_dbm(sf) + ADR_MARGIN_DB) {
+                    s->sf = (uint8_t)sf;
+                    break;
+                }
+            }
+        }
+        stats.sf_stations[s->sf - SIM_CHANNEL_SF_MIN]++;
+        double drift = (2 * rng_uniform() - 1) * CLOCK_DRIFT_PPM * 1e-6;
+        s->period_ns = config->period_s * 1e9 * (1 + drift);
+        s->next_ns = (uint64_t)(rng_uniform() * config->period_s * 1e9);
+        s->budget_credit = DUTY_BURST_NS;
+        heap_push(i);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Execução e relatório
+// ----------------------------------------------------------------------------
+
+static int compare_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+static uint32_t percentile(double p) {
+    if (latency_count == 0) return 0;
+    uint64_t i = (uint64_t)(p * (latency_count - 1) + 0.5);
+    return latencies[i];
+}
+
+static double ratio(uint64_t a, uint64_t b) {
+    return b ? (double)a / b : 0.0;
+}
+
+static void run(const config_t* config) {
+    memset(&stats, 0, sizeof(stats));
+    heap_size = 0;
+    active_count = 0;
+    latency_count = 0;
+    rng = config->seed ? config->seed : 1;
+
+    sim_reset();
+    sim_sx1276_on_tx(sim_radio(), on_radio_tx, NULL);
+    rfm95_initialize();
+    rfm95_set_tx_power(TX_POWER_DBM);
+    radio_sf = SIM_CHANNEL_SF_MIN;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    place_stations(config);
+    uint64_t end_ns = (uint64_t)(config->hours * 3600e9);
+    while (heap_size > 0) {
+        uint32_t index = heap[0];
+        station_t* s = &stations[index];
+        if (s->next_ns >= end_ns) break;
+        uint64_t now = s->next_ns;
+        retire_packets(now);
+        station_cycle(config, index, now);
+        s->next_ns = now + (uint64_t)s->period_ns;
+        heap_sift_root();
+    }
+    retire_packets(UINT64_MAX);
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double wall_s = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    uint64_t max_station_airtime = 0;
+    for (uint32_t i = 0; i < config->stations; i++) {
+        if (stations[i].airtime_ns > max_station_airtime) max_station_airtime = stations[i].airtime_ns;
+    }
+    qsort(latencies, latency_count, sizeof(uint32_t), compare_u32);
+    double latency_sum = 0;
+    for (uint64_t i = 0; i < latency_count; i++) latency_sum += latencies[i];
+    double duration_ns = (double)end_ns;
+
+    printf("{\"estacoes\":%u,\"horas\":%g,\"periodo_s\":%g,\"lote\":%d,\"sf\":%d,\"raio_m\":%g,"
+           "\"demoduladores\":%d,\"duty_ppm\":%u,\"semente\":%u,",
+           config->stations, config->hours, config->period_s, config->batch < 1 ? 1 : config->batch,
+           config->sf, config->radius_m, config->demodulators, config->duty_ppm, config->seed);
+    printf("\"pacotes\":%llu,\"entregues\":%llu,\"pdr\":%.4f,",
+           (unsigned long long)stats.packets, (unsigned long long)stats.delivered,
+           ratio(stats.delivered, stats.packets));
+    printf("\"perdas\":{\"sensibilidade\":%llu,\"demodulador\":%llu,\"colisao\":%llu},",
+           (unsigned long long)stats.lost_sensitivity, (unsigned long long)stats.lost_demodulator,
+           (unsigned long long)stats.lost_collision);
+    printf("\"leituras\":%llu,\"leituras_entregues\":%llu,\"leituras_duty\":%llu,\"entrega_leituras\":%.4f,",
+           (unsigned long long)stats.readings, (unsigned long long)stats.readings_delivered,
+           (unsigned long long)stats.readings_duty, ratio(stats.readings_delivered, stats.readings));
+    printf("\"por_sf\":{");
+    for (int i = 0; i < SIM_CHANNEL_NUM_SF; i++) {
+        printf("%s\"%d\":{\"estacoes\":%llu,\"pacotes\":%llu,\"pdr\":%.4f}", i ? "," : "",
+               SIM_CHANNEL_SF_MIN + i, (unsigned long long)stats.sf_stations[i],
+               (unsigned long long)stats.sf_packets[i], ratio(stats.sf_delivered[i], stats.sf_packets[i]));
+    }
+    printf("},");
+    printf("\"latencia_ms\":{\"media\":%.1f,\"p50\":%u,\"p95\":%u,\"p99\":%u,\"max\":%u},",
+           latency_count ? latency_sum / latency_count : 0.0, percentile(0.50), percentile(0.95),
+           percentile(0.99), latency_count ? latencies[latency_count - 1] : 0);
+    printf("\"tempo_no_ar\":{\"carga\":%.4f,\"vazao\":%.4f,\"ms_por_estacao_h\":%.1f,\"duty_max\":%.6f},",
+           stats.airtime_ns / duration_ns, stats.delivered_airtime_ns / duration_ns,
+           stats.airtime_ns / 1e6 / config->stations / config->hours, max_station_airtime / duration_ns);
+    printf("\"simulacao\":{\"transmissoes_driver\":%llu,\"latencia_driver_us\":%.1f,\"s\":%.3f,"
+           "\"estacao_h_por_s\":%.0f}}\n",
+           (unsigned long long)stats.driver_tx, stats.max_lead_ns / 1e3, wall_s,
+           wall_s > 0 ? config->stations * config->hours / wall_s : 0.0);
+    fflush(stdout);
+}
+
+static void usage(void) {
+    fprintf(stderr,
+            "uso: net_sim [-n estacoes] [-H horas] [-p periodo_s] [-b leituras_por_lote]\n"
+            "             [-s sf (0 = pela distancia)] [-r raio_m] [-g demoduladores]\n"
+            "             [-d duty_ppm] [-e expoente_perda] [-S semente]\n"
+            "             [--sweep n1,n2,...]\n");
+}
+
+int main(int argc, char** argv) {
+    config_t config = {
+        .stations = 1000,
+        .hours = 1,
+        .period_s = 60,
+        .batch = 1,
+        .sf = 0,
+        .radius_m = 5000,
+        .demodulators = 8,
+        .duty_ppm = 0,
+        .seed = 1,
+    };
+    sim_channel_default(&config.channel);
+    const char* sweep = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char* opt = argv[i];
+        if (strcmp(opt, "--sweep") == 0 && i + 1 < argc) {
+            sweep = argv[++i];
+        } else if (opt[0] == '-' && strlen(opt) == 2 && strchr("nHpbsrgdeS", opt[1]) && i + 1 < argc) {
+            double v = atof(argv[++i]);
+            switch (opt[1]) {
+                case 'n': config.stations = (uint32_t)v; break;
+                case 'H': config.hours = v; break;
+                case 'p': config.period_s = v; break;
+                case 'b': config.batch = (int)v; break;
+                case 's': config.sf = (int)v; break;
+                case 'r': config.radius_m = v; break;
+                case 'g': config.demodulators = (int)v; break;
+                case 'd': config.duty_ppm = (uint32_t)v; break;
+                case 'e': config.channel.exponent = v; break;
+                case 'S': config.seed = (uint32_t)v; break;
+            }
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (config.period_s <= 0 || config.hours <= 0 || config.demodulators < 1 ||
+        (config.sf != 0 && (config.sf < SIM_CHANNEL_SF_MIN || config.sf > SIM_CHANNEL_SF_MAX)) ||
+        config.batch > FRAME_BATCH_MAX_SAMPLES) {
+        usage();
+        return 2;
+    }
+
+    stations = malloc(MAX_STATIONS * sizeof(station_t));
+    heap = malloc(MAX_STATIONS * sizeof(uint32_t));
+
+    if (sweep == NULL) {
+        if (config.stations < 1 || config.stations > MAX_STATIONS) {
+            usage();
+            return 2;
+        }
+        run(&config);
+        return 0;
+    }
+    for (const char* p = sweep; *p; ) {
+        config.stations = (uint32_t)strtoul(p, (char**)&p, 10);
+        if (config.stations < 1 || config.stations > MAX_STATIONS) {
+            usage();
+            return 2;
+        }
+        run(&config);
+        if (*p == ',') p++;
+        else if (*p) {
+            usage();
+            return 2;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,311 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "sim_trace.h"
+#include "rfm95.h"
+#include "aht20.h"
+#include "bmp280.h"
+#include "frame.h"
+#include "report.h"
+
+// ============================================================================
+// REPRODUÇÃO DE TRAÇOS PELO RELATO POR EXCEÇÃO
+// ============================================================================
+// Passa um traço de leituras pela política de report_decide() e mede, contra
+// uma leitura por pacote, os pacotes e o tempo no ar economizados e o erro de
+// reconstrução no gateway, que mantém o último valor recebido de cada canal.
+//
+// O traço vem da entrada padrão, uma leitura por linha em CSV:
+//
+//   tempo_ms,campos,temperatura,umidade,pressao
+//
+// (campos = máscara FRAME_FIELD_*, temperatura e umidade em centésimos,
+// pressão em Pa; linhas começando com # são ignoradas), ou é gravado no
+// simulador com os drivers lendo os sensores como main.c faz:
+//
+//   report_replay --sim storm 24                  perfil e horas a cada 2 s
+//   report_replay --sim indoor 6 --dump > t.csv   só grava o traço
+//   report_replay -t 10 -u 50 -p 10 -b 300 < t.csv
+//
+// Sem bandas na linha de comando, roda um conjunto de configurações. Sem
+// intervalo mínimo, confere que o erro de reconstrução fica sempre abaixo da
+// banda morta e o silêncio abaixo do batimento; sai com 1 se não ficar.
+
+#define MAX_SAMPLES         (7 * 24 * 1800)     // Uma semana a cada 2 s
+#define SAMPLE_PERIOD_MS    2000
+#define I2C_PORT_SENSORS    i2c0
+
+typedef struct {
+    uint32_t time_ms;
+    uint8_t fields;
+    int32_t value[REPORT_CHANNELS];     // Centésimos de °C, centésimos de %RH, Pa
+} sample_t;
+
+typedef struct {
+    const char* name;
+    report_config_t config;
+} preset_t;
+
+typedef struct {
+    uint32_t packets;
+    uint32_t reasons[REPORT_NUM_REASONS];
+    uint32_t max_silence_ms;
+    int32_t max_error[REPORT_CHANNELS];
+    double rms_error[REPORT_CHANNELS];
+    uint32_t violations;                // Erro na banda morta ou silêncio além do batimento
+} result_t;
+
+static sample_t samples[MAX_SAMPLES];
+
+static const preset_t PRESETS[] = {
+    { "toda variacao", { .heartbeat_ms = 300000 } },
+    { "fina", { { { 5, 0 }, { 20, 0 }, { 5, 0 } }, 0, 300000 } },
+    { "padrao", { { { 10, 0 }, { 50, 0 }, { 10, 0 } }, 0, 300000 } },
+    { "larga", { { { 25, 0 }, { 100, 0 }, { 25, 0 } }, 0, 900000 } },
+    { "padrao, min 30 s", { { { 10, 0 }, { 50, 0 }, { 10, 0 } }, 30000, 300000 } },
+    { "relativa 100 ppm", { { { 10, 0 }, { 50, 0 }, { 0, 100 } }, 0, 300000 } },
+};
+
+static const double CHANNEL_SCALE[REPORT_CHANNELS] = { 100.0, 100.0, 1.0 };
+
+/**
+ * @brief Grava o traço lendo os sensores simulados pelos drivers
+ *
+ * Mesma sequência de read_sensors() em main.c: AHT20 disparado, BMP280 em
+ * modo forçado, compensação em uma passada e média das duas temperaturas.
+ */
+static int record_sim(sim_trace_profile_t profile, int count) {
+    sim_trace_t trace;
+    struct bmp280_calib_param params;
+
+    sim_reset();
+    sim_trace_init(&trace, profile, 12345);
+    setup_I2C_aht20(I2C_PORT_SENSORS, 0, 1, 400 * 1000);
+    aht20_init(I2C_PORT_SENSORS);
+    bmp280_init(I2C_PORT_SENSORS);
+    bmp280_set_profile(I2C_PORT_SENSORS, &bmp280_profile_standard);
+    bmp280_get_calib_params(I2C_PORT_SENSORS, &params);
+
+    uint64_t start = sim_now_ns();
+    for (int i = 0; i < count; i++) {
+        uint64_t t = start + (uint64_t)i * SAMPLE_PERIOD_MS * 1000000ull;
+        sim_advance_ns(t - sim_now_ns());
+        sim_env_t env = sim_trace_env(&trace, t);
+        sim_env_set(&env);
+
+        sample_t* s = &samples[i];
+        s->time_ms = (uint32_t)((t - start) / 1000000ull);
+        s->fields = FRAME_FIELDS_ALL;
+
+        bool aht20_ok = aht20_start_measurement(I2C_PORT_SENSORS);
+        int32_t raw_t, raw_p;
+        bmp280_reading_t bmp = { 0 };
+        if (bmp280_measure(I2C_PORT_SENSORS, &raw_t, &raw_p)) {
+            bmp280_compensate(raw_t, raw_p, &params, &bmp);
+        } else {
+            s->fields &= ~FRAME_FIELD_PRESSURE;
+        }
+        AHT20_Fixed aht;
+        if (aht20_ok && aht20_collect_fixed(I2C_PORT_SENSORS, &aht)) {
+            s->value[0] = (s->fields & FRAME_FIELD_PRESSURE)
+                ? (aht.temperature + bmp.temperature) / 2
+                : aht.temperature;
+            s->value[1] = aht.humidity > 10000 ? 10000 : aht.humidity;
+        } else {
+            s->fields &= FRAME_FIELD_PRESSURE;
+        }
+        s->value[2] = (int32_t)bmp.pressure;
+    }
+    return count;
+}
+
+static int read_csv(FILE* in) {
+    char line[256];
+    int count = 0;
+    while (count < MAX_SAMPLES && fgets(line, sizeof(line), in)) {
+        sample_t* s = &samples[count];
+        unsigned fields;
+        if (line[0] == '#' || sscanf(line, "%u,%u,%d,%d,%d", &s->time_ms, &fields,
+                                     &s->value[0], &s->value[1], &s->value[2]) != 5) {
+            continue;
+        }
+        s->fields = (uint8_t)fields;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Reproduz o traço pela política e reconstrói como o gateway
+ */
+static void replay(const report_config_t* config, int count, result_t* r) {
+    report_state_t state;
+    report_init(&state, config);
+    memset(r, 0, sizeof(*r));
+
+    int32_t held[REPORT_CHANNELS] = { 0 };
+    uint8_t held_fields = 0;
+    double sq[REPORT_CHANNELS] = { 0 };
+    uint32_t n[REPORT_CHANNELS] = { 0 };
+
+    for (int i = 0; i < count; i++) {
+        const sample_t* s = &samples[i];
+        uint32_t silence = s->time_ms - state.last_ms;
+        report_reason_t reason = report_decide(&state, s->value, s->fields, s->time_ms);
+        r->reasons[reason]++;
+        if (reason != REPORT_SKIP) {
+            if (state.started && silence > r->max_silence_ms) {
+                r->max_silence_ms = silence;
+            }
+            report_commit(&state, s->value, s->fields, s->time_ms);
+            memcpy(held, s->value, sizeof(held));
+            held_fields = s->fields;
+            r->packets++;
+        } else if (config->min_interval_ms == 0 && config->heartbeat_ms > 0 &&
+                   silence >= config->heartbeat_ms) {
+            r->violations++;
+        }
+
+        for (int c = 0; c < REPORT_CHANNELS; c++) {
+            if (!(s->fields & held_fields & (1u << c))) {
+                continue;
+            }
+            int32_t err = abs(s->value[c] - held[c]);
+            if (err > r->max_error[c]) r->max_error[c] = err;
+            sq[c] += (double)err * err;
+            n[c]++;
+            if (config->min_interval_ms == 0 && err > 0 &&
+                (uint32_t)err >= report_threshold(&config->deadband[c], held[c])) {
+                r->violations++;
+            }
+        }
+    }
+    for (int c = 0; c < REPORT_CHANNELS; c++) {
+        r->rms_error[c] = n[c] ? sqrt(sq[c] / n[c]) : 0;
+    }
+}
+
+static void print_header(void) {
+    printf("  %-18s %8s %8s %9s %23s %23s %9s\n", "configuracao", "pacotes", "economia", "no ar s",
+           "erro max T/U/P", "erro RMS T/U/P", "silencio");
+}
+
+static void print_result(const char* name, const result_t* r, int count, uint32_t airtime_us) {
+    char max_err[48], rms_err[48];
+    snprintf(max_err, sizeof(max_err), "%.2f/%.2f/%.0f",
+             r->max_error[0] / CHANNEL_SCALE[0], r->max_error[1] / CHANNEL_SCALE[1], r->max_error[2] / CHANNEL_SCALE[2]);
+    snprintf(rms_err, sizeof(rms_err), "%.3f/%.3f/%.1f",
+             r->rms_error[0] / CHANNEL_SCALE[0], r->rms_error[1] / CHANNEL_SCALE[1], r->rms_error[2] / CHANNEL_SCALE[2]);
+    printf("  %-18s %8u %7.1f%% %9.1f %23s %23s %8.0fs%s\n", name, r->packets,
+           100.0 * (count - (int)r->packets) / count, (double)r->packets * airtime_us / 1e6,
+           max_err, rms_err, r->max_silence_ms / 1000.0, r->violations ? "  VIOLACAO" : "");
+}
+
+static void usage(void) {
+    fprintf(stderr,
+            "uso: report_replay [--sim indoor|outdoor|storm [horas]] [--dump]\n"
+            "                   [-t centesimos_C] [-u centesimos_UR] [-p Pa] [-r ppm]\n"
+            "                   [-m intervalo_min_ms] [-b batimento_ms] [< traco.csv]\n");
+}
+
+int main(int argc, char** argv) {
+    const char* sim_profile = NULL;
+    double hours = 24;
+    bool dump = false, custom = false;
+    report_config_t config = { .heartbeat_ms = 300000 };
+
+    for (int i = 1; i < argc; i++) {
+        const char* opt = argv[i];
+        if (strcmp(opt, "--sim") == 0 && i + 1 < argc) {
+            sim_profile = argv[++i];
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                hours = atof(argv[++i]);
+            }
+        } else if (strcmp(opt, "--dump") == 0) {
+            dump = true;
+        } else if (opt[0] == '-' && strlen(opt) == 2 && strchr("tuprmb", opt[1]) && i + 1 < argc) {
+            long v = atol(argv[++i]);
+            switch (opt[1]) {
+                case 't': config.deadband[0].absolute = (int32_t)v; break;
+                case 'u': config.deadband[1].absolute = (int32_t)v; break;
+                case 'p': config.deadband[2].absolute = (int32_t)v; break;
+                case 'r':
+                    for (int c = 0; c < REPORT_CHANNELS; c++) config.deadband[c].relative_ppm = (uint32_t)v;
+                    break;
+                case 'm': config.min_interval_ms = (uint32_t)v; break;
+                case 'b': config.heartbeat_ms = (uint32_t)v; break;
+            }
+            custom = true;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    int count;
+    const char* source = "entrada padrao";
+    if (sim_profile) {
+        sim_trace_profile_t profile;
+        if (strcmp(sim_profile, "indoor") == 0) profile = SIM_TRACE_INDOOR;
+        else if (strcmp(sim_profile, "outdoor") == 0) profile = SIM_TRACE_OUTDOOR;
+        else if (strcmp(sim_profile, "storm") == 0) profile = SIM_TRACE_STORM;
+        else {
+            usage();
+            return 2;
+        }
+        int wanted = (int)(hours * 3600000.0 / SAMPLE_PERIOD_MS);
+        count = record_sim(profile, wanted < 1 ? 1 : wanted > MAX_SAMPLES ? MAX_SAMPLES : wanted);
+        source = sim_trace_name(profile);
+    } else {
+        count = read_csv(stdin);
+    }
+    if (count == 0) {
+        fprintf(stderr, "traco vazio\n");
+        return 2;
+    }
+
+    if (dump) {
+        printf("# tempo_ms,campos,temperatura,umidade,pressao\n");
+        for (int i = 0; i < count; i++) {
+            const sample_t* s = &samples[i];
+            printf("%u,%u,%d,%d,%d\n", s->time_ms, s->fields, s->value[0], s->value[1], s->value[2]);
+        }
+        return 0;
+    }
+
+    // Tempo no ar de um quadro de leitura completo no perfil padrão do rádio
+    sim_reset();
+    rfm95_initialize();
+    uint32_t airtime_us = rfm95_time_on_air_us(FRAME_READING_MAX_SIZE);
+
+    printf("Traco: %s, %d leituras em %.1f h; uma por pacote: %d pacotes, %.1f s no ar\n",
+           source, count, samples[count - 1].time_ms / 3600000.0, count, (double)count * airtime_us / 1e6);
+    print_header();
+
+    uint32_t violations = 0;
+    result_t r;
+    if (custom) {
+        replay(&config, count, &r);
+        print_result("linha de comando", &r, count, airtime_us);
+        violations += r.violations;
+    } else {
+        for (size_t p = 0; p < sizeof(PRESETS) / sizeof(PRESETS[0]); p++) {
+            replay(&PRESETS[p].config, count, &r);
+            print_result(PRESETS[p].name, &r, count, airtime_us);
+            violations += r.violations;
+        }
+    }
+
+    if (custom) {
+        printf("  motivos:");
+        for (int k = 0; k < REPORT_NUM_REASONS; k++) {
+            printf(" %s %u", report_reason_name((report_reason_t)k), r.reasons[k]);
+        }
+        printf("\n");
+    }
+    printf("unidades: T e U em °C e %%RH, P em Pa; %s\n", violations ? "FALHA" : "OK");
+    return violations ? 1 : 0;
+}
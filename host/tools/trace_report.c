@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trace.h"
+
+// ============================================================================
+// PERCENTIS DOS HISTOGRAMAS DE FASE
+// ============================================================================
+// Lê o console da estação (compilada com a opção TRACE) e, com o último
+// histograma de cada fase, imprime contagem, mínimo, percentis, máximo,
+// média e a fração do tempo da fase gasta nos próprios pontos de medição.
+// As demais linhas do console são ignoradas:
+//
+//   cat /dev/ttyACM0 | trace_report
+//   trace_report < console.log
+
+static trace_hist_t phases[TRACE_NUM_PHASES];
+static unsigned long overhead_ns, uptime_ms;
+
+/**
+ * @brief Interpreta uma linha "@trace <fase> <n> <min> <max> <soma> <faixa>:<contagem> ..."
+ */
+static bool parse_phase(char* line) {
+    char* save;
+    char* name = strtok_r(line, " \n", &save);
+    trace_phase_t phase = name ? trace_phase_find(name) : TRACE_NUM_PHASES;
+    if (phase == TRACE_NUM_PHASES) {
+        return false;
+    }
+
+    trace_hist_t h;
+    trace_hist_clear(&h);
+    char* fields[4];
+    for (int i = 0; i < 4; i++) {
+        fields[i] = strtok_r(NULL, " \n", &save);
+        if (fields[i] == NULL) return false;
+    }
+    h.count = (uint32_t)strtoul(fields[0], NULL, 10);
+    h.min_us = (uint32_t)strtoul(fields[1], NULL, 10);
+    h.max_us = (uint32_t)strtoul(fields[2], NULL, 10);
+    h.sum_us = strtoull(fields[3], NULL, 10);
+
+    uint64_t total = 0;
+    for (char* tok; (tok = strtok_r(NULL, " \n", &save)) != NULL; ) {
+        char* colon = strchr(tok, ':');
+        unsigned long b = strtoul(tok, NULL, 10);
+        if (colon == NULL || b >= TRACE_BUCKETS) return false;
+        h.buckets[b] = (uint32_t)strtoul(colon + 1, NULL, 10);
+        total += h.buckets[b];
+    }
+    if (total != h.count) {
+        return false;                               // Linha truncada no console
+    }
+    phases[phase] = h;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        fprintf(stderr, "uso: trace_report < console.log\n");
+        return 2;
+    }
+
+    char line[4096];
+    int dumps = 0, bad = 0;
+    while (fgets(line, sizeof(line), stdin)) {
+        char* p = strstr(line, "@trace ");
+        if (p == NULL) {
+            continue;
+        }
+        p += 7;
+        if (sscanf(p, "custo_ns %lu tempo_ms %lu", &overhead_ns, &uptime_ms) == 2) {
+            dumps++;
+        } else if (!parse_phase(p)) {
+            bad++;
+        }
+    }
+    if (dumps == 0) {
+        fprintf(stderr, "nenhuma linha @trace na entrada\n");
+        return 1;
+    }
+
+    printf("%d despejos, o último em %.1f s; custo de um ponto de medição: %lu ns", dumps,
+           uptime_ms / 1000.0, overhead_ns);
+    if (bad) printf(" (%d linhas inválidas ignoradas)", bad);
+    printf("\n\n%-14s %8s %9s %9s %9s %9s %9s %9s %9s %7s\n",
+           "fase", "n", "min_us", "p50", "p90", "p99", "p99.9", "max_us", "media", "custo%");
+    for (int i = 0; i < TRACE_NUM_PHASES; i++) {
+        const trace_hist_t* h = &phases[i];
+        if (h->count == 0) {
+            continue;
+        }
+        double mean = (double)h->sum_us / h->count;
+        double cost = h->sum_us ? 100.0 * h->count * (overhead_ns / 1000.0) / h->sum_us : 0;
+        printf("%-14s %8lu %9lu %9lu %9lu %9lu %9lu %9lu %9.1f %7.3f\n",
+               trace_phase_name((trace_phase_t)i), (unsigned long)h->count, (unsigned long)h->min_us,
+               (unsigned long)trace_percentile(h, 500), (unsigned long)trace_percentile(h, 900),
+               (unsigned long)trace_percentile(h, 990), (unsigned long)trace_percentile(h, 999),
+               (unsigned long)h->max_us, mean, cost);
+    }
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "aht20.h"
+#include "trace.h"
 
 #define AHT20_I2C_ADDR      0x38
 #define AHT20_CMD_INIT      0xBE
@@ -35,41 +36,169 @@ bool aht20_init(i2c_inst_t *i2c) {
     return false;  // Falhou na calibração
 }
 
+// Medição em andamento (um único sensor no barramento)
+static bool measuring = false;
+static absolute_time_t ready_at;    // Fim previsto da conversão
+static absolute_time_t deadline;    // Depois disso a medição é abandonada
+static uint64_t measuring_time_us;  // Soma das conversões disparadas (estimativa de consumo)
+
 bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
+    return aht20_start_measurement(i2c) && aht20_collect(i2c, data);
+}
+
+/**
+ * @brief Envia o comando de medição e retorna sem esperar a conversão
+ * 
+ * @return false se o sensor não respondeu ao comando
+ */
+bool aht20_start_measurement(i2c_inst_t *i2c) {
     uint8_t trigger_cmd[3] = {AHT20_CMD_TRIGGER, 0x33, 0x00};
+
+    measuring = false;
+    if (i2c_write_blocking(i2c, AHT20_I2C_ADDR, trigger_cmd, 3, false) != 3) {
+        return false;
+    }
+
+    ready_at = make_timeout_time_ms(AHT20_MEASUREMENT_MS);
+    deadline = make_timeout_time_ms(AHT20_MEASUREMENT_TIMEOUT_MS);
+    measuring = true;
+    measuring_time_us += AHT20_MEASUREMENT_MS * 1000;
+    return true;
+}
+
+/**
+ * @brief Tempo total de conversão desde o boot (duração nominal por medição)
+ * 
+ * Fora da conversão o sensor fica ocioso, com consumo desprezível.
+ */
+uint64_t aht20_measuring_time_us(void) {
+    return measuring_time_us;
+}
+
+/**
+ * @brief Converte as leituras brutas de 20 bits com ponto flutuante
+ */
+void aht20_convert(uint32_t raw_humidity, uint32_t raw_temp, AHT20_Data *data) {
+    data->humidity = (float)raw_humidity * 100.0 / 1048576.0;
+    data->temperature = ((float)raw_temp * 200.0 / 1048576.0) - 50.0;
+}
+
+/**
+ * @brief Converte as leituras brutas de 20 bits sem FPU
+ * 
+ * UR = raw * 100 / 2^20 % e T = raw * 200 / 2^20 - 50 °C viram, em
+ * centésimos, raw * 625 / 2^16 e raw * 1250 / 2^16 - 5000: os produtos
+ * cabem em 32 bits e o resultado é arredondado para o centésimo mais próximo.
+ */
+void aht20_convert_fixed(uint32_t raw_humidity, uint32_t raw_temp, AHT20_Fixed *data) {
+    data->humidity = (uint16_t)((raw_humidity * 625 + 32768) >> 16);
+    data->temperature = (int16_t)((int32_t)((raw_temp * 1250 + 32768) >> 16) - 5000);
+}
+
+/**
+ * @brief Verifica a medição e extrai os valores brutos de 20 bits
+ * 
+ * Antes do tempo de conversão retorna AHT20_BUSY sem tocar no barramento.
+ * Depois, o status e os dados vêm em uma única leitura de 6 bytes.
+ */
+static aht20_status_t aht20_poll_raw(i2c_inst_t *i2c, uint32_t *raw_humidity, uint32_t *raw_temp) {
     uint8_t buffer[6];
 
-    // Envia comando de medição
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, trigger_cmd, 3, false);
-    
-    // Aguarda até o sensor estar pronto
-    uint8_t status;
-    for (int i = 0; i < 10; i++) {
-        i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false);
-        if (!(status & AHT20_STATUS_BUSY)) {
-            break;
+    if (!measuring) {
+        return AHT20_ERROR;
+    }
+    if (!time_reached(ready_at)) {
+        return AHT20_BUSY;
+    }
+
+    TRACE_BEGIN(TRACE_AHT20_READ);
+    int read = i2c_read_blocking(i2c, AHT20_I2C_ADDR, buffer, 6, false);
+    TRACE_END(TRACE_AHT20_READ);
+    if (read != 6) {
+        measuring = false;
+        return AHT20_ERROR;
+    }
+
+    // Ainda ocupado: tenta de novo até o prazo
+    if (buffer[0] & AHT20_STATUS_BUSY) {
+        if (time_reached(deadline)) {
+            measuring = false;
+            return AHT20_ERROR;
         }
-        sleep_ms(10);
+        return AHT20_BUSY;
     }
-    
-    // Se ainda estiver ocupado, falha na leitura
-    if (status & AHT20_STATUS_BUSY) {
-        return false;
+    measuring = false;
+
+    *raw_humidity = ((uint32_t)buffer[1] << 12) | ((uint32_t)buffer[2] << 4) | (buffer[3] >> 4);
+    *raw_temp = ((uint32_t)(buffer[3] & 0x0F) << 16) | ((uint32_t)buffer[4] << 8) | buffer[5];
+    return AHT20_READY;
+}
+
+/**
+ * @brief Dorme até o instante previsto e consulta até o fim da medição
+ */
+static bool aht20_collect_raw(i2c_inst_t *i2c, uint32_t *raw_humidity, uint32_t *raw_temp) {
+    TRACE_BEGIN(TRACE_AHT20_WAIT);
+    for (;;) {
+        aht20_status_t status = aht20_poll_raw(i2c, raw_humidity, raw_temp);
+        if (status != AHT20_BUSY) {
+            TRACE_END(TRACE_AHT20_WAIT);
+            return status == AHT20_READY;
+        }
+
+        if (!time_reached(ready_at)) {
+            sleep_until(ready_at);
+        } else {
+            sleep_ms(AHT20_POLL_INTERVAL_MS);
+        }
     }
+}
 
-    // Lê os 6 bytes de dados
-    if (i2c_read_blocking(i2c, AHT20_I2C_ADDR, buffer, 6, false) != 6) {
-        return false;
+/**
+ * @brief Verifica a medição iniciada por aht20_start_measurement()
+ * 
+ * @param i2c Barramento do sensor
+ * @param data Temperatura e umidade, preenchidas quando retorna AHT20_READY
+ * @return AHT20_BUSY enquanto a conversão não terminou
+ */
+aht20_status_t aht20_poll(i2c_inst_t *i2c, AHT20_Data *data) {
+    uint32_t raw_humidity, raw_temp;
+    aht20_status_t status = aht20_poll_raw(i2c, &raw_humidity, &raw_temp);
+    if (status == AHT20_READY) {
+        aht20_convert(raw_humidity, raw_temp, data);
     }
+    return status;
+}
 
-    // Processa os dados de umidade (20 bits)
-    uint32_t raw_humidity = ((uint32_t)buffer[1] << 12) | ((uint32_t)buffer[2] << 4) | (buffer[3] >> 4);
-    data->humidity = (float)raw_humidity * 100.0 / 1048576.0;
+aht20_status_t aht20_poll_fixed(i2c_inst_t *i2c, AHT20_Fixed *data) {
+    uint32_t raw_humidity, raw_temp;
+    aht20_status_t status = aht20_poll_raw(i2c, &raw_humidity, &raw_temp);
+    if (status == AHT20_READY) {
+        aht20_convert_fixed(raw_humidity, raw_temp, data);
+    }
+    return status;
+}
 
-    // Processa os dados de temperatura (20 bits)
-    uint32_t raw_temp = ((uint32_t)(buffer[3] & 0x0F) << 16) | ((uint32_t)buffer[4] << 8) | buffer[5];
-    data->temperature = ((float)raw_temp * 200.0 / 1048576.0) - 50.0;
+/**
+ * @brief Aguarda o fim da medição dormindo até o instante previsto
+ * 
+ * @return true se os dados foram lidos antes do prazo
+ */
+bool aht20_collect(i2c_inst_t *i2c, AHT20_Data *data) {
+    uint32_t raw_humidity, raw_temp;
+    if (!aht20_collect_raw(i2c, &raw_humidity, &raw_temp)) {
+        return false;
+    }
+    aht20_convert(raw_humidity, raw_temp, data);
+    return true;
+}
 
+bool aht20_collect_fixed(i2c_inst_t *i2c, AHT20_Fixed *data) {
+    uint32_t raw_humidity, raw_temp;
+    if (!aht20_collect_raw(i2c, &raw_humidity, &raw_temp)) {
+        return false;
+    }
+    aht20_convert_fixed(raw_humidity, raw_temp, data);
     return true;
 }
 
@@ -14,21 +14,59 @@
 #define AHT20_CMD_TRIGGER   0xAC
 #define AHT20_CMD_RESET     0xBA
 
+// Tempo de conversão do datasheet e prazo para desistir de uma medição
+#define AHT20_MEASUREMENT_MS            80
+#define AHT20_MEASUREMENT_TIMEOUT_MS    150
+#define AHT20_POLL_INTERVAL_MS          5   // Espera entre consultas após o tempo de conversão
+
 // Estrutura para armazenar os valores de temperatura e umidade
 typedef struct {
     float temperature;
     float humidity;
 } AHT20_Data;
 
+// Temperatura e umidade em ponto fixo (conversão sem FPU)
+typedef struct {
+    int16_t temperature;    // Centésimos de °C
+    uint16_t humidity;      // Centésimos de %RH (0-10000)
+} AHT20_Fixed;
+
+// Estado de uma medição iniciada por aht20_start_measurement()
+typedef enum {
+    AHT20_BUSY,         // Conversão em andamento
+    AHT20_READY,        // Dados lidos
+    AHT20_ERROR,        // Falha de I2C, prazo esgotado ou nenhuma medição iniciada
+} aht20_status_t;
+
 // Configura o I2C para o AHT20
 void setup_I2C_aht20(i2c_inst_t *I2C_PORT, uint I2C_SDA, uint I2C_SCL, uint clock);
 
 // Inicializa o sensor AHT20
 bool aht20_init(i2c_inst_t *i2c);
 
-// Faz a leitura de temperatura e umidade do AHT20
+// Faz a leitura de temperatura e umidade do AHT20 (bloqueia ~80 ms)
 bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data);
 
+// Leitura em duas fases: dispara a conversão e retorna imediatamente
+bool aht20_start_measurement(i2c_inst_t *i2c);
+
+// Consulta sem bloquear; não acessa o barramento antes do fim da conversão
+aht20_status_t aht20_poll(i2c_inst_t *i2c, AHT20_Data *data);
+
+// Dorme até o fim da conversão e lê os dados (ou desiste no prazo)
+bool aht20_collect(i2c_inst_t *i2c, AHT20_Data *data);
+
+// Tempo total em conversão desde o boot (estimativa de consumo)
+uint64_t aht20_measuring_time_us(void);
+
+// Variantes em ponto fixo: só operações inteiras (o Cortex-M0+ não tem FPU)
+aht20_status_t aht20_poll_fixed(i2c_inst_t *i2c, AHT20_Fixed *data);
+bool aht20_collect_fixed(i2c_inst_t *i2c, AHT20_Fixed *data);
+
+// Conversão das leituras brutas de 20 bits (ponto flutuante e ponto fixo)
+void aht20_convert(uint32_t raw_humidity, uint32_t raw_temp, AHT20_Data *data);
+void aht20_convert_fixed(uint32_t raw_humidity, uint32_t raw_temp, AHT20_Fixed *data);
+
 // Reseta o sensor AHT20
 void aht20_reset(i2c_inst_t *i2c);
 
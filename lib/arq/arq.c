@@ -0,0 +1,234 @@
+#include <string.h>
+
+#include "arq.h"
+
+// Sequência a anterior a b, com volta do contador de 16 bits
+static bool arq_before(uint16_t a, uint16_t b) {
+    return (int16_t)(a - b) < 0;
+}
+
+static bool arq_reached(uint32_t now_ms, uint32_t due_ms) {
+    return (int32_t)(now_ms - due_ms) >= 0;
+}
+
+// Maior espera que arq_reached distingue (diferença com sinal de 32 bits)
+#define ARQ_WAIT_LIMIT_MS   ((uint32_t)INT32_MAX)
+
+// ============================================================================
+// ESTAÇÃO
+// ============================================================================
+
+void arq_sender_init(arq_sender_t* sender, const arq_config_t* config,
+                     arq_result_cb_t on_result, void* ctx) {
+    memset(sender, 0, sizeof(*sender));
+    sender->config = config;
+    sender->on_result = on_result;
+    sender->ctx = ctx;
+}
+
+static void arq_finish(arq_sender_t* sender, arq_frame_t* frame, bool delivered) {
+    if (delivered) {
+        sender->stats.delivered++;
+    } else {
+        sender->stats.dropped++;
+    }
+    if (sender->on_result) {
+        sender->on_result(sender->ctx, frame, delivered);
+    }
+    frame->used = false;
+    sender->count--;
+}
+
+/**
+ * @brief Descarta os quadros que esgotaram as tentativas e a última espera
+ */
+static void arq_expire(arq_sender_t* sender, uint32_t now_ms) {
+    for (int i = 0; i < ARQ_MAX_WINDOW; i++) {
+        arq_frame_t* f = &sender->frames[i];
+        if (f->used && f->tries >= sender->config->max_tries && arq_reached(now_ms, f->due_ms)) {
+            arq_finish(sender, f, false);
+        }
+    }
+}
+
+static const arq_frame_t* arq_oldest(const arq_sender_t* sender) {
+    const arq_frame_t* oldest = NULL;
+    for (int i = 0; i < ARQ_MAX_WINDOW; i++) {
+        const arq_frame_t* f = &sender->frames[i];
+        if (f->used && (!oldest || arq_before(f->sequence, oldest->sequence))) {
+            oldest = f;
+        }
+    }
+    return oldest;
+}
+
+/**
+ * @brief Coloca um quadro na janela, pronto para a primeira transmissão
+ *
+ * O limite de FRAME_ACK_SPAN sequências garante que toda sequência pendente
+ * cabe no mapa da confirmação.
+ */
+bool arq_sender_push(arq_sender_t* sender, const uint8_t* data, uint8_t length, uint32_t now_ms) {
+    uint16_t first;
+    int span = frame_sequence_span(data, length, &first);
+    if (span <= 0 || span > FRAME_ACK_SPAN) {
+        return false;
+    }
+
+    arq_expire(sender, now_ms);
+    const arq_frame_t* oldest = arq_oldest(sender);
+    if (sender->count >= sender->config->window || sender->count >= ARQ_MAX_WINDOW ||
+        (oldest && (uint16_t)(first + span - 1 - oldest->sequence) >= FRAME_ACK_SPAN)) {
+        sender->stats.rejected++;
+        return false;
+    }
+
+    arq_frame_t* f = sender->frames;
+    while (f->used) {
+        f++;
+    }
+    memcpy(f->data, data, length);
+    f->length = length;
+    f->used = true;
+    f->tries = 0;
+    f->span = (uint8_t)span;
+    f->sequence = first;
+    f->queued_ms = now_ms;
+    f->due_ms = now_ms;
+    sender->count++;
+    sender->stats.queued++;
+    return true;
+}
+
+/**
+ * @brief Quadro mais antigo cuja transmissão venceu
+ *
+ * Um quadro que já foi transmitido max_tries vezes só é descartado depois
+ * da última espera, pois a confirmação da última tentativa ainda pode chegar.
+ */
+const arq_frame_t* arq_sender_due(arq_sender_t* sender, uint32_t now_ms) {
+    arq_expire(sender, now_ms);
+    const arq_frame_t* due = NULL;
+    for (int i = 0; i < ARQ_MAX_WINDOW; i++) {
+        const arq_frame_t* f = &sender->frames[i];
+        if (f->used && arq_reached(now_ms, f->due_ms) && (!due || arq_before(f->sequence, due->sequence))) {
+            due = f;
+        }
+    }
+    return due;
+}
+
+/**
+ * @brief Registra a transmissão e agenda a próxima tentativa
+ *
+ * A espera começa em timeout_ms e dobra a cada tentativa, limitada a
+ * backoff_max_ms (0 = sem limite). Sem limite ela satura em
+ * ARQ_WAIT_LIMIT_MS em vez de dar a volta para 0 (o que, após umas 32
+ * tentativas, retransmitiria sem espera alguma).
+ */
+void arq_sender_sent(arq_sender_t* sender, const arq_frame_t* frame, uint32_t now_ms) {
+    const arq_config_t* c = sender->config;
+    arq_frame_t* f = &sender->frames[frame - sender->frames];
+
+    uint32_t limit = c->backoff_max_ms > 0 && c->backoff_max_ms < ARQ_WAIT_LIMIT_MS
+                     ? c->backoff_max_ms : ARQ_WAIT_LIMIT_MS;
+    uint32_t wait = c->timeout_ms;
+    for (int i = 0; i < f->tries && wait < limit; i++) {
+        wait = wait > limit / 2 ? limit : wait * 2;
+    }
+    if (wait > limit) {
+        wait = limit;
+    }
+
+    if (f->tries > 0) {
+        sender->stats.retransmissions++;
+    }
+    f->tries++;
+    f->due_ms = now_ms + wait;
+    sender->stats.transmissions++;
+}
+
+static bool arq_acked(const frame_ack_t* ack, uint16_t sequence) {
+    uint16_t d = (uint16_t)(ack->sequence - sequence);
+    return d < FRAME_ACK_SPAN && (ack->bitmap & (1u << d));
+}
+
+/**
+ * @brief Libera os quadros confirmados e antecipa os que faltam
+ *
+ * Um quadro já transmitido que não está no mapa, mas é mais antigo que a
+ * maior sequência recebida, foi perdido: volta a vencer agora.
+ */
+int arq_sender_ack(arq_sender_t* sender, const frame_ack_t* ack, uint32_t now_ms) {
+    int delivered = 0;
+    sender->stats.acks++;
+    for (int i = 0; i < ARQ_MAX_WINDOW; i++) {
+        arq_frame_t* f = &sender->frames[i];
+        if (!f->used) {
+            continue;
+        }
+        bool all = true;
+        for (int k = 0; k < f->span && all; k++) {
+            all = arq_acked(ack, (uint16_t)(f->sequence + k));
+        }
+        if (all) {
+            arq_finish(sender, f, true);
+            delivered++;
+        } else if (f->tries > 0 && arq_before((uint16_t)(f->sequence + f->span - 1), ack->sequence) &&
+                   !arq_reached(now_ms, f->due_ms)) {
+            f->due_ms = now_ms;
+        }
+    }
+    return delivered;
+}
+
+int arq_sender_pending(const arq_sender_t* sender) {
+    return sender->count;
+}
+
+void arq_sender_get_stats(const arq_sender_t* sender, arq_stats_t* stats) {
+    *stats = sender->stats;
+}
+
+// ============================================================================
+// GATEWAY
+// ============================================================================
+
+void arq_receiver_init(arq_receiver_t* receiver) {
+    memset(receiver, 0, sizeof(*receiver));
+}
+
+static bool arq_receiver_mark_one(arq_receiver_t* r, uint16_t sequence) {
+    int16_t d = (int16_t)(sequence - r->sequence);
+    if (!r->started || d <= -FRAME_ACK_SPAN) {
+        // Primeira sequência, ou muito atrás da maior: estação reiniciou
+        r->started = true;
+        r->sequence = sequence;
+        r->bitmap = 1;
+        return true;
+    }
+    if (d > 0) {
+        r->bitmap = d >= FRAME_ACK_SPAN ? 0 : r->bitmap << d;
+        r->bitmap |= 1;
+        r->sequence = sequence;
+        return true;
+    }
+    uint32_t bit = 1u << -d;
+    bool fresh = !(r->bitmap & bit);
+    r->bitmap |= bit;
+    return fresh;
+}
+
+int arq_receiver_mark(arq_receiver_t* receiver, uint16_t first, int span) {
+    int fresh = 0;
+    for (int i = 0; i < span; i++) {
+        fresh += arq_receiver_mark_one(receiver, (uint16_t)(first + i));
+    }
+    return fresh;
+}
+
+void arq_receiver_ack(const arq_receiver_t* receiver, uint8_t station_id, frame_ack_t* ack) {
+    ack->station_id = station_id;
+    ack->sequence = receiver->sequence;
+    ack->bitmap = receiver->bitmap;
+}
@@ -0,0 +1,119 @@
+#ifndef ARQ_H
+#define ARQ_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "frame.h"
+
+// ============================================================================
+// ENTREGA CONFIRMADA: JANELA DE RETRANSMISSÃO SELETIVA
+// ============================================================================
+// A estação guarda cada quadro transmitido até o gateway confirmá-lo. Depois
+// de cada transmissão ela abre uma janela curta de recepção; o gateway
+// responde com um quadro FRAME_TYPE_ACK que traz o mapa das últimas
+// FRAME_ACK_SPAN sequências recebidas, então uma confirmação perdida é
+// coberta pela seguinte e só os quadros que faltam são retransmitidos.
+//
+// Um quadro é retransmitido quando:
+//   - a confirmação mostra uma sequência mais nova recebida e a dele não
+//     (perda detectada, retransmissão imediata);
+//   - nenhuma confirmação o cobre em timeout_ms; a espera dobra a cada
+//     tentativa, até backoff_max_ms, para não gastar o duty cycle durante
+//     um desvanecimento longo.
+// Depois de max_tries transmissões sem confirmação o quadro é descartado e
+// a perda é informada; a estação distingue perda de silêncio.
+//
+// Com window = 1 e timeout_ms = 0 o mesmo código faz pare e espere com
+// retransmissão imediata.
+//
+// O lado do gateway (arq_receiver_t) mantém o mapa por estação e descarta
+// duplicatas. Uma sequência mais de FRAME_ACK_SPAN atrás da maior recebida
+// é tomada como reinício da estação.
+//
+// O código não depende do Pico SDK e é usado também pelo gateway.
+
+#define ARQ_MAX_WINDOW      16
+
+typedef struct {
+    uint8_t window;             // Quadros sem confirmação (1..ARQ_MAX_WINDOW; 1 = pare e espere)
+    uint8_t max_tries;          // Transmissões por quadro antes de desistir
+    uint32_t timeout_ms;        // Espera pela confirmação após a 1ª transmissão
+    uint32_t backoff_max_ms;    // Espera máxima entre tentativas (0 = até INT32_MAX)
+} arq_config_t;
+
+// Quadro aguardando confirmação
+typedef struct {
+    uint8_t data[FRAME_MAX_SIZE];
+    uint8_t length;
+    bool used;
+    uint8_t tries;              // Transmissões feitas
+    uint8_t span;               // Sequências ocupadas (lote: uma por leitura)
+    uint16_t sequence;          // Primeira sequência do quadro
+    uint32_t queued_ms;         // Instante em que entrou na janela
+    uint32_t due_ms;            // Próxima transmissão
+} arq_frame_t;
+
+// Resultado de um quadro: confirmado ou descartado após max_tries
+typedef void (*arq_result_cb_t)(void* ctx, const arq_frame_t* frame, bool delivered);
+
+typedef struct {
+    uint32_t queued;            // Quadros aceitos por arq_sender_push
+    uint32_t rejected;          // Quadros recusados (janela cheia)
+    uint32_t transmissions;     // Transmissões, inclusive retransmissões
+    uint32_t retransmissions;
+    uint32_t delivered;
+    uint32_t dropped;           // Descartados após max_tries
+    uint32_t acks;              // Confirmações processadas
+} arq_stats_t;
+
+typedef struct {
+    const arq_config_t* config;
+    arq_frame_t frames[ARQ_MAX_WINDOW];
+    uint8_t count;
+    arq_result_cb_t on_result;
+    void* ctx;
+    arq_stats_t stats;
+} arq_sender_t;
+
+// Mapa de recepção de uma estação no gateway
+typedef struct {
+    bool started;
+    uint16_t sequence;          // Maior sequência recebida
+    uint32_t bitmap;            // Bit i = sequência (sequence - i) recebida
+} arq_receiver_t;
+
+void arq_sender_init(arq_sender_t* sender, const arq_config_t* config,
+                     arq_result_cb_t on_result, void* ctx);
+
+// Coloca um quadro da estação na janela (copiado); false se a janela estiver
+// cheia, se ele ficar a FRAME_ACK_SPAN sequências ou mais do mais antigo
+// pendente, ou se o quadro não tiver sequência. Os quadros que esgotaram as
+// tentativas são descartados antes.
+bool arq_sender_push(arq_sender_t* sender, const uint8_t* data, uint8_t length, uint32_t now_ms);
+
+// Quadro mais antigo a transmitir agora, ou NULL; descarta antes os que
+// esgotaram as tentativas
+const arq_frame_t* arq_sender_due(arq_sender_t* sender, uint32_t now_ms);
+
+// Registra a transmissão do quadro devolvido por arq_sender_due
+void arq_sender_sent(arq_sender_t* sender, const arq_frame_t* frame, uint32_t now_ms);
+
+// Processa uma confirmação; retorna a quantidade de quadros confirmados
+int arq_sender_ack(arq_sender_t* sender, const frame_ack_t* ack, uint32_t now_ms);
+
+// Quadros aguardando confirmação
+int arq_sender_pending(const arq_sender_t* sender);
+
+void arq_sender_get_stats(const arq_sender_t* sender, arq_stats_t* stats);
+
+void arq_receiver_init(arq_receiver_t* receiver);
+
+// Marca as span sequências a partir de first; retorna quantas eram novas
+// (0 = duplicata)
+int arq_receiver_mark(arq_receiver_t* receiver, uint16_t first, int span);
+
+// Confirmação com o mapa atual
+void arq_receiver_ack(const arq_receiver_t* receiver, uint8_t station_id, frame_ack_t* ack);
+
+#endif // ARQ_H
@@ -13,19 +13,132 @@ void setup_I2C_bmp280(i2c_inst_t *I2C_PORT, uint I2C_SDA, uint I2C_SCL, uint clo
     gpio_pull_up(I2C_SCL); // Configura pull-up para a linha de clock
 }
 
+// ============================================================================
+// PERFIS DE MEDIÇÃO
+// ============================================================================
+
+const bmp280_profile_t bmp280_profile_ultra_low_power = {
+    BMP280_MODE_FORCED, BMP280_OSRS_X1, BMP280_OSRS_X1, BMP280_FILTER_OFF, BMP280_STANDBY_0_5_MS
+};
+const bmp280_profile_t bmp280_profile_standard = {
+    BMP280_MODE_FORCED, BMP280_OSRS_X1, BMP280_OSRS_X4, BMP280_FILTER_4, BMP280_STANDBY_0_5_MS
+};
+const bmp280_profile_t bmp280_profile_high_resolution = {
+    BMP280_MODE_FORCED, BMP280_OSRS_X2, BMP280_OSRS_X16, BMP280_FILTER_16, BMP280_STANDBY_0_5_MS
+};
+const bmp280_profile_t bmp280_profile_normal = {
+    BMP280_MODE_NORMAL, BMP280_OSRS_X1, BMP280_OSRS_X4, BMP280_FILTER_16, BMP280_STANDBY_500_MS
+};
+
+// Perfil em uso e valor de REG_CTRL_MEAS que dispara uma conversão forçada
+static bmp280_profile_t active_profile;
+static uint8_t ctrl_meas_forced;
+static uint64_t measuring_time_us;  // Soma das conversões forçadas (estimativa de consumo)
+
 void bmp280_init(i2c_inst_t *i2c) {
+    bmp280_set_profile(i2c, &bmp280_profile_normal);
+}
+
+/**
+ * @brief Aplica um perfil de medição
+ * 
+ * No modo forçado o sensor fica em sleep até bmp280_start_measurement().
+ * O filtro IIR continua valendo entre conversões forçadas.
+ */
+void bmp280_set_profile(i2c_inst_t *i2c, const bmp280_profile_t* profile) {
     uint8_t buf[2];
-    const uint8_t reg_config_val = ((0x04 << 5) | (0x05 << 2)) & 0xFC;
+    active_profile = *profile;
+
+    // Modo sleep antes de mudar REG_CONFIG (escritas no modo normal podem ser ignoradas)
+    buf[0] = REG_CTRL_MEAS;
+    buf[1] = BMP280_MODE_SLEEP;
+    i2c_write_blocking(i2c, ADDR, buf, 2, false);
+
     buf[0] = REG_CONFIG;
-    buf[1] = reg_config_val;
-   
+    buf[1] = ((profile->standby & 0x07) << 5) | ((profile->filter & 0x07) << 2);
     i2c_write_blocking(i2c, ADDR, buf, 2, false);
 
-    const uint8_t reg_ctrl_meas_val = (0x01 << 5) | (0x03 << 2) | (0x03);
-    buf[0] = REG_CTRL_MEAS;
-    buf[1] = reg_ctrl_meas_val;
+    uint8_t ctrl_meas = ((profile->osrs_t & 0x07) << 5) | ((profile->osrs_p & 0x07) << 2);
+    ctrl_meas_forced = ctrl_meas | BMP280_MODE_FORCED;
+    if (profile->mode == BMP280_MODE_NORMAL) {
+        buf[0] = REG_CTRL_MEAS;
+        buf[1] = ctrl_meas | BMP280_MODE_NORMAL;
+        i2c_write_blocking(i2c, ADDR, buf, 2, false);
+    }
+}
+
+static uint32_t bmp280_oversampling(uint8_t osrs) {
+    if (osrs == BMP280_OSRS_SKIP) return 0;
+    return 1u << ((osrs > BMP280_OSRS_X16 ? BMP280_OSRS_X16 : osrs) - 1);
+}
+
+/**
+ * @brief Tempo máximo de uma conversão no perfil (datasheet, apêndice B)
+ * 
+ * t_max = 1.25 + 2.3 * T_os + (2.3 * P_os + 0.575) ms
+ * 
+ * @return Tempo em microssegundos
+ */
+uint32_t bmp280_conversion_time_us(const bmp280_profile_t* profile) {
+    uint32_t t_os = bmp280_oversampling(profile->osrs_t);
+    uint32_t p_os = bmp280_oversampling(profile->osrs_p);
+    return 1250 + 2300 * t_os + (p_os ? 2300 * p_os + 575 : 0);
+}
+
+/**
+ * @brief Dispara uma conversão forçada e retorna sem esperar
+ * 
+ * @return Tempo máximo da conversão em microssegundos; 0 no modo normal,
+ *         em que o último resultado já está disponível
+ */
+uint32_t bmp280_start_measurement(i2c_inst_t *i2c) {
+    if (active_profile.mode == BMP280_MODE_NORMAL) {
+        return 0;
+    }
+    uint8_t buf[2] = { REG_CTRL_MEAS, ctrl_meas_forced };
     i2c_write_blocking(i2c, ADDR, buf, 2, false);
- //   printf("Ctrl_meas register value: %x\n", reg_ctrl_meas_val);
+    uint32_t conversion_us = bmp280_conversion_time_us(&active_profile);
+    measuring_time_us += conversion_us;
+    return conversion_us;
+}
+
+/**
+ * @brief Tempo total de conversão forçada desde o boot (tempo máximo do
+ * perfil por medição); entre conversões o sensor fica em sleep
+ */
+uint64_t bmp280_measuring_time_us(void) {
+    return measuring_time_us;
+}
+
+/**
+ * @brief Faz uma medição completa no perfil ativo
+ * 
+ * No modo forçado dispara a conversão e dorme o tempo máximo do perfil.
+ * Status e dados vêm na mesma leitura em rajada (0xF3 a 0xFC).
+ * 
+ * @return false se a conversão ainda não terminou ou o I2C falhou
+ */
+bool bmp280_measure(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure) {
+    uint8_t buf[REG_TEMP_XLSB - REG_STATUS + 1];
+    uint8_t reg = REG_STATUS;
+
+    uint32_t wait_us = bmp280_start_measurement(i2c);
+    if (wait_us) {
+        sleep_us(wait_us);
+    }
+
+    i2c_write_blocking(i2c, ADDR, &reg, 1, true);
+    if (i2c_read_blocking(i2c, ADDR, buf, sizeof(buf), false) != (int)sizeof(buf)) {
+        return false;
+    }
+    if (wait_us && (buf[0] & BMP280_STATUS_MEASURING)) {
+        return false;
+    }
+
+    const uint8_t* data = &buf[REG_PRESSURE_MSB - REG_STATUS];
+    *pressure = (data[0] << 12) | (data[1] << 4) | (data[2] >> 4);
+    *temp = (data[3] << 12) | (data[4] << 4) | (data[5] >> 4);
+    return true;
 }
 
 void bmp280_read_raw(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure) {
@@ -45,14 +158,24 @@ void bmp280_reset(i2c_inst_t *i2c) {
     i2c_write_blocking(i2c, ADDR, buf, 2, false);
 }
 
+// Compensação de temperatura de 32 bits do datasheet (t_fine). Única cópia
+// da fórmula: o par de chamadas, a passada única, a de 64 bits e o lote
+// passam por aqui, este último com os coeficientes já carregados
+static inline int32_t bmp280_t_fine_coeffs(int32_t raw_t, int32_t t1, int32_t t2, int32_t t3) {
+    int32_t var1, var2;
+    var1 = (((raw_t >> 3) - (t1 << 1)) * t2) >> 11;
+    var2 = (((((raw_t >> 4) - t1) * ((raw_t >> 4) - t1)) >> 12) * t3) >> 14;
+    return var1 + var2;
+}
+
+static inline int32_t bmp280_t_fine(int32_t raw_t, const struct bmp280_calib_param* params) {
+    return bmp280_t_fine_coeffs(raw_t, params->dig_t1, params->dig_t2, params->dig_t3);
+}
+
 // função intermediária que calcula a temperatura de resolução fina
 // usada tanto para conversões de pressão quanto de temperatura
 int32_t bmp280_convert(int32_t temp, struct bmp280_calib_param* params) {
-    // usa os 32 bits de compensação de ponto fixo implementados no datasheet
-    int32_t var1, var2;
-    var1 = ((((temp >> 3) - ((int32_t)params->dig_t1 << 1))) * ((int32_t)params->dig_t2)) >> 11;
-    var2 = (((((temp >> 4) - ((int32_t)params->dig_t1)) * ((temp >> 4) - ((int32_t)params->dig_t1))) >> 12) * ((int32_t)params->dig_t3)) >> 14;
-    return var1 + var2;
+    return bmp280_t_fine(temp, params);
 }
 
 int32_t bmp280_convert_temp(int32_t temp, struct bmp280_calib_param* params) {
@@ -90,11 +213,204 @@ int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_ca
     return converted;
 }
 
+// ============================================================================
+// COMPENSAÇÃO EM UMA PASSADA
+// ============================================================================
+// bmp280_convert_temp() e bmp280_convert_pressure() calculam t_fine cada
+// uma; as funções abaixo calculam uma vez só e devolvem os dois valores.
+
+/**
+ * @brief Compensação de 32 bits do datasheet (mesmo resultado do par
+ * bmp280_convert_temp/bmp280_convert_pressure)
+ * 
+ * @param raw_t Temperatura bruta (20 bits)
+ * @param raw_p Pressão bruta (20 bits)
+ * @param params Parâmetros de calibração
+ * @param out Temperatura em centésimos de °C e pressão em Pa (pressure = 0
+ *            se a calibração for inválida)
+ */
+void bmp280_compensate(int32_t raw_t, int32_t raw_p, const struct bmp280_calib_param* params, bmp280_reading_t* out) {
+    int32_t t_fine = bmp280_t_fine(raw_t, params);
+    out->temperature = (t_fine * 5 + 128) >> 8;
+
+    int32_t var1, var2;
+    uint32_t p;
+    var1 = (t_fine >> 1) - (int32_t)64000;
+    var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * ((int32_t)params->dig_p6);
+    var2 += ((var1 * ((int32_t)params->dig_p5)) << 1);
+    var2 = (var2 >> 2) + (((int32_t)params->dig_p4) << 16);
+    var1 = (((params->dig_p3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + ((((int32_t)params->dig_p2) * var1) >> 1)) >> 18;
+    var1 = ((((32768 + var1)) * ((int32_t)params->dig_p1)) >> 15);
+    if (var1 == 0) {
+        out->pressure = 0;
+        out->pressure_q8 = 0;
+        return;
+    }
+    p = (((uint32_t)(((int32_t)1048576) - raw_p) - (var2 >> 12))) * 3125;
+    if (p < 0x80000000) {
+        p = (p << 1) / ((uint32_t)var1);
+    } else {
+        p = (p / (uint32_t)var1) * 2;
+    }
+    var1 = (((int32_t)params->dig_p9) * ((int32_t)(((p >> 3) * (p >> 3)) >> 13))) >> 12;
+    var2 = (((int32_t)(p >> 2)) * ((int32_t)params->dig_p8)) >> 13;
+    out->pressure = (uint32_t)((int32_t)p + ((var1 + var2 + params->dig_p7) >> 4));
+    out->pressure_q8 = out->pressure << 8;
+}
+
+/**
+ * @brief Compensação de pressão com inteiros de 64 bits (datasheet, 3.11.3)
+ * 
+ * Resolução de 1/256 Pa em pressure_q8; pressure é o valor arredondado
+ * para Pa. Os deslocamentos à esquerda de valores com sinal do datasheet
+ * foram trocados por multiplicações equivalentes.
+ */
+void bmp280_compensate64(int32_t raw_t, int32_t raw_p, const struct bmp280_calib_param* params, bmp280_reading_t* out) {
+    int32_t t_fine = bmp280_t_fine(raw_t, params);
+    out->temperature = (t_fine * 5 + 128) >> 8;
+
+    int64_t var1, var2, p;
+    var1 = (int64_t)t_fine - 128000;
+    var2 = var1 * var1 * (int64_t)params->dig_p6;
+    var2 = var2 + var1 * (int64_t)params->dig_p5 * 131072;
+    var2 = var2 + (int64_t)params->dig_p4 * 34359738368;
+    var1 = ((var1 * var1 * (int64_t)params->dig_p3) >> 8) + var1 * (int64_t)params->dig_p2 * 4096;
+    var1 = ((((int64_t)1) << 47) + var1) * (int64_t)params->dig_p1 >> 33;
+    if (var1 == 0) {
+        out->pressure = 0;
+        out->pressure_q8 = 0;
+        return;
+    }
+    p = 1048576 - raw_p;
+    p = ((p * 2147483648) - var2) * 3125 / var1;
+    var1 = ((int64_t)params->dig_p9 * (p >> 13) * (p >> 13)) >> 25;
+    var2 = ((int64_t)params->dig_p8 * p) >> 19;
+    p = ((p + var1 + var2) >> 8) + (int64_t)params->dig_p7 * 16;
+
+    out->pressure_q8 = (uint32_t)p;
+    out->pressure = (uint32_t)((p + 128) >> 8);
+}
+
+// Conversões uint32 <-> double pelo caminho com sinal, que tem instrução
+// vetorial no SSE2/NEON (o caminho sem sinal impede a vetorização)
+static inline double bmp280_u32_to_double(uint32_t v) {
+    return (double)(int32_t)(v ^ 0x80000000u) + 2147483648.0;
+}
+
+// v >= 0, truncado como a divisão inteira. Quocientes a partir de 2^31 só
+// aparecem com var1 < 2 (calibração inválida) e saturam.
+static inline uint32_t bmp280_double_to_u32(double v) {
+    double c = v < 2147483647.0 ? v : 2147483647.0;
+    return (uint32_t)(int32_t)c;
+}
+
+/**
+ * @brief Compensa um vetor de leituras brutas (logs no gateway)
+ * 
+ * @param raw_t Temperaturas brutas
+ * @param raw_p Pressões brutas
+ * @param temperature Saída em centésimos de °C
+ * @param pressure Saída em Pa
+ * @param count Quantidade de leituras
+ * @param params Parâmetros de calibração
+ * 
+ * Mesmo resultado de bmp280_compensate(), organizado para vetorização:
+ * vetores separados por grandeza, sem desvios no laço (o caso da divisão é
+ * escolhido por seleção) e a divisão de 32 bits feita em double, que é exata
+ * para operandos menores que 2^32. t_fine fica em temperature entre as duas
+ * passadas.
+ */
+void bmp280_compensate_batch(const int32_t* raw_t, const int32_t* raw_p, int32_t* temperature, uint32_t* pressure,
+                             int count, const struct bmp280_calib_param* params) {
+    const int32_t t1 = params->dig_t1, t2 = params->dig_t2, t3 = params->dig_t3;
+    const int32_t p1 = params->dig_p1, p2 = params->dig_p2, p3 = params->dig_p3;
+    const int32_t p4 = params->dig_p4, p5 = params->dig_p5, p6 = params->dig_p6;
+    const int32_t p7 = params->dig_p7, p8 = params->dig_p8, p9 = params->dig_p9;
+
+    for (int i = 0; i < count; i++) {
+        temperature[i] = bmp280_t_fine_coeffs(raw_t[i], t1, t2, t3);   // t_fine
+    }
+
+    for (int i = 0; i < count; i++) {
+        int32_t t_fine = temperature[i];
+        int32_t var1 = (t_fine >> 1) - 64000;
+        int32_t var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * p6;
+        var2 += (var1 * p5) * 2;
+        var2 = (var2 >> 2) + p4 * 65536;
+        var1 = (((p3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + ((p2 * var1) >> 1)) >> 18;
+        var1 = ((32768 + var1) * p1) >> 15;
+
+        uint32_t p = ((uint32_t)(1048576 - raw_p[i]) - (uint32_t)(var2 >> 12)) * 3125;
+        // Uma única divisão: (p << 1) / var1 ou (p / var1) * 2, conforme p.
+        // Seleções feitas com máscaras; com ?: o GCC duplica a conversão
+        // para double em cada ramo e desiste da vetorização.
+        uint32_t low = 0u - (p < 0x80000000);
+        double div = bmp280_u32_to_double((uint32_t)var1) + (var1 == 0);
+        uint32_t q = bmp280_double_to_u32(bmp280_u32_to_double(p + (p & low)) / div);
+        p = q + (q & ~low);
+
+        int32_t v1 = (p9 * (int32_t)(((p >> 3) * (p >> 3)) >> 13)) >> 12;
+        int32_t v2 = ((int32_t)(p >> 2) * p8) >> 13;
+        p = (uint32_t)((int32_t)p + ((v1 + v2 + p7) >> 4));
+
+        temperature[i] = (t_fine * 5 + 128) >> 8;
+        pressure[i] = p & (0u - (var1 != 0));
+    }
+}
+
 // Função para calcular a altitude a partir da pressão atmosférica
 double calculate_altitude(double pressure) {
     return 44330.0 * (1.0 - pow(pressure / SEA_LEVEL_PRESSURE, 0.1903));
 }
 
+// ============================================================================
+// ALTITUDE SEM FPU
+// ============================================================================
+// h(p) = 44330 * (1 - (p / 101325)^0.1903) m, o mesmo de calculate_altitude(),
+// tabelado em centímetros a cada 1024 Pa de 30720 a 110592 Pa (cerca de
+// 9100 m a -740 m) e interpolado linearmente. Erro da interpolação contra a
+// fórmula em double: até 0.74 m perto de 30 kPa e até 0.18 m acima de 70 kPa
+// (abaixo de ~3000 m), bem menor que a incerteza absoluta do BMP280
+// (±1 hPa, cerca de ±8 m).
+
+#define ALTITUDE_TABLE_P_MIN    30720
+#define ALTITUDE_TABLE_SHIFT    10          // 1024 Pa por intervalo
+#define ALTITUDE_TABLE_SIZE     79
+
+static const int32_t altitude_table_cm[ALTITUDE_TABLE_SIZE] = {
+    900631, 878520, 856980, 835978, 815485, 795474, 775921, 756803,
+    738099, 719790, 701856, 684283, 667052, 650151, 633565, 617282,
+    601289, 585575, 570129, 554942, 540004, 525306, 510839, 496596,
+    482569, 468751, 455134, 441713, 428482, 415433, 402563, 389865,
+    377335, 364967, 352757, 340701, 328794, 317032, 305412, 293929,
+    282580, 271361, 260270, 249302, 238456, 227728, 217115, 206614,
+    196224, 185940, 175762, 165686, 155710, 145832, 136050, 126362,
+    116766, 107260, 97841, 88509, 79262, 70097, 61014, 52010,
+    43084, 34235, 25461, 16761, 8133, -425, -8912, -17331,
+    -25683, -33968, -42189, -50346, -58440, -66473, -74445,
+};
+
+/**
+ * @brief Altitude em centímetros a partir da pressão em Pa, só com inteiros
+ * 
+ * @param pressure Pressão em Pa (ex: bmp280_reading_t.pressure)
+ * @return Altitude em cm; fora de 30720-110592 Pa, o valor do extremo da tabela
+ */
+int32_t bmp280_altitude_cm(uint32_t pressure) {
+    if (pressure <= ALTITUDE_TABLE_P_MIN) {
+        return altitude_table_cm[0];
+    }
+    uint32_t offset = pressure - ALTITUDE_TABLE_P_MIN;
+    uint32_t i = offset >> ALTITUDE_TABLE_SHIFT;
+    if (i >= ALTITUDE_TABLE_SIZE - 1) {
+        return altitude_table_cm[ALTITUDE_TABLE_SIZE - 1];
+    }
+
+    int32_t frac = (int32_t)(offset & ((1u << ALTITUDE_TABLE_SHIFT) - 1));
+    int32_t slope = altitude_table_cm[i + 1] - altitude_table_cm[i];
+    return altitude_table_cm[i] + ((slope * frac + (1 << (ALTITUDE_TABLE_SHIFT - 1))) >> ALTITUDE_TABLE_SHIFT);
+}
+
 void bmp280_get_calib_params(i2c_inst_t *i2c, struct bmp280_calib_param* params) {
     uint8_t buf[NUM_CALIB_PARAMS] = { 0 };
     uint8_t reg = REG_DIG_T1_LSB;
@@ -8,6 +8,7 @@
 // Defina os endereços e registros conforme o código original
 #define ADDR _u(0x76)
 
+#define REG_STATUS _u(0xF3)
 #define REG_CONFIG _u(0xF5)
 #define REG_CTRL_MEAS _u(0xF4)
 #define REG_RESET _u(0xE0)
@@ -45,6 +46,38 @@
 #define REG_DIG_P9_LSB _u(0x9E)
 #define REG_DIG_P9_MSB _u(0x9F)
 
+// Modos de operação (REG_CTRL_MEAS bits 1-0)
+#define BMP280_MODE_SLEEP   0x00
+#define BMP280_MODE_FORCED  0x01    // Uma conversão e volta ao modo sleep
+#define BMP280_MODE_NORMAL  0x03    // Conversões contínuas separadas pelo standby
+
+// Sobreamostragem de temperatura e pressão (osrs_t / osrs_p)
+#define BMP280_OSRS_SKIP    0x00
+#define BMP280_OSRS_X1      0x01
+#define BMP280_OSRS_X2      0x02
+#define BMP280_OSRS_X4      0x03
+#define BMP280_OSRS_X8      0x04
+#define BMP280_OSRS_X16     0x05
+
+// Coeficiente do filtro IIR (REG_CONFIG bits 4-2)
+#define BMP280_FILTER_OFF   0x00
+#define BMP280_FILTER_2     0x01
+#define BMP280_FILTER_4     0x02
+#define BMP280_FILTER_8     0x03
+#define BMP280_FILTER_16    0x04
+
+// Tempo de standby do modo normal (REG_CONFIG bits 7-5)
+#define BMP280_STANDBY_0_5_MS   0x00
+#define BMP280_STANDBY_62_5_MS  0x01
+#define BMP280_STANDBY_125_MS   0x02
+#define BMP280_STANDBY_250_MS   0x03
+#define BMP280_STANDBY_500_MS   0x04
+#define BMP280_STANDBY_1000_MS  0x05
+#define BMP280_STANDBY_2000_MS  0x06
+#define BMP280_STANDBY_4000_MS  0x07
+
+#define BMP280_STATUS_MEASURING 0x08
+
 #define NUM_CALIB_PARAMS 24
 #define SEA_LEVEL_PRESSURE 101325.0 // Pressão ao nível do mar em Pa
 
@@ -64,13 +97,46 @@ struct bmp280_calib_param {
     int16_t dig_p9;
 };
 
+// Perfil de medição: modo, sobreamostragem e filtro
+typedef struct {
+    uint8_t mode;       // BMP280_MODE_*
+    uint8_t osrs_t;     // BMP280_OSRS_*
+    uint8_t osrs_p;     // BMP280_OSRS_*
+    uint8_t filter;     // BMP280_FILTER_*
+    uint8_t standby;    // BMP280_STANDBY_* (só no modo normal)
+} bmp280_profile_t;
+
+// Perfis prontos (datasheet, seção 3.8). Para um perfil próprio, basta
+// preencher um bmp280_profile_t.
+extern const bmp280_profile_t bmp280_profile_ultra_low_power;  // Forçado, x1/x1, sem filtro
+extern const bmp280_profile_t bmp280_profile_standard;         // Forçado, t x1, p x4, filtro 4
+extern const bmp280_profile_t bmp280_profile_high_resolution;  // Forçado, t x2, p x16, filtro 16
+extern const bmp280_profile_t bmp280_profile_normal;           // Contínuo, configuração antiga do bmp280_init
+
+// Temperatura e pressão compensadas em uma única passada
+typedef struct {
+    int32_t temperature;    // Centésimos de °C
+    uint32_t pressure;      // Pa
+    uint32_t pressure_q8;   // Pa em Q24.8 (1/256 Pa); resolução total só em bmp280_compensate64
+} bmp280_reading_t;
+
 void setup_I2C_bmp280(i2c_inst_t *I2C_PORT, uint I2C_SDA, uint I2C_SCL, uint clock);
 void bmp280_init(i2c_inst_t *i2c);
+void bmp280_set_profile(i2c_inst_t *i2c, const bmp280_profile_t* profile);
+uint32_t bmp280_conversion_time_us(const bmp280_profile_t* profile);
+uint32_t bmp280_start_measurement(i2c_inst_t *i2c);
+bool bmp280_measure(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure);
+uint64_t bmp280_measuring_time_us(void);
 void bmp280_read_raw(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure);
 void bmp280_reset(i2c_inst_t *i2c);
 int32_t bmp280_convert_temp(int32_t temp, struct bmp280_calib_param* params);
 int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_calib_param* params);
+void bmp280_compensate(int32_t raw_t, int32_t raw_p, const struct bmp280_calib_param* params, bmp280_reading_t* out);
+void bmp280_compensate64(int32_t raw_t, int32_t raw_p, const struct bmp280_calib_param* params, bmp280_reading_t* out);
+void bmp280_compensate_batch(const int32_t* raw_t, const int32_t* raw_p, int32_t* temperature, uint32_t* pressure,
+                             int count, const struct bmp280_calib_param* params);
 double calculate_altitude(double pressure);
+int32_t bmp280_altitude_cm(uint32_t pressure);
 void bmp280_get_calib_params(i2c_inst_t *i2c, struct bmp280_calib_param* params);
 
 #endif
@@ -0,0 +1,485 @@
+#include <string.h>
+
+#include "flashlog.h"
+#include "pico/flash.h"
+#include "hardware/regs/addressmap.h"
+
+#define FLASHLOG_MAGIC          0x314C5357u     // "WSL1"
+#define FLASHLOG_TYPE_READING   0x52            // 'R'
+#define FLASHLOG_TYPE_ACK       0x41            // 'A'
+#define FLASHLOG_FREE           0xFF
+
+#define FLASHLOG_SAFE_TIMEOUT_MS 100
+
+// Página (ou par de páginas) montada para uma gravação parcial
+static uint8_t flashlog_page[2 * FLASH_PAGE_SIZE];
+
+typedef struct {
+    bool valid;
+    uint32_t order;
+    uint32_t erase_count;
+} flashlog_header_t;
+
+typedef struct {
+    uint32_t offset;
+    const uint8_t* data;
+    size_t count;
+} flashlog_op_t;
+
+// ============================================================================
+// CODIFICAÇÃO
+// ============================================================================
+
+static uint16_t flashlog_crc16(const uint8_t* data, int len) {
+    uint16_t crc = 0xFFFF;
+    for (int i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void flashlog_put_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t flashlog_get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void flashlog_encode(uint8_t type, const flashlog_record_t* r, uint8_t* p) {
+    p[0] = type;
+    p[1] = r->fields;
+    p[2] = r->boot;
+    flashlog_put_u32(&p[3], r->seq);
+    flashlog_put_u32(&p[7], r->time_ms);
+    p[11] = (uint8_t)r->temperature;
+    p[12] = (uint8_t)((uint16_t)r->temperature >> 8);
+    p[13] = (uint8_t)r->humidity;
+    p[14] = (uint8_t)(r->humidity >> 8);
+    p[15] = (uint8_t)r->pressure;
+    p[16] = (uint8_t)(r->pressure >> 8);
+    p[17] = (uint8_t)(r->pressure >> 16);
+    uint16_t crc = flashlog_crc16(p, FLASHLOG_RECORD_SIZE - 2);
+    p[18] = (uint8_t)crc;
+    p[19] = (uint8_t)(crc >> 8);
+}
+
+/**
+ * @brief Lê um registro do slot
+ *
+ * @return Tipo do registro, FLASHLOG_FREE se o slot está apagado ou 0 se o
+ *         conteúdo é inválido (gravação interrompida)
+ */
+static uint8_t flashlog_decode(const uint8_t* p, flashlog_record_t* r) {
+    bool blank = true;
+    for (int i = 0; i < FLASHLOG_RECORD_SIZE && blank; i++) {
+        blank = p[i] == 0xFF;
+    }
+    if (blank) {
+        return FLASHLOG_FREE;
+    }
+    uint16_t crc = (uint16_t)(p[18] | (p[19] << 8));
+    if ((p[0] != FLASHLOG_TYPE_READING && p[0] != FLASHLOG_TYPE_ACK) ||
+        crc != flashlog_crc16(p, FLASHLOG_RECORD_SIZE - 2)) {
+        return 0;
+    }
+    r->fields = p[1];
+    r->boot = p[2];
+    r->seq = flashlog_get_u32(&p[3]);
+    r->time_ms = flashlog_get_u32(&p[7]);
+    r->temperature = (int16_t)(p[11] | (p[12] << 8));
+    r->humidity = (uint16_t)(p[13] | (p[14] << 8));
+    r->pressure = (uint32_t)p[15] | ((uint32_t)p[16] << 8) | ((uint32_t)p[17] << 16);
+    return p[0];
+}
+
+// ============================================================================
+// ACESSO À FLASH
+// ============================================================================
+
+static const uint8_t* flashlog_sector_ptr(const flashlog_t* log, uint16_t sector) {
+    return (const uint8_t*)(XIP_BASE + log->offset + (uint32_t)sector * FLASH_SECTOR_SIZE);
+}
+
+static const uint8_t* flashlog_slot_ptr(const flashlog_t* log, uint16_t sector, uint16_t slot) {
+    return flashlog_sector_ptr(log, sector) + FLASHLOG_HEADER_SIZE + slot * FLASHLOG_RECORD_SIZE;
+}
+
+static flashlog_header_t flashlog_read_header(const flashlog_t* log, uint16_t sector) {
+    const uint8_t* p = flashlog_sector_ptr(log, sector);
+    flashlog_header_t h = { 0 };
+    h.valid = flashlog_get_u32(p) == FLASHLOG_MAGIC &&
+              (uint16_t)(p[12] | (p[13] << 8)) == flashlog_crc16(p, 12);
+    if (h.valid) {
+        h.order = flashlog_get_u32(&p[4]);
+        h.erase_count = flashlog_get_u32(&p[8]);
+    }
+    return h;
+}
+
+static void flashlog_do_erase(void* param) {
+    const flashlog_op_t* op = param;
+    flash_range_erase(op->offset, op->count);
+}
+
+static void flashlog_do_program(void* param) {
+    const flashlog_op_t* op = param;
+    flash_range_program(op->offset, op->data, op->count);
+}
+
+/**
+ * @brief Grava bytes em qualquer posição com gravação parcial de página
+ *
+ * Os bytes fora do intervalo ficam em 0xFF no buffer e não alteram a flash.
+ * Intervalos de até FLASH_PAGE_SIZE bytes tocam no máximo duas páginas.
+ */
+static bool flashlog_program(flashlog_t* log, uint32_t offset, const uint8_t* data, int len) {
+    uint32_t page = offset & ~(FLASH_PAGE_SIZE - 1);
+    uint32_t end = (offset + len + FLASH_PAGE_SIZE - 1) & ~(FLASH_PAGE_SIZE - 1);
+    memset(flashlog_page, 0xFF, end - page);
+    memcpy(&flashlog_page[offset - page], data, len);
+
+    flashlog_op_t op = { page, flashlog_page, end - page };
+    if (flash_safe_execute(flashlog_do_program, &op, FLASHLOG_SAFE_TIMEOUT_MS) != PICO_OK) {
+        return false;
+    }
+    log->stats.page_programs += (end - page) / FLASH_PAGE_SIZE;
+    return true;
+}
+
+static bool flashlog_sector_blank(const flashlog_t* log, uint16_t sector) {
+    const uint32_t* p = (const uint32_t*)flashlog_sector_ptr(log, sector);
+    for (uint32_t i = 0; i < FLASH_SECTOR_SIZE / 4; i++) {
+        if (p[i] != 0xFFFFFFFFu) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Prepara um setor para escrita: apaga (se preciso) e grava o cabeçalho
+ */
+static bool flashlog_format_sector(flashlog_t* log, uint16_t sector, uint32_t order, uint32_t erase_count) {
+    uint32_t offset = log->offset + (uint32_t)sector * FLASH_SECTOR_SIZE;
+    if (!flashlog_sector_blank(log, sector)) {
+        flashlog_op_t op = { offset, NULL, FLASH_SECTOR_SIZE };
+        if (flash_safe_execute(flashlog_do_erase, &op, FLASHLOG_SAFE_TIMEOUT_MS) != PICO_OK) {
+            return false;
+        }
+        log->stats.sector_erases++;
+        erase_count++;
+    }
+
+    uint8_t header[FLASHLOG_HEADER_SIZE];
+    memset(header, 0xFF, sizeof(header));
+    flashlog_put_u32(&header[0], FLASHLOG_MAGIC);
+    flashlog_put_u32(&header[4], order);
+    flashlog_put_u32(&header[8], erase_count);
+    uint16_t crc = flashlog_crc16(header, 12);
+    header[12] = (uint8_t)crc;
+    header[13] = (uint8_t)(crc >> 8);
+    return flashlog_program(log, offset, header, sizeof(header));
+}
+
+// ============================================================================
+// PERCURSO DO ANEL
+// ============================================================================
+
+/**
+ * @brief Procura a partir de (sector, slot) a primeira leitura com seq >= min_seq
+ *
+ * Percorre os setores em ordem de uso até a posição de escrita, pulando
+ * setores sem cabeçalho válido e registros inválidos ou de confirmação.
+ *
+ * @return true se encontrou; sector e slot apontam para a leitura, ou para a
+ *         posição de escrita se não houver nenhuma
+ */
+static bool flashlog_seek(const flashlog_t* log, uint16_t* sector, uint16_t* slot,
+                          uint32_t min_seq, flashlog_record_t* out) {
+    uint16_t s = *sector;
+    uint16_t i = *slot;
+    for (int visited = 0; visited <= log->sectors; visited++) {
+        bool head = s == log->head_sector;
+        uint16_t limit = head ? log->head_slot : FLASHLOG_RECORDS_PER_SECTOR;
+        if (head || flashlog_read_header(log, s).valid) {
+            for (; i < limit; i++) {
+                flashlog_record_t r;
+                if (flashlog_decode(flashlog_slot_ptr(log, s, i), &r) == FLASHLOG_TYPE_READING &&
+                    r.seq >= min_seq) {
+                    *sector = s;
+                    *slot = i;
+                    if (out) *out = r;
+                    return true;
+                }
+            }
+        }
+        if (head) {
+            break;
+        }
+        s = (uint16_t)((s + 1) % log->sectors);
+        i = 0;
+    }
+    *sector = log->head_sector;
+    *slot = log->head_slot;
+    return false;
+}
+
+/**
+ * @brief Posiciona a cauda na primeira leitura com seq >= tail_seq
+ */
+static void flashlog_find_tail(flashlog_t* log) {
+    uint16_t sector = (uint16_t)((log->head_sector + 1) % log->sectors);
+    uint16_t slot = 0;
+    flashlog_record_t r;
+    if (flashlog_seek(log, &sector, &slot, log->tail_seq, &r)) {
+        log->tail_seq = r.seq;
+    } else {
+        log->tail_seq = log->next_seq;
+    }
+    log->tail_sector = sector;
+    log->tail_slot = slot;
+}
+
+/**
+ * @brief Passa a escrever no próximo setor do anel
+ *
+ * Se ele ainda guarda leituras pendentes, elas são descartadas e a cauda
+ * avança para a leitura seguinte que sobrou.
+ */
+static bool flashlog_advance_head(flashlog_t* log) {
+    uint16_t next = log->formatted ? (uint16_t)((log->head_sector + 1) % log->sectors) : 0;
+    flashlog_header_t old = flashlog_read_header(log, next);
+    flashlog_header_t head = log->formatted ? flashlog_read_header(log, log->head_sector)
+                                            : (flashlog_header_t){ 0 };
+    uint32_t erase_count = old.valid ? old.erase_count
+                         : head.valid && head.erase_count > 0 ? head.erase_count - 1 : 0;
+
+    // Leituras pendentes no setor que será apagado
+    uint32_t lost = 0;
+    if (log->formatted && old.valid && log->pending > 0) {
+        for (uint16_t i = 0; i < FLASHLOG_RECORDS_PER_SECTOR; i++) {
+            flashlog_record_t r;
+            if (flashlog_decode(flashlog_slot_ptr(log, next, i), &r) == FLASHLOG_TYPE_READING &&
+                r.seq >= log->tail_seq) {
+                lost++;
+            }
+        }
+    }
+
+    uint32_t order = log->formatted ? log->head_order + 1 : 0;
+    if (!flashlog_format_sector(log, next, order, erase_count)) {
+        return false;
+    }
+    log->formatted = true;
+    log->head_sector = next;
+    log->head_slot = 0;
+    log->head_order = order;
+
+    if (lost > 0) {
+        log->stats.dropped += lost;
+        log->pending -= lost;
+        flashlog_find_tail(log);
+    } else if (log->pending == 0) {
+        log->tail_sector = next;
+        log->tail_slot = 0;
+    }
+    return true;
+}
+
+static bool flashlog_write(flashlog_t* log, uint8_t type, const flashlog_record_t* record) {
+    if (!log->formatted || log->head_slot >= FLASHLOG_RECORDS_PER_SECTOR) {
+        if (!flashlog_advance_head(log)) {
+            return false;
+        }
+    }
+    uint8_t data[FLASHLOG_RECORD_SIZE];
+    flashlog_encode(type, record, data);
+    uint32_t offset = log->offset + (uint32_t)log->head_sector * FLASH_SECTOR_SIZE +
+                      FLASHLOG_HEADER_SIZE + log->head_slot * FLASHLOG_RECORD_SIZE;
+    if (!flashlog_program(log, offset, data, sizeof(data))) {
+        return false;
+    }
+    log->head_slot++;
+    return true;
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+/**
+ * @brief Monta o log e recupera o estado após um reboot ou corte de energia
+ *
+ * 1. O setor em escrita é o de maior ordem entre os cabeçalhos válidos
+ * 2. Os setores são lidos do mais antigo ao mais novo: a maior sequência
+ *    gravada dá a próxima, a maior confirmação dá a cauda
+ * 3. A escrita continua após o último slot usado do setor mais novo (um
+ *    registro rasgado ocupa o seu slot)
+ */
+bool flashlog_init(flashlog_t* log, uint32_t offset, uint16_t sectors) {
+    memset(log, 0, sizeof(*log));
+    if (offset % FLASH_SECTOR_SIZE || sectors < 2 ||
+        offset + (uint32_t)sectors * FLASH_SECTOR_SIZE > PICO_FLASH_SIZE_BYTES) {
+        return false;
+    }
+    log->offset = offset;
+    log->sectors = sectors;
+
+    for (uint16_t s = 0; s < sectors; s++) {
+        flashlog_header_t h = flashlog_read_header(log, s);
+        if (h.valid && (!log->formatted || h.order > log->head_order)) {
+            log->formatted = true;
+            log->head_sector = s;
+            log->head_order = h.order;
+        }
+    }
+    if (!log->formatted) {
+        return true;                               // Log vazio; formata na primeira gravação
+    }
+
+    bool any = false, any_ack = false;
+    uint32_t max_seq = 0, min_seq = 0, max_ack = 0;
+    uint8_t max_boot = 0;
+    for (uint16_t k = 1; k <= sectors; k++) {
+        uint16_t s = (uint16_t)((log->head_sector + k) % sectors);
+        if (!flashlog_read_header(log, s).valid) {
+            continue;
+        }
+        for (uint16_t i = 0; i < FLASHLOG_RECORDS_PER_SECTOR; i++) {
+            flashlog_record_t r;
+            uint8_t type = flashlog_decode(flashlog_slot_ptr(log, s, i), &r);
+            if (type == FLASHLOG_FREE) {
+                continue;
+            }
+            if (s == log->head_sector) {
+                log->head_slot = i + 1;
+            }
+            if (type == 0) {
+                log->stats.torn++;
+            } else if (type == FLASHLOG_TYPE_ACK) {
+                if (!any_ack || r.seq > max_ack) max_ack = r.seq;
+                any_ack = true;
+            } else {
+                if (!any || r.seq < min_seq) min_seq = r.seq;
+                if (!any || r.seq > max_seq) max_seq = r.seq;
+                any = true;
+            }
+            if (type != 0 && (uint8_t)(r.boot - max_boot) < 0x80) {
+                max_boot = r.boot;
+            }
+        }
+    }
+
+    log->boot = (uint8_t)(max_boot + 1);
+    log->next_seq = any ? max_seq + 1 : 0;
+    if (any_ack && max_ack + 1 > log->next_seq) {
+        log->next_seq = max_ack + 1;
+    }
+    log->tail_seq = any_ack && max_ack + 1 > min_seq ? max_ack + 1 : min_seq;
+    if (!any) {
+        log->tail_seq = log->next_seq;
+    }
+    flashlog_find_tail(log);
+    log->acked_seq = log->tail_seq;
+
+    // Pendentes: leituras válidas da cauda em diante
+    uint16_t sector = log->tail_sector, slot = log->tail_slot;
+    while (flashlog_seek(log, &sector, &slot, log->tail_seq, NULL)) {
+        log->pending++;
+        slot++;
+    }
+    return true;
+}
+
+bool flashlog_append(flashlog_t* log, flashlog_record_t* record) {
+    record->seq = log->next_seq;
+    record->boot = log->boot;
+    if (!flashlog_write(log, FLASHLOG_TYPE_READING, record)) {
+        return false;
+    }
+    if (log->pending == 0) {
+        log->tail_sector = log->head_sector;
+        log->tail_slot = (uint16_t)(log->head_slot - 1);
+        log->tail_seq = record->seq;
+    }
+    log->next_seq++;
+    log->pending++;
+    log->stats.appended++;
+    return true;
+}
+
+int flashlog_peek(const flashlog_t* log, flashlog_record_t* records, int max) {
+    uint16_t sector = log->tail_sector, slot = log->tail_slot;
+    int n = 0;
+    while (n < max && flashlog_seek(log, &sector, &slot, log->tail_seq, &records[n])) {
+        n++;
+        slot++;
+    }
+    return n;
+}
+
+/**
+ * @brief Confirma as leituras mais antigas e grava o registro de confirmação
+ */
+bool flashlog_consume(flashlog_t* log, int count) {
+    if (count <= 0) {
+        return true;
+    }
+    uint16_t sector = log->tail_sector, slot = log->tail_slot;
+    flashlog_record_t last;
+    int n = 0;
+    while (n < count && flashlog_seek(log, &sector, &slot, log->tail_seq, &last)) {
+        n++;
+        slot++;
+    }
+    if (n < count) {
+        return false;
+    }
+
+    log->tail_seq = last.seq + 1;
+    log->tail_sector = sector;
+    log->tail_slot = slot;
+    log->pending -= (uint32_t)n;
+    log->stats.consumed += (uint32_t)n;
+
+    // Setor em escrita cheio e cauda no próximo: gravar a confirmação
+    // apagaria leituras pendentes, então ela espera a cauda sair dele
+    uint16_t next = (uint16_t)((log->head_sector + 1) % log->sectors);
+    if (log->head_slot >= FLASHLOG_RECORDS_PER_SECTOR && log->pending > 0 && log->tail_sector == next) {
+        return true;
+    }
+
+    flashlog_record_t ack = { .seq = last.seq, .boot = log->boot };
+    if (!flashlog_write(log, FLASHLOG_TYPE_ACK, &ack)) {
+        return false;
+    }
+    log->acked_seq = last.seq + 1;
+    if (log->pending == 0) {
+        log->tail_sector = log->head_sector;
+        log->tail_slot = log->head_slot;
+    }
+    return true;
+}
+
+uint32_t flashlog_pending(const flashlog_t* log) {
+    return log->pending;
+}
+
+void flashlog_get_stats(const flashlog_t* log, flashlog_stats_t* stats) {
+    *stats = log->stats;
+    stats->min_erase_count = UINT32_MAX;
+    stats->max_erase_count = 0;
+    for (uint16_t s = 0; s < log->sectors; s++) {
+        flashlog_header_t h = flashlog_read_header(log, s);
+        uint32_t count = h.valid ? h.erase_count : 0;
+        if (count < stats->min_erase_count) stats->min_erase_count = count;
+        if (count > stats->max_erase_count) stats->max_erase_count = count;
+    }
+}
@@ -0,0 +1,116 @@
+#ifndef FLASHLOG_H
+#define FLASHLOG_H
+
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+
+// ============================================================================
+// LOG CIRCULAR NA FLASH (STORE-AND-FORWARD)
+// ============================================================================
+// Guarda na flash QSPI livre as leituras que não puderam ser entregues e as
+// devolve em ordem quando o enlace volta. A região é um anel de setores de
+// 4 KB usados em sequência: o log só acrescenta registros, e um setor só é
+// apagado quando o anel dá a volta. Assim todos os setores recebem o mesmo
+// número de apagamentos (nivelamento de desgaste). Com o anel cheio, o setor
+// mais antigo é descartado mesmo com leituras pendentes.
+//
+// Layout de cada setor:
+//   Bytes 0-15 : cabeçalho (magic, ordem do setor no anel, apagamentos, CRC)
+//   Bytes 16-  : FLASHLOG_RECORDS_PER_SECTOR registros de 20 bytes
+//
+// Registro (20 bytes):
+//   Byte 0     : tipo (leitura ou confirmação; 0xFF = livre)
+//   Byte 1     : máscara de campos presentes (FRAME_FIELD_*)
+//   Byte 2     : contador de montagens (boot) em que a leitura foi feita
+//   Bytes 3-6  : sequência do log (u32)
+//   Bytes 7-10 : to_ms_since_boot() da leitura (u32)
+//   Bytes 11-12: temperatura (centésimos de °C, s16)
+//   Bytes 13-14: umidade (centésimos de %RH, u16)
+//   Bytes 15-17: pressão (Pa, u24)
+//   Bytes 18-19: CRC-16/CCITT dos bytes 0-17
+// Valores little-endian.
+//
+// Cada registro é gravado de uma vez com gravação parcial de página (os
+// demais bytes da página em 0xFF, que não alteram a NOR). Um corte de energia
+// no meio deixa um registro com CRC inválido, ignorado na montagem; o slot
+// seguinte continua livre. Um corte entre o apagamento e o cabeçalho deixa o
+// setor sem cabeçalho válido, e ele é apagado de novo ao ser reutilizado.
+//
+// As leituras entregues são marcadas com um registro de confirmação com a
+// última sequência entregue (um por lote, não um por leitura). Um corte antes
+// dessa gravação faz o lote ser entregue de novo (pelo menos uma vez). Com o
+// anel cheio, a confirmação que apagaria leituras ainda pendentes do setor
+// mais antigo fica só na RAM até a cauda sair dele; um corte nesse intervalo
+// reentrega no máximo um setor.
+//
+// Gravação e apagamento rodam em flash_safe_execute(): com dois núcleos, o
+// outro precisa ter chamado flash_safe_execute_core_init().
+
+#define FLASHLOG_HEADER_SIZE            16
+#define FLASHLOG_RECORD_SIZE            20
+#define FLASHLOG_RECORDS_PER_SECTOR     ((FLASH_SECTOR_SIZE - FLASHLOG_HEADER_SIZE) / FLASHLOG_RECORD_SIZE)
+
+// Região padrão: os últimos FLASHLOG_SECTORS setores da flash
+#ifndef FLASHLOG_SECTORS
+#define FLASHLOG_SECTORS                64      // 256 KB, 13056 leituras
+#endif
+#define FLASHLOG_OFFSET                 (PICO_FLASH_SIZE_BYTES - FLASHLOG_SECTORS * FLASH_SECTOR_SIZE)
+
+// Leitura guardada no log
+typedef struct {
+    uint32_t seq;               // Sequência no log (atribuída por flashlog_append)
+    uint32_t time_ms;           // to_ms_since_boot() no momento da leitura
+    uint8_t boot;               // Montagem em que a leitura foi feita
+    uint8_t fields;             // FRAME_FIELD_* presentes
+    int16_t temperature;        // Centésimos de °C
+    uint16_t humidity;          // Centésimos de %RH
+    uint32_t pressure;          // Pa
+} flashlog_record_t;
+
+typedef struct {
+    uint32_t appended;          // Leituras gravadas desde a montagem
+    uint32_t consumed;          // Leituras confirmadas
+    uint32_t dropped;           // Leituras pendentes perdidas na volta do anel
+    uint32_t torn;              // Registros com CRC inválido vistos na montagem
+    uint32_t page_programs;
+    uint32_t sector_erases;
+    uint32_t min_erase_count;   // Apagamentos por setor segundo os cabeçalhos
+    uint32_t max_erase_count;
+} flashlog_stats_t;
+
+typedef struct {
+    uint32_t offset;            // Início da região (alinhado ao setor)
+    uint16_t sectors;
+    uint8_t boot;               // Montagem atual
+    bool formatted;             // Algum setor com cabeçalho válido
+    uint16_t head_sector;       // Setor em escrita
+    uint16_t head_slot;         // Próximo slot livre (FLASHLOG_RECORDS_PER_SECTOR = cheio)
+    uint32_t head_order;        // Ordem do setor em escrita no anel
+    uint16_t tail_sector;       // Posição da próxima leitura a entregar
+    uint16_t tail_slot;
+    uint32_t next_seq;          // Sequência da próxima leitura gravada
+    uint32_t tail_seq;          // Sequência da próxima leitura a entregar
+    uint32_t acked_seq;         // Cauda segundo a última confirmação gravada
+    uint32_t pending;           // Leituras gravadas e ainda não confirmadas
+    flashlog_stats_t stats;
+} flashlog_t;
+
+// Monta o log na região [offset, offset + sectors * FLASH_SECTOR_SIZE),
+// recuperando o estado gravado; false se a região for inválida
+bool flashlog_init(flashlog_t* log, uint32_t offset, uint16_t sectors);
+
+// Grava uma leitura (record->seq e record->boot são preenchidos)
+bool flashlog_append(flashlog_t* log, flashlog_record_t* record);
+
+// Copia até max leituras pendentes, da mais antiga, sem consumi-las
+int flashlog_peek(const flashlog_t* log, flashlog_record_t* records, int max);
+
+// Confirma as count leituras mais antigas (as devolvidas por flashlog_peek)
+bool flashlog_consume(flashlog_t* log, int count);
+
+// Leituras pendentes
+uint32_t flashlog_pending(const flashlog_t* log);
+
+void flashlog_get_stats(const flashlog_t* log, flashlog_stats_t* stats);
+
+#endif // FLASHLOG_H
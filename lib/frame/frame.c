@@ -0,0 +1,459 @@
+#include <stddef.h>
+
+#include "frame.h"
+
+// ============================================================================
+// ACESSO LITTLE-ENDIAN
+// ============================================================================
+
+static void frame_put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t frame_get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// ============================================================================
+// CAMPOS DE UMA LEITURA
+// ============================================================================
+
+static int frame_fields_size(uint8_t fields) {
+    int size = 0;
+    if (fields & FRAME_FIELD_TEMPERATURE) size += 2;
+    if (fields & FRAME_FIELD_HUMIDITY)    size += 2;
+    if (fields & FRAME_FIELD_PRESSURE)    size += 2;
+    return size;
+}
+
+/**
+ * @brief Escreve os campos presentes em fields; a pressão é arredondada para
+ * decapascal e limitada a 16 bits
+ */
+static uint8_t* frame_put_fields(uint8_t* p, uint8_t fields, const frame_reading_t* reading) {
+    if (fields & FRAME_FIELD_TEMPERATURE) {
+        frame_put_u16(p, (uint16_t)reading->temperature);
+        p += 2;
+    }
+    if (fields & FRAME_FIELD_HUMIDITY) {
+        frame_put_u16(p, reading->humidity);
+        p += 2;
+    }
+    if (fields & FRAME_FIELD_PRESSURE) {
+        uint32_t dapa = (reading->pressure + 5) / 10;
+        frame_put_u16(p, dapa > 0xFFFF ? 0xFFFF : (uint16_t)dapa);
+        p += 2;
+    }
+    return p;
+}
+
+/**
+ * @brief Lê os campos indicados em reading->fields
+ * 
+ * @return Posição após o último campo, ou NULL se o quadro estiver truncado
+ *         ou tiver um campo desconhecido
+ */
+static const uint8_t* frame_get_fields(const uint8_t* p, const uint8_t* end, frame_reading_t* reading) {
+    reading->temperature = 0;
+    reading->humidity = 0;
+    reading->pressure = 0;
+
+    if (reading->fields & ~FRAME_FIELDS_ALL) {
+        return NULL;                                // Campo desconhecido
+    }
+    if (end - p < frame_fields_size(reading->fields)) {
+        return NULL;                                // Quadro truncado
+    }
+
+    if (reading->fields & FRAME_FIELD_TEMPERATURE) {
+        reading->temperature = (int16_t)frame_get_u16(p);
+        p += 2;
+    }
+    if (reading->fields & FRAME_FIELD_HUMIDITY) {
+        reading->humidity = frame_get_u16(p);
+        p += 2;
+    }
+    if (reading->fields & FRAME_FIELD_PRESSURE) {
+        reading->pressure = (uint32_t)frame_get_u16(p) * 10;
+        p += 2;
+    }
+    return p;
+}
+
+// ============================================================================
+// CODIFICAÇÃO E DECODIFICAÇÃO
+// ============================================================================
+
+/**
+ * @brief Codifica uma leitura no quadro binário
+ * 
+ * @param reading Leitura em ponto fixo
+ * @param buffer Buffer de saída
+ * @param size Tamanho do buffer
+ * @return Tamanho do quadro em bytes, ou 0 se o buffer for pequeno demais
+ * 
+ * A pressão é arredondada para decapascal e limitada a 16 bits.
+ */
+int frame_encode(const frame_reading_t* reading, uint8_t* buffer, int size) {
+    uint8_t fields = reading->fields & FRAME_FIELDS_ALL;
+    int length = FRAME_HEADER_SIZE + frame_fields_size(fields);
+    if (length > size) {
+        return 0;
+    }
+
+    buffer[0] = (FRAME_VERSION << 4) | FRAME_TYPE_READING;
+    buffer[1] = reading->station_id;
+    frame_put_u16(&buffer[2], reading->sequence);
+    buffer[4] = fields;
+    frame_put_fields(&buffer[FRAME_HEADER_SIZE], fields, reading);
+    return length;
+}
+
+/**
+ * @brief Decodifica um quadro de leitura
+ * 
+ * @param buffer Quadro recebido
+ * @param length Tamanho do quadro
+ * @param reading Leitura decodificada (campos ausentes ficam zerados)
+ * @return true se o quadro é uma leitura válida desta versão
+ */
+bool frame_decode(const uint8_t* buffer, int length, frame_reading_t* reading) {
+    if (length < FRAME_HEADER_SIZE ||
+        buffer[0] != ((FRAME_VERSION << 4) | FRAME_TYPE_READING)) {
+        return false;
+    }
+
+    reading->station_id = buffer[1];
+    reading->sequence = frame_get_u16(&buffer[2]);
+    reading->fields = buffer[4];
+
+    const uint8_t* p = frame_get_fields(&buffer[FRAME_HEADER_SIZE], buffer + length, reading);
+    return p == buffer + length;
+}
+
+// ============================================================================
+// LOTE DE LEITURAS
+// ============================================================================
+
+/**
+ * @brief Inicia um lote vazio
+ * 
+ * @param batch Lote a ser preparado
+ * @param station_id Identificador da estação
+ * 
+ * O número de sequência do quadro é o da primeira leitura acrescentada.
+ */
+void frame_batch_init(frame_batch_t* batch, uint8_t station_id) {
+    batch->data[0] = (FRAME_VERSION << 4) | FRAME_TYPE_BATCH;
+    batch->data[1] = station_id;
+    batch->data[4] = 0;
+    batch->length = FRAME_HEADER_SIZE;
+    batch->count = 0;
+}
+
+/**
+ * @brief Acrescenta uma leitura ao lote
+ * 
+ * @param batch Lote em construção
+ * @param reading Leitura (station_id é ignorado; sequence só é usado na
+ *                primeira leitura do lote)
+ * @param time_ms Instante da leitura em ms (ex: to_ms_since_boot)
+ * @return false se a leitura não cabe no quadro
+ */
+bool frame_batch_add(frame_batch_t* batch, const frame_reading_t* reading, uint32_t time_ms) {
+    uint8_t fields = reading->fields & FRAME_FIELDS_ALL;
+    int size = FRAME_BATCH_SAMPLE_HEADER + frame_fields_size(fields);
+    if (batch->length + size > FRAME_MAX_SIZE) {
+        return false;
+    }
+
+    if (batch->count == 0) {
+        frame_put_u16(&batch->data[2], reading->sequence);
+    }
+
+    // A idade (bytes 1-2 da amostra) é gravada em frame_batch_finish
+    uint8_t* p = &batch->data[batch->length];
+    p[0] = fields;
+    frame_put_fields(p + FRAME_BATCH_SAMPLE_HEADER, fields, reading);
+
+    batch->time_ms[batch->count++] = time_ms;
+    batch->length += size;
+    return true;
+}
+
+/**
+ * @brief Indica se uma leitura com todos os campos ainda cabe no lote
+ */
+bool frame_batch_full(const frame_batch_t* batch) {
+    return batch->length + FRAME_BATCH_SAMPLE_MAX_SIZE > FRAME_MAX_SIZE;
+}
+
+/**
+ * @brief Fecha o lote gravando a idade de cada leitura
+ * 
+ * @param batch Lote em construção
+ * @param now_ms Instante do envio, na mesma base de tempo de frame_batch_add
+ * @return Tamanho do quadro em batch->data
+ * 
+ * As idades são arredondadas para FRAME_BATCH_AGE_UNIT_MS e saturam em
+ * 0xFFFF (cerca de 1h49min).
+ */
+int frame_batch_finish(frame_batch_t* batch, uint32_t now_ms) {
+    batch->data[4] = batch->count;
+
+    uint8_t* p = &batch->data[FRAME_HEADER_SIZE];
+    for (int i = 0; i < batch->count; i++) {
+        uint32_t age = (now_ms - batch->time_ms[i] + FRAME_BATCH_AGE_UNIT_MS / 2) / FRAME_BATCH_AGE_UNIT_MS;
+        frame_put_u16(p + 1, age > 0xFFFF ? 0xFFFF : (uint16_t)age);
+        p += FRAME_BATCH_SAMPLE_HEADER + frame_fields_size(p[0]);
+    }
+    return batch->length;
+}
+
+/**
+ * @brief Decodifica um quadro de lote
+ * 
+ * @param buffer Quadro recebido
+ * @param length Tamanho do quadro
+ * @param readings Leituras decodificadas, com a sequência de cada uma
+ * @param age_ms Idade de cada leitura em ms no instante do envio (ou NULL)
+ * @param max_readings Capacidade de readings e age_ms
+ * @return Quantidade de leituras, ou -1 se o quadro for inválido, truncado
+ *         ou tiver mais leituras que max_readings
+ */
+int frame_decode_batch(const uint8_t* buffer, int length, frame_reading_t* readings,
+                       uint32_t* age_ms, int max_readings) {
+    if (length < FRAME_HEADER_SIZE ||
+        buffer[0] != ((FRAME_VERSION << 4) | FRAME_TYPE_BATCH) ||
+        buffer[4] > max_readings) {
+        return -1;
+    }
+
+    uint16_t sequence = frame_get_u16(&buffer[2]);
+    int count = buffer[4];
+    const uint8_t* p = &buffer[FRAME_HEADER_SIZE];
+    const uint8_t* end = buffer + length;
+
+    for (int i = 0; i < count; i++) {
+        if (end - p < FRAME_BATCH_SAMPLE_HEADER) return -1;
+
+        frame_reading_t* r = &readings[i];
+        r->station_id = buffer[1];
+        r->sequence = (uint16_t)(sequence + i);
+        r->fields = p[0];
+        if (age_ms) age_ms[i] = (uint32_t)frame_get_u16(p + 1) * FRAME_BATCH_AGE_UNIT_MS;
+
+        p = frame_get_fields(p + FRAME_BATCH_SAMPLE_HEADER, end, r);
+        if (!p) return -1;
+    }
+    return p == end ? count : -1;
+}
+
+// ============================================================================
+// RESUMO DE UMA JANELA
+// ============================================================================
+
+/**
+ * @brief Valor de 16 bits de um campo: pressão em decapascal (arredondada e
+ * limitada), temperatura e umidade em centésimos
+ */
+static uint16_t frame_stat_value(uint8_t field, int32_t value) {
+    if (field == FRAME_FIELD_PRESSURE) {
+        int32_t dapa = (value + 5) / 10;
+        return dapa < 0 ? 0 : dapa > 0xFFFF ? 0xFFFF : (uint16_t)dapa;
+    }
+    return (uint16_t)value;
+}
+
+static int32_t frame_stat_unpack(uint8_t field, uint16_t value) {
+    switch (field) {
+        case FRAME_FIELD_TEMPERATURE: return (int16_t)value;
+        case FRAME_FIELD_PRESSURE:    return (int32_t)value * 10;
+        default:                      return value;
+    }
+}
+
+static uint8_t* frame_put_stat(uint8_t* p, uint8_t field, const frame_stat_t* stat) {
+    frame_put_u16(p, frame_stat_value(field, stat->last));
+    frame_put_u16(p + 2, frame_stat_value(field, stat->mean));
+    frame_put_u16(p + 4, frame_stat_value(field, stat->min));
+    frame_put_u16(p + 6, frame_stat_value(field, stat->max));
+    uint32_t sd = field == FRAME_FIELD_PRESSURE ? (stat->stddev + 5) / 10 : stat->stddev;
+    frame_put_u16(p + 8, sd > 0xFFFF ? 0xFFFF : (uint16_t)sd);
+    return p + FRAME_SUMMARY_STAT_SIZE;
+}
+
+static const uint8_t* frame_get_stat(const uint8_t* p, uint8_t field, frame_stat_t* stat) {
+    stat->last = frame_stat_unpack(field, frame_get_u16(p));
+    stat->mean = frame_stat_unpack(field, frame_get_u16(p + 2));
+    stat->min = frame_stat_unpack(field, frame_get_u16(p + 4));
+    stat->max = frame_stat_unpack(field, frame_get_u16(p + 6));
+    stat->stddev = frame_get_u16(p + 8) * (field == FRAME_FIELD_PRESSURE ? 10u : 1u);
+    return p + FRAME_SUMMARY_STAT_SIZE;
+}
+
+static int frame_summary_fields(uint8_t fields) {
+    return ((fields & FRAME_FIELD_TEMPERATURE) != 0) +
+           ((fields & FRAME_FIELD_HUMIDITY) != 0) +
+           ((fields & FRAME_FIELD_PRESSURE) != 0);
+}
+
+/**
+ * @brief Codifica o resumo de uma janela
+ * 
+ * @return Tamanho do quadro em bytes, ou 0 se o buffer for pequeno demais
+ * 
+ * A duração é arredondada para décimos de segundo e satura em 0xFFFF.
+ */
+int frame_encode_summary(const frame_summary_t* summary, uint8_t* buffer, int size) {
+    uint8_t fields = summary->fields & FRAME_FIELDS_ALL;
+    int length = FRAME_HEADER_SIZE + 4 + frame_summary_fields(fields) * FRAME_SUMMARY_STAT_SIZE;
+    if (length > size) {
+        return 0;
+    }
+
+    buffer[0] = (FRAME_VERSION << 4) | FRAME_TYPE_SUMMARY;
+    buffer[1] = summary->station_id;
+    frame_put_u16(&buffer[2], summary->sequence);
+    buffer[4] = fields;
+    frame_put_u16(&buffer[5], summary->count);
+    uint32_t span = (summary->span_ms + FRAME_BATCH_AGE_UNIT_MS / 2) / FRAME_BATCH_AGE_UNIT_MS;
+    frame_put_u16(&buffer[7], span > 0xFFFF ? 0xFFFF : (uint16_t)span);
+
+    uint8_t* p = &buffer[FRAME_HEADER_SIZE + 4];
+    if (fields & FRAME_FIELD_TEMPERATURE) p = frame_put_stat(p, FRAME_FIELD_TEMPERATURE, &summary->temperature);
+    if (fields & FRAME_FIELD_HUMIDITY)    p = frame_put_stat(p, FRAME_FIELD_HUMIDITY, &summary->humidity);
+    if (fields & FRAME_FIELD_PRESSURE)    p = frame_put_stat(p, FRAME_FIELD_PRESSURE, &summary->pressure);
+    return length;
+}
+
+/**
+ * @brief Decodifica um quadro de resumo (campos ausentes ficam zerados)
+ */
+bool frame_decode_summary(const uint8_t* buffer, int length, frame_summary_t* summary) {
+    if (length < FRAME_HEADER_SIZE + 4 ||
+        buffer[0] != ((FRAME_VERSION << 4) | FRAME_TYPE_SUMMARY) ||
+        (buffer[4] & ~FRAME_FIELDS_ALL)) {
+        return false;
+    }
+
+    uint8_t fields = buffer[4];
+    if (length != FRAME_HEADER_SIZE + 4 + frame_summary_fields(fields) * FRAME_SUMMARY_STAT_SIZE) {
+        return false;
+    }
+
+    const frame_stat_t empty = { 0 };
+    summary->station_id = buffer[1];
+    summary->sequence = frame_get_u16(&buffer[2]);
+    summary->fields = fields;
+    summary->count = frame_get_u16(&buffer[5]);
+    summary->span_ms = (uint32_t)frame_get_u16(&buffer[7]) * FRAME_BATCH_AGE_UNIT_MS;
+    summary->temperature = summary->humidity = summary->pressure = empty;
+
+    const uint8_t* p = &buffer[FRAME_HEADER_SIZE + 4];
+    if (fields & FRAME_FIELD_TEMPERATURE) p = frame_get_stat(p, FRAME_FIELD_TEMPERATURE, &summary->temperature);
+    if (fields & FRAME_FIELD_HUMIDITY)    p = frame_get_stat(p, FRAME_FIELD_HUMIDITY, &summary->humidity);
+    if (fields & FRAME_FIELD_PRESSURE)    frame_get_stat(p, FRAME_FIELD_PRESSURE, &summary->pressure);
+    return true;
+}
+
+// ============================================================================
+// CONFIRMAÇÃO DO GATEWAY
+// ============================================================================
+
+static void frame_put_u32(uint8_t* p, uint32_t v) {
+    frame_put_u16(p, (uint16_t)v);
+    frame_put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+/**
+ * @brief Codifica a confirmação enviada pelo gateway
+ * 
+ * @return FRAME_ACK_SIZE, ou 0 se o buffer for pequeno demais
+ */
+int frame_encode_ack(const frame_ack_t* ack, uint8_t* buffer, int size) {
+    if (size < FRAME_ACK_SIZE) {
+        return 0;
+    }
+    buffer[0] = (FRAME_VERSION << 4) | FRAME_TYPE_ACK;
+    buffer[1] = ack->station_id;
+    frame_put_u16(&buffer[2], ack->sequence);
+    frame_put_u32(&buffer[4], ack->bitmap);
+    return FRAME_ACK_SIZE;
+}
+
+/**
+ * @brief Decodifica uma confirmação; o bit 0 (a própria sequência) é obrigatório
+ */
+bool frame_decode_ack(const uint8_t* buffer, int length, frame_ack_t* ack) {
+    if (length != FRAME_ACK_SIZE ||
+        buffer[0] != ((FRAME_VERSION << 4) | FRAME_TYPE_ACK) ||
+        !(buffer[4] & 0x01)) {
+        return false;
+    }
+    ack->station_id = buffer[1];
+    ack->sequence = frame_get_u16(&buffer[2]);
+    ack->bitmap = (uint32_t)frame_get_u16(&buffer[4]) | ((uint32_t)frame_get_u16(&buffer[6]) << 16);
+    return true;
+}
+
+// ============================================================================
+// BEACON TDMA
+// ============================================================================
+
+/**
+ * @brief Codifica o beacon do gateway
+ * 
+ * A duração do slot é arredondada para cima em FRAME_BEACON_SLOT_UNIT_US.
+ */
+int frame_encode_beacon(const frame_beacon_t* beacon, uint8_t* buffer, int size) {
+    if (size < FRAME_BEACON_SIZE) {
+        return 0;
+    }
+    uint32_t slot = (beacon->slot_us + FRAME_BEACON_SLOT_UNIT_US - 1) / FRAME_BEACON_SLOT_UNIT_US;
+    buffer[0] = (FRAME_VERSION << 4) | FRAME_TYPE_BEACON;
+    buffer[1] = beacon->gateway_id;
+    frame_put_u16(&buffer[2], beacon->frame_number);
+    frame_put_u16(&buffer[4], beacon->slots);
+    frame_put_u16(&buffer[6], slot > 0xFFFF ? 0xFFFF : (uint16_t)slot);
+    return FRAME_BEACON_SIZE;
+}
+
+/**
+ * @brief Decodifica um beacon; exige ao menos um slot além do beacon
+ */
+bool frame_decode_beacon(const uint8_t* buffer, int length, frame_beacon_t* beacon) {
+    if (length != FRAME_BEACON_SIZE ||
+        buffer[0] != ((FRAME_VERSION << 4) | FRAME_TYPE_BEACON) ||
+        frame_get_u16(&buffer[4]) < 2 || frame_get_u16(&buffer[6]) == 0) {
+        return false;
+    }
+    beacon->gateway_id = buffer[1];
+    beacon->frame_number = frame_get_u16(&buffer[2]);
+    beacon->slots = frame_get_u16(&buffer[4]);
+    beacon->slot_us = (uint32_t)frame_get_u16(&buffer[6]) * FRAME_BEACON_SLOT_UNIT_US;
+    return true;
+}
+
+/**
+ * @brief Sequências ocupadas por um quadro da estação
+ * 
+ * Leitura e resumo ocupam uma; o lote ocupa uma por leitura. Só o cabeçalho
+ * é examinado.
+ */
+int frame_sequence_span(const uint8_t* buffer, int length, uint16_t* first) {
+    if (length < FRAME_HEADER_SIZE || (buffer[0] >> 4) != FRAME_VERSION) {
+        return 0;
+    }
+    *first = frame_get_u16(&buffer[2]);
+    switch (buffer[0] & 0x0F) {
+    case FRAME_TYPE_READING:
+    case FRAME_TYPE_SUMMARY:
+        return 1;
+    case FRAME_TYPE_BATCH:
+        return buffer[4];
+    default:
+        return 0;
+    }
+}
@@ -0,0 +1,207 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// QUADRO BINÁRIO DE LEITURAS DOS SENSORES
+// ============================================================================
+// Substitui o JSON em ASCII (~55 bytes) por um quadro de até 11 bytes.
+// Todos os campos multibyte são little-endian.
+//
+//   Byte 0     : versão (bits 7-4) | tipo de quadro (bits 3-0)
+//   Byte 1     : identificador da estação
+//   Bytes 2-3  : número de sequência
+//   Byte 4     : máscara de campos presentes (FRAME_FIELD_*)
+//   Em seguida, apenas os campos presentes, nesta ordem:
+//     temperatura  int16   centésimos de °C
+//     umidade      uint16  centésimos de %RH
+//     pressão      uint16  decapascal (0.1 hPa)
+//
+// Quadro de lote (FRAME_TYPE_BATCH): várias leituras em um único pacote
+//
+//   Byte 0     : versão | FRAME_TYPE_BATCH
+//   Byte 1     : identificador da estação
+//   Bytes 2-3  : número de sequência da primeira leitura (as demais seguem +1)
+//   Byte 4     : quantidade de leituras
+//   Para cada leitura:
+//     máscara de campos  uint8
+//     idade              uint16  décimos de segundo antes do envio do quadro
+//     campos presentes, como no quadro de leitura
+//
+// O gateway reconstrói o instante de cada leitura subtraindo a idade do
+// instante de recepção.
+//
+// Quadro de resumo (FRAME_TYPE_SUMMARY): estatísticas de uma janela de leituras
+//
+//   Byte 0     : versão | FRAME_TYPE_SUMMARY
+//   Byte 1     : identificador da estação
+//   Bytes 2-3  : número de sequência do resumo
+//   Byte 4     : máscara de campos presentes
+//   Bytes 5-6  : quantidade de leituras na janela
+//   Bytes 7-8  : duração da janela (primeira à última leitura), em décimos de segundo
+//   Para cada campo presente, na ordem do quadro de leitura e na mesma
+//   unidade do campo: última, média, mínimo, máximo e desvio padrão
+//
+// Quadro de confirmação (FRAME_TYPE_ACK): enviado pelo gateway à estação
+//
+//   Byte 0     : versão | FRAME_TYPE_ACK
+//   Byte 1     : identificador da estação
+//   Bytes 2-3  : maior número de sequência recebido
+//   Bytes 4-7  : mapa de recepção; bit i = sequência (maior - i) recebida
+//
+// Um lote ocupa as sequências da primeira à última leitura, e o gateway marca
+// todas ao recebê-lo.
+//
+// Beacon (FRAME_TYPE_BEACON): enviado pelo gateway no início de cada quadro
+// TDMA, no slot 0
+//
+//   Byte 0     : versão | FRAME_TYPE_BEACON
+//   Byte 1     : identificador do gateway
+//   Bytes 2-3  : número do quadro TDMA
+//   Bytes 4-5  : slots por quadro (incluindo o do beacon)
+//   Bytes 6-7  : duração do slot, em unidades de 100 µs
+//
+// O código não depende do Pico SDK e é usado também pelo gateway Linux.
+
+#define FRAME_VERSION               1
+#define FRAME_HEADER_SIZE           5
+
+// Tipos de quadro
+#define FRAME_TYPE_READING          0x0     // Uma leitura
+#define FRAME_TYPE_BATCH            0x1     // Lote de leituras com idades relativas
+#define FRAME_TYPE_SUMMARY          0x2     // Estatísticas de uma janela de leituras
+#define FRAME_TYPE_ACK              0x3     // Confirmação do gateway com mapa de recepção
+#define FRAME_TYPE_BEACON           0x4     // Início de quadro TDMA
+
+// Campos da máscara
+#define FRAME_FIELD_TEMPERATURE     0x01
+#define FRAME_FIELD_HUMIDITY        0x02
+#define FRAME_FIELD_PRESSURE        0x04
+#define FRAME_FIELDS_ALL            0x07
+
+// Tamanho máximo de um quadro de leitura
+#define FRAME_READING_MAX_SIZE      (FRAME_HEADER_SIZE + 6)
+
+// Limites do quadro de lote (payload LoRa de até 255 bytes)
+#define FRAME_MAX_SIZE              255
+#define FRAME_BATCH_SAMPLE_HEADER   3       // Máscara + idade
+#define FRAME_BATCH_SAMPLE_MAX_SIZE (FRAME_BATCH_SAMPLE_HEADER + 6)
+#define FRAME_BATCH_MAX_SAMPLES     ((FRAME_MAX_SIZE - FRAME_HEADER_SIZE) / FRAME_BATCH_SAMPLE_HEADER)
+#define FRAME_BATCH_AGE_UNIT_MS     100
+
+// Tamanho máximo de um quadro de resumo (5 valores de 16 bits por campo)
+#define FRAME_SUMMARY_STAT_SIZE     10
+#define FRAME_SUMMARY_MAX_SIZE      (FRAME_HEADER_SIZE + 4 + 3 * FRAME_SUMMARY_STAT_SIZE)
+
+// Quadro de confirmação e sequências cobertas pelo mapa
+#define FRAME_ACK_SIZE              8
+#define FRAME_ACK_SPAN              32
+
+// Beacon
+#define FRAME_BEACON_SIZE           8
+#define FRAME_BEACON_SLOT_UNIT_US   100
+
+// Leitura em ponto fixo
+typedef struct {
+    uint8_t station_id;
+    uint16_t sequence;
+    uint8_t fields;             // FRAME_FIELD_* presentes
+    int16_t temperature;        // Centésimos de °C
+    uint16_t humidity;          // Centésimos de %RH (0-10000)
+    uint32_t pressure;          // Pa (transmitido em decapascal)
+} frame_reading_t;
+
+// Estatísticas de um campo na janela, na unidade de frame_reading_t
+typedef struct {
+    int32_t last;
+    int32_t mean;
+    int32_t min;
+    int32_t max;
+    uint32_t stddev;
+} frame_stat_t;
+
+// Resumo de uma janela de leituras
+typedef struct {
+    uint8_t station_id;
+    uint16_t sequence;
+    uint8_t fields;             // FRAME_FIELD_* presentes
+    uint16_t count;             // Leituras na janela
+    uint32_t span_ms;           // Da primeira à última leitura (transmitido em décimos de segundo)
+    frame_stat_t temperature;   // Centésimos de °C
+    frame_stat_t humidity;      // Centésimos de %RH
+    frame_stat_t pressure;      // Pa (transmitido em decapascal)
+} frame_summary_t;
+
+// Confirmação do gateway
+typedef struct {
+    uint8_t station_id;
+    uint16_t sequence;          // Maior sequência recebida
+    uint32_t bitmap;            // Bit i = sequência (sequence - i) recebida
+} frame_ack_t;
+
+// Beacon do gateway
+typedef struct {
+    uint8_t gateway_id;
+    uint16_t frame_number;
+    uint16_t slots;             // Slots por quadro, incluindo o do beacon
+    uint32_t slot_us;           // Duração do slot (múltiplo de FRAME_BEACON_SLOT_UNIT_US)
+} frame_beacon_t;
+
+// Lote em construção; as leituras são codificadas à medida que chegam e as
+// idades são preenchidas em frame_batch_finish()
+typedef struct {
+    uint8_t data[FRAME_MAX_SIZE];
+    int length;
+    uint8_t count;
+    uint32_t time_ms[FRAME_BATCH_MAX_SAMPLES];  // Instante de cada leitura
+} frame_batch_t;
+
+// Codifica uma leitura; retorna o tamanho do quadro ou 0 se não couber no buffer
+int frame_encode(const frame_reading_t* reading, uint8_t* buffer, int size);
+
+// Decodifica um quadro de leitura; retorna false se for inválido ou truncado
+bool frame_decode(const uint8_t* buffer, int length, frame_reading_t* reading);
+
+// Inicia um lote vazio
+void frame_batch_init(frame_batch_t* batch, uint8_t station_id);
+
+// Acrescenta uma leitura feita em time_ms; retorna false se não couber
+bool frame_batch_add(frame_batch_t* batch, const frame_reading_t* reading, uint32_t time_ms);
+
+// Indica se uma leitura completa ainda cabe no lote
+bool frame_batch_full(const frame_batch_t* batch);
+
+// Grava as idades relativas a now_ms; retorna o tamanho do quadro em batch->data
+int frame_batch_finish(frame_batch_t* batch, uint32_t now_ms);
+
+// Decodifica um quadro de lote; retorna a quantidade de leituras ou -1 se for
+// inválido. age_ms recebe a idade de cada leitura e pode ser NULL.
+int frame_decode_batch(const uint8_t* buffer, int length, frame_reading_t* readings,
+                       uint32_t* age_ms, int max_readings);
+
+// Codifica um resumo; retorna o tamanho do quadro ou 0 se não couber no buffer
+int frame_encode_summary(const frame_summary_t* summary, uint8_t* buffer, int size);
+
+// Decodifica um quadro de resumo; retorna false se for inválido ou truncado
+bool frame_decode_summary(const uint8_t* buffer, int length, frame_summary_t* summary);
+
+// Codifica uma confirmação; retorna FRAME_ACK_SIZE ou 0 se não couber no buffer
+int frame_encode_ack(const frame_ack_t* ack, uint8_t* buffer, int size);
+
+// Decodifica um quadro de confirmação; retorna false se for inválido
+bool frame_decode_ack(const uint8_t* buffer, int length, frame_ack_t* ack);
+
+// Codifica um beacon; retorna FRAME_BEACON_SIZE ou 0 se não couber no buffer
+int frame_encode_beacon(const frame_beacon_t* beacon, uint8_t* buffer, int size);
+
+// Decodifica um beacon; retorna false se for inválido
+bool frame_decode_beacon(const uint8_t* buffer, int length, frame_beacon_t* beacon);
+
+// Sequências ocupadas por um quadro da estação (leitura, lote ou resumo):
+// retorna a quantidade e grava a primeira em first, ou 0 se o quadro não tiver
+// número de sequência
+int frame_sequence_span(const uint8_t* buffer, int length, uint16_t* first);
+
+#endif // FRAME_H
@@ -0,0 +1,70 @@
+#include "json.h"
+
+// ============================================================================
+// ESCRITA DE TEXTO E NÚMEROS
+// ============================================================================
+
+static uint8_t* json_put_str(uint8_t* p, const char* s) {
+    while (*s) {
+        *p++ = (uint8_t)*s++;
+    }
+    return p;
+}
+
+static uint8_t* json_put_uint(uint8_t* p, uint32_t v) {
+    uint8_t digits[10];
+    int n = 0;
+    do {
+        digits[n++] = (uint8_t)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    while (n) {
+        *p++ = digits[--n];
+    }
+    return p;
+}
+
+static uint8_t* json_put_int(uint8_t* p, int32_t v) {
+    if (v < 0) {
+        *p++ = '-';
+        return json_put_uint(p, 0u - (uint32_t)v);
+    }
+    return json_put_uint(p, (uint32_t)v);
+}
+
+/**
+ * @brief Escreve centésimos como "%.2f" escreveria o valor / 100
+ */
+static uint8_t* json_put_centi(uint8_t* p, int32_t v) {
+    uint32_t u = (uint32_t)v;
+    if (v < 0) {
+        *p++ = '-';
+        u = 0u - u;
+    }
+    p = json_put_uint(p, u / 100);
+    u %= 100;
+    *p++ = '.';
+    *p++ = (uint8_t)('0' + u / 10);
+    *p++ = (uint8_t)('0' + u % 10);
+    return p;
+}
+
+// ============================================================================
+// LEITURA
+// ============================================================================
+
+int json_encode(int16_t temperatura, int32_t pressao, uint16_t umidade, uint8_t* buffer, int size) {
+    if (size < JSON_READING_MAX_SIZE) {
+        return 0;
+    }
+
+    uint8_t* p = buffer;
+    p = json_put_str(p, "{\"temperatura\":");
+    p = json_put_centi(p, temperatura);
+    p = json_put_str(p, ",\"pressao\":");
+    p = json_put_int(p, pressao);
+    p = json_put_str(p, ",\"umidade\":");
+    p = json_put_centi(p, umidade);
+    p = json_put_str(p, "}\r\n");
+    return (int)(p - buffer);
+}
@@ -0,0 +1,31 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include <stdint.h>
+
+// ============================================================================
+// PAYLOAD JSON SEM PRINTF
+// ============================================================================
+// Gera o mesmo texto de
+//
+//   snprintf(buffer, size, "{\"temperatura\":%.2f,\"pressao\":%d,\"umidade\":%.2f}\r\n", ...)
+//
+// byte a byte, mas a partir dos valores em ponto fixo, sem ponto flutuante,
+// sem alocação e sem o printf da newlib (que traz junto o suporte a float).
+// A igualdade vale para valores que já estavam em centésimos (float =
+// inteiro / 100, como no main.c antigo); um float qualquer passa antes pelo
+// arredondamento para centésimos do chamador, que pode diferir do de %.2f
+// na última casa.
+// O terminador nulo não é escrito: o resultado é um payload com tamanho.
+//
+// O código não depende do Pico SDK e é usado também pelo gateway Linux.
+
+// Maior saída possível: temperatura "-327.68", pressão "-2147483648" e
+// umidade "655.35"
+#define JSON_READING_MAX_SIZE       64
+
+// Codifica uma leitura (temperatura e umidade em centésimos, pressão em kPa);
+// retorna o tamanho em bytes ou 0 se size < JSON_READING_MAX_SIZE
+int json_encode(int16_t temperatura, int32_t pressao, uint16_t umidade, uint8_t* buffer, int size);
+
+#endif // JSON_H
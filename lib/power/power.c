@@ -0,0 +1,171 @@
+#include "power.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "hardware/structs/scb.h"
+#include "rfm95.h"
+#include "aht20.h"
+#include "bmp280.h"
+
+// Início da contabilização e valores dos contadores dos drivers nesse instante
+static uint64_t start_us;
+static uint64_t cpu_sleep_us;
+
+// Núcleos em sono profundo; o trecho com todos dormindo é o sono da CPU
+static spin_lock_t* sleep_lock;
+static uint num_cores = 1;
+static uint sleeping_cores;
+static uint64_t all_asleep_since_us;
+static rfm95_mode_times_t radio_start;
+static uint64_t aht20_start_us;
+static uint64_t bmp280_start_us;
+
+static const uint32_t phase_current_na[POWER_NUM_PHASES] = {
+    [POWER_CPU_RUN]        = POWER_CPU_RUN_NA,
+    [POWER_CPU_SLEEP]      = POWER_CPU_SLEEP_NA,
+    [POWER_RADIO_TX]       = POWER_RADIO_TX_NA,
+    [POWER_RADIO_RX]       = POWER_RADIO_RX_NA,
+    [POWER_RADIO_STANDBY]  = POWER_RADIO_STANDBY_NA,
+    [POWER_RADIO_SLEEP]    = POWER_RADIO_SLEEP_NA,
+    [POWER_AHT20_MEASURE]  = POWER_AHT20_MEASURE_NA,
+    [POWER_AHT20_IDLE]     = POWER_AHT20_IDLE_NA,
+    [POWER_BMP280_MEASURE] = POWER_BMP280_MEASURE_NA,
+    [POWER_BMP280_SLEEP]   = POWER_BMP280_SLEEP_NA,
+};
+
+static const char* const phase_names[POWER_NUM_PHASES] = {
+    [POWER_CPU_RUN]        = "cpu_run",
+    [POWER_CPU_SLEEP]      = "cpu_sleep",
+    [POWER_RADIO_TX]       = "radio_tx",
+    [POWER_RADIO_RX]       = "radio_rx",
+    [POWER_RADIO_STANDBY]  = "radio_standby",
+    [POWER_RADIO_SLEEP]    = "radio_sleep",
+    [POWER_AHT20_MEASURE]  = "aht20_measure",
+    [POWER_AHT20_IDLE]     = "aht20_idle",
+    [POWER_BMP280_MEASURE] = "bmp280_measure",
+    [POWER_BMP280_SLEEP]   = "bmp280_sleep",
+};
+
+void power_init(void) {
+    // Só o timer (alarme que acorda o núcleo), o watchdog (gera o tick do
+    // timer) e o USB (stdio) continuam com clock no sono profundo
+    clocks_hw->sleep_en0 = 0;
+    clocks_hw->sleep_en1 = CLOCKS_SLEEP_EN1_CLK_SYS_TIMER_BITS
+                         | CLOCKS_SLEEP_EN1_CLK_SYS_WATCHDOG_BITS
+                         | CLOCKS_SLEEP_EN1_CLK_SYS_USBCTRL_BITS
+                         | CLOCKS_SLEEP_EN1_CLK_USB_USBCTRL_BITS;
+
+    sleep_lock = spin_lock_init(spin_lock_claim_unused(true));
+    num_cores = 1;
+    sleeping_cores = 0;
+    start_us = time_us_64();
+    cpu_sleep_us = 0;
+    rfm95_get_mode_times(&radio_start);
+    aht20_start_us = aht20_measuring_time_us();
+    bmp280_start_us = bmp280_measuring_time_us();
+}
+
+void power_radio_sleep(void) {
+    rfm95_transmit_wait();                         // TxDone com o núcleo em WFI
+    rfm95_set_sleep_mode();                        // Registradores preservados
+}
+
+void power_set_num_cores(uint count) {
+    num_cores = count;
+}
+
+/**
+ * @brief Marca o núcleo atual como em sono profundo (SLEEPDEEP ligado)
+ */
+static void power_core_sleep_begin(void) {
+    uint32_t irq = spin_lock_blocking(sleep_lock);
+    if (++sleeping_cores == num_cores) {
+        all_asleep_since_us = time_us_64();
+    }
+    spin_unlock(sleep_lock, irq);
+    scb_hw->scr |= M0PLUS_SCR_SLEEPDEEP_BITS;
+}
+
+static void power_core_sleep_end(void) {
+    scb_hw->scr &= ~M0PLUS_SCR_SLEEPDEEP_BITS;
+    uint32_t irq = spin_lock_blocking(sleep_lock);
+    if (sleeping_cores-- == num_cores) {
+        cpu_sleep_us += time_us_64() - all_asleep_since_us;
+    }
+    spin_unlock(sleep_lock, irq);
+}
+
+/**
+ * @brief Sono profundo até o instante t
+ * 
+ * Com SLEEPDEEP, o WFE de sleep_until() leva o sistema ao estado de sono, em
+ * que só os clocks escolhidos em power_init() continuam ligados, desde que
+ * os outros núcleos em uso também estejam em sono profundo; o alarme do
+ * timer acorda o núcleo e os clocks voltam sozinhos.
+ */
+void power_cpu_sleep_until(absolute_time_t t) {
+    power_core_sleep_begin();
+    sleep_until(t);
+    power_core_sleep_end();
+}
+
+/**
+ * @brief Sono profundo até o próximo evento
+ * 
+ * Para o núcleo que espera o outro: sem SLEEPDEEP aqui, o chip nunca
+ * entraria no estado de sono, mesmo com o outro núcleo em
+ * power_cpu_sleep_until(). Um despertar espúrio só encurta a espera.
+ */
+void power_cpu_wait_event(void) {
+    power_core_sleep_begin();
+    __wfe();
+    power_core_sleep_end();
+}
+
+void power_sleep_until(absolute_time_t t) {
+    power_radio_sleep();
+    power_cpu_sleep_until(t);
+}
+
+/**
+ * @brief Carga em nC de uma fase, sem estourar 64 bits em períodos longos
+ */
+static uint64_t power_charge_nc(uint64_t time_us, uint32_t current_na) {
+    return (time_us / 1000000) * current_na + (time_us % 1000000) * current_na / 1000000;
+}
+
+void power_get_stats(power_stats_t* stats) {
+    uint64_t elapsed = time_us_64() - start_us;
+    rfm95_mode_times_t radio;
+    rfm95_get_mode_times(&radio);
+    uint64_t aht20_us = aht20_measuring_time_us() - aht20_start_us;
+    uint64_t bmp280_us = bmp280_measuring_time_us() - bmp280_start_us;
+
+    // O tempo nominal de conversão pode passar do fim do período contado
+    if (aht20_us > elapsed) aht20_us = elapsed;
+    if (bmp280_us > elapsed) bmp280_us = elapsed;
+
+    stats->elapsed_us = elapsed;
+    stats->time_us[POWER_CPU_RUN]        = elapsed - cpu_sleep_us;
+    stats->time_us[POWER_CPU_SLEEP]      = cpu_sleep_us;
+    stats->time_us[POWER_RADIO_TX]       = radio.tx_us - radio_start.tx_us;
+    stats->time_us[POWER_RADIO_RX]       = radio.rx_us - radio_start.rx_us;
+    stats->time_us[POWER_RADIO_STANDBY]  = radio.standby_us - radio_start.standby_us;
+    stats->time_us[POWER_RADIO_SLEEP]    = radio.sleep_us - radio_start.sleep_us;
+    stats->time_us[POWER_AHT20_MEASURE]  = aht20_us;
+    stats->time_us[POWER_AHT20_IDLE]     = elapsed - aht20_us;
+    stats->time_us[POWER_BMP280_MEASURE] = bmp280_us;
+    stats->time_us[POWER_BMP280_SLEEP]   = elapsed - bmp280_us;
+
+    stats->total_charge_nc = 0;
+    for (int i = 0; i < POWER_NUM_PHASES; i++) {
+        stats->charge_nc[i] = power_charge_nc(stats->time_us[i], phase_current_na[i]);
+        stats->total_charge_nc += stats->charge_nc[i];
+    }
+
+    // nC / µs = mA, então nC * 1000 / µs = µA
+    stats->average_ua = elapsed ? (uint32_t)(stats->total_charge_nc * 1000 / elapsed) : 0;
+}
+
+const char* power_phase_name(power_phase_t phase) {
+    return phase < POWER_NUM_PHASES ? phase_names[phase] : "?";
+}
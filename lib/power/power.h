@@ -0,0 +1,88 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include "pico/stdlib.h"
+
+// ============================================================================
+// ESCALONADOR DE BAIXO CONSUMO
+// ============================================================================
+// Entre dois ciclos de leitura o rádio vai para Sleep e o núcleo dorme em sono
+// profundo até o alarme do timer, com apenas os clocks do timer e do USB
+// ligados. Os sensores já ficam em baixo consumo sozinhos: o BMP280 em modo
+// forçado volta ao sleep ao fim de cada conversão e o AHT20 fica ocioso após
+// a medição. O rádio mantém os registradores no Sleep, então o próximo envio
+// só troca o modo (com a espera de partida do oscilador), sem repetir
+// rfm95_initialize().
+//
+// O consumo é estimado multiplicando o tempo em cada fase pela corrente
+// típica do datasheet de cada componente. Os tempos vêm dos contadores dos
+// drivers (modos do rádio, conversões dos sensores) e do próprio escalonador
+// (sono da CPU); todo o tempo fora de power_cpu_sleep_until() e
+// power_cpu_wait_event() conta como CPU ativa, inclusive sleep_ms() e __wfe()
+// sem SLEEPDEEP. O RP2040 só corta os clocks com todos os núcleos em uso em
+// sono profundo, então com dois núcleos (power_set_num_cores) a fase de sono
+// da CPU é só a interseção dos sonos dos dois.
+
+// Correntes típicas por fase, em nA
+#define POWER_CPU_RUN_NA            20000000    // RP2040 a 125 MHz
+#define POWER_CPU_SLEEP_NA          800000      // Sono com clocks cortados, XOSC e PLLs ligados
+#define POWER_RADIO_TX_NA           87000000    // RFM95 a +17 dBm no PA_BOOST
+#define POWER_RADIO_RX_NA           10800000
+#define POWER_RADIO_STANDBY_NA      1600000
+#define POWER_RADIO_SLEEP_NA        200
+#define POWER_AHT20_MEASURE_NA      980000
+#define POWER_AHT20_IDLE_NA         250
+#define POWER_BMP280_MEASURE_NA     720000      // Conversão de pressão
+#define POWER_BMP280_SLEEP_NA       100
+
+// Fases de consumo (cada componente está sempre em exatamente uma das suas)
+typedef enum {
+    POWER_CPU_RUN,
+    POWER_CPU_SLEEP,
+    POWER_RADIO_TX,
+    POWER_RADIO_RX,
+    POWER_RADIO_STANDBY,
+    POWER_RADIO_SLEEP,
+    POWER_AHT20_MEASURE,
+    POWER_AHT20_IDLE,
+    POWER_BMP280_MEASURE,
+    POWER_BMP280_SLEEP,
+    POWER_NUM_PHASES
+} power_phase_t;
+
+// Contadores desde power_init()
+typedef struct {
+    uint64_t elapsed_us;
+    uint64_t time_us[POWER_NUM_PHASES];
+    uint64_t charge_nc[POWER_NUM_PHASES];   // Carga em nC (nA * s)
+    uint64_t total_charge_nc;
+    uint32_t average_ua;                    // Corrente média no período
+} power_stats_t;
+
+// Inicia a contabilização (depois de inicializar os drivers) e escolhe os
+// clocks mantidos no sono profundo
+void power_init(void);
+
+// Aguarda a transmissão em andamento e coloca o rádio em Sleep
+void power_radio_sleep(void);
+
+// Núcleos em uso (1 ou 2, depois de power_init); o sono da CPU só conta com
+// todos dormindo
+void power_set_num_cores(uint count);
+
+// Sono profundo do núcleo atual até o instante t
+void power_cpu_sleep_until(absolute_time_t t);
+
+// Sono profundo do núcleo atual até um evento (__sev do outro núcleo ou IRQ)
+void power_cpu_wait_event(void);
+
+// Fim de ciclo: rádio em Sleep e CPU em sono profundo até t
+void power_sleep_until(absolute_time_t t);
+
+// Tempos e carga estimada por fase
+void power_get_stats(power_stats_t* stats);
+
+// Nome curto de cada fase
+const char* power_phase_name(power_phase_t phase);
+
+#endif // POWER_H
@@ -0,0 +1,75 @@
+#include "report.h"
+
+void report_init(report_state_t* state, const report_config_t* config) {
+    state->config = config;
+    state->started = false;
+    state->fields = 0;
+    state->last_ms = 0;
+    for (int i = 0; i < REPORT_CHANNELS; i++) {
+        state->value[i] = 0;
+    }
+}
+
+/**
+ * @brief Maior entre a banda absoluta e a relativa ao valor de referência
+ */
+uint32_t report_threshold(const report_deadband_t* deadband, int32_t reference) {
+    uint32_t magnitude = reference < 0 ? 0u - (uint32_t)reference : (uint32_t)reference;
+    uint32_t relative = (uint32_t)(((uint64_t)magnitude * deadband->relative_ppm) / 1000000u);
+    uint32_t absolute = deadband->absolute > 0 ? (uint32_t)deadband->absolute : 0;
+    return relative > absolute ? relative : absolute;
+}
+
+/**
+ * @brief Decide se a leitura deve ser enviada
+ * 
+ * O intervalo mínimo vale para todos os motivos menos a primeira leitura;
+ * um canal que saiu da banda durante esse intervalo é enviado no primeiro
+ * ciclo depois dele, se ainda estiver fora.
+ */
+report_reason_t report_decide(const report_state_t* state, const int32_t value[REPORT_CHANNELS],
+                              uint8_t fields, uint32_t now_ms) {
+    const report_config_t* config = state->config;
+
+    if (!state->started) {
+        return REPORT_FIRST;
+    }
+    uint32_t elapsed = now_ms - state->last_ms;
+    if (elapsed < config->min_interval_ms) {
+        return REPORT_SKIP;
+    }
+    if (fields != state->fields) {
+        return REPORT_FIELDS;
+    }
+    for (int i = 0; i < REPORT_CHANNELS; i++) {
+        if (!(fields & (1u << i))) {
+            continue;
+        }
+        int64_t diff = (int64_t)value[i] - state->value[i];
+        uint64_t change = (uint64_t)(diff < 0 ? -diff : diff);
+        if (change > 0 && change >= report_threshold(&config->deadband[i], state->value[i])) {
+            return REPORT_CHANGE;
+        }
+    }
+    if (config->heartbeat_ms > 0 && elapsed >= config->heartbeat_ms) {
+        return REPORT_HEARTBEAT;
+    }
+    return REPORT_SKIP;
+}
+
+void report_commit(report_state_t* state, const int32_t value[REPORT_CHANNELS],
+                   uint8_t fields, uint32_t now_ms) {
+    state->started = true;
+    state->fields = fields;
+    state->last_ms = now_ms;
+    for (int i = 0; i < REPORT_CHANNELS; i++) {
+        state->value[i] = value[i];
+    }
+}
+
+const char* report_reason_name(report_reason_t reason) {
+    static const char* const names[REPORT_NUM_REASONS] = {
+        "silencio", "primeira", "campos", "variacao", "batimento",
+    };
+    return reason < REPORT_NUM_REASONS ? names[reason] : "?";
+}
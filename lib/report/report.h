@@ -0,0 +1,74 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// RELATO POR EXCEÇÃO (SEND-ON-DELTA)
+// ============================================================================
+// Decide a cada ciclo se a leitura precisa ser transmitida. Um canal só gera
+// envio quando se afasta do último valor transmitido por pelo menos a sua
+// banda morta (absoluta, relativa ao último valor ou a maior das duas). Um
+// batimento (heartbeat) força o envio após um intervalo máximo em silêncio,
+// para o gateway distinguir estação estável de estação parada, e um
+// intervalo mínimo limita a taxa de pacotes em variações rápidas.
+//
+// Sem intervalo mínimo, o valor mantido pelo gateway (o último recebido)
+// nunca fica a uma banda morta ou mais do valor real.
+//
+// A decisão e o registro do envio são separados: report_commit() só deve ser
+// chamado quando a leitura foi de fato entregue ao rádio, assim uma leitura
+// descartada (duty cycle esgotado) volta a ser candidata no ciclo seguinte.
+//
+// O código não depende do Pico SDK e é usado também pelas ferramentas do
+// gateway.
+
+#define REPORT_CHANNELS     3       // Temperatura, umidade e pressão
+
+// Banda morta de um canal; com as duas em 0 qualquer variação é enviada
+typedef struct {
+    int32_t absolute;           // Variação mínima na unidade do canal (0 = desligada)
+    uint32_t relative_ppm;      // Variação mínima em ppm do último valor enviado (0 = desligada)
+} report_deadband_t;
+
+typedef struct {
+    report_deadband_t deadband[REPORT_CHANNELS];
+    uint32_t min_interval_ms;   // Intervalo mínimo entre envios (0 = sem limite)
+    uint32_t heartbeat_ms;      // Silêncio máximo antes de um envio forçado (0 = sem batimento)
+} report_config_t;
+
+// Motivo da decisão
+typedef enum {
+    REPORT_SKIP,                // Nada a transmitir neste ciclo
+    REPORT_FIRST,               // Primeira leitura
+    REPORT_FIELDS,              // Conjunto de canais válidos mudou (sensor falhou ou voltou)
+    REPORT_CHANGE,              // Algum canal saiu da banda morta
+    REPORT_HEARTBEAT,           // Intervalo máximo em silêncio
+    REPORT_NUM_REASONS
+} report_reason_t;
+
+typedef struct {
+    const report_config_t* config;
+    bool started;
+    uint8_t fields;                     // Canais válidos no último envio (bit i = canal i)
+    uint32_t last_ms;                   // Instante do último envio
+    int32_t value[REPORT_CHANNELS];     // Valores do último envio
+} report_state_t;
+
+void report_init(report_state_t* state, const report_config_t* config);
+
+// Decide se a leitura deve ser enviada; não altera o estado
+report_reason_t report_decide(const report_state_t* state, const int32_t value[REPORT_CHANNELS],
+                              uint8_t fields, uint32_t now_ms);
+
+// Registra a leitura como enviada
+void report_commit(report_state_t* state, const int32_t value[REPORT_CHANNELS],
+                   uint8_t fields, uint32_t now_ms);
+
+// Banda morta efetiva do canal em torno do último valor enviado
+uint32_t report_threshold(const report_deadband_t* deadband, int32_t reference);
+
+const char* report_reason_name(report_reason_t reason);
+
+#endif // REPORT_H
@@ -1,5 +1,109 @@
 #include "rfm95.h"
 #include "rfm95_definitions.h"
+#include "hardware/sync.h"
+#if RFM95_USE_DMA
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#endif
+#include "trace.h"
+
+// Tempo de partida do oscilador ao sair do modo Sleep (TS_OSC, datasheet: 250 µs)
+#define RFM95_TS_OSC_US             250
+
+// ============================================================================
+// CÓPIA SOMBRA DOS REGISTRADORES
+// ============================================================================
+// Guarda o último valor escrito (ou lido) de cada registrador de configuração.
+// Escritas de um valor idêntico ao da sombra são omitidas e leituras desses
+// registradores são atendidas sem acesso SPI. Registradores que o próprio
+// chip altera (FIFO, ponteiros, flags de IRQ, status de pacote) nunca são
+// armazenados.
+
+static uint8_t shadow_value[0x80];
+static bool shadow_valid[0x80];
+
+/**
+ * @brief Indica se o registrador pode ser alterado pelo próprio rádio
+ */
+static bool rfm95_is_volatile(uint8_t reg) {
+    switch (reg) {
+        case REG_FIFO:
+        case REG_FIFO_ADDR_PTR:                    // Incrementa a cada acesso ao FIFO
+        case REG_FIFO_RX_CURRENT_ADDR:
+        case REG_IRQ_FLAGS:                        // Limpo escrevendo 1
+        case REG_VERSION:                          // Verificação de comunicação
+            return true;
+        default:
+            // REG_RX_NB_BYTES até REG_HOP_CHANNEL e REG_FREQ_ERROR: status de pacote
+            return (reg >= REG_RX_NB_BYTES && reg <= 0x1C) || (reg >= REG_FREQ_ERROR && reg <= 0x2C);
+    }
+}
+
+/**
+ * @brief Carrega na sombra os valores de reset do datasheet
+ * 
+ * Após o reset por hardware o conteúdo dos registradores é conhecido, o que
+ * permite pular escritas de valores iguais ao padrão (ex: REG_MODEM_CONFIG_1)
+ * e o read-modify-write de REG_LNA sem nenhuma leitura SPI.
+ */
+static void rfm95_shadow_reset() {
+    static const uint8_t reset_values[][2] = {
+        { REG_OPMODE,          0x09 },
+        { REG_FRF_MSB,         0x6C },
+        { REG_FRF_MID,         0x80 },
+        { REG_FRF_LSB,         0x00 },
+        { REG_PA_CONFIG,       0x4F },
+        { REG_LNA,             0x20 },
+        { REG_FIFO_TX_BASE_AD, 0x80 },
+        { REG_FIFO_RX_BASE_AD, 0x00 },
+        { REG_MODEM_CONFIG_1,  0x72 },
+        { REG_MODEM_CONFIG_2,  0x70 },
+        { REG_PREAMBLE_MSB,    0x00 },
+        { REG_PREAMBLE_LSB,    0x08 },
+        { REG_PAYLOAD_LENGTH,  0x01 },
+        { REG_MODEM_CONFIG_3,  0x00 },
+        { REG_DIO_MAPPING_1,   0x00 },
+    };
+
+    memset(shadow_valid, 0, sizeof(shadow_valid));
+    for (size_t i = 0; i < sizeof(reset_values) / sizeof(reset_values[0]); i++) {
+        shadow_value[reset_values[i][0]] = reset_values[i][1];
+        shadow_valid[reset_values[i][0]] = true;
+    }
+}
+
+/**
+ * @brief Atualiza a sombra quando o rádio muda um registrador sozinho
+ * 
+ * Ex: ao final de TX o chip volta para Standby sem escrita do driver.
+ */
+static void rfm95_shadow_set(uint8_t reg, uint8_t value) {
+    shadow_value[reg] = value;
+    shadow_valid[reg] = true;
+}
+
+// ============================================================================
+// TEMPO EM CADA MODO
+// ============================================================================
+// Tempo acumulado em cada modo de operação (bits 2-0 de REG_OPMODE) desde
+// rfm95_initialize(), usado na estimativa de consumo. A volta de TX para
+// Standby, feita pelo próprio rádio, é registrada na IRQ do TxDone.
+
+static uint64_t mode_time_us[8];
+static uint8_t mode_current;
+static uint64_t mode_since_us;
+
+/**
+ * @brief Fecha o intervalo do modo atual e passa a contar o novo modo
+ * 
+ * Chamada com as interrupções desabilitadas ou de dentro da IRQ do DIO0.
+ */
+static void rfm95_mode_account(uint8_t mode) {
+    uint64_t now = time_us_64();
+    mode_time_us[mode_current] += now - mode_since_us;
+    mode_since_us = now;
+    mode_current = mode & 0x07;
+}
 
 // ============================================================================
 // COMUNICAÇÃO SPI E CONTROLE DE HARDWARE
@@ -16,6 +120,28 @@ static void rfm95_reset() {
     sleep_ms(10);            // Mantém reset por 10ms
     gpio_put(PIN_RST, 1);    // Desativa reset (HIGH)
     sleep_ms(10);            // Aguarda estabilização
+    rfm95_shadow_reset();    // Registradores voltam aos valores padrão
+}
+
+/**
+ * @brief Inicia uma transação SPI (CS em LOW)
+ * 
+ * @return Estado das interrupções a ser passado para rfm95_deselect
+ * 
+ * As interrupções ficam desabilitadas durante a transação porque o
+ * tratador do DIO0 também acessa o SPI (motor de recepção): uma IRQ no meio
+ * de um quadro misturaria os bytes das duas transações. Uma borda do DIO0
+ * nesse intervalo fica pendente e é atendida em rfm95_deselect.
+ */
+static uint32_t rfm95_select() {
+    uint32_t irq = save_and_disable_interrupts();
+    gpio_put(PIN_CS, 0);
+    return irq;
+}
+
+static void rfm95_deselect(uint32_t irq) {
+    gpio_put(PIN_CS, 1);
+    restore_interrupts(irq);
 }
 
 /**
@@ -25,16 +151,25 @@ static void rfm95_reset() {
  * @return Valor lido do registrador
  * 
  * Para leitura, o bit MSB deve ser 0. Envia o endereço seguido de um byte dummy
- * e recebe a resposta no segundo byte.
+ * e recebe a resposta no segundo byte. Registradores de configuração presentes
+ * na sombra são retornados sem acesso SPI.
  */
 static uint8_t rfm95_read_register(uint8_t reg) {
-    uint8_t tx[] = { reg & 0x7F, 0x00 };  // Garante bit MSB = 0 para leitura
+    reg &= 0x7F;
+    if (shadow_valid[reg]) {
+        return shadow_value[reg];          // Valor conhecido, sem acesso SPI
+    }
+
+    uint8_t tx[] = { reg, 0x00 };          // Bit MSB = 0 para leitura
     uint8_t rx[2];
     
-    gpio_put(PIN_CS, 0);                   // Seleciona o dispositivo
+    uint32_t irq = rfm95_select();         // Seleciona o dispositivo
     spi_write_read_blocking(SPI_PORT, tx, rx, 2);
-    gpio_put(PIN_CS, 1);                   // Desseleciona o dispositivo
-    
+    rfm95_deselect(irq);                   // Desseleciona o dispositivo
+
+    if (!rfm95_is_volatile(reg)) {
+        rfm95_shadow_set(reg, rx[1]);
+    }
     return rx[1];                          // Retorna o valor lido
 }
 
@@ -45,14 +180,231 @@ static uint8_t rfm95_read_register(uint8_t reg) {
  * @param value Valor a ser escrito
  * 
  * Para escrita, o bit MSB deve ser 1. Envia o endereço com MSB=1 seguido do valor.
+ * A escrita é omitida se a sombra já contém o mesmo valor. Não há espera após
+ * a escrita: apenas as transições de modo exigem estabilização (rfm95_set_mode).
  */
 static void rfm95_write_register(uint8_t reg, uint8_t value) {
+    reg &= 0x7F;
+    if (shadow_valid[reg] && shadow_value[reg] == value) {
+        return;                            // Valor inalterado, escrita omitida
+    }
+
     uint8_t tx[] = { reg | 0x80, value }; // Define bit MSB = 1 para escrita
     
-    gpio_put(PIN_CS, 0);                   // Seleciona o dispositivo
+    uint32_t irq = rfm95_select();         // Seleciona o dispositivo
     spi_write_blocking(SPI_PORT, tx, 2);
-    gpio_put(PIN_CS, 1);                   // Desseleciona o dispositivo
-    sleep_ms(1); // Aguarda estabilização após escrita
+    rfm95_deselect(irq);                   // Desseleciona o dispositivo
+
+    if (!rfm95_is_volatile(reg)) {
+        rfm95_shadow_set(reg, value);
+    }
+}
+
+/**
+ * @brief Altera o modo de operação em REG_OPMODE
+ * 
+ * @param mode Modo desejado (MODE_SLEEP, MODE_STDBY, MODE_TX...)
+ * 
+ * Ao sair do modo Sleep aguarda a partida do oscilador (TS_OSC); as demais
+ * transições são temporizadas pelo próprio rádio. Nada é escrito se o módulo
+ * já estiver no modo pedido.
+ */
+static void rfm95_set_mode(uint8_t mode) {
+    bool was_sleeping = (rfm95_read_register(REG_OPMODE) & 0x07) == MODE_SLEEP;
+
+    rfm95_write_register(REG_OPMODE, MODE_LORA | mode);
+
+    uint32_t irq = save_and_disable_interrupts();
+    rfm95_mode_account(mode);
+    restore_interrupts(irq);
+
+    if (was_sleeping && mode != MODE_SLEEP) {
+        sleep_us(RFM95_TS_OSC_US);
+    }
+}
+
+/**
+ * @brief Lê registradores consecutivos em uma única transação SPI
+ * 
+ * @param reg Primeiro registrador da sequência
+ * @param data Buffer para os valores lidos
+ * @param length Quantidade de registradores
+ * 
+ * O SX1276 incrementa o endereço a cada byte enquanto o CS estiver ativo
+ * (exceto em REG_FIFO, que lê bytes sucessivos do FIFO). Se todos os
+ * registradores estiverem na sombra, nenhum acesso SPI é feito.
+ */
+static void rfm95_read_burst(uint8_t reg, uint8_t* data, uint8_t length) {
+    reg &= 0x7F;
+    bool cached = (reg != REG_FIFO);
+    for (uint8_t i = 0; cached && i < length; i++) {
+        cached = shadow_valid[(reg + i) & 0x7F];
+    }
+    if (cached) {
+        for (uint8_t i = 0; i < length; i++) {
+            data[i] = shadow_value[(reg + i) & 0x7F];
+        }
+        return;
+    }
+
+    uint32_t irq = rfm95_select();
+    spi_write_blocking(SPI_PORT, &reg, 1);         // Endereço com MSB = 0 (leitura)
+    spi_read_blocking(SPI_PORT, 0, data, length);  // Lê os dados
+    rfm95_deselect(irq);
+
+    for (uint8_t i = 0; reg != REG_FIFO && i < length; i++) {
+        uint8_t r = (reg + i) & 0x7F;
+        if (!rfm95_is_volatile(r)) rfm95_shadow_set(r, data[i]);
+    }
+}
+
+/**
+ * @brief Escreve registradores consecutivos em uma única transação SPI
+ * 
+ * @param reg Primeiro registrador da sequência
+ * @param data Valores a serem escritos
+ * @param length Quantidade de registradores
+ * 
+ * Registradores no início e no fim da sequência cujo valor já está na sombra
+ * são descartados da rajada; se nada mudou, nenhuma escrita é feita.
+ */
+static void rfm95_write_burst(uint8_t reg, const uint8_t* data, uint8_t length) {
+    reg &= 0x7F;
+    if (reg != REG_FIFO) {
+        while (length > 0 && !rfm95_is_volatile(reg) &&
+               shadow_valid[reg] && shadow_value[reg] == data[0]) {
+            reg = (reg + 1) & 0x7F;                // Início inalterado
+            data++;
+            length--;
+        }
+        while (length > 0) {
+            uint8_t last = (reg + length - 1) & 0x7F;
+            if (rfm95_is_volatile(last) || !shadow_valid[last] ||
+                shadow_value[last] != data[length - 1]) break;
+            length--;                              // Fim inalterado
+        }
+        if (length == 0) return;
+    }
+
+    uint8_t addr = reg | 0x80;                     // Endereço com MSB = 1 (escrita)
+
+    uint32_t irq = rfm95_select();
+    spi_write_blocking(SPI_PORT, &addr, 1);
+    spi_write_blocking(SPI_PORT, data, length);    // Escreve os dados
+    rfm95_deselect(irq);
+
+    for (uint8_t i = 0; reg != REG_FIFO && i < length; i++) {
+        uint8_t r = (reg + i) & 0x7F;
+        if (!rfm95_is_volatile(r)) rfm95_shadow_set(r, data[i]);
+    }
+}
+
+// ============================================================================
+// RAJADAS DO FIFO (DMA)
+// ============================================================================
+// Com RFM95_USE_DMA, rajadas de pelo menos dma_min_bytes bytes são movidas
+// por dois canais DMA pacidos pelo SPI: um escreve os dados (ou zeros, numa
+// leitura) no registrador de dados e o outro recolhe as respostas (ou as
+// descarta, numa escrita). O canal de RX termina só depois do último byte
+// deslocado, então o CS pode subir logo em seguida. Durante a rajada o
+// núcleo dorme em WFI; o fim do canal de RX levanta DMA_IRQ_0, que acorda o
+// núcleo mesmo com as interrupções desabilitadas pela transação. A própria
+// espera reconhece o canal e limpa a pendência no NVIC; o tratador,
+// compartilhado com outros usuários da linha, só cobre uma IRQ que escape disso.
+
+#if RFM95_USE_DMA
+static int dma_tx = -1;
+static int dma_rx = -1;
+static uint16_t dma_min_bytes = RFM95_DMA_MIN_BYTES;
+static const uint8_t dma_zero = 0;                 // MOSI durante a leitura do FIFO
+static uint8_t dma_discard;                        // MISO durante a escrita no FIFO
+
+static void rfm95_dma_irq_handler() {
+    // DMA_IRQ_0 é compartilhada: só reconhece o próprio canal
+    if (dma_channel_get_irq0_status(dma_rx)) {
+        dma_channel_acknowledge_irq0(dma_rx);
+    }
+}
+
+/**
+ * @brief Reserva os canais e acrescenta o tratador à DMA_IRQ_0 (uma vez)
+ */
+static void rfm95_dma_init() {
+    if (dma_tx < 0) {
+        dma_tx = dma_claim_unused_channel(true);
+        dma_rx = dma_claim_unused_channel(true);
+        irq_add_shared_handler(DMA_IRQ_0, rfm95_dma_irq_handler,
+                               PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    }
+    dma_channel_set_irq0_enabled(dma_rx, true);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+/**
+ * @brief Troca length bytes por DMA dentro de uma transação já aberta
+ * 
+ * @param tx Bytes a enviar, ou NULL para enviar zeros
+ * @param rx Destino das respostas, ou NULL para descartá-las
+ * 
+ * Só no laço principal: numa IRQ de mesma prioridade o WFI não acordaria.
+ */
+static void rfm95_dma_transfer(const uint8_t* tx, uint8_t* rx, uint8_t length) {
+    dma_channel_config c = dma_channel_get_default_config(dma_tx);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_dreq(&c, spi_get_dreq(SPI_PORT, true));
+    channel_config_set_read_increment(&c, tx != NULL);
+    channel_config_set_write_increment(&c, false);
+    dma_channel_configure(dma_tx, &c, &spi_get_hw(SPI_PORT)->dr, tx ? tx : &dma_zero, length, false);
+
+    c = dma_channel_get_default_config(dma_rx);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_dreq(&c, spi_get_dreq(SPI_PORT, false));
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, rx != NULL);
+    dma_channel_configure(dma_rx, &c, rx ? rx : &dma_discard, &spi_get_hw(SPI_PORT)->dr, length, false);
+
+    dma_start_channel_mask((1u << dma_tx) | (1u << dma_rx));
+    while (dma_channel_is_busy(dma_rx)) {
+        __wfi();
+    }
+
+    // Com as interrupções mascaradas pela transação o tratador não roda: sem
+    // limpar aqui, a DMA_IRQ_0 pendente faria o WFI da próxima rajada
+    // retornar na hora e o laço girar até o fim dela
+    dma_channel_acknowledge_irq0(dma_rx);
+    irq_clear(DMA_IRQ_0);
+}
+
+/**
+ * @brief Tamanho mínimo de rajada do FIFO movida por DMA
+ * 
+ * @param bytes Rajadas menores usam o SPI bloqueante; acima de 255 o DMA
+ *              nunca é usado
+ */
+void rfm95_set_dma_min_bytes(uint16_t bytes) {
+    dma_min_bytes = bytes;
+}
+#else
+void rfm95_set_dma_min_bytes(uint16_t bytes) {
+    (void)bytes;
+}
+#endif
+
+/**
+ * @brief Move uma rajada do FIFO por DMA ou pelo SPI bloqueante
+ */
+static void rfm95_fifo_transfer(const uint8_t* tx, uint8_t* rx, uint8_t length) {
+#if RFM95_USE_DMA
+    if (length > 0 && length >= dma_min_bytes) {
+        rfm95_dma_transfer(tx, rx, length);
+        return;
+    }
+#endif
+    if (rx) {
+        spi_read_blocking(SPI_PORT, 0, rx, length);
+    } else {
+        spi_write_blocking(SPI_PORT, tx, length);
+    }
 }
 
 /**
@@ -62,31 +414,243 @@ static void rfm95_write_register(uint8_t reg, uint8_t value) {
  * @param length Quantidade de bytes a serem lidos
  * 
  * Acessa o FIFO através do registrador REG_FIFO para receber dados de pacotes.
+ * Usa DMA; o motor de recepção, na IRQ do DIO0, lê com rfm95_read_burst.
  */
 static void rfm95_read_payload_data(uint8_t* data, uint8_t length) {
-    uint8_t addr = REG_FIFO & 0x7F;       // Endereço FIFO para leitura
-    
-    gpio_put(PIN_CS, 0);
-    spi_write_blocking(SPI_PORT, &addr, 1);        // Envia endereço do FIFO
-    spi_read_blocking(SPI_PORT, 0, data, length); // Lê os dados
-    gpio_put(PIN_CS, 1);
+    uint8_t addr = REG_FIFO;
+
+    uint32_t irq = rfm95_select();
+    spi_write_blocking(SPI_PORT, &addr, 1);
+    rfm95_fifo_transfer(NULL, data, length);
+    rfm95_deselect(irq);
 }
 
 /**
- * @brief Escreve dados no FIFO do RFM95
+ * @brief Escreve os segmentos de um pacote no FIFO do RFM95
  * 
- * @param buffer Buffer contendo os dados a serem escritos
- * @param length Quantidade de bytes a serem escritos
+ * @param segments Trechos do pacote, na ordem
+ * @param count Quantidade de trechos
  * 
- * Acessa o FIFO através do registrador REG_FIFO para enviar dados de pacotes.
+ * Todos os trechos vão na mesma transação SPI, direto dos buffers de
+ * origem: o FIFO não incrementa o endereço, então cabeçalho e carga em
+ * buffers diferentes chegam contíguos ao rádio sem uma cópia intermediária.
  */
-static void rfm95_write_payload_data(const uint8_t* data, uint8_t length) {
-    uint8_t addr = REG_FIFO | 0x80;       // Endereço FIFO para escrita
-    
-    gpio_put(PIN_CS, 0);
-    spi_write_blocking(SPI_PORT, &addr, 1);         // Envia endereço do FIFO
-    spi_write_blocking(SPI_PORT, data, length);   // Escreve os dados
-    gpio_put(PIN_CS, 1);
+static void rfm95_write_payload_data(const rfm95_segment_t* segments, uint8_t count) {
+    uint8_t addr = REG_FIFO | 0x80;
+
+    uint32_t irq = rfm95_select();
+    spi_write_blocking(SPI_PORT, &addr, 1);
+    for (uint8_t i = 0; i < count; i++) {
+        if (segments[i].length > 0) {
+            rfm95_fifo_transfer(segments[i].data, NULL, segments[i].length);
+        }
+    }
+    rfm95_deselect(irq);
+}
+
+// ============================================================================
+// TRANSMISSÃO ASSÍNCRONA (IRQ DO DIO0)
+// ============================================================================
+
+// Estados da transmissão assíncrona
+#define TX_IDLE     0   // Nenhuma transmissão pendente
+#define TX_BUSY     1   // Pacote no ar, aguardando TxDone
+#define TX_DONE     2   // TxDone sinalizado pelo DIO0, flag ainda não limpa
+
+static volatile uint8_t tx_state = TX_IDLE;
+static rfm95_tx_callback_t tx_callback;
+
+// Motor de recepção: anel de descritores preenchido pela IRQ (produtor) e
+// consumido pela aplicação. head e tail só avançam; cada lado escreve apenas
+// o seu índice, então não há trava.
+static rfm95_packet_t rx_ring[RFM95_RX_RING_SIZE];
+static volatile uint32_t rx_head;                  // Próximo slot a preencher (IRQ)
+static volatile uint32_t rx_tail;                  // Próximo slot a consumir (aplicação)
+static volatile uint32_t rx_dropped;               // Pacotes perdidos com o anel cheio
+static volatile bool rx_active;
+
+static void rfm95_rx_drain();
+
+/**
+ * @brief Tratador da interrupção do pino DIO0
+ * 
+ * Executado em contexto de interrupção. No TxDone não acessa o SPI, apenas
+ * registra a conclusão e chama o callback do usuário (a flag é limpa na
+ * próxima chamada do driver). No RxDone, com o motor de recepção ativo,
+ * copia o pacote para o anel de descritores; as transações do laço
+ * principal desabilitam as interrupções, então o SPI está sempre livre aqui.
+ */
+static void rfm95_dio0_irq_handler(uint gpio, uint32_t events) {
+    if (gpio != PIN_DIO0 || !(events & GPIO_IRQ_EDGE_RISE)) return;
+
+    if (tx_state == TX_BUSY) {
+        tx_state = TX_DONE;
+        rfm95_mode_account(MODE_STDBY);            // O rádio volta sozinho ao Standby
+        if (tx_callback) tx_callback();
+    } else if (rx_active) {
+        rfm95_rx_drain();
+    }
+}
+
+/**
+ * @brief Encerra a transmissão anterior antes de um novo comando ao rádio
+ * 
+ * Após TxDone o rádio já voltou ao Standby; a sombra de REG_OPMODE é
+ * atualizada e a flag é limpa para que o DIO0 volte a LOW e a próxima
+ * transmissão gere uma nova borda de subida. Uma transmissão ainda em
+ * andamento é abandonada (a troca de modo seguinte a interrompe).
+ */
+static void rfm95_tx_settle() {
+    uint32_t irq = save_and_disable_interrupts();
+    uint8_t state = tx_state;
+    tx_state = TX_IDLE;
+    restore_interrupts(irq);
+
+    if (state == TX_DONE) {
+        rfm95_shadow_set(REG_OPMODE, MODE_LORA | MODE_STDBY);
+    }
+    if (state != TX_IDLE) {
+        rfm95_write_register(REG_IRQ_FLAGS, IRQ_TX_DONE_MASK);
+    }
+}
+
+// ============================================================================
+// TEMPO NO AR E ORÇAMENTO DE DUTY CYCLE
+// ============================================================================
+
+// Duração de 1/4 de símbolo com SF=0, em meios µs, para cada largura de banda
+// de REG_MODEM_CONFIG_1 (bits 7-4): 2^SF / BW = (k << SF) / 8 µs. Todas as
+// larguras de banda do SX1276 são 125 kHz * 2^n ou 125 kHz / 3, então o tempo
+// no ar é calculado em inteiros sem erro de arredondamento.
+static const uint8_t quarter_symbol_half_us[] = {
+    64,     // 7.8 kHz
+    48,     // 10.4 kHz
+    32,     // 15.6 kHz
+    24,     // 20.8 kHz
+    16,     // 31.25 kHz
+    12,     // 41.7 kHz
+    8,      // 62.5 kHz
+    4,      // 125 kHz
+    2,      // 250 kHz
+    1,      // 500 kHz
+};
+
+// Símbolos maiores que 16 ms exigem Low Data Rate Optimize (datasheet 4.1.1.6)
+#define RFM95_LDRO_SYMBOL_US        16000
+
+// Balde de fichas do orçamento de tempo no ar, em µs * ppm: cada µs decorrido
+// acrescenta duty_cycle_ppm e cada µs transmitido consome 1000000. O saldo
+// pode ficar negativo após um pacote maior que a rajada, pagando a dívida
+// antes do próximo envio.
+static uint32_t budget_duty_ppm;                   // 0 = sem limite
+static int64_t budget_capacity;
+static int64_t budget_credit;
+static uint64_t budget_updated_us;
+
+/**
+ * @brief Duração de um símbolo LoRa com a configuração programada, em µs
+ */
+static uint32_t rfm95_symbol_us(uint8_t config1, uint8_t config2) {
+    uint8_t bw = config1 >> 4;
+    uint8_t sf = config2 >> 4;
+    if (bw >= sizeof(quarter_symbol_half_us)) bw = sizeof(quarter_symbol_half_us) - 1;
+    if (sf < 6) sf = 6;
+    return ((uint32_t)quarter_symbol_half_us[bw] << sf) * 2;
+}
+
+/**
+ * @brief Calcula o tempo no ar de um pacote com a configuração atual do modem
+ * 
+ * @param size Tamanho do payload em bytes
+ * @return Duração da transmissão em µs (preâmbulo, header e payload)
+ * 
+ * Fórmula da seção 4.1.1.7 do datasheet do SX1276:
+ * T_sym = 2^SF / BW
+ * T_preamble = (n_preamble + 4.25) * T_sym
+ * n_payload = 8 + max(ceil((8PL - 4SF + 28 + 16CRC - 20IH) / (4(SF - 2DE))) * (CR + 4), 0)
+ * 
+ * SF, BW, CR, header, CRC, preâmbulo e LDRO (REG_MODEM_CONFIG_3) vêm da
+ * cópia sombra, sem acesso SPI.
+ */
+uint32_t rfm95_time_on_air_us(uint8_t size) {
+    uint8_t config1 = rfm95_read_register(REG_MODEM_CONFIG_1);
+    uint8_t config2 = rfm95_read_register(REG_MODEM_CONFIG_2);
+    uint8_t config3 = rfm95_read_register(REG_MODEM_CONFIG_3);
+    uint32_t preamble = (rfm95_read_register(REG_PREAMBLE_MSB) << 8) | rfm95_read_register(REG_PREAMBLE_LSB);
+
+    int sf  = config2 >> 4;
+    if (sf < 6) sf = 6;
+    int cr  = (config1 >> 1) & 0x07;
+    int ih  = config1 & IMPLICIT_MODE;
+    int crc = (config2 & CRC_ON) ? 1 : 0;
+    int de  = (config3 & LOW_DATA_RATE_OPTIMIZE) ? 1 : 0;
+
+    // Símbolos do payload (ceil com numerador possivelmente negativo)
+    int num = 8 * size - 4 * sf + 28 + 16 * crc - 20 * ih;
+    int den = 4 * (sf - 2 * de);
+    int blocks = num > 0 ? (num + den - 1) / den : 0;
+    uint32_t payload_symbols = 8 + blocks * (cr + 4);
+
+    // Total em quartos de símbolo: 4 * (n_preamble + 4.25 + n_payload)
+    uint64_t quarters = 4 * (preamble + payload_symbols) + 17;
+    return (uint32_t)(quarters * rfm95_symbol_us(config1, config2) / 4);
+}
+
+/**
+ * @brief Acumula o crédito do orçamento pelo tempo decorrido
+ */
+static void rfm95_budget_refill() {
+    uint64_t now = time_us_64();
+    budget_credit += (int64_t)(now - budget_updated_us) * budget_duty_ppm;
+    if (budget_credit > budget_capacity) budget_credit = budget_capacity;
+    budget_updated_us = now;
+}
+
+/**
+ * @brief Configura o limite de duty cycle aplicado às transmissões
+ * 
+ * @param duty_cycle_ppm Fração máxima do tempo no ar em partes por milhão
+ *                       (ex: 10000 = 1%, limite da sub-banda g1 em 868 MHz);
+ *                       0 desabilita o limite
+ * @param burst_us Tempo no ar que pode ser gasto de uma vez com o balde cheio
+ * 
+ * O balde começa cheio: uma rajada de até burst_us é liberada imediatamente
+ * e, a partir daí, a média fica limitada a duty_cycle_ppm.
+ */
+void rfm95_set_airtime_budget(uint32_t duty_cycle_ppm, uint32_t burst_us) {
+    budget_duty_ppm = duty_cycle_ppm;
+    budget_capacity = (int64_t)burst_us * 1000000;
+    budget_credit = budget_capacity;
+    budget_updated_us = time_us_64();
+}
+
+/**
+ * @brief Tempo até que um pacote caiba no orçamento de tempo no ar
+ * 
+ * @param size Tamanho do payload em bytes
+ * @return µs a aguardar antes de transmitir (0 = pode transmitir agora)
+ */
+uint32_t rfm95_airtime_wait_us(uint8_t size) {
+    if (budget_duty_ppm == 0) return 0;
+
+    rfm95_budget_refill();
+    int64_t cost = (int64_t)rfm95_time_on_air_us(size) * 1000000;
+    if (cost > budget_capacity) cost = budget_capacity;   // Pacote maior que a rajada: exige o balde cheio
+    if (budget_credit >= cost) return 0;
+
+    return (uint32_t)((cost - budget_credit + budget_duty_ppm - 1) / budget_duty_ppm);
+}
+
+/**
+ * @brief Debita do orçamento o tempo no ar de um pacote
+ * 
+ * @return false se o pacote excede o orçamento disponível
+ */
+static bool rfm95_budget_consume(uint8_t size) {
+    if (budget_duty_ppm == 0) return true;
+    if (rfm95_airtime_wait_us(size) != 0) return false;
+    budget_credit -= (int64_t)rfm95_time_on_air_us(size) * 1000000;
+    return true;
 }
 
 // ============================================================================
@@ -99,8 +663,10 @@ static void rfm95_write_payload_data(const uint8_t* data, uint8_t length) {
  * @return true se a inicialização foi bem-sucedida, false caso contrário
  * 
  * Configura:
- * - Interface SPI (1 MHz, modo 0)
- * - Pinos GPIO (CS, RST)
+ * - Interface SPI (modo 0) a RFM95_SPI_SAFE_HZ durante a configuração e
+ *   depois a RFM95_SPI_HZ, se a comunicação for confirmada nesse clock
+ * - Canais DMA das rajadas do FIFO (RFM95_USE_DMA)
+ * - Pinos GPIO (CS, RST, DIO0 com interrupção de borda de subida)
  * - Reset do módulo
  * - Verificação da versão do chip
  * - Frequência de operação (915 MHz - Brasil)
@@ -109,7 +675,7 @@ static void rfm95_write_payload_data(const uint8_t* data, uint8_t length) {
  */
 bool rfm95_initialize() {
     // Configuração da interface SPI
-    spi_init(SPI_PORT, 1 * 1000 * 1000);          
+    spi_init(SPI_PORT, RFM95_SPI_SAFE_HZ);
     gpio_set_function(PIN_MISO, GPIO_FUNC_SPI);
     gpio_set_function(PIN_SCK,  GPIO_FUNC_SPI);
     gpio_set_function(PIN_MOSI, GPIO_FUNC_SPI);
@@ -123,8 +689,18 @@ bool rfm95_initialize() {
     gpio_init(PIN_RST);  
     gpio_set_dir(PIN_RST, GPIO_OUT);
 
+    gpio_init(PIN_DIO0);
+    gpio_set_dir(PIN_DIO0, GPIO_IN);
+    gpio_set_irq_enabled_with_callback(PIN_DIO0, GPIO_IRQ_EDGE_RISE, true, &rfm95_dio0_irq_handler);
+    tx_state = TX_IDLE;
+    rx_active = false;
+    rx_head = rx_tail = rx_dropped = 0;
+
     // Reset do módulo e verificação de comunicação
     rfm95_reset();
+    memset(mode_time_us, 0, sizeof(mode_time_us));
+    mode_current = MODE_STDBY;                     // Modo após o reset
+    mode_since_us = time_us_64();
     if (rfm95_read_register(REG_VERSION) != 0x12) {     // Versão esperada do RFM95
         return false;                              // Falha na comunicação
     }
@@ -140,20 +716,56 @@ bool rfm95_initialize() {
     // Configuração do LNA (Low Noise Amplifier)
     rfm95_write_register(REG_LNA, rfm95_read_register(REG_LNA) | 0x03);
 
-    // Configuração LoRa: BW=125kHz, CR=4/5, modo explícito
-    rfm95_write_register(REG_MODEM_CONFIG_1, BANDWIDTH_125K + ERROR_CODING_4_5 + EXPLICIT_MODE);
-
-    // Configuração LoRa: SF=7, CRC habilitado
-    rfm95_write_register(REG_MODEM_CONFIG_2, SPREADING_7 + CRC_ON);
+    // Configuração LoRa: BW=125kHz, CR=4/5, modo explícito / SF=7, CRC habilitado
+    rfm95_set_modem_config(BANDWIDTH_125K + ERROR_CODING_4_5 + EXPLICIT_MODE,
+                           SPREADING_7 + CRC_ON);
 
     // Configuração do preâmbulo (8 símbolos)
-    rfm95_write_register(REG_PREAMBLE_MSB, 0x00);
-    rfm95_write_register(REG_PREAMBLE_LSB, 0x08);
+    rfm95_set_preamble_length(8);
 
     rfm95_set_idle_mode();                         // Coloca em modo standby
+
+    // Só em LoRa: no modo FSK do reset, 0x0D é RegRxConfig e não guarda os padrões
+    rfm95_set_spi_clock(RFM95_SPI_HZ);
+#if RFM95_USE_DMA
+    rfm95_dma_init();
+#endif
     return true;
 }
 
+/**
+ * @brief Ajusta o clock SPI e confirma a comunicação nele
+ * 
+ * @param hz Clock desejado (o SX1276 aceita até 10 MHz)
+ * @return Clock efetivo; RFM95_SPI_SAFE_HZ se a verificação falhar
+ * 
+ * Coloca o rádio em Standby (o motor de recepção para e uma transmissão
+ * em andamento é abortada), relê REG_VERSION e grava e relê padrões
+ * complementares em REG_FIFO_ADDR_PTR (volátil, sempre lido pelo SPI),
+ * restaurando o ponteiro ao fim. Não chamar com TX ou RX em andamento;
+ * exige o modo LoRa, já ativo após rfm95_initialize().
+ * Fiação longa ou capacitiva corrompe bits de dados bem antes de impedir a
+ * comunicação, e só a releitura de padrões pega isso.
+ */
+uint32_t rfm95_set_spi_clock(uint32_t hz) {
+    static const uint8_t patterns[] = { 0x55, 0xAA, 0x00, 0xFF };
+
+    rfm95_set_idle_mode();
+    uint8_t fifo_ptr = rfm95_read_register(REG_FIFO_ADDR_PTR);  // Ainda no clock já validado
+
+    uint32_t actual = spi_set_baudrate(SPI_PORT, hz);
+    bool ok = rfm95_read_register(REG_VERSION) == 0x12;
+    for (size_t i = 0; ok && i < sizeof(patterns); i++) {
+        rfm95_write_register(REG_FIFO_ADDR_PTR, patterns[i]);
+        ok = rfm95_read_register(REG_FIFO_ADDR_PTR) == patterns[i];
+    }
+    if (!ok) {
+        actual = spi_set_baudrate(SPI_PORT, RFM95_SPI_SAFE_HZ);
+    }
+    rfm95_write_register(REG_FIFO_ADDR_PTR, fifo_ptr);
+    return actual;
+}
+
 /**
  * @brief Define a frequência de operação do RFM95
  * 
@@ -166,10 +778,13 @@ bool rfm95_initialize() {
 void rfm95_set_frequency(long frequency) {
     uint64_t frf = ((uint64_t)frequency << 19) / RF_CRYSTAL_FREQ_HZ;
     
-    // Escreve os 24 bits da frequência nos 3 registradores
-    rfm95_write_register(REG_FRF_MSB, (uint8_t)(frf >> 16));  // Bits 23-16
-    rfm95_write_register(REG_FRF_MID, (uint8_t)(frf >> 8));   // Bits 15-8
-    rfm95_write_register(REG_FRF_LSB, (uint8_t) frf);         // Bits 7-0
+    // Escreve os 24 bits da frequência nos 3 registradores em uma rajada
+    const uint8_t frf_bytes[] = {
+        (uint8_t)(frf >> 16),                      // REG_FRF_MSB: bits 23-16
+        (uint8_t)(frf >> 8),                       // REG_FRF_MID: bits 15-8
+        (uint8_t) frf,                             // REG_FRF_LSB: bits 7-0
+    };
+    rfm95_write_burst(REG_FRF_MSB, frf_bytes, sizeof(frf_bytes));
 }
 
 /**
@@ -189,6 +804,37 @@ void rfm95_set_tx_power(uint8_t power) {
     rfm95_write_register(REG_PA_CONFIG, 0x80 | (power - 2));
 }
 
+/**
+ * @brief Configura largura de banda, coding rate, header, SF e CRC
+ * 
+ * @param config1 Valor de REG_MODEM_CONFIG_1 (BANDWIDTH_* + ERROR_CODING_* + *_MODE)
+ * @param config2 Valor de REG_MODEM_CONFIG_2 (SPREADING_* + CRC_*)
+ * 
+ * Ativa Low Data Rate Optimize em REG_MODEM_CONFIG_3 quando o símbolo
+ * resultante passa de 16 ms (ex: SF11 e SF12 em 125 kHz), como exige o
+ * datasheet. Escritas de valores já programados são omitidas pela sombra.
+ */
+void rfm95_set_modem_config(uint8_t config1, uint8_t config2) {
+    const uint8_t modem_config[] = { config1, config2 };  // REG_MODEM_CONFIG_1, REG_MODEM_CONFIG_2
+    rfm95_write_burst(REG_MODEM_CONFIG_1, modem_config, sizeof(modem_config));
+
+    uint8_t config3 = rfm95_read_register(REG_MODEM_CONFIG_3) & ~LOW_DATA_RATE_OPTIMIZE;
+    if (rfm95_symbol_us(config1, config2) > RFM95_LDRO_SYMBOL_US) {
+        config3 |= LOW_DATA_RATE_OPTIMIZE;
+    }
+    rfm95_write_register(REG_MODEM_CONFIG_3, config3);
+}
+
+/**
+ * @brief Define o número de símbolos do preâmbulo
+ * 
+ * @param length Símbolos programáveis (o rádio acrescenta 4.25 símbolos fixos)
+ */
+void rfm95_set_preamble_length(uint16_t length) {
+    const uint8_t preamble[] = { (uint8_t)(length >> 8), (uint8_t)length };  // REG_PREAMBLE_MSB, REG_PREAMBLE_LSB
+    rfm95_write_burst(REG_PREAMBLE_MSB, preamble, sizeof(preamble));
+}
+
 /**
  * @brief Coloca o módulo em modo Sleep
  * 
@@ -196,7 +842,9 @@ void rfm95_set_tx_power(uint8_t power) {
  * desabilitadas exceto a interface SPI.
  */
 void rfm95_set_sleep_mode() {
-    rfm95_write_register(REG_OPMODE, MODE_LORA | MODE_SLEEP);
+    rx_active = false;
+    rfm95_tx_settle();
+    rfm95_set_mode(MODE_SLEEP);
 }
 
 /**
@@ -206,7 +854,29 @@ void rfm95_set_sleep_mode() {
  * com consumo reduzido (~1.5mA) mas maior que Sleep.
  */
 void rfm95_set_idle_mode() {
-    rfm95_write_register(REG_OPMODE, MODE_LORA | MODE_STDBY);
+    rx_active = false;
+    rfm95_tx_settle();
+    rfm95_set_mode(MODE_STDBY);
+}
+
+/**
+ * @brief Tempo acumulado em cada estado do rádio desde rfm95_initialize()
+ * 
+ * @param times Tempos em µs, incluindo o intervalo em andamento
+ * 
+ * Os modos de síntese (FSTX/FSRX) contam como Standby e o CAD como RX.
+ */
+void rfm95_get_mode_times(rfm95_mode_times_t* times) {
+    uint32_t irq = save_and_disable_interrupts();
+    uint64_t t[8];
+    memcpy(t, mode_time_us, sizeof(t));
+    t[mode_current] += time_us_64() - mode_since_us;
+    restore_interrupts(irq);
+
+    times->sleep_us = t[MODE_SLEEP];
+    times->standby_us = t[MODE_STDBY] + t[0x02] + t[0x04];       // Standby, FSTX, FSRX
+    times->tx_us = t[MODE_TX];
+    times->rx_us = t[MODE_RX_CONTINUOUS] + t[MODE_RX_SINGLE] + t[0x07];  // RX e CAD
 }
 
 // ============================================================================
@@ -214,63 +884,166 @@ void rfm95_set_idle_mode() {
 // ============================================================================
 
 /**
- * @brief Transmite um pacote de dados
+ * @brief Inicia a transmissão de um pacote sem aguardar sua conclusão
  * 
  * @param buffer Ponteiro para os dados a serem transmitidos
  * @param size Tamanho dos dados em bytes (máximo 255)
+ * @param callback Função chamada (em contexto de interrupção) ao fim da
+ *                 transmissão, ou NULL
+ * @return true se a transmissão foi iniciada, false se o rádio ainda está
+ *         transmitindo o pacote anterior ou se o pacote excede o orçamento
+ *         de tempo no ar (ver rfm95_set_airtime_budget)
  * 
  * Processo:
- * 1. Coloca o módulo em modo Standby
- * 2. Reseta o ponteiro do FIFO
- * 3. Escreve os dados no FIFO
+ * 1. Encerra a transmissão anterior e coloca o módulo em modo Standby
+ * 2. Mapeia TxDone no pino DIO0
+ * 3. Reseta o ponteiro do FIFO e escreve os dados
  * 4. Define o tamanho do payload
- * 5. Inicia transmissão
- * 6. Aguarda conclusão da transmissão
- * 7. Limpa a flag de transmissão concluída
- * 8. Retorna ao modo Standby
+ * 5. Inicia transmissão e retorna imediatamente
+ * 
+ * Os dados são copiados para o FIFO antes do retorno, então o buffer pode
+ * ser reutilizado logo em seguida. A conclusão é sinalizada pela borda de
+ * subida do DIO0 (rfm95_transmit_busy / rfm95_transmit_wait / callback).
  */
-void rfm95_transmit(const uint8_t* data, uint8_t size) {
+bool rfm95_transmit_async(const uint8_t* data, uint8_t size, rfm95_tx_callback_t callback) {
+    rfm95_segment_t segment = { data, size };
+    return rfm95_transmit_async_segments(&segment, 1, callback);
+}
+
+/**
+ * @brief Inicia a transmissão de um pacote formado por vários trechos
+ * 
+ * @param segments Trechos do pacote, na ordem (ex: cabeçalho e carga)
+ * @param count Quantidade de trechos
+ * @param callback Como em rfm95_transmit_async
+ * @return Como em rfm95_transmit_async; false também se o total passar de
+ *         255 bytes
+ * 
+ * Cada trecho é escrito no FIFO direto do seu buffer, sem montar o pacote
+ * em um buffer intermediário. Os buffers podem ser reutilizados no retorno.
+ */
+bool rfm95_transmit_async_segments(const rfm95_segment_t* segments, uint8_t count,
+                                   rfm95_tx_callback_t callback) {
+    uint16_t total = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        total += segments[i].length;
+    }
+    uint8_t size = (uint8_t)total;
+    if (total > 255 || tx_state == TX_BUSY) {
+        return false;                              // Grande demais ou pacote anterior ainda no ar
+    }
+    if (!rfm95_budget_consume(size)) {
+        return false;                              // Duty cycle esgotado
+    }
     rfm95_set_idle_mode();                         // Modo Standby
+    rfm95_write_register(REG_DIO_MAPPING_1, DIO0_TX_DONE);  // DIO0 = TxDone
     
     // Prepara o FIFO para transmissão
     rfm95_write_register(REG_FIFO_ADDR_PTR, 0);         // Reset ponteiro FIFO
-    rfm95_write_payload_data(data, size);                // Escreve dados no FIFO
+    TRACE_BEGIN(TRACE_RFM95_FIFO);
+    rfm95_write_payload_data(segments, count);          // Escreve dados no FIFO
+    TRACE_END(TRACE_RFM95_FIFO);
     rfm95_write_register(REG_PAYLOAD_LENGTH, size);     // Define tamanho do payload
 
-    // Inicia transmissão
-    rfm95_write_register(REG_OPMODE, MODE_LORA | MODE_TX);
+    // Inicia transmissão; o estado é marcado antes para não perder a IRQ
+    tx_callback = callback;
+    tx_state = TX_BUSY;
+    rfm95_set_mode(MODE_TX);
+    return true;
+}
+
+/**
+ * @brief Indica se há uma transmissão em andamento
+ * 
+ * Apenas consulta o estado atualizado pela IRQ do DIO0, sem acesso SPI.
+ */
+bool rfm95_transmit_busy() {
+    return tx_state == TX_BUSY;
+}
 
-    // Aguarda conclusão da transmissão
-    while (!(rfm95_read_register(REG_IRQ_FLAGS) & IRQ_TX_DONE_MASK)) {
-        sleep_ms(1);                               // Polling com delay
+/**
+ * @brief Aguarda o fim da transmissão em andamento com o núcleo em WFI
+ * 
+ * As interrupções são desabilitadas entre o teste do estado e o WFI para
+ * que um TxDone ocorrido nesse intervalo não seja perdido: a IRQ pendente
+ * acorda o núcleo mesmo com PRIMASK ativo e é tratada em restore_interrupts.
+ */
+void rfm95_transmit_wait() {
+    TRACE_BEGIN(TRACE_RFM95_TX_WAIT);
+    bool busy = true;
+    while (busy) {
+        uint32_t irq = save_and_disable_interrupts();
+        busy = (tx_state == TX_BUSY);
+        if (busy) __wfi();
+        restore_interrupts(irq);
     }
-    
-    // Limpa flag de transmissão concluída
-    rfm95_write_register(REG_IRQ_FLAGS, IRQ_TX_DONE_MASK);
-    rfm95_set_idle_mode();                         // Retorna ao Standby
+    TRACE_END(TRACE_RFM95_TX_WAIT);
+}
+
+/**
+ * @brief Transmite um pacote de dados e aguarda a conclusão
+ * 
+ * @param buffer Ponteiro para os dados a serem transmitidos
+ * @param size Tamanho dos dados em bytes (máximo 255)
+ * 
+ * Versão bloqueante sobre rfm95_transmit_async: aguarda uma transmissão
+ * anterior e o orçamento de tempo no ar, inicia o pacote, dorme até o
+ * TxDone e retorna ao Standby.
+ */
+void rfm95_transmit(const uint8_t* data, uint8_t size) {
+    rfm95_transmit_wait();
+    uint32_t wait_us = rfm95_airtime_wait_us(size);
+    if (wait_us > 0) {
+        sleep_us(wait_us);                         // Respeita o duty cycle
+    }
+    rfm95_transmit_async(data, size, NULL);
+    rfm95_transmit_wait();
+    rfm95_set_idle_mode();                         // Limpa TxDone, já em Standby
+}
+
+/**
+ * @brief Lê REG_IRQ_FLAGS e, com RxDone, o endereço e o tamanho do pacote
+ * 
+ * @param status REG_FIFO_RX_CURRENT_ADDR..REG_RX_NB_BYTES, preenchido só com RxDone
+ * @return REG_IRQ_FLAGS
+ * 
+ * As flags vêm antes: numa rajada única a partir de REG_FIFO_RX_CURRENT_ADDR,
+ * um RxDone que chegasse entre os bytes seria visto junto com o endereço do
+ * pacote anterior.
+ */
+static uint8_t rfm95_rx_status(uint8_t status[REG_RX_NB_BYTES - REG_FIFO_RX_CURRENT_ADDR + 1]) {
+    uint8_t irq = rfm95_read_register(REG_IRQ_FLAGS);
+    if (irq & IRQ_RX_DONE_MASK) {
+        rfm95_read_burst(REG_FIFO_RX_CURRENT_ADDR, status, REG_RX_NB_BYTES - REG_FIFO_RX_CURRENT_ADDR + 1);
+    }
+    return irq;
 }
 
 /**
  * @brief Verifica se há dados recebidos e os lê
  * 
- * @param buffer Buffer para armazenar os dados recebidos
+ * @param data Buffer para armazenar os dados recebidos
  * @param max_size Tamanho máximo do buffer
  * @return Número de bytes recebidos (0 se nenhum dado disponível)
  * 
  * Processo:
  * 1. Coloca o módulo em modo de recepção contínua
- * 2. Verifica se há dados recebidos (flag RX_DONE)
- * 3. Verifica se há erro de CRC
- * 4. Lê o tamanho dos dados recebidos
+ * 2. Lê as flags (RX_DONE) e, só com RX_DONE, o endereço e o tamanho do pacote
+ * 3. Limpa RX_DONE e verifica se há erro de CRC
+ * 4. Aponta o FIFO para o endereço lido
  * 5. Lê os dados do FIFO
  * 6. Retorna o número de bytes lidos
  */
 int rfm95_receive(uint8_t* data, int max_size) {
-    // Coloca em modo de recepção contínua
-    rfm95_write_register(REG_OPMODE, MODE_LORA | MODE_RX_CONTINUOUS);
+    // Coloca em modo de recepção contínua (omitido se já estiver em RX)
+    rx_active = false;                             // Exclusivo com o motor de recepção
+    rfm95_tx_settle();
+    rfm95_write_register(REG_DIO_MAPPING_1, DIO0_RX_DONE);  // DIO0 = RxDone
+    rfm95_set_mode(MODE_RX_CONTINUOUS);
 
-    // Verifica flags de interrupção
-    uint8_t irq = rfm95_read_register(REG_IRQ_FLAGS);
+    // REG_IRQ_FLAGS e, com RxDone, REG_FIFO_RX_CURRENT_ADDR..REG_RX_NB_BYTES
+    uint8_t status[REG_RX_NB_BYTES - REG_FIFO_RX_CURRENT_ADDR + 1];
+    uint8_t irq = rfm95_rx_status(status);
 
     if (irq & IRQ_RX_DONE_MASK) {                  // Dados recebidos?
         // Limpa flag de recepção concluída
@@ -281,12 +1054,12 @@ int rfm95_receive(uint8_t* data, int max_size) {
             return 0;                              // Dados corrompidos
         }
 
-        // Lê tamanho dos dados recebidos
-        uint8_t len = rfm95_read_register(REG_RX_NB_BYTES);
+        // Tamanho dos dados recebidos
+        uint8_t len = status[REG_RX_NB_BYTES - REG_FIFO_RX_CURRENT_ADDR];
         if (len > max_size) len = max_size;        // Limita ao tamanho do buffer
 
         // Configura ponteiro do FIFO para posição dos dados recebidos
-        uint8_t fifo_addr = rfm95_read_register(REG_FIFO_RX_CURRENT_ADDR);
+        uint8_t fifo_addr = status[0];
         rfm95_write_register(REG_FIFO_ADDR_PTR, fifo_addr);
         
         // Lê os dados do FIFO
@@ -297,6 +1070,114 @@ int rfm95_receive(uint8_t* data, int max_size) {
     return 0;                                      // Nenhum dado disponível
 }
 
+// ============================================================================
+// MOTOR DE RECEPÇÃO (IRQ DO DIO0 + ANEL DE DESCRITORES)
+// ============================================================================
+
+/**
+ * @brief Copia o pacote recebido do FIFO para o próximo descritor livre
+ * 
+ * Executado na IRQ do DIO0. A flag RxDone é limpa antes da leitura do FIFO
+ * para que um pacote que chegue durante a cópia gere uma nova borda (em RX
+ * contínuo o rádio grava o próximo pacote após o atual no FIFO). Com o anel
+ * cheio o pacote é descartado e contado em rx_dropped.
+ */
+static void rfm95_rx_drain() {
+    uint64_t timestamp = time_us_64();
+
+    uint8_t status[REG_RX_NB_BYTES - REG_FIFO_RX_CURRENT_ADDR + 1];
+    uint8_t irq = rfm95_rx_status(status);
+    if (!(irq & IRQ_RX_DONE_MASK)) {
+        return;
+    }
+    rfm95_write_register(REG_IRQ_FLAGS, IRQ_RX_DONE_MASK | IRQ_PAYLOAD_CRC_ERROR_MASK);
+
+    uint32_t head = rx_head;
+    if (head - rx_tail >= RFM95_RX_RING_SIZE) {
+        rx_dropped++;                              // Aplicação não consumiu a tempo
+        return;
+    }
+
+    rfm95_packet_t* p = &rx_ring[head % RFM95_RX_RING_SIZE];
+    p->length = status[REG_RX_NB_BYTES - REG_FIFO_RX_CURRENT_ADDR];
+    p->crc_ok = !(irq & IRQ_PAYLOAD_CRC_ERROR_MASK);
+    p->timestamp_us = timestamp;
+
+    rfm95_write_register(REG_FIFO_ADDR_PTR, status[0]);
+    rfm95_read_burst(REG_FIFO, p->data, p->length);   // SPI bloqueante: dentro da IRQ
+
+    // REG_PKT_SNR_VALUE e REG_PKT_RSSI_VALUE do mesmo pacote, em uma rajada
+    uint8_t quality[REG_PKT_RSSI_VALUE - REG_PKT_SNR_VALUE + 1];
+    rfm95_read_burst(REG_PKT_SNR_VALUE, quality, sizeof(quality));
+    p->snr = ((int8_t)quality[0]) * 0.25f;
+    p->rssi = quality[1] - 157;
+
+    __dmb();                                       // Descritor completo antes de publicá-lo
+    rx_head = head + 1;
+}
+
+/**
+ * @brief Liga o motor de recepção
+ * 
+ * Entra em RX contínuo uma única vez e mapeia RxDone no DIO0. A partir daí
+ * cada pacote é copiado pela IRQ para o anel de descritores, sem polling.
+ * O motor é desligado por rfm95_set_idle_mode, rfm95_set_sleep_mode,
+ * rfm95_receive e pelas transmissões; basta chamar rfm95_rx_start de novo.
+ * Pacotes ainda não consumidos no anel são preservados.
+ */
+void rfm95_rx_start() {
+    rfm95_tx_settle();
+    rfm95_write_register(REG_DIO_MAPPING_1, DIO0_RX_DONE);  // DIO0 = RxDone
+    rfm95_set_mode(MODE_RX_CONTINUOUS);
+
+    // Um pacote recebido antes deste ponto não gera borda: drena agora
+    uint32_t irq = save_and_disable_interrupts();
+    rx_active = true;
+    rfm95_rx_drain();
+    restore_interrupts(irq);
+}
+
+/**
+ * @brief Desliga o motor de recepção e coloca o rádio em Standby
+ */
+void rfm95_rx_stop() {
+    rfm95_set_idle_mode();
+}
+
+/**
+ * @brief Retorna o pacote mais antigo do anel sem copiá-lo
+ * 
+ * @return Descritor do pacote, ou NULL se o anel estiver vazio
+ * 
+ * O descritor continua válido (a IRQ não o sobrescreve) até
+ * rfm95_rx_release ser chamada.
+ */
+const rfm95_packet_t* rfm95_rx_peek() {
+    uint32_t tail = rx_tail;
+    if (tail == rx_head) {
+        return NULL;
+    }
+    __dmb();                                       // Lê o descritor após ver o head
+    return &rx_ring[tail % RFM95_RX_RING_SIZE];
+}
+
+/**
+ * @brief Libera o descritor retornado por rfm95_rx_peek
+ */
+void rfm95_rx_release() {
+    if (rx_tail != rx_head) {
+        __dmb();                                   // Termina a leitura antes de liberar
+        rx_tail = rx_tail + 1;
+    }
+}
+
+/**
+ * @brief Quantidade de pacotes descartados por falta de descritor livre
+ */
+uint32_t rfm95_rx_dropped() {
+    return rx_dropped;
+}
+
 // ============================================================================
 // INFORMAÇÕES DE QUALIDADE DO SINAL
 // ============================================================================
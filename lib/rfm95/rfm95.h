@@ -16,6 +16,53 @@
 #define PIN_SCK  18
 #define PIN_MOSI 19
 #define PIN_RST  20
+#define PIN_DIO0 21     // Interrupção de TxDone/RxDone do rádio
+
+// Clock SPI: máximo do SX1276, confirmado por releitura em rfm95_initialize()
+// com volta a RFM95_SPI_SAFE_HZ se a comunicação falhar nele
+#ifndef RFM95_SPI_HZ
+#define RFM95_SPI_HZ        (10 * 1000 * 1000)
+#endif
+#define RFM95_SPI_SAFE_HZ   (1 * 1000 * 1000)
+
+// Rajadas do FIFO por DMA (dois canais e DMA_IRQ_0), desligadas por padrão;
+// ligue (-DRFM95_DMA=ON) só com o bench_spi mostrando menos CPU ocupada que
+// a escrita bloqueante. Abaixo de RFM95_DMA_MIN_BYTES a escrita bloqueante
+// termina antes de os canais serem configurados e o núcleo acordar
+#ifndef RFM95_USE_DMA
+#define RFM95_USE_DMA       0
+#endif
+#define RFM95_DMA_MIN_BYTES 16
+
+// Callback de fim de transmissão (executado em contexto de interrupção)
+typedef void (*rfm95_tx_callback_t)(void);
+
+// Trecho de um pacote escrito direto do buffer de origem no FIFO
+typedef struct {
+    const uint8_t* data;
+    uint8_t length;
+} rfm95_segment_t;
+
+// Motor de recepção: quantidade de descritores (potência de 2)
+#define RFM95_RX_RING_SIZE 8
+
+// Pacote recebido, preenchido pela IRQ do DIO0
+typedef struct {
+    uint8_t data[255];
+    uint8_t length;
+    bool crc_ok;
+    int16_t rssi;               // dBm
+    float snr;                  // dB
+    uint64_t timestamp_us;      // time_us_64() no RxDone
+} rfm95_packet_t;
+
+// Tempo acumulado em cada estado do rádio (estimativa de consumo)
+typedef struct {
+    uint64_t tx_us;
+    uint64_t rx_us;
+    uint64_t standby_us;
+    uint64_t sleep_us;
+} rfm95_mode_times_t;
 
 // --- ASSINATURA DAS FUNÇÕES ---
 bool rfm95_initialize();
@@ -23,7 +70,24 @@ void rfm95_set_idle_mode();
 void rfm95_set_sleep_mode();
 void rfm95_set_frequency(long frequency);
 void rfm95_set_tx_power(uint8_t power);
+void rfm95_set_modem_config(uint8_t config1, uint8_t config2);
+void rfm95_set_preamble_length(uint16_t length);
+uint32_t rfm95_set_spi_clock(uint32_t hz);
+void rfm95_set_dma_min_bytes(uint16_t bytes);
+uint32_t rfm95_time_on_air_us(uint8_t size);
+void rfm95_set_airtime_budget(uint32_t duty_cycle_ppm, uint32_t burst_us);
+uint32_t rfm95_airtime_wait_us(uint8_t size);
 void rfm95_transmit(const uint8_t* buffer, uint8_t size);
+bool rfm95_transmit_async(const uint8_t* buffer, uint8_t size, rfm95_tx_callback_t callback);
+bool rfm95_transmit_async_segments(const rfm95_segment_t* segments, uint8_t count, rfm95_tx_callback_t callback);
+bool rfm95_transmit_busy();
+void rfm95_transmit_wait();
 int rfm95_receive(uint8_t* buffer, int max_size);
+void rfm95_rx_start();
+void rfm95_rx_stop();
+const rfm95_packet_t* rfm95_rx_peek();
+void rfm95_rx_release();
+uint32_t rfm95_rx_dropped();
+void rfm95_get_mode_times(rfm95_mode_times_t* times);
 int rfm95_get_rssi();
 float rfm95_get_snr();
\ No newline at end of file
@@ -58,6 +58,11 @@
 #define REG_DIO_MAPPING_1           0x40    // Mapeamento DIO0-DIO3
 #define REG_DIO_MAPPING_2           0x41    // Mapeamento DIO4-DIO5
 
+// Função do pino DIO0 (bits 7-6 de REG_DIO_MAPPING_1) no modo LoRa
+#define DIO0_RX_DONE                0x00    // DIO0 = RxDone
+#define DIO0_TX_DONE                0x40    // DIO0 = TxDone
+#define DIO0_CAD_DONE               0x80    // DIO0 = CadDone
+
 // ============================================================================
 // REGISTRADORES FSK (MODO FSK/OOK)
 // ============================================================================
@@ -122,6 +127,10 @@
 #define CRC_OFF                     0x00    // CRC desabilitado
 #define CRC_ON                      0x04    // CRC habilitado
 
+// REG_MODEM_CONFIG_3
+#define LOW_DATA_RATE_OPTIMIZE      0x08    // Obrigatório com símbolos > 16 ms
+#define AGC_AUTO_ON                 0x04    // Ganho do LNA controlado pelo AGC
+
 // ============================================================================
 // CONFIGURAÇÕES DE POTÊNCIA (POWER AMPLIFIER)
 // ============================================================================
@@ -0,0 +1,331 @@
+#include <string.h>
+
+#include "series.h"
+
+// ============================================================================
+// ZIG-ZAG E VARINT
+// ============================================================================
+
+static uint32_t series_zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t series_unzigzag(uint32_t v) {
+    return (int32_t)((v >> 1) ^ (0u - (v & 1)));
+}
+
+/**
+ * @brief Escreve um varint de 7 bits por byte (bit 7 = continua)
+ *
+ * @return Quantidade de bytes escritos (1 a SERIES_VARINT_MAX_SIZE)
+ */
+static int series_put_varint(uint8_t* p, uint32_t v) {
+    int n = 0;
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+// ============================================================================
+// CODIFICADOR DE INTEIROS
+// ============================================================================
+
+/**
+ * @brief Prepara um codificador sobre um buffer do chamador
+ *
+ * @param enc Estado do codificador
+ * @param buffer Buffer de saída
+ * @param size Tamanho do buffer
+ * @param channels Valores por amostra (1 a SERIES_MAX_CHANNELS)
+ */
+void series_encoder_init(series_encoder_t* enc, uint8_t* buffer, int size, uint8_t channels) {
+    enc->buffer = buffer;
+    enc->size = size;
+    enc->length = 0;
+    enc->count = 0;
+    enc->channels = channels > SERIES_MAX_CHANNELS ? SERIES_MAX_CHANNELS : channels;
+    memset(enc->last, 0, sizeof(enc->last));
+}
+
+/**
+ * @brief Acrescenta uma amostra ao fluxo
+ *
+ * @param enc Estado do codificador
+ * @param values Um valor por canal
+ * @return false se a amostra não cabe no buffer; o fluxo fica inalterado
+ *
+ * Como o estado inicial de cada canal é zero, a primeira amostra é gravada
+ * como diferença para zero, isto é, o próprio valor. A subtração é feita
+ * em aritmética modular, então qualquer par de int32 é representável.
+ */
+bool series_encode(series_encoder_t* enc, const int32_t* values) {
+    uint8_t tmp[SERIES_MAX_CHANNELS * SERIES_VARINT_MAX_SIZE];
+    int n = 0;
+
+    for (int c = 0; c < enc->channels; c++) {
+        int32_t delta = (int32_t)((uint32_t)values[c] - (uint32_t)enc->last[c]);
+        n += series_put_varint(&tmp[n], series_zigzag(delta));
+    }
+    if (enc->length + n > enc->size) {
+        return false;
+    }
+
+    memcpy(&enc->buffer[enc->length], tmp, n);
+    memcpy(enc->last, values, enc->channels * sizeof(int32_t));
+    enc->length += n;
+    enc->count++;
+    return true;
+}
+
+// ============================================================================
+// DECODIFICADOR DE INTEIROS
+// ============================================================================
+
+void series_decoder_init(series_decoder_t* dec, const uint8_t* buffer, int length, uint8_t channels) {
+    dec->buffer = buffer;
+    dec->length = length;
+    dec->pos = 0;
+    dec->channels = channels > SERIES_MAX_CHANNELS ? SERIES_MAX_CHANNELS : channels;
+    memset(dec->last, 0, sizeof(dec->last));
+}
+
+/**
+ * @brief Lê a próxima amostra do fluxo
+ *
+ * @param dec Estado do decodificador
+ * @param values Recebe um valor por canal
+ * @return false no fim do fluxo ou se a amostra estiver truncada ou com um
+ *         varint maior que 32 bits
+ */
+bool series_decode(series_decoder_t* dec, int32_t* values) {
+    int pos = dec->pos;
+    int32_t out[SERIES_MAX_CHANNELS];
+
+    for (int c = 0; c < dec->channels; c++) {
+        uint32_t v = 0;
+        int shift = 0;
+        for (;;) {
+            if (pos >= dec->length || shift > 28) return false;
+            uint8_t b = dec->buffer[pos++];
+            v |= (uint32_t)(b & 0x7F) << shift;
+            shift += 7;
+            if (!(b & 0x80)) break;
+        }
+        out[c] = (int32_t)((uint32_t)dec->last[c] + (uint32_t)series_unzigzag(v));
+    }
+
+    memcpy(dec->last, out, dec->channels * sizeof(int32_t));
+    memcpy(values, out, dec->channels * sizeof(int32_t));
+    dec->pos = pos;
+    return true;
+}
+
+// ============================================================================
+// FLUXO DE BITS
+// ============================================================================
+
+/**
+ * @brief Escreve os n bits menos significativos de value (MSB primeiro)
+ *
+ * @return false se o buffer acabou; nada é escrito nesse caso
+ */
+static bool series_put_bits(uint8_t* buffer, int size, uint32_t* pos, uint32_t value, int n) {
+    if (*pos + n > (uint32_t)size * 8) {
+        return false;
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        uint8_t mask = 0x80 >> (*pos & 7);
+        if ((value >> i) & 1) buffer[*pos >> 3] |= mask;
+        else                  buffer[*pos >> 3] &= (uint8_t)~mask;
+        (*pos)++;
+    }
+    return true;
+}
+
+static bool series_get_bits(const uint8_t* buffer, uint32_t bits, uint32_t* pos, uint32_t* value, int n) {
+    if (*pos + n > bits) {
+        return false;
+    }
+    uint32_t v = 0;
+    for (int i = 0; i < n; i++) {
+        v = (v << 1) | ((buffer[*pos >> 3] >> (7 - (*pos & 7))) & 1);
+        (*pos)++;
+    }
+    *value = v;
+    return true;
+}
+
+static uint32_t series_float_bits(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static float series_bits_float(uint32_t u) {
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+// Janela de bits significativos ainda não definida
+#define SERIES_NO_WINDOW    0xFF
+
+// ============================================================================
+// CODIFICADOR DE FLOATS (XOR)
+// ============================================================================
+
+void series_xor_encoder_init(series_xor_encoder_t* enc, uint8_t* buffer, int size, uint8_t channels) {
+    enc->buffer = buffer;
+    enc->size = size;
+    enc->bits = 0;
+    enc->count = 0;
+    enc->channels = channels > SERIES_MAX_CHANNELS ? SERIES_MAX_CHANNELS : channels;
+    memset(enc->last, 0, sizeof(enc->last));
+    memset(enc->leading, SERIES_NO_WINDOW, sizeof(enc->leading));
+    memset(enc->trailing, 0, sizeof(enc->trailing));
+}
+
+/**
+ * @brief Codifica o XOR de um canal com o valor anterior
+ */
+static bool series_xor_put(series_xor_encoder_t* enc, uint32_t* pos, int c, uint32_t value) {
+    if (enc->count == 0) {
+        return series_put_bits(enc->buffer, enc->size, pos, value, 32);
+    }
+
+    uint32_t x = value ^ enc->last[c];
+    if (x == 0) {
+        return series_put_bits(enc->buffer, enc->size, pos, 0, 1);
+    }
+
+    int leading = __builtin_clz(x);
+    int trailing = __builtin_ctz(x);
+    if (leading > 31) leading = 31;
+
+    // Cabe na janela anterior: '10' + bits da janela
+    if (enc->leading[c] != SERIES_NO_WINDOW && leading >= enc->leading[c] && trailing >= enc->trailing[c]) {
+        int length = 32 - enc->leading[c] - enc->trailing[c];
+        return series_put_bits(enc->buffer, enc->size, pos, 0x2, 2) &&
+               series_put_bits(enc->buffer, enc->size, pos, x >> enc->trailing[c], length);
+    }
+
+    // Nova janela: '11' + zeros à esquerda (5) + tamanho - 1 (5) + bits
+    int length = 32 - leading - trailing;
+    enc->leading[c] = (uint8_t)leading;
+    enc->trailing[c] = (uint8_t)trailing;
+    return series_put_bits(enc->buffer, enc->size, pos, 0x3, 2) &&
+           series_put_bits(enc->buffer, enc->size, pos, (uint32_t)leading, 5) &&
+           series_put_bits(enc->buffer, enc->size, pos, (uint32_t)(length - 1), 5) &&
+           series_put_bits(enc->buffer, enc->size, pos, x >> trailing, length);
+}
+
+/**
+ * @brief Acrescenta uma amostra de floats ao fluxo
+ *
+ * @param enc Estado do codificador
+ * @param values Um valor por canal
+ * @return false se a amostra não cabe no buffer; o fluxo fica inalterado
+ */
+bool series_xor_encode(series_xor_encoder_t* enc, const float* values) {
+    uint32_t pos = enc->bits;
+    uint8_t leading[SERIES_MAX_CHANNELS], trailing[SERIES_MAX_CHANNELS];
+    memcpy(leading, enc->leading, sizeof(leading));
+    memcpy(trailing, enc->trailing, sizeof(trailing));
+
+    for (int c = 0; c < enc->channels; c++) {
+        if (!series_xor_put(enc, &pos, c, series_float_bits(values[c]))) {
+            // Desfaz as janelas alteradas; os bits além de enc->bits são ignorados
+            memcpy(enc->leading, leading, sizeof(leading));
+            memcpy(enc->trailing, trailing, sizeof(trailing));
+            return false;
+        }
+    }
+
+    for (int c = 0; c < enc->channels; c++) {
+        enc->last[c] = series_float_bits(values[c]);
+    }
+    enc->bits = pos;
+    enc->count++;
+    return true;
+}
+
+int series_xor_length(const series_xor_encoder_t* enc) {
+    // Zera os bits de enchimento do último byte
+    if (enc->bits & 7) {
+        enc->buffer[enc->bits >> 3] &= (uint8_t)(0xFF00 >> (enc->bits & 7));
+    }
+    return (int)((enc->bits + 7) / 8);
+}
+
+// ============================================================================
+// DECODIFICADOR DE FLOATS (XOR)
+// ============================================================================
+
+void series_xor_decoder_init(series_xor_decoder_t* dec, const uint8_t* buffer, int length,
+                             uint8_t channels, uint16_t count) {
+    dec->buffer = buffer;
+    dec->bits = (uint32_t)length * 8;
+    dec->pos = 0;
+    dec->count = count;
+    dec->channels = channels > SERIES_MAX_CHANNELS ? SERIES_MAX_CHANNELS : channels;
+    memset(dec->last, 0, sizeof(dec->last));
+    memset(dec->leading, SERIES_NO_WINDOW, sizeof(dec->leading));
+    memset(dec->trailing, 0, sizeof(dec->trailing));
+}
+
+static bool series_xor_get(series_xor_decoder_t* dec, bool first, int c, uint32_t* value) {
+    uint32_t v;
+    if (first) {
+        return series_get_bits(dec->buffer, dec->bits, &dec->pos, value, 32);
+    }
+
+    if (!series_get_bits(dec->buffer, dec->bits, &dec->pos, &v, 1)) return false;
+    if (v == 0) {
+        *value = dec->last[c];                     // Valor repetido
+        return true;
+    }
+
+    if (!series_get_bits(dec->buffer, dec->bits, &dec->pos, &v, 1)) return false;
+    if (v == 1) {
+        uint32_t leading, length;
+        if (!series_get_bits(dec->buffer, dec->bits, &dec->pos, &leading, 5) ||
+            !series_get_bits(dec->buffer, dec->bits, &dec->pos, &length, 5)) {
+            return false;
+        }
+        length++;
+        if (leading + length > 32) return false;
+        dec->leading[c] = (uint8_t)leading;
+        dec->trailing[c] = (uint8_t)(32 - leading - length);
+    } else if (dec->leading[c] == SERIES_NO_WINDOW) {
+        return false;                               // Janela anterior inexistente
+    }
+
+    int length = 32 - dec->leading[c] - dec->trailing[c];
+    if (!series_get_bits(dec->buffer, dec->bits, &dec->pos, &v, length)) return false;
+    *value = dec->last[c] ^ (v << dec->trailing[c]);
+    return true;
+}
+
+/**
+ * @brief Lê a próxima amostra de floats
+ *
+ * @return false após count amostras ou se o fluxo estiver truncado
+ */
+bool series_xor_decode(series_xor_decoder_t* dec, float* values) {
+    if (dec->count == 0) {
+        return false;
+    }
+    bool first = (dec->pos == 0);
+
+    for (int c = 0; c < dec->channels; c++) {
+        uint32_t v;
+        if (!series_xor_get(dec, first, c, &v)) return false;
+        dec->last[c] = v;
+        values[c] = series_bits_float(v);
+    }
+    dec->count--;
+    return true;
+}
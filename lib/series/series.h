@@ -0,0 +1,99 @@
+#ifndef SERIES_H
+#define SERIES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// COMPRESSÃO DE SÉRIES TEMPORAIS DOS SENSORES
+// ============================================================================
+// Dois codificadores de fluxo, sem alocação dinâmica: o chamador fornece o
+// buffer de saída e cada amostra (um valor por canal) é acrescentada ao fim.
+// O decodificador lê as amostras na mesma ordem até o fim do buffer.
+//
+// Inteiros (series_encoder_t): a primeira amostra de cada canal é gravada
+// inteira e as seguintes como a diferença para a anterior, em zig-zag
+// (0, -1, 1, -2, 2... -> 0, 1, 2, 3, 4...) e varint de 7 bits por byte.
+// Leituras em ponto fixo que variam pouco ocupam 1 byte por canal.
+//
+// Floats (series_xor_encoder_t): XOR com o valor anterior no estilo Gorilla
+// (Pelkonen et al., 2015), empacotado em bits:
+//   '0'                      valor repetido
+//   '10' + bits              bits significativos na mesma janela anterior
+//   '11' + 5 + 5 + bits      zeros à esquerda, tamanho - 1, bits significativos
+//
+// O código não depende do Pico SDK e é usado também pelo gateway Linux.
+
+#define SERIES_MAX_CHANNELS         4
+#define SERIES_VARINT_MAX_SIZE      5       // int32 em zig-zag varint
+
+// Codificador de inteiros
+typedef struct {
+    uint8_t* buffer;
+    int size;
+    int length;                             // Bytes escritos
+    uint16_t count;                         // Amostras codificadas
+    uint8_t channels;
+    int32_t last[SERIES_MAX_CHANNELS];
+} series_encoder_t;
+
+// Decodificador de inteiros
+typedef struct {
+    const uint8_t* buffer;
+    int length;
+    int pos;
+    uint8_t channels;
+    int32_t last[SERIES_MAX_CHANNELS];
+} series_decoder_t;
+
+// Codificador de floats (XOR)
+typedef struct {
+    uint8_t* buffer;
+    int size;
+    uint32_t bits;                          // Bits escritos
+    uint16_t count;
+    uint8_t channels;
+    uint32_t last[SERIES_MAX_CHANNELS];
+    uint8_t leading[SERIES_MAX_CHANNELS];   // Janela do último XOR não nulo
+    uint8_t trailing[SERIES_MAX_CHANNELS];
+} series_xor_encoder_t;
+
+// Decodificador de floats (XOR)
+typedef struct {
+    const uint8_t* buffer;
+    uint32_t bits;                          // Tamanho do fluxo em bits
+    uint32_t pos;
+    uint16_t count;
+    uint8_t channels;
+    uint32_t last[SERIES_MAX_CHANNELS];
+    uint8_t leading[SERIES_MAX_CHANNELS];
+    uint8_t trailing[SERIES_MAX_CHANNELS];
+} series_xor_decoder_t;
+
+// --- INTEIROS ---
+void series_encoder_init(series_encoder_t* enc, uint8_t* buffer, int size, uint8_t channels);
+
+// Acrescenta uma amostra; retorna false (sem alterar o fluxo) se não couber
+bool series_encode(series_encoder_t* enc, const int32_t* values);
+
+void series_decoder_init(series_decoder_t* dec, const uint8_t* buffer, int length, uint8_t channels);
+
+// Lê a próxima amostra; retorna false no fim do buffer ou se estiver truncado
+bool series_decode(series_decoder_t* dec, int32_t* values);
+
+// --- FLOATS (XOR) ---
+void series_xor_encoder_init(series_xor_encoder_t* enc, uint8_t* buffer, int size, uint8_t channels);
+
+// Acrescenta uma amostra; retorna false (sem alterar o fluxo) se não couber
+bool series_xor_encode(series_xor_encoder_t* enc, const float* values);
+
+// Tamanho do fluxo em bytes (o último byte é completado com zeros)
+int series_xor_length(const series_xor_encoder_t* enc);
+
+// count é a quantidade de amostras: o fluxo em bits não marca o próprio fim
+void series_xor_decoder_init(series_xor_decoder_t* dec, const uint8_t* buffer, int length,
+                             uint8_t channels, uint16_t count);
+
+bool series_xor_decode(series_xor_decoder_t* dec, float* values);
+
+#endif // SERIES_H
@@ -0,0 +1,66 @@
+#include <string.h>
+
+#include "spsc.h"
+
+/**
+ * @brief Prepara uma fila vazia sobre um buffer do chamador
+ *
+ * @param q Fila
+ * @param storage Buffer com capacity * elem_size bytes
+ * @param capacity Quantidade de elementos (potência de 2)
+ * @param elem_size Tamanho de cada elemento em bytes
+ * @return false se a capacidade não for potência de 2
+ */
+bool spsc_init(spsc_queue_t* q, void* storage, uint32_t capacity, uint32_t elem_size) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+    q->slots = storage;
+    q->mask = capacity - 1;
+    q->elem_size = elem_size;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    return true;
+}
+
+/**
+ * @brief Copia um elemento para o fim da fila (lado do produtor)
+ *
+ * O elemento é escrito antes de o novo head ser publicado com release; o
+ * consumidor que observar o head com acquire vê o elemento completo.
+ */
+bool spsc_push(spsc_queue_t* q, const void* elem) {
+    uint32_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    if (head - tail > q->mask) {
+        return false;                               // Cheia
+    }
+
+    memcpy(&q->slots[(head & q->mask) * q->elem_size], elem, q->elem_size);
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Retira o elemento mais antigo da fila (lado do consumidor)
+ *
+ * O tail só é liberado com release depois da cópia, para que o produtor não
+ * reutilize o slot enquanto ele ainda é lido.
+ */
+bool spsc_pop(spsc_queue_t* q, void* elem) {
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    if (head == tail) {
+        return false;                               // Vazia
+    }
+
+    memcpy(elem, &q->slots[(tail & q->mask) * q->elem_size], q->elem_size);
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+uint32_t spsc_count(spsc_queue_t* q) {
+    uint32_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    return head - tail;
+}
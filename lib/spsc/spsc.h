@@ -0,0 +1,40 @@
+#ifndef SPSC_H
+#define SPSC_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// FILA SEM TRAVA COM UM PRODUTOR E UM CONSUMIDOR
+// ============================================================================
+// Anel de elementos de tamanho fixo sobre um buffer do chamador. O produtor
+// só escreve head e o consumidor só escreve tail; a publicação usa
+// release/acquire do C11, que no RP2040 (Cortex-M0+) vira um DMB e no Linux
+// funciona entre threads. Os índices crescem livremente e a posição no anel
+// é índice % capacidade (capacidade potência de 2).
+//
+// Seguro entre os dois núcleos do RP2040, entre uma IRQ e o laço principal
+// ou entre duas threads, desde que cada lado tenha um único chamador.
+
+typedef struct {
+    _Atomic uint32_t head;      // Próximo slot a escrever (produtor)
+    _Atomic uint32_t tail;      // Próximo slot a ler (consumidor)
+    uint8_t* slots;
+    uint32_t mask;              // Capacidade - 1
+    uint32_t elem_size;
+} spsc_queue_t;
+
+// storage deve ter capacity * elem_size bytes; capacity potência de 2
+bool spsc_init(spsc_queue_t* q, void* storage, uint32_t capacity, uint32_t elem_size);
+
+// Copia um elemento para a fila; false se estiver cheia
+bool spsc_push(spsc_queue_t* q, const void* elem);
+
+// Retira o elemento mais antigo; false se estiver vazia
+bool spsc_pop(spsc_queue_t* q, void* elem);
+
+// Elementos na fila (aproximado se chamado por um terceiro)
+uint32_t spsc_count(spsc_queue_t* q);
+
+#endif // SPSC_H
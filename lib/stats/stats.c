@@ -0,0 +1,97 @@
+#include "stats.h"
+
+#define STATS_ONE           ((int64_t)1 << STATS_FRAC_BITS)
+#define STATS_HALF_BITS     (STATS_FRAC_BITS / 2)
+
+/**
+ * @brief Divisão com arredondamento para o inteiro mais próximo
+ */
+static int64_t stats_div_round(int64_t num, int64_t den) {
+    return num >= 0 ? (num + den / 2) / den : -((-num + den / 2) / den);
+}
+
+/**
+ * @brief Raiz quadrada inteira (piso) de 64 bits, bit a bit
+ */
+static uint32_t stats_isqrt(uint64_t v) {
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+void stats_reset(stats_channel_t* c) {
+    c->count = 0;
+    c->min = 0;
+    c->max = 0;
+    c->last = 0;
+    c->sum = 0;
+    c->mean_q = 0;
+    c->m2_q = 0;
+}
+
+/**
+ * @brief Acrescenta uma amostra (atualização de Welford)
+ * 
+ *   delta  = x - média(n-1)
+ *   média  = soma / n
+ *   M2    += delta * (x - média(n))
+ * 
+ * A média sai da soma exata em vez de média += delta / n: com n grande o
+ * incremento arredondado some e a média para de acompanhar uma deriva lenta.
+ * Os dois desvios estão em Q16; o produto Q32 volta para Q16. Desvios que
+ * não cabem em 31 bits em Q16 são reduzidos a Q8 antes do produto.
+ */
+void stats_add(stats_channel_t* c, int32_t x) {
+    if (c->count == 0) {
+        c->min = c->max = x;
+    } else {
+        if (x < c->min) c->min = x;
+        if (x > c->max) c->max = x;
+    }
+    c->last = x;
+    c->count++;
+
+    int64_t x_q = (int64_t)x * STATS_ONE;
+    int64_t delta = x_q - c->mean_q;
+    c->sum += x;
+    c->mean_q = stats_div_round(c->sum * STATS_ONE, c->count);
+    int64_t delta2 = x_q - c->mean_q;
+
+    const int64_t limit = (int64_t)1 << 31;
+    if (delta > -limit && delta < limit && delta2 > -limit && delta2 < limit) {
+        c->m2_q += (delta * delta2) >> STATS_FRAC_BITS;
+    } else {
+        c->m2_q += (delta >> STATS_HALF_BITS) * (delta2 >> STATS_HALF_BITS);
+    }
+}
+
+int32_t stats_mean(const stats_channel_t* c) {
+    return (int32_t)stats_div_round(c->mean_q, STATS_ONE);
+}
+
+uint64_t stats_variance_q(const stats_channel_t* c) {
+    if (c->count < 2 || c->m2_q <= 0) {
+        return 0;
+    }
+    return (uint64_t)c->m2_q / (c->count - 1);
+}
+
+/**
+ * @brief Desvio padrão: raiz da variância em Q16 dá o desvio em Q8
+ */
+uint32_t stats_stddev(const stats_channel_t* c) {
+    uint32_t sd_q = stats_isqrt(stats_variance_q(c));
+    return (sd_q + (1u << (STATS_HALF_BITS - 1))) >> STATS_HALF_BITS;
+}
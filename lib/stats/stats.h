@@ -0,0 +1,51 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+
+// ============================================================================
+// ESTATÍSTICAS DE UMA JANELA DE LEITURAS
+// ============================================================================
+// Agregador de fluxo por canal em memória constante: quantidade, mínimo,
+// máximo, última leitura, média e variância pelo método de Welford
+// (Welford, 1962), que atualiza média e soma dos quadrados dos desvios a cada
+// amostra sem o cancelamento de Σx² - (Σx)²/n.
+//
+// Tudo em inteiros (o Cortex-M0+ não tem FPU): as amostras são valores em
+// ponto fixo do próprio canal (centésimos de °C, Pa...), a média é guardada
+// com STATS_FRAC_BITS bits fracionários e a soma dos quadrados dos desvios
+// (M2) também. Desvios de até ±32767 unidades entre amostra e média usam o
+// produto completo; acima disso (até ±2^23) o produto perde 8 bits de cada
+// fator. M2 cabe em 64 bits até ~2^47 unidades² acumuladas, e a soma exata
+// das amostras que dá a média até 2^47 unidades somadas.
+//
+// O código não depende do Pico SDK e é usado também pelo gateway Linux.
+
+#define STATS_FRAC_BITS     16
+
+typedef struct {
+    uint32_t count;
+    int32_t min;
+    int32_t max;
+    int32_t last;
+    int64_t sum;            // Soma exata das amostras
+    int64_t mean_q;         // Média * 2^STATS_FRAC_BITS
+    int64_t m2_q;           // Soma dos quadrados dos desvios * 2^STATS_FRAC_BITS
+} stats_channel_t;
+
+// Esvazia o canal (início de uma nova janela)
+void stats_reset(stats_channel_t* c);
+
+// Acrescenta uma amostra em O(1)
+void stats_add(stats_channel_t* c, int32_t x);
+
+// Média arredondada para a unidade do canal (0 se vazio)
+int32_t stats_mean(const stats_channel_t* c);
+
+// Variância amostral (divisor n - 1) * 2^STATS_FRAC_BITS (0 com menos de 2 amostras)
+uint64_t stats_variance_q(const stats_channel_t* c);
+
+// Desvio padrão amostral arredondado para a unidade do canal
+uint32_t stats_stddev(const stats_channel_t* c);
+
+#endif // STATS_H
@@ -0,0 +1,130 @@
+#include <string.h>
+
+#include "tdma.h"
+
+// ============================================================================
+// ESCALA
+// ============================================================================
+
+void tdma_schedule_init(tdma_schedule_t* schedule, uint16_t stations, uint32_t toa_us, uint32_t guard_us) {
+    uint32_t slot = toa_us + 2 * guard_us;
+    schedule->slots = (uint16_t)(stations + 1);
+    schedule->slot_us = (slot + FRAME_BEACON_SLOT_UNIT_US - 1) / FRAME_BEACON_SLOT_UNIT_US * FRAME_BEACON_SLOT_UNIT_US;
+}
+
+uint64_t tdma_frame_us(const tdma_schedule_t* schedule) {
+    return (uint64_t)schedule->slots * schedule->slot_us;
+}
+
+uint16_t tdma_slot_of(const tdma_schedule_t* schedule, uint8_t station_id) {
+    uint16_t data_slots = schedule->slots - 1;
+    return (uint16_t)(1 + (station_id + data_slots - 1) % data_slots);
+}
+
+void tdma_beacon(const tdma_schedule_t* schedule, uint8_t gateway_id, uint16_t frame_number,
+                 frame_beacon_t* beacon) {
+    beacon->gateway_id = gateway_id;
+    beacon->frame_number = frame_number;
+    beacon->slots = schedule->slots;
+    beacon->slot_us = schedule->slot_us;
+}
+
+// ============================================================================
+// SINCRONISMO
+// ============================================================================
+
+void tdma_sync_init(tdma_sync_t* sync, bool track_drift, uint8_t max_missed) {
+    memset(sync, 0, sizeof(*sync));
+    sync->track_drift = track_drift;
+    sync->max_missed = max_missed;
+}
+
+// Duração do gateway convertida para o relógio local
+static int64_t tdma_local(const tdma_sync_t* sync, int64_t gateway_us) {
+    return gateway_us + gateway_us * sync->drift_ppb / 1000000000;
+}
+
+/**
+ * @brief Alinha o relógio local pelo beacon e atualiza a estimativa de deriva
+ *
+ * O início do quadro é o fim da recepção menos o tempo no ar do beacon. A
+ * deriva medida entre dois beacons entra em uma média exponencial (peso 1/4)
+ * para suavizar a latência de atendimento da IRQ.
+ */
+void tdma_sync_beacon(tdma_sync_t* sync, const frame_beacon_t* beacon,
+                      uint64_t rx_end_us, uint32_t beacon_toa_us) {
+    uint64_t start = rx_end_us - (uint64_t)tdma_local(sync, beacon_toa_us);
+    bool same = sync->locked &&
+                sync->schedule.slots == beacon->slots && sync->schedule.slot_us == beacon->slot_us;
+
+    if (!same) {
+        // Primeiro beacon ou escala nova: a deriva medida antes não vale mais
+        sync->drift_valid = false;
+        sync->drift_ppb = 0;
+    } else if (sync->track_drift) {
+        uint16_t frames = (uint16_t)(beacon->frame_number - sync->frame_number);
+        int64_t nominal = (int64_t)frames * (int64_t)tdma_frame_us(&sync->schedule);
+        if (frames > 0 && start > sync->frame_start_us) {
+            int64_t measured = (int64_t)(start - sync->frame_start_us);
+            int32_t ppb = (int32_t)((measured - nominal) * 1000000000 / nominal);
+            sync->drift_ppb = sync->drift_valid ? sync->drift_ppb + (ppb - sync->drift_ppb) / 4 : ppb;
+            sync->drift_valid = true;
+        }
+    }
+
+    sync->schedule.slots = beacon->slots;
+    sync->schedule.slot_us = beacon->slot_us;
+    sync->frame_number = beacon->frame_number;
+    sync->frame_start_us = start;
+    sync->locked = true;
+    sync->missed = 0;
+    sync->beacons++;
+}
+
+bool tdma_sync_missed(tdma_sync_t* sync) {
+    if (sync->missed < 0xFF) {
+        sync->missed++;
+    }
+    if (sync->missed > sync->max_missed) {
+        sync->locked = false;
+    }
+    return sync->locked;
+}
+
+bool tdma_sync_listen(const tdma_sync_t* sync, uint64_t frame_us, uint16_t every) {
+    if (!sync->locked || (sync->track_drift && !sync->drift_valid) || frame_us <= sync->frame_start_us) {
+        return true;
+    }
+    uint64_t frame = tdma_frame_us(&sync->schedule);
+    return (frame_us - sync->frame_start_us + frame / 2) / frame >= every;
+}
+
+/**
+ * @brief Primeiro instante frame_start + local(n * frame + offset) >= now
+ */
+static uint64_t tdma_next(const tdma_sync_t* sync, uint64_t offset_us, uint64_t now_us) {
+    int64_t frame = (int64_t)tdma_frame_us(&sync->schedule);
+    int64_t local_frame = tdma_local(sync, frame);
+    uint64_t n = 0;
+    if (now_us > sync->frame_start_us) {
+        n = (now_us - sync->frame_start_us) / (uint64_t)local_frame;
+    }
+    while (n > 0 && sync->frame_start_us + (uint64_t)tdma_local(sync, (int64_t)(n * frame + offset_us)) >= now_us) {
+        n--;
+    }
+    uint64_t t;
+    while ((t = sync->frame_start_us + (uint64_t)tdma_local(sync, (int64_t)(n * frame + offset_us))) < now_us) {
+        n++;
+    }
+    return t;
+}
+
+uint64_t tdma_next_frame_us(const tdma_sync_t* sync, uint64_t now_us) {
+    return tdma_next(sync, 0, now_us);
+}
+
+uint64_t tdma_next_slot_us(const tdma_sync_t* sync, uint16_t slot, uint32_t toa_us, uint64_t now_us) {
+    uint32_t slot_us = sync->schedule.slot_us;
+    uint64_t offset = (uint64_t)slot * slot_us + (toa_us < slot_us ? (slot_us - toa_us) / 2 : 0);
+    return tdma_next(sync, offset, now_us);
+}
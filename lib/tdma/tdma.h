@@ -0,0 +1,86 @@
+#ifndef TDMA_H
+#define TDMA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "frame.h"
+
+// ============================================================================
+// ESCALONAMENTO TDMA DAS ESTAÇÕES
+// ============================================================================
+// O canal é dividido em quadros de slots de mesma duração. O slot 0 é do
+// beacon do gateway; a estação de identificador id transmite no slot
+// 1 + (id - 1) % (slots - 1), com o pacote centrado no slot. A sobra de cada
+// lado do pacote é a margem de guarda contra erro de sincronismo.
+//
+// A duração do slot vem do tempo no ar do maior quadro da estação mais duas
+// guardas, e o quadro tem um slot por estação mais o do beacon. Assim o
+// período do quadro cresce com o tempo no ar e com o número de estações.
+//
+// O relógio da estação se alinha pelo instante de recepção do beacon, que o
+// gateway transmite no início do quadro. Entre dois beacons recebidos a
+// estação mede a deriva do seu cristal em relação ao gateway e corrige as
+// previsões, então pode escutar só um beacon a cada vários quadros sem
+// precisar de guardas grandes. Após max_missed beacons perdidos seguidos a
+// estação perde o sincronismo e para de transmitir até o próximo beacon.
+//
+// Os instantes são em µs do relógio local (time_us_64() no firmware). O
+// código não depende do Pico SDK e é usado também pelo gateway.
+
+// Escala e guardas de um quadro
+typedef struct {
+    uint16_t slots;             // Slots por quadro, incluindo o do beacon
+    uint32_t slot_us;
+} tdma_schedule_t;
+
+typedef struct {
+    tdma_schedule_t schedule;   // Escala anunciada pelo último beacon
+    bool locked;                // Sincronizado: pode transmitir
+    bool track_drift;           // Estima e corrige a deriva do relógio local
+    uint8_t max_missed;
+    uint8_t missed;             // Beacons perdidos seguidos
+    bool drift_valid;
+    int32_t drift_ppb;          // Relógio local em relação ao gateway (+ = adiantado)
+    uint16_t frame_number;      // Quadro do último beacon recebido
+    uint64_t frame_start_us;    // Início desse quadro no relógio local
+    uint32_t beacons;           // Beacons recebidos
+} tdma_sync_t;
+
+// Escala para stations estações com pacotes de até toa_us no ar e guard_us
+// de guarda de cada lado (slot arredondado para cima em FRAME_BEACON_SLOT_UNIT_US)
+void tdma_schedule_init(tdma_schedule_t* schedule, uint16_t stations, uint32_t toa_us, uint32_t guard_us);
+
+// Período do quadro
+uint64_t tdma_frame_us(const tdma_schedule_t* schedule);
+
+// Slot da estação
+uint16_t tdma_slot_of(const tdma_schedule_t* schedule, uint8_t station_id);
+
+// Beacon do gateway para o quadro frame_number
+void tdma_beacon(const tdma_schedule_t* schedule, uint8_t gateway_id, uint16_t frame_number,
+                 frame_beacon_t* beacon);
+
+void tdma_sync_init(tdma_sync_t* sync, bool track_drift, uint8_t max_missed);
+
+// Beacon recebido com RxDone em rx_end_us (relógio local); beacon_toa_us é o
+// tempo no ar do beacon
+void tdma_sync_beacon(tdma_sync_t* sync, const frame_beacon_t* beacon,
+                      uint64_t rx_end_us, uint32_t beacon_toa_us);
+
+// Beacon esperado e não recebido; false se o sincronismo foi perdido
+bool tdma_sync_missed(tdma_sync_t* sync);
+
+// true se a estação deve escutar o beacon do quadro que começa em frame_us:
+// todos enquanto não há sincronismo ou a deriva não foi medida, depois só
+// quando o último beacon recebido ficou every quadros ou mais para trás
+bool tdma_sync_listen(const tdma_sync_t* sync, uint64_t frame_us, uint16_t every);
+
+// Início (relógio local) do primeiro quadro que começa em now_us ou depois
+uint64_t tdma_next_frame_us(const tdma_sync_t* sync, uint64_t now_us);
+
+// Início da transmissão de um pacote de toa_us no próximo slot da estação
+// em now_us ou depois (o pacote fica centrado no slot)
+uint64_t tdma_next_slot_us(const tdma_sync_t* sync, uint16_t slot, uint32_t toa_us, uint64_t now_us);
+
+#endif // TDMA_H
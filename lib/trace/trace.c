@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "trace.h"
+
+#define TRACE_CALIBRATION_RUNS  1000
+
+static trace_hist_t histograms[TRACE_NUM_PHASES];
+static uint32_t overhead_ns;
+
+static const char* const phase_names[TRACE_NUM_PHASES] = {
+    "laco", "sensores", "aht20_disparo", "bmp280", "aht20_espera", "aht20_i2c",
+    "codificacao", "envio", "rfm95_fifo", "rfm95_txdone",
+};
+
+// ============================================================================
+// FAIXAS
+// ============================================================================
+
+/**
+ * @brief Faixa log-linear do valor
+ *
+ * Abaixo de 2 * TRACE_SUB_BUCKETS a faixa é o próprio valor. Acima, os
+ * TRACE_SUB_BITS bits seguintes ao bit mais significativo escolhem uma das
+ * faixas da potência de 2.
+ */
+uint32_t trace_bucket(uint32_t us) {
+    if (us < 2 * TRACE_SUB_BUCKETS) {
+        return us;
+    }
+    uint32_t msb = 31 - (uint32_t)__builtin_clz(us);
+    uint32_t shift = msb - TRACE_SUB_BITS;
+    return (shift + 1) * TRACE_SUB_BUCKETS + ((us >> shift) & (TRACE_SUB_BUCKETS - 1));
+}
+
+uint32_t trace_bucket_low(uint32_t bucket) {
+    if (bucket < 2 * TRACE_SUB_BUCKETS) {
+        return bucket;
+    }
+    uint32_t shift = bucket / TRACE_SUB_BUCKETS - 1;
+    return (TRACE_SUB_BUCKETS + bucket % TRACE_SUB_BUCKETS) << shift;
+}
+
+uint32_t trace_bucket_high(uint32_t bucket) {
+    if (bucket < 2 * TRACE_SUB_BUCKETS) {
+        return bucket;
+    }
+    uint32_t shift = bucket / TRACE_SUB_BUCKETS - 1;
+    return trace_bucket_low(bucket) + ((1u << shift) - 1);
+}
+
+// ============================================================================
+// HISTOGRAMAS
+// ============================================================================
+
+void trace_hist_clear(trace_hist_t* hist) {
+    memset(hist, 0, sizeof(*hist));
+}
+
+void trace_hist_add(trace_hist_t* hist, uint32_t us) {
+    if (hist->count == 0 || us < hist->min_us) hist->min_us = us;
+    if (us > hist->max_us) hist->max_us = us;
+    hist->buckets[trace_bucket(us)]++;
+    hist->count++;
+    hist->sum_us += us;
+}
+
+uint32_t trace_percentile(const trace_hist_t* hist, uint32_t per_mille) {
+    if (hist->count == 0) {
+        return 0;
+    }
+    // Posição (1..count) da amostra procurada
+    uint64_t rank = ((uint64_t)hist->count * per_mille + 999) / 1000;
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < TRACE_BUCKETS; b++) {
+        seen += hist->buckets[b];
+        if (seen >= rank) {
+            uint32_t low = trace_bucket_low(b), high = trace_bucket_high(b);
+            uint32_t value = low + (high - low) / 2;
+            if (value < hist->min_us) value = hist->min_us;
+            if (value > hist->max_us) value = hist->max_us;
+            return value;
+        }
+    }
+    return hist->max_us;
+}
+
+void trace_record(trace_phase_t phase, uint32_t us) {
+    trace_hist_add(&histograms[phase], us);
+}
+
+const trace_hist_t* trace_get(trace_phase_t phase) {
+    return &histograms[phase];
+}
+
+void trace_reset(void) {
+    for (int i = 0; i < TRACE_NUM_PHASES; i++) {
+        trace_hist_clear(&histograms[i]);
+    }
+}
+
+/**
+ * @brief Mede o custo de um par TRACE_BEGIN/TRACE_END
+ *
+ * Repete TRACE_CALIBRATION_RUNS vezes as duas leituras do timer e o registro
+ * em um histograma descartável; o tempo total em µs é o custo por par em ns.
+ */
+uint32_t trace_calibrate(void) {
+    static trace_hist_t scratch;
+    trace_hist_clear(&scratch);
+
+    uint32_t start = time_us_32();
+    for (int i = 0; i < TRACE_CALIBRATION_RUNS; i++) {
+        uint32_t t0 = time_us_32();
+        trace_hist_add(&scratch, time_us_32() - t0);
+    }
+    overhead_ns = (uint32_t)((uint64_t)(time_us_32() - start) * 1000 / TRACE_CALIBRATION_RUNS);
+    return overhead_ns;
+}
+
+void trace_dump(void) {
+    printf("@trace custo_ns %lu tempo_ms %lu\n", (unsigned long)overhead_ns,
+           (unsigned long)to_ms_since_boot(get_absolute_time()));
+    for (int i = 0; i < TRACE_NUM_PHASES; i++) {
+        const trace_hist_t* h = &histograms[i];
+        if (h->count == 0) {
+            continue;
+        }
+        printf("@trace %s %lu %lu %lu %llu", phase_names[i], (unsigned long)h->count,
+               (unsigned long)h->min_us, (unsigned long)h->max_us, (unsigned long long)h->sum_us);
+        for (uint32_t b = 0; b < TRACE_BUCKETS; b++) {
+            if (h->buckets[b]) {
+                printf(" %lu:%lu", (unsigned long)b, (unsigned long)h->buckets[b]);
+            }
+        }
+        printf("\n");
+    }
+}
+
+const char* trace_phase_name(trace_phase_t phase) {
+    return phase < TRACE_NUM_PHASES ? phase_names[phase] : "?";
+}
+
+trace_phase_t trace_phase_find(const char* name) {
+    for (int i = 0; i < TRACE_NUM_PHASES; i++) {
+        if (strcmp(name, phase_names[i]) == 0) {
+            return (trace_phase_t)i;
+        }
+    }
+    return TRACE_NUM_PHASES;
+}
@@ -0,0 +1,103 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pico/stdlib.h"
+
+// ============================================================================
+// HISTOGRAMAS DE LATÊNCIA POR FASE
+// ============================================================================
+// TRACE_BEGIN e TRACE_END marcam o início e o fim de uma fase com o timer de
+// 1 µs do RP2040 (time_us_32) e acumulam a duração em um histograma
+// log-linear de tamanho fixo. Até 15 µs o valor é exato; acima disso cada
+// potência de 2 é dividida em TRACE_SUB_BUCKETS faixas, então o erro
+// relativo fica abaixo de 12.5% em qualquer escala, com 240 contadores por
+// fase. Com TRACE_ENABLED = 0 (padrão) os macros não geram código.
+//
+// O registro tem custo constante: sem divisão, sem laço e sem trava. Cada
+// fase deve ser registrada por um só núcleo. trace_calibrate() mede no alvo
+// o custo de um par TRACE_BEGIN/TRACE_END, que trace_dump() informa junto
+// com os histogramas.
+//
+// Os histogramas são cumulativos desde o boot. trace_dump() os imprime no
+// console (USB) com uma linha por fase:
+//
+//   @trace custo_ns <ns> tempo_ms <ms>
+//   @trace <fase> <n> <min_us> <max_us> <soma_us> <faixa>:<contagem> ...
+//
+// e host/tools/trace_report converte essas linhas em percentis.
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 0
+#endif
+
+typedef enum {
+    TRACE_LOOP,             // Iteração do laço: leitura e envio
+    TRACE_SENSORS,          // read_sensors()
+    TRACE_AHT20_START,      // Disparo da conversão do AHT20
+    TRACE_BMP280,           // Conversão forçada, leitura e compensação do BMP280
+    TRACE_AHT20_WAIT,       // Espera pelo fim da conversão do AHT20, com a leitura
+    TRACE_AHT20_READ,       // Leitura I2C do status e dos dados do AHT20
+    TRACE_ENCODE,           // Quadro binário, lote, resumo ou JSON
+    TRACE_SEND,             // send_reading()
+    TRACE_RFM95_FIFO,       // Carga do FIFO do rádio
+    TRACE_RFM95_TX_WAIT,    // Espera pelo TxDone
+    TRACE_NUM_PHASES
+} trace_phase_t;
+
+#define TRACE_SUB_BITS      3
+#define TRACE_SUB_BUCKETS   (1u << TRACE_SUB_BITS)
+#define TRACE_BUCKETS       ((32 - TRACE_SUB_BITS) * TRACE_SUB_BUCKETS + TRACE_SUB_BUCKETS)
+
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t buckets[TRACE_BUCKETS];
+} trace_hist_t;
+
+#if TRACE_ENABLED
+#define TRACE_BEGIN(phase)  uint32_t trace_start_##phase = time_us_32()
+#define TRACE_END(phase)    trace_record((phase), time_us_32() - trace_start_##phase)
+#else
+#define TRACE_BEGIN(phase)  ((void)0)
+#define TRACE_END(phase)    ((void)0)
+#endif
+
+// Acumula uma duração no histograma da fase
+void trace_record(trace_phase_t phase, uint32_t us);
+
+// Histograma acumulado da fase
+const trace_hist_t* trace_get(trace_phase_t phase);
+
+// Zera todos os histogramas
+void trace_reset(void);
+
+// Mede o custo de um par TRACE_BEGIN/TRACE_END em ns
+uint32_t trace_calibrate(void);
+
+// Imprime os histogramas não vazios no console
+void trace_dump(void);
+
+const char* trace_phase_name(trace_phase_t phase);
+
+// Fase pelo nome impresso em trace_dump(); TRACE_NUM_PHASES se não existir
+trace_phase_t trace_phase_find(const char* name);
+
+// Histograma avulso: zera e acumula
+void trace_hist_clear(trace_hist_t* hist);
+void trace_hist_add(trace_hist_t* hist, uint32_t us);
+
+// Faixa de um valor e limites (inclusivos) de uma faixa
+uint32_t trace_bucket(uint32_t us);
+uint32_t trace_bucket_low(uint32_t bucket);
+uint32_t trace_bucket_high(uint32_t bucket);
+
+// Percentil em milésimos (500 = mediana, 999 = p99.9): meio da faixa em que
+// cai, limitado ao mínimo e ao máximo observados
+uint32_t trace_percentile(const trace_hist_t* hist, uint32_t per_mille);
+
+#endif // TRACE_H
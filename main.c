@@ -6,6 +6,32 @@
 #include "rfm95.h"
 #include "bmp280.h"
 #include "aht20.h"
+#include "frame.h"
+#include "json.h"
+#include "power.h"
+#include "stats.h"
+#include "report.h"
+#include "flashlog.h"
+#include "arq.h"
+#include "tdma.h"
+#include "trace.h"
+
+// === PIPELINE EM DOIS NÚCLEOS ===
+// core1 lê os sensores em período fixo e entrega as amostras ao core0 por uma
+// fila sem trava; core0 codifica e transmite. Assim o tempo no ar e a espera
+// do rádio não atrasam o instante das leituras. Opcional (-DDUAL_CORE=ON no
+// CMake); o build host compila sempre com DUAL_CORE=0, pois o relógio
+// virtual do simulador tem uma única thread.
+#ifndef DUAL_CORE
+#define DUAL_CORE 0
+#endif
+
+#if DUAL_CORE
+#include "pico/multicore.h"
+#include "pico/flash.h"
+#include "hardware/sync.h"
+#include "spsc.h"
+#endif
 
 // === DEFINIÇÕES DE PINOS E CONSTANTES DOS SENSORES ===
 #define I2C_PORT_SENSORS i2c0
@@ -15,69 +41,791 @@
 #define I2C_SDA_DISP 14
 #define I2C_SCL_DISP 15
 
+// === PERÍODO DE AMOSTRAGEM ===
+#define SAMPLE_PERIOD_MS 2000       // Intervalo entre leituras dos sensores
+#define SAMPLE_QUEUE_SIZE 16        // Amostras em trânsito entre core1 e core0 (potência de 2)
+
+// === PERFIL DO BMP280 ===
+// Modo forçado: uma conversão por leitura em vez de conversões contínuas
+#define BMP280_PROFILE bmp280_profile_standard
+
+// === CONFIGURAÇÃO DO PAYLOAD ===
+#define STATION_ID 1            // Identificador da estação no quadro binário
+#define USE_JSON_PAYLOAD 0      // 1 = JSON em ASCII (formato antigo), 0 = quadro binário
+
+// === LOTES DE LEITURAS (somente quadro binário) ===
+#define BATCH_SAMPLES 1             // Leituras por pacote (1 = um pacote por leitura)
+#define BATCH_MAX_AGE_MS 60000      // Idade máxima da leitura mais antiga antes do envio
+
+// === RESUMO DE JANELA (somente quadro binário) ===
+// Amostra a cada SAMPLE_PERIOD_MS e transmite, a cada SUMMARY_SAMPLES
+// leituras, um único quadro com última, média, mínimo, máximo e desvio padrão
+#define SUMMARY_SAMPLES 1           // Leituras por resumo (1 = um quadro por leitura)
+
+#if SUMMARY_SAMPLES > 1 && BATCH_SAMPLES > 1
+#error "SUMMARY_SAMPLES e BATCH_SAMPLES são alternativos"
+#endif
+
+// === RELATO POR EXCEÇÃO ===
+// Só transmite a leitura quando algum canal sai da banda morta em torno do
+// último valor enviado, ou após REPORT_HEARTBEAT_MS em silêncio
+#define REPORT_ON_DELTA 0               // 1 = relato por exceção, 0 = toda leitura
+#define REPORT_DEADBAND_TEMP 10         // Centésimos de °C
+#define REPORT_DEADBAND_HUMIDITY 50     // Centésimos de %RH
+#define REPORT_DEADBAND_PRESSURE 10     // Pa
+#define REPORT_DEADBAND_PPM 0           // Banda relativa ao último valor, em todos os canais
+#define REPORT_MIN_INTERVAL_MS 0        // Intervalo mínimo entre envios
+#define REPORT_HEARTBEAT_MS 300000      // Silêncio máximo
+
+#if REPORT_ON_DELTA && SUMMARY_SAMPLES > 1
+#error "REPORT_ON_DELTA não se aplica aos resumos de janela"
+#endif
+
+// === ARMAZENAMENTO LOCAL (somente quadro de leitura avulsa) ===
+// Leituras que o rádio não aceitou ficam no log circular dos últimos setores
+// da flash e seguem em lotes, depois das leituras novas, quando ele volta
+#define STORE_AND_FORWARD 0         // 1 = guarda na flash as leituras não transmitidas
+#define STORE_DRAIN_BATCH 16        // Leituras do log por quadro de lote
+
+#if STORE_AND_FORWARD && (USE_JSON_PAYLOAD || BATCH_SAMPLES > 1 || SUMMARY_SAMPLES > 1)
+#error "STORE_AND_FORWARD usa o quadro de leitura avulsa"
+#endif
+
+// === ENTREGA CONFIRMADA (somente quadro binário) ===
+// Depois de cada transmissão o rádio escuta por ARQ_RX_WINDOW_MS a
+// confirmação do gateway, com o mapa das últimas sequências recebidas; só os
+// quadros que faltam são retransmitidos, com espera crescente entre tentativas
+#define RELIABLE_LINK 0                 // 1 = confirmação e retransmissão seletiva
+#define ARQ_WINDOW 16                   // Quadros aguardando confirmação (1 = pare e espere)
+#define ARQ_MAX_TRIES 8                 // Transmissões por quadro antes de desistir
+#define ARQ_TIMEOUT_MS SAMPLE_PERIOD_MS // Espera antes da 1ª retransmissão; dobra a cada tentativa
+#define ARQ_BACKOFF_MAX_MS (8 * SAMPLE_PERIOD_MS)
+#define ARQ_RX_WINDOW_MS 100            // Atraso do gateway + tempo no ar da confirmação
+#define ARQ_MAX_PER_CYCLE 4             // Transmissões por ciclo
+
+#if RELIABLE_LINK && USE_JSON_PAYLOAD
+#error "RELIABLE_LINK usa o número de sequência do quadro binário"
+#endif
+
+// === ESCALONAMENTO TDMA (somente quadro binário) ===
+// O gateway transmite um beacon no início de cada quadro, no slot 0; a
+// estação acumula as leituras em um lote e o transmite no seu slot, derivado
+// de STATION_ID. Depois de medir a deriva do cristal, só escuta um beacon a
+// cada TDMA_BEACON_EVERY quadros. O gateway monta a escala com os mesmos
+// TDMA_STATIONS, TDMA_GUARD_US e TDMA_BATCH_MAX
+#define TDMA_SLOTTED 0              // 1 = transmite só no slot da estação
+#define TDMA_STATIONS 32            // Slots de dados por quadro
+#define TDMA_GUARD_US 2000          // Guarda de cada lado do pacote
+#define TDMA_BEACON_EVERY 8         // Quadros entre beacons escutados com a deriva medida
+#define TDMA_MAX_MISSED 3           // Beacons perdidos seguidos antes de perder o sincronismo
+#define TDMA_BATCH_MAX 4            // Leituras por lote (dimensiona o slot)
+
+#if TDMA_SLOTTED && (USE_JSON_PAYLOAD || BATCH_SAMPLES > 1 || SUMMARY_SAMPLES > 1 || \
+                     REPORT_ON_DELTA || STORE_AND_FORWARD || RELIABLE_LINK)
+#error "TDMA_SLOTTED monta o seu próprio lote de leituras avulsas"
+#endif
+
+// === INSTRUMENTAÇÃO ===
+// Com TRACE_ENABLED (opção TRACE do CMake), a duração de cada fase do laço e
+// dos drivers vai para histogramas impressos no console a cada TRACE_DUMP_MS
+#define TRACE_DUMP_MS 60000
+
+// === LIMITE DE TEMPO NO AR ===
+#define AIRTIME_DUTY_PPM 0          // Duty cycle máximo em ppm (0 = sem limite; 10000 = 1% em 868 MHz)
+#define AIRTIME_BURST_US 1000000    // Tempo no ar liberado de uma vez com o orçamento cheio
+
 // === DADOS DOS SENSORES ===
-float temperatura;
-int32_t pressao;
-float umidade;
+int16_t temperatura;    // Centésimos de °C (média AHT20 + BMP280)
+int32_t pressao;        // kPa
+uint16_t umidade;       // Centésimos de %RH
+
+// Leitura dos sensores com o instante em que foi feita
+typedef struct {
+    uint32_t time_ms;           // to_ms_since_boot() no momento da leitura
+    uint8_t fields;             // FRAME_FIELD_* válidos
+    int16_t temperatura;        // Centésimos de °C
+    uint16_t umidade;           // Centésimos de %RH
+    int32_t pressure_pa;        // Pa
+} amostra_t;
+
+// === ESTRUTURAS DE DADOS DOS SENSORES ===
+static struct bmp280_calib_param params;
+static AHT20_Fixed aht20_data;
+#if !USE_JSON_PAYLOAD
+static uint16_t sequencia;      // Número de sequência do quadro binário
+#endif
+#if !USE_JSON_PAYLOAD && BATCH_SAMPLES > 1
+static frame_batch_t lote;      // Leituras aguardando envio
+#endif
+#if !USE_JSON_PAYLOAD && SUMMARY_SAMPLES > 1
+static stats_channel_t janela[3];   // Temperatura, umidade e pressão da janela atual
+static uint16_t janela_leituras;
+static uint32_t janela_inicio_ms;
+#endif
+#if REPORT_ON_DELTA
+static const report_config_t relato_config = {
+    .deadband = {
+        { REPORT_DEADBAND_TEMP, REPORT_DEADBAND_PPM },
+        { REPORT_DEADBAND_HUMIDITY, REPORT_DEADBAND_PPM },
+        { REPORT_DEADBAND_PRESSURE, REPORT_DEADBAND_PPM },
+    },
+    .min_interval_ms = REPORT_MIN_INTERVAL_MS,
+    .heartbeat_ms = REPORT_HEARTBEAT_MS,
+};
+static report_state_t relato;   // Último valor enviado de cada canal
+#endif
+#if STORE_AND_FORWARD
+static flashlog_t armazenamento;    // Leituras aguardando reenvio
+static frame_batch_t lote_armazenado;
+#endif
+#if RELIABLE_LINK
+static const arq_config_t arq_config = {
+    .window = ARQ_WINDOW,
+    .max_tries = ARQ_MAX_TRIES,
+    .timeout_ms = ARQ_TIMEOUT_MS,
+    .backoff_max_ms = ARQ_BACKOFF_MAX_MS,
+};
+static arq_sender_t enlace;     // Quadros aguardando confirmação
+#if STORE_AND_FORWARD
+static uint16_t lote_armazenado_seq;    // Sequência do lote do log na janela
+static int lote_armazenado_leituras;    // Leituras desse lote (0 = nenhum)
+#endif
+#endif
+#if TDMA_SLOTTED
+static tdma_sync_t sincronismo;     // Alinhamento ao beacon do gateway
+static frame_batch_t lote_tdma;     // Leituras aguardando o slot
+static uint32_t beacon_toa_us;
+#endif
+#if DUAL_CORE
+static amostra_t fila_amostras[SAMPLE_QUEUE_SIZE];
+static spsc_queue_t fila;       // core1 (produtor) -> core0 (consumidor)
+static volatile uint32_t amostras_descartadas;
+#endif
 
-// === PROTÓTIPO DA FUNÇÃO DE INICIALIZAÇÃO ===
-void setup();
+// === PROTÓTIPOS DAS FUNÇÕES ===
+bool setup();
+void loop();
+static void read_sensors(amostra_t* amostra);
+static void send_reading(const amostra_t* amostra);
+#if !USE_JSON_PAYLOAD
+static void sequence_accepted(const uint8_t* quadro, int length);
+#endif
+#if !USE_JSON_PAYLOAD && SUMMARY_SAMPLES > 1
+static int encode_summary(const amostra_t* amostra, uint8_t* buffer, int size);
+#endif
+#if STORE_AND_FORWARD
+static void store_reading(const amostra_t* amostra);
+static void drain_stored(void);
+#endif
+#if RELIABLE_LINK
+static void service_link(void);
+static void link_result(void* ctx, const arq_frame_t* quadro, bool entregue);
+#endif
+#if TDMA_SLOTTED
+static void tdma_service(absolute_time_t ate);
+static bool tdma_receive_beacon(uint64_t fim_us);
+#endif
+#if TRACE_ENABLED
+static void dump_traces(void);
+#endif
+#if DUAL_CORE
+static void core1_main(void);
+#endif
 
 // ========================================================================
 // FUNÇÃO PRINCIPAL
 // ========================================================================
 int main() {
 
-    // Inicialização do módulo LoRa e do sistema
-    setup();
-
-    if(!rfm95_initialize()) {
-        printf("RFM95 initialization failed!\n");
+    // Inicialização do sistema, dos sensores e do módulo LoRa
+    if (!setup()) {
         return 1;
     }
 
-    printf("RFM95 initialized successfully!\n");
-    rfm95_set_tx_power(17); // Define potência de transmissão (2-17 dBm)
+#if DUAL_CORE
+    // core0: codifica e transmite o que o core1 colocou na fila
+    spsc_init(&fila, fila_amostras, SAMPLE_QUEUE_SIZE, sizeof(amostra_t));
+    power_set_num_cores(2);                         // Sono da CPU só com os dois dormindo
+    multicore_launch_core1(core1_main);
 
-    // Inicialização das estruturas de dados para os sensores
-    struct bmp280_calib_param params;
-    bmp280_get_calib_params(I2C_PORT_SENSORS, &params);
+    while (true) {
+        amostra_t amostra;
+        while (spsc_pop(&fila, &amostra)) {
+            TRACE_BEGIN(TRACE_SEND);
+            send_reading(&amostra);
+            TRACE_END(TRACE_SEND);
+        }
+#if RELIABLE_LINK
+        service_link();                             // Transmissões e retransmissões vencidas
+#endif
+#if TDMA_SLOTTED
+        tdma_service(make_timeout_time_ms(SAMPLE_PERIOD_MS));  // Beacons e slots até a próxima amostra
+#endif
+#if TRACE_ENABLED
+        dump_traces();
+#endif
+        power_radio_sleep();                        // Rádio em Sleep até a próxima amostra
+        power_cpu_wait_event();                     // Sono profundo até o __sev() do core1
+    }
+#else
+    // Período fixo: o próximo ciclo é contado a partir do anterior
+    absolute_time_t proxima = get_absolute_time();
+    while (true) {
+        loop();
+        proxima = delayed_by_ms(proxima, SAMPLE_PERIOD_MS);
+#if TDMA_SLOTTED
+        tdma_service(proxima);                      // Beacons e slots até a próxima leitura
+#endif
+        power_sleep_until(proxima);                 // Rádio em Sleep e CPU em sono profundo
+    }
+#endif
+}
+
+// ========================================================================
+// LOOP DE AQUISIÇÃO E TRANSMISSÃO
+// ========================================================================
 
-    AHT20_Data aht20_data;
+/**
+ * @brief Executa uma iteração de leitura dos sensores e transmissão LoRa
+ */
+void loop() {
+    TRACE_BEGIN(TRACE_LOOP);
+    amostra_t amostra;
+    read_sensors(&amostra);
+    TRACE_BEGIN(TRACE_SEND);
+    send_reading(&amostra);
+    TRACE_END(TRACE_SEND);
+#if RELIABLE_LINK
+    service_link();                                 // Transmissões e retransmissões vencidas
+#endif
+    TRACE_END(TRACE_LOOP);
+#if TRACE_ENABLED
+    dump_traces();
+#endif
+}
+
+#if DUAL_CORE
+/**
+ * @brief Laço de aquisição do core1
+ * 
+ * O próximo instante de leitura é calculado a partir do anterior, e não do
+ * fim da leitura, então o período não acumula o tempo gasto nos sensores.
+ * Se o core0 ficar para trás e a fila encher, a amostra é descartada.
+ */
+static void core1_main(void) {
+    absolute_time_t proxima = get_absolute_time();
+
+#if STORE_AND_FORWARD
+    flash_safe_execute_core_init();                // O core0 grava na flash
+#endif
+
+    while (true) {
+        amostra_t amostra;
+        read_sensors(&amostra);
+        if (!spsc_push(&fila, &amostra)) {
+            amostras_descartadas++;
+        }
+        __sev();                                    // Avisa o core0
+
+        proxima = delayed_by_ms(proxima, SAMPLE_PERIOD_MS);
+        power_cpu_sleep_until(proxima);
+    }
+}
+#endif
+
+/**
+ * @brief Lê o BMP280 durante a conversão do AHT20
+ * 
+ * @param amostra Leitura com o instante em que foi feita
+ */
+static void read_sensors(amostra_t* amostra) {
     int32_t raw_temp_bmp;
     int32_t raw_pressure;
 
-    char buffer[64];
+    TRACE_BEGIN(TRACE_SENSORS);
+    amostra->time_ms = to_ms_since_boot(get_absolute_time());
+
+    // === DISPARO DO AHT20 ===
+    // A conversão (~80 ms) corre enquanto o BMP280 é lido
+    TRACE_BEGIN(TRACE_AHT20_START);
+    bool aht20_ok = aht20_start_measurement(I2C_PORT_SENSORS);
+    TRACE_END(TRACE_AHT20_START);
+
+    // === LEITURA DO SENSOR BMP280 ===
+    // Conversão forçada; espera o tempo máximo do perfil (~13 ms no padrão)
+    uint8_t fields = FRAME_FIELDS_ALL;
+    int32_t temperature_bmp = 0;
+    int32_t pressure_pa = 0;
+    TRACE_BEGIN(TRACE_BMP280);
+    bool bmp280_ok = bmp280_measure(I2C_PORT_SENSORS, &raw_temp_bmp, &raw_pressure);
+    if (bmp280_ok) {
+        bmp280_reading_t bmp;
+        bmp280_compensate(raw_temp_bmp, raw_pressure, &params, &bmp);    // t_fine calculado uma vez
+        temperature_bmp = bmp.temperature;                                  // Centésimos de °C
+        pressure_pa = (int32_t)bmp.pressure;                                // Pa
+    }
+    else {
+        printf("Erro ao ler BMP280\n");
+        fields &= ~FRAME_FIELD_PRESSURE;
+    }
+    TRACE_END(TRACE_BMP280);
+    pressao = pressure_pa / 1000; // kPa
+
+    // === LEITURA DO SENSOR AHT20 ===
+    // Tudo em centésimos e com inteiros: o Cortex-M0+ não tem FPU
+    if (aht20_ok && aht20_collect_fixed(I2C_PORT_SENSORS, &aht20_data)) {
+        temperatura = bmp280_ok
+            ? (int16_t)((aht20_data.temperature + temperature_bmp) / 2)   // Média das temperaturas
+            : aht20_data.temperature;
+        umidade = aht20_data.humidity > 10000 ? 10000 : aht20_data.humidity; // Limita a umidade a 100%
+    }
+    else {
+        printf("Erro ao ler AHT20\n");
+        temperatura = 0;
+        umidade = 0;
+        fields &= FRAME_FIELD_PRESSURE;            // Envia apenas a pressão
+    }
+
+    amostra->fields = fields;
+    amostra->temperatura = temperatura;
+    amostra->umidade = umidade;
+    amostra->pressure_pa = pressure_pa;
+    TRACE_END(TRACE_SENSORS);
+}
+
+/**
+ * @brief Codifica uma leitura e a transmite via LoRa (ou a acumula no lote)
+ * 
+ * @param amostra Leitura feita por read_sensors()
+ */
+static void send_reading(const amostra_t* amostra) {
+    uint8_t buffer[64];
+    const uint8_t* payload = buffer;
+    int length;
+
+#if REPORT_ON_DELTA
+    // Leitura dentro da banda morta de todos os canais: nada a transmitir
+    const int32_t valores[REPORT_CHANNELS] = { amostra->temperatura, amostra->umidade, amostra->pressure_pa };
+    if (report_decide(&relato, valores, amostra->fields, amostra->time_ms) == REPORT_SKIP) {
+        return;
+    }
+#endif
+
+    // Só as codificações que terminam em um quadro a transmitir são medidas
+    TRACE_BEGIN(TRACE_ENCODE);
+#if USE_JSON_PAYLOAD
+    // Mesmo texto do antigo snprintf com %.2f, gerado direto dos centésimos
+    length = json_encode(amostra->temperatura, amostra->pressure_pa / 1000, amostra->umidade,
+                         buffer, sizeof(buffer));
+#elif SUMMARY_SAMPLES > 1
+    // Só transmite quando a janela fecha: um quadro por SUMMARY_SAMPLES leituras
+    length = encode_summary(amostra, buffer, sizeof(buffer));
+    if (length == 0) {
+        return;
+    }
+#else
+    // Quadro binário em ponto fixo (11 bytes)
+    frame_reading_t reading = {
+        .station_id = STATION_ID,
+        .sequence = sequencia,                     // Avança só com o quadro aceito
+        .fields = amostra->fields,
+        .temperature = amostra->temperatura,       // Centésimos de °C
+        .humidity = amostra->umidade,              // Centésimos de %RH
+        .pressure = (uint32_t)amostra->pressure_pa,
+    };
+#if TDMA_SLOTTED
+    // O lote vai ao ar no próximo slot da estação, em tdma_service()
+    if (lote_tdma.count == 0) {
+        frame_batch_init(&lote_tdma, STATION_ID);
+    }
+    if (lote_tdma.count >= TDMA_BATCH_MAX || !frame_batch_add(&lote_tdma, &reading, amostra->time_ms)) {
+        printf("Lote TDMA cheio, leitura descartada\n");
+    }
+    return;
+#elif BATCH_SAMPLES > 1
+    // Acumula a leitura e só transmite quando o lote atinge BATCH_SAMPLES
+    // leituras, a mais antiga passa de BATCH_MAX_AGE_MS ou o quadro enche
+    uint32_t agora = to_ms_since_boot(get_absolute_time());
+    if (lote.count == 0) {
+        frame_batch_init(&lote, STATION_ID);
+    }
+    frame_batch_add(&lote, &reading, amostra->time_ms);
+#if REPORT_ON_DELTA
+    report_commit(&relato, valores, amostra->fields, amostra->time_ms);
+#endif
+    if (lote.count < BATCH_SAMPLES &&
+        agora - lote.time_ms[0] < BATCH_MAX_AGE_MS &&
+        !frame_batch_full(&lote)) {
+        return;
+    }
+    length = frame_batch_finish(&lote, agora);
+    lote.count = 0;
+    payload = lote.data;
+#else
+    length = frame_encode(&reading, buffer, sizeof(buffer));
+#endif
+#endif
+    TRACE_END(TRACE_ENCODE);
+
+#if RELIABLE_LINK
+    // O quadro entra na janela de retransmissão e vai ao ar em service_link();
+    // sai dela com a confirmação do gateway ou após ARQ_MAX_TRIES tentativas
+    if (!arq_sender_push(&enlace, payload, (uint8_t)length, to_ms_since_boot(get_absolute_time()))) {
+#if STORE_AND_FORWARD
+        store_reading(amostra);
+#else
+        printf("Janela de retransmissão cheia, leitura descartada\n");
+#endif
+        return;
+    }
+#else
+    // Transmissão dos dados via LoRa sem bloquear: o pacote fica no ar
+    // enquanto o laço segue (TxDone é sinalizado pela IRQ do DIO0)
+    rfm95_transmit_wait();                         // Pacote anterior ainda no ar?
+    if (!rfm95_transmit_async(payload, length, NULL)) {
+#if STORE_AND_FORWARD
+        store_reading(amostra);
+#else
+        printf("Duty cycle esgotado, leitura descartada\n");
+#endif
+        return;
+    }
+#endif
+#if !USE_JSON_PAYLOAD
+    sequence_accepted(payload, length);
+#endif
+#if REPORT_ON_DELTA && BATCH_SAMPLES <= 1
+    // Só conta como enviada a leitura que foi ao ar; a descartada volta a
+    // ser comparada no próximo ciclo
+    report_commit(&relato, valores, amostra->fields, amostra->time_ms);
+#endif
+#if STORE_AND_FORWARD
+    drain_stored();
+#endif
+}
+
+#if !USE_JSON_PAYLOAD
+/**
+ * @brief Consome as sequências de um quadro aceito pelo rádio ou pela janela
+ * 
+ * Os quadros são codificados com a próxima sequência sem consumi-la: um
+ * recusado pelo duty cycle ou pela janela cheia a repete no próximo, e o
+ * gateway não conta como perdido um número que nunca foi ao ar.
+ */
+static void sequence_accepted(const uint8_t* quadro, int length) {
+    uint16_t primeira;
+    int span = frame_sequence_span(quadro, length, &primeira);
+    if (span > 0) {
+        sequencia = (uint16_t)(primeira + span);
+    }
+}
+#endif
+
+#if STORE_AND_FORWARD
+/**
+ * @brief Guarda no log da flash uma leitura que não foi ao ar
+ */
+static void store_reading(const amostra_t* amostra) {
+    flashlog_record_t registro = {
+        .time_ms = amostra->time_ms,
+        .fields = amostra->fields,
+        .temperature = amostra->temperatura,
+        .humidity = amostra->umidade,
+        .pressure = (uint32_t)amostra->pressure_pa,
+    };
+    if (!flashlog_append(&armazenamento, &registro)) {
+        printf("Falha ao gravar na flash, leitura descartada\n");
+    }
+}
+
+/**
+ * @brief Reenvia as leituras mais antigas do log em um quadro de lote
+ * 
+ * Chamado depois que uma leitura nova foi aceita pelo rádio, ou seja, com o
+ * enlace disponível; envia no máximo um lote por ciclo. As leituras só saem
+ * do log se o lote também for aceito (com RELIABLE_LINK, quando o gateway o
+ * confirma). As de um boot anterior não têm instante comparável ao relógio
+ * atual e vão com a idade máxima do quadro.
+ */
+static void drain_stored(void) {
+    if (flashlog_pending(&armazenamento) == 0) {
+        return;
+    }
+#if RELIABLE_LINK
+    if (lote_armazenado_leituras > 0) {
+        return;                                    // Lote anterior ainda sem confirmação
+    }
+#endif
+    flashlog_record_t registros[STORE_DRAIN_BATCH];
+    int n = flashlog_peek(&armazenamento, registros, STORE_DRAIN_BATCH);
+    uint32_t agora = to_ms_since_boot(get_absolute_time());
+
+    frame_batch_init(&lote_armazenado, STATION_ID);
+    int adicionadas = 0;
+    for (; adicionadas < n; adicionadas++) {
+        const flashlog_record_t* r = &registros[adicionadas];
+        frame_reading_t reading = {
+            .station_id = STATION_ID,
+            .sequence = (uint16_t)(sequencia + adicionadas),
+            .fields = r->fields,
+            .temperature = r->temperature,
+            .humidity = r->humidity,
+            .pressure = r->pressure,
+        };
+        uint32_t instante = r->boot == armazenamento.boot
+            ? r->time_ms
+            : agora - 0xFFFFu * FRAME_BATCH_AGE_UNIT_MS;
+        if (!frame_batch_add(&lote_armazenado, &reading, instante)) {
+            break;
+        }
+    }
+    int length = frame_batch_finish(&lote_armazenado, agora);
+
+#if RELIABLE_LINK
+    // Sai do log quando o gateway confirmar (link_result)
+    if (arq_sender_push(&enlace, lote_armazenado.data, (uint8_t)length, agora)) {
+        lote_armazenado_seq = sequencia;
+        lote_armazenado_leituras = adicionadas;
+        sequencia += adicionadas;
+    }
+#else
+    rfm95_transmit_wait();                         // Leitura nova ainda no ar
+    if (rfm95_transmit_async(lote_armazenado.data, length, NULL)) {
+        sequencia += adicionadas;
+        flashlog_consume(&armazenamento, adicionadas);
+    }
+#endif
+}
+#endif
+
+#if RELIABLE_LINK
+/**
+ * @brief Transmite os quadros da janela cuja vez chegou e recebe as confirmações
+ * 
+ * Cada transmissão é seguida de uma janela de recepção de ARQ_RX_WINDOW_MS,
+ * encerrada assim que a confirmação chega; uma confirmação pode liberar
+ * vários quadros e antecipar a retransmissão dos que faltam. Com o duty cycle
+ * esgotado, os quadros ficam para o próximo ciclo.
+ */
+static void service_link(void) {
+    for (int i = 0; i < ARQ_MAX_PER_CYCLE; i++) {
+        const arq_frame_t* quadro = arq_sender_due(&enlace, to_ms_since_boot(get_absolute_time()));
+        if (quadro == NULL) {
+            break;
+        }
+        rfm95_transmit_wait();
+        if (!rfm95_transmit_async(quadro->data, quadro->length, NULL)) {
+            break;
+        }
+        arq_sender_sent(&enlace, quadro, to_ms_since_boot(get_absolute_time()));
+        rfm95_transmit_wait();
+
+        absolute_time_t fim = make_timeout_time_ms(ARQ_RX_WINDOW_MS);
+        while (!time_reached(fim)) {
+            uint8_t dados[16];
+            frame_ack_t ack;
+            int n = rfm95_receive(dados, sizeof(dados));
+            if (n > 0 && frame_decode_ack(dados, n, &ack) && ack.station_id == STATION_ID) {
+                arq_sender_ack(&enlace, &ack, to_ms_since_boot(get_absolute_time()));
+                break;
+            }
+            sleep_ms(1);
+        }
+        rfm95_set_idle_mode();
+    }
+}
+
+/**
+ * @brief Resultado de um quadro da janela: confirmado ou descartado
+ * 
+ * O lote tirado do log só é consumido com a confirmação; se for descartado,
+ * as leituras continuam no log e seguem em um lote novo. Uma leitura nova
+ * descartada vai para o log (a pressão volta arredondada para decapascal).
+ */
+static void link_result(void* ctx, const arq_frame_t* quadro, bool entregue) {
+    (void)ctx;
+#if STORE_AND_FORWARD
+    if (lote_armazenado_leituras > 0 && quadro->sequence == lote_armazenado_seq) {
+        if (entregue) {
+            flashlog_consume(&armazenamento, lote_armazenado_leituras);
+        }
+        lote_armazenado_leituras = 0;
+        return;
+    }
+    // Leitura nova sem confirmação: volta para o log, com o instante em que
+    // entrou na janela (logo após a leitura)
+    frame_reading_t reading;
+    if (!entregue && frame_decode(quadro->data, quadro->length, &reading)) {
+        amostra_t amostra = {
+            .time_ms = quadro->queued_ms,
+            .fields = reading.fields,
+            .temperatura = reading.temperature,
+            .umidade = reading.humidity,
+            .pressure_pa = (int32_t)reading.pressure,
+        };
+        store_reading(&amostra);
+        return;
+    }
+#endif
+    if (!entregue) {
+        printf("Quadro %u sem confirmação, descartado\n", (unsigned)quadro->sequence);
+    }
+}
+#endif
+
+#if TDMA_SLOTTED
+/**
+ * @brief Escuta beacons e transmite o lote no slot da estação até ate
+ * 
+ * Sem sincronismo, o rádio fica em RX contínuo até ate procurando o beacon.
+ * Sincronizada, a estação dorme até a janela do beacon (aberta uma guarda
+ * antes do início previsto do quadro e fechada no fim do slot 0), quando
+ * tdma_sync_listen() pede, e até o seu slot, quando há leituras no lote. Um
+ * evento que não termina antes de ate fica para a próxima chamada.
+ */
+static void tdma_service(absolute_time_t ate) {
+    uint64_t limite = to_us_since_boot(ate);
 
     while (true) {
+        uint64_t agora = time_us_64();
+        if (!sincronismo.locked) {
+            if (!tdma_receive_beacon(limite)) {
+                return;
+            }
+            continue;
+        }
 
-        // === LEITURA DO SENSOR BMP280 ===
-        bmp280_read_raw(I2C_PORT_SENSORS, &raw_temp_bmp, &raw_pressure);
-        int32_t temperature_bmp = bmp280_convert_temp(raw_temp_bmp, &params); 
-        pressao = (bmp280_convert_pressure(raw_pressure, raw_temp_bmp, &params) / 1000); // kPa
+        uint32_t slot_us = sincronismo.schedule.slot_us;
+        uint64_t quadro = tdma_next_frame_us(&sincronismo, agora + TDMA_GUARD_US);
+        uint64_t envio = UINT64_MAX;
+        uint32_t toa_us = 0;
+        if (lote_tdma.count > 0) {
+            toa_us = rfm95_time_on_air_us((uint8_t)lote_tdma.length);
+            envio = tdma_next_slot_us(&sincronismo, tdma_slot_of(&sincronismo.schedule, STATION_ID),
+                                      toa_us, agora);
+        }
 
-        // === LEITURA DO SENSOR AHT20 ===
-        if (aht20_read(I2C_PORT_SENSORS, &aht20_data)) {
-            temperatura = ((aht20_data.temperature + (temperature_bmp / 100.0)) / 2.0); // Média das temperaturas
-            umidade = (aht20_data.humidity) > 100 ? 100 : (aht20_data.humidity); // Limita a umidade a 100%
+        if (quadro - TDMA_GUARD_US < envio &&
+            tdma_sync_listen(&sincronismo, quadro, TDMA_BEACON_EVERY)) {
+            if (quadro + slot_us > limite) {
+                return;
+            }
+            power_cpu_sleep_until(from_us_since_boot(quadro - TDMA_GUARD_US));
+            if (!tdma_receive_beacon(quadro + slot_us) && !tdma_sync_missed(&sincronismo)) {
+                printf("Sincronismo TDMA perdido\n");
+            }
+            continue;
         }
-        else {
-            printf("Erro ao ler AHT20\n");
-            temperatura = 0.0;
-            umidade = 0.0;
+
+        if (envio == UINT64_MAX || envio + toa_us > limite) {
+            return;
+        }
+        power_cpu_sleep_until(from_us_since_boot(envio));
+        int length = frame_batch_finish(&lote_tdma, to_ms_since_boot(get_absolute_time()));
+        if (!rfm95_transmit_async(lote_tdma.data, length, NULL)) {
+            printf("Duty cycle esgotado, lote mantido para o próximo slot\n");
+            return;
+        }
+        sequence_accepted(lote_tdma.data, length);
+        rfm95_transmit_wait();
+        lote_tdma.count = 0;
+    }
+}
+
+/**
+ * @brief Recebe o beacon do gateway até fim_us e alinha o relógio local
+ * 
+ * Usa o motor de recepção em vez de rfm95_receive(): o instante do RxDone
+ * fica registrado pela IRQ e não depende de quando o laço consulta o rádio.
+ * 
+ * @return true se um beacon foi recebido
+ */
+static bool tdma_receive_beacon(uint64_t fim_us) {
+    bool recebido = false;
+    rfm95_rx_start();
+    while (!recebido && time_us_64() < fim_us) {
+        const rfm95_packet_t* pacote = rfm95_rx_peek();
+        if (pacote == NULL) {
+            uint64_t acorda = time_us_64() + 1000;
+            power_cpu_sleep_until(from_us_since_boot(acorda < fim_us ? acorda : fim_us));
+            continue;
         }
+        frame_beacon_t beacon;
+        if (pacote->crc_ok && frame_decode_beacon(pacote->data, pacote->length, &beacon)) {
+            tdma_sync_beacon(&sincronismo, &beacon, pacote->timestamp_us, beacon_toa_us);
+            recebido = true;
+        }
+        rfm95_rx_release();
+    }
+    rfm95_rx_stop();
+    return recebido;
+}
+#endif
 
-        // Formatação da string JSON
-        snprintf(buffer, sizeof(buffer),
-                            "{\"temperatura\":%.2f,\"pressao\":%d,\"umidade\":%.2f}\r\n",
-                            temperatura, pressao, umidade);
+#if TRACE_ENABLED
+/**
+ * @brief Imprime os histogramas de fase a cada TRACE_DUMP_MS
+ */
+static void dump_traces(void) {
+    static uint32_t ultimo_ms;
+    uint32_t agora = to_ms_since_boot(get_absolute_time());
+    if (agora - ultimo_ms >= TRACE_DUMP_MS) {
+        ultimo_ms = agora;
+        trace_dump();
+    }
+}
+#endif
 
-        // Transmissão dos dados via LoRa
-        rfm95_transmit((uint8_t*)buffer, strlen(buffer));
+#if !USE_JSON_PAYLOAD && SUMMARY_SAMPLES > 1
+/**
+ * @brief Acrescenta a leitura à janela e codifica o resumo quando ela fecha
+ * 
+ * @return Tamanho do quadro de resumo, ou 0 enquanto a janela não fechou
+ * 
+ * Cada canal só recebe as leituras em que o campo é válido; um campo sem
+ * nenhuma leitura válida na janela fica fora do quadro.
+ */
+static int encode_summary(const amostra_t* amostra, uint8_t* buffer, int size) {
+    static const uint8_t campos[3] = { FRAME_FIELD_TEMPERATURE, FRAME_FIELD_HUMIDITY, FRAME_FIELD_PRESSURE };
+    const int32_t valores[3] = { amostra->temperatura, amostra->umidade, amostra->pressure_pa };
 
-        sleep_ms(2000);
+    if (janela_leituras == 0) {
+        for (int i = 0; i < 3; i++) {
+            stats_reset(&janela[i]);
+        }
+        janela_inicio_ms = amostra->time_ms;
+    }
+    janela_leituras++;
+    for (int i = 0; i < 3; i++) {
+        if (amostra->fields & campos[i]) {
+            stats_add(&janela[i], valores[i]);
+        }
     }
+    if (janela_leituras < SUMMARY_SAMPLES) {
+        return 0;
+    }
+
+    frame_summary_t resumo = {
+        .station_id = STATION_ID,
+        .sequence = sequencia,                     // Avança só com o quadro aceito
+        .count = janela_leituras,
+        .span_ms = amostra->time_ms - janela_inicio_ms,
+    };
+    frame_stat_t* destino[3] = { &resumo.temperature, &resumo.humidity, &resumo.pressure };
+    for (int i = 0; i < 3; i++) {
+        if (janela[i].count > 0) {
+            resumo.fields |= campos[i];
+            destino[i]->last = janela[i].last;
+            destino[i]->mean = stats_mean(&janela[i]);
+            destino[i]->min = janela[i].min;
+            destino[i]->max = janela[i].max;
+            destino[i]->stddev = stats_stddev(&janela[i]);
+        }
+    }
+    janela_leituras = 0;
+    return frame_encode_summary(&resumo, buffer, size);
 }
+#endif
 
 
 // ========================================================================
@@ -86,8 +834,10 @@ int main() {
 
 /**
  * @brief Inicializa todos os periféricos e sensores do sistema
+ * 
+ * @return true se o módulo LoRa foi inicializado, false caso contrário
  */
-void setup() {
+bool setup() {
     stdio_init_all();
 
     // === CONFIGURAÇÃO DOS SENSORES ===
@@ -95,4 +845,52 @@ void setup() {
     aht20_reset(I2C_PORT_SENSORS);
     aht20_init(I2C_PORT_SENSORS);
     bmp280_init(I2C_PORT_SENSORS);
+    bmp280_set_profile(I2C_PORT_SENSORS, &BMP280_PROFILE);
+
+    // === CONFIGURAÇÃO DO MÓDULO LORA ===
+    if(!rfm95_initialize()) {
+        printf("RFM95 initialization failed!\n");
+        return false;
+    }
+
+    printf("RFM95 initialized successfully!\n");
+    rfm95_set_tx_power(17); // Define potência de transmissão (2-17 dBm)
+    rfm95_set_airtime_budget(AIRTIME_DUTY_PPM, AIRTIME_BURST_US);
+
+    // Parâmetros de calibração do BMP280
+    bmp280_get_calib_params(I2C_PORT_SENSORS, &params);
+
+#if REPORT_ON_DELTA
+    report_init(&relato, &relato_config);
+#endif
+
+#if RELIABLE_LINK
+    arq_sender_init(&enlace, &arq_config, link_result, NULL);
+#endif
+
+#if TDMA_SLOTTED
+    // Slot para o maior lote; a escala efetiva vem no beacon do gateway
+    tdma_schedule_t escala;
+    tdma_schedule_init(&escala, TDMA_STATIONS,
+                       rfm95_time_on_air_us(FRAME_HEADER_SIZE + TDMA_BATCH_MAX * FRAME_BATCH_SAMPLE_MAX_SIZE),
+                       TDMA_GUARD_US);
+    beacon_toa_us = rfm95_time_on_air_us(FRAME_BEACON_SIZE);
+    tdma_sync_init(&sincronismo, true, TDMA_MAX_MISSED);
+    printf("TDMA: slot %u de %u, quadro de %lu ms\n", (unsigned)tdma_slot_of(&escala, STATION_ID),
+           (unsigned)escala.slots, (unsigned long)(tdma_frame_us(&escala) / 1000));
+#endif
+
+#if STORE_AND_FORWARD
+    // Recupera o log da flash (inclusive após um corte de energia)
+    flashlog_init(&armazenamento, FLASHLOG_OFFSET, FLASHLOG_SECTORS);
+    printf("Leituras guardadas na flash: %u\n", (unsigned)flashlog_pending(&armazenamento));
+#endif
+
+#if TRACE_ENABLED
+    printf("Custo de um ponto de medição: %lu ns\n", (unsigned long)trace_calibrate());
+#endif
+
+    // Contabilização de consumo a partir daqui
+    power_init();
+    return true;
 }